@@ -23,6 +23,9 @@
 #ifndef COMMON_H
 #define COMMON_H
 
+#include <stdio.h>
+#include <stdbool.h>
+
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 
@@ -100,11 +103,13 @@ void str_upper(char *str);
 void str_lower(char *str);
 char *create_base_name(char *file_name);
 char *function_prefix(char *project, char *declaration);
+char *container_prefix(char *project, char *declaration, char *container);
 
     /* Miscellaneous functions */
 
 size_t get_file_size(char *file_name);
 void emit_indent(FILE *outfile, int indent);
+void emit_alloc(FILE *outfile, char *lvalue, char *type, bool aligned);
 
     /* Functions to assist in XML parsing */
 
@@ -0,0 +1,98 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file layout.h
+ *  @brief Computes memory layout of struct and union declarations
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is a layout report, or layout information for other modules
+ */
+
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "common.h"
+
+#define LAYOUT_CACHE_LINE 64  /**<  cache line size in bytes  */
+
+  /**
+   *  @typedef layout_member
+   *  @brief creates a type for a @a layout_member struct
+   */
+
+typedef struct layout_member layout_member;
+
+  /**
+   *  @struct layout_member
+   *  @brief defines placement of a single field in an aggregate
+   *
+   *  NOTE:  all offsets, sizes and alignments are in bits
+   */
+
+struct layout_member
+{
+  xmlNodePtr field;  /**<  field element from declarations          */
+  char *name;        /**<  field name, NULL for anonymous aggregate  */
+  char *type_name;   /**<  printable type of field                   */
+  int offset;        /**<  offset of field from start of aggregate   */
+  int size;          /**<  size of field                             */
+  int align;         /**<  required alignment of field               */
+  bool bitfield;     /**<  true if field is a bitfield               */
+};
+
+  /**
+   *  @typedef layout
+   *  @brief creates a type for a @a layout struct
+   */
+
+typedef struct layout layout;
+
+  /**
+   *  @struct layout
+   *  @brief defines placement of all fields in a struct or union
+   *
+   *  NOTE:  all offsets, sizes and alignments are in bits
+   */
+
+struct layout
+{
+  xmlNodePtr node;          /**<  struct or union element               */
+  char *name;               /**<  name of struct or union               */
+  bool is_union;            /**<  true if aggregate is a union          */
+  int size;                 /**<  size of aggregate                     */
+  int align;                /**<  required alignment of aggregate       */
+  int n;                    /**<  number of items in @a members         */
+  layout_member *members;   /**<  array of members in declared order    */
+};
+
+layout *layout_new(xmlNodePtr node);
+void layout_free(layout *lo);
+layout *layout_pack(layout *lo);
+int layout_hole_bits(layout *lo);
+
+int layout_type_size(xmlNodePtr node);
+int layout_type_align(xmlNodePtr node);
+xmlNodePtr layout_find_declaration(xmlDocPtr doc, char *name);
+
+void gen_layout_report(xmlDocPtr doc, FILE *outfile);
+
+#endif //LAYOUT_H
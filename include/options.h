@@ -56,6 +56,66 @@ bool option_gen_avl(void);
 void option_gen_avl_on(void);
 void option_gen_avl_off(void);
 
+bool option_gen_serialize(void);
+void option_gen_serialize_on(void);
+void option_gen_serialize_off(void);
+
+bool option_gen_flat(void);
+void option_gen_flat_on(void);
+void option_gen_flat_off(void);
+
+bool option_gen_mmap(void);
+void option_gen_mmap_on(void);
+void option_gen_mmap_off(void);
+bool option_gen_delimited(void);
+void option_gen_delimited_on(void);
+void option_gen_delimited_off(void);
+bool option_gen_json(void);
+void option_gen_json_on(void);
+void option_gen_json_off(void);
+bool option_gen_hash(void);
+void option_gen_hash_on(void);
+void option_gen_hash_off(void);
+bool option_gen_ring(void);
+void option_gen_ring_on(void);
+void option_gen_ring_off(void);
+bool option_gen_shardmap(void);
+void option_gen_shardmap_on(void);
+void option_gen_shardmap_off(void);
+char *option_shardmap_key(void);
+void option_set_shardmap_key(char *field);
+bool option_gen_parallel(void);
+void option_gen_parallel_on(void);
+void option_gen_parallel_off(void);
+bool option_gen_heap(void);
+void option_gen_heap_on(void);
+void option_gen_heap_off(void);
+char *option_heap_key(void);
+void option_set_heap_key(char *field);
+bool option_heap_max(void);
+void option_heap_max_on(void);
+void option_heap_max_off(void);
+bool option_gen_bitmap(void);
+void option_gen_bitmap_on(void);
+void option_gen_bitmap_off(void);
+bool option_gen_skiplist(void);
+void option_gen_skiplist_on(void);
+void option_gen_skiplist_off(void);
+char *option_skiplist_key(void);
+void option_set_skiplist_key(char *field);
+bool option_concurrent_array(void);
+void option_concurrent_array_on(void);
+void option_concurrent_array_off(void);
+bool option_concurrent_list(void);
+void option_concurrent_list_on(void);
+void option_concurrent_list_off(void);
+bool option_concurrent_avl(void);
+void option_concurrent_avl_on(void);
+void option_concurrent_avl_off(void);
+bool option_persistent_avl(void);
+void option_persistent_avl_on(void);
+void option_persistent_avl_off(void);
+
 bool option_gen_readme(void);
 void option_gen_readme_on(void);
 void option_gen_readme_off(void);
@@ -72,5 +132,26 @@ bool option_cpp_compatible(void);
 void option_cpp_compatible_on(void);
 void option_cpp_compatible_off(void);
 
+bool option_layout_report(void);
+void option_layout_report_on(void);
+void option_layout_report_off(void);
+
+bool option_pack(void);
+void option_pack_on(void);
+void option_pack_off(void);
+
+char *option_profile(void);
+void option_set_profile(char *file_name);
+
+char *option_tuning(void);
+void option_set_tuning(char *file_name);
+
+bool option_inline_accessors(void);
+void option_inline_accessors_on(void);
+void option_inline_accessors_off(void);
+
+int option_split_source(void);
+void option_set_split_source(char *count);
+
 #endif //OPTIONS_H
 
@@ -0,0 +1,38 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file profile.h
+ *  @brief tracks field access profile used for hot/cold struct splitting
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdbool.h>
+
+#include "common.h"
+
+#define PROFILE_HOT_PERCENT 10  /**<  percent of hottest field to be hot  */
+
+int profile_load(char *file_name, xmlDocPtr doc);
+void profile_free(void);
+bool profile_split(char *aggregate);
+bool profile_field_is_cold(char *aggregate, char *field);
+char *profile_field_path(char *aggregate, char *field);
+
+#endif //PROFILE_H
@@ -0,0 +1,41 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-bitmap.h
+ *  @brief bitmap index add-on for source.h
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#ifndef SOURCE_BITMAP_H
+#define SOURCE_BITMAP_H
+
+#include <stdbool.h>
+
+#include "common.h"
+
+bool bitmap_field(xmlNodePtr field, xmlNodePtr *enumeration);
+bool bitmap_any(xmlNodePtr node);
+char *bitmap_value_type(xmlNodePtr field);
+void emit_aggregate_bitmap_functions(FILE *outfile,
+                                     xmlNodePtr node,
+                                     char *project);
+
+#endif //SOURCE_BITMAP_H
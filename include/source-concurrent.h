@@ -0,0 +1,63 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-concurrent.h
+ *  @brief thread-safe container add-on for source.h
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#ifndef SOURCE_CONCURRENT_H
+#define SOURCE_CONCURRENT_H
+
+#include <stdbool.h>
+
+#include "common.h"
+
+  /**
+   *  @typedef enum concurrent_lock
+   *  @brief locking done by a public wrapper around an unlocked function
+   */
+
+typedef enum
+{
+  concurrent_lock_read = 0,  /**<  shared lock                          */
+  concurrent_lock_write,     /**<  exclusive lock                       */
+  concurrent_lock_cursor,    /**<  shared lock plus cursor mutex        */
+  concurrent_lock_create,    /**<  initialise locks of new container    */
+  concurrent_lock_copy,      /**<  shared lock on source, init new one  */
+  concurrent_lock_destroy    /**<  destroy locks, then free container   */
+} concurrent_lock;
+
+bool concurrent_container(char *kind);
+char *concurrent_storage(bool concurrent);
+char *concurrent_suffix(bool concurrent);
+void emit_concurrent_wrapper(FILE *outfile,
+                             concurrent_lock lock,
+                             char *kind,
+                             char *return_type,
+                             bool pointer,
+                             char *fpre,
+                             char *op,
+                             char *args,
+                             char *params,
+                             ...);
+
+#endif //SOURCE_CONCURRENT_H
@@ -0,0 +1,48 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-flat.h
+ *  @brief flat view add-on for source.h
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#ifndef SOURCE_FLAT_H
+#define SOURCE_FLAT_H
+
+#include <stdint.h>
+
+#include "common.h"
+#include "source-serialize.h"
+
+void emit_flat_helpers(FILE *outfile, xmlNodePtr root);
+void emit_aggregate_flat_functions(FILE *outfile,
+                                   xmlNodePtr node,
+                                   char *project_name);
+char *flat_macro(char *project, char *aggregate_name, char *suffix);
+char *flat_field_size(char *project,
+                      char *aggregate_name,
+                      xmlNodePtr field,
+                      serialize_kind kind,
+                      xmlNodePtr type);
+char *flat_field_type(serialize_kind kind, xmlNodePtr type);
+uint64_t flat_layout_hash(xmlNodePtr node);
+
+#endif //SOURCE_FLAT_H
@@ -0,0 +1,58 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-hash.h
+ *  @brief hash and equality add-on for source.h
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#ifndef SOURCE_HASH_H
+#define SOURCE_HASH_H
+
+#include "common.h"
+
+  /**
+   *  @typedef enum hash_kind
+   *  @brief ways fields are hashed and compared
+   */
+
+typedef enum
+{
+  hash_kind_none = 0,     /**<  field can not be compared            */
+  hash_kind_integer,      /**<  integer or enum                      */
+  hash_kind_pointer,      /**<  pointer, compared by address         */
+  hash_kind_array,        /**<  array of integers or pointers        */
+  hash_kind_bitfield,     /**<  bitfield                             */
+  hash_kind_float,        /**<  float or double                      */
+  hash_kind_float_array,  /**<  array of float or double             */
+  hash_kind_string,       /**<  char *                               */
+  hash_kind_chars,        /**<  char array holding a string          */
+  hash_kind_struct,       /**<  nested struct                        */
+  hash_kind_bytes         /**<  anything else, compared byte by byte */
+} hash_kind;
+
+hash_kind hash_field_kind(xmlNodePtr node, xmlNodePtr *type);
+void emit_hash_helpers(FILE *outfile, xmlNodePtr root);
+void emit_aggregate_hash_functions(FILE *outfile,
+                                   xmlNodePtr node,
+                                   char *project_name);
+
+#endif //SOURCE_HASH_H
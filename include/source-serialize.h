@@ -0,0 +1,63 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-serialize.h
+ *  @brief serializer add-on for source.h
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#ifndef SOURCE_SERIALIZE_H
+#define SOURCE_SERIALIZE_H
+
+#include "common.h"
+
+  /**
+   *  @typedef enum serialize_kind
+   *  @brief encodings used for fields
+   */
+
+typedef enum
+{
+  serialize_kind_none = 0,   /**<  field can not be serialized      */
+  serialize_kind_integer,    /**<  integer or enum                  */
+  serialize_kind_float,      /**<  32 bit floating point            */
+  serialize_kind_double,     /**<  64 bit floating point            */
+  serialize_kind_bytes,      /**<  copied byte for byte             */
+  serialize_kind_bitfield,   /**<  bitfield, as 32 bit integer      */
+  serialize_kind_string,     /**<  char *, length prefixed          */
+  serialize_kind_aggregate,  /**<  nested struct or union           */
+  serialize_kind_array       /**<  array of integers or floats      */
+} serialize_kind;
+
+void emit_serialize_helpers(FILE *outfile, xmlNodePtr root);
+void emit_aggregate_serialize_functions(FILE *outfile,
+                                        xmlNodePtr node,
+                                        char *project_name);
+serialize_kind serialize_field_kind(xmlNodePtr node, xmlNodePtr *type);
+serialize_kind serialize_scalar_kind(xmlNodePtr node);
+void emit_aggregate_serialize_annotation(FILE *outfile,
+                                         char *prototype,
+                                         char *brief,
+                                         char **params,
+                                         char *returns,
+                                         int indent);
+
+#endif //SOURCE_SERIALIZE_H
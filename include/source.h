@@ -27,8 +27,16 @@
 #ifndef SOURCE_H
 #define SOURCE_H
 
+#include <stdio.h>
+#include <stdbool.h>
+
 #include "common.h"
 
 void gen_source(xmlDocPtr doc, char *base_name);
+int source_split_files(xmlNodePtr root);
+void emit_aggregate_inline_accessors(FILE *outfile,
+                                     xmlNodePtr node,
+                                     char *project_name);
+bool aggregate_accessor_is_inline(xmlNodePtr node, bool setter);
 
 #endif //SOURCE_H
@@ -0,0 +1,39 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file tuning.h
+ *  @brief tracks layout tuning directives for generated structs
+ */
+
+#ifndef TUNING_H
+#define TUNING_H
+
+#include <stdbool.h>
+
+#include "common.h"
+
+int tuning_load(char *file_name);
+void tuning_free(void);
+int tuning_align(char *aggregate);
+int tuning_field_align(char *aggregate, char *field);
+bool tuning_aligned(char *aggregate);
+bool tuning_field_interned(char *aggregate, char *field);
+bool tuning_interns(void);
+int tuning_field_inline(char *aggregate, char *field);
+
+#endif //TUNING_H
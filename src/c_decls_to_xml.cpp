@@ -878,6 +878,9 @@ static void add_struct(char **xml_str,
   }
   *xml_str = strapp(*xml_str, (char *)" size=\"");
   *xml_str = strapp(*xml_str, (char *)size_str);
+  sprintf(size_str, "%u", TYPE_ALIGN(base_type));
+  *xml_str = strapp(*xml_str, (char *)"\" align=\"");
+  *xml_str = strapp(*xml_str, (char *)size_str);
   *xml_str = strapp(*xml_str, (char *)"\">\n");
 
   ++indent_level;
@@ -928,6 +931,9 @@ static void add_union(char **xml_str,
   }
   *xml_str = strapp(*xml_str, (char *)" size=\"");
   *xml_str = strapp(*xml_str, (char *)size_str);
+  sprintf(size_str, "%u", TYPE_ALIGN(base_type));
+  *xml_str = strapp(*xml_str, (char *)"\" align=\"");
+  *xml_str = strapp(*xml_str, (char *)size_str);
   *xml_str = strapp(*xml_str, (char *)"\">\n");
 
   ++indent_level;
@@ -1054,6 +1060,9 @@ static void add_scalar(char **xml_str, tree field, int indent_level)
   add_indent(xml_str, indent_level);
   *xml_str = strapp(*xml_str, (char *)"<scalar size=\"");
   *xml_str = strapp(*xml_str, (char *)num_str);
+  sprintf(num_str, "%u", TYPE_ALIGN(field));
+  *xml_str = strapp(*xml_str, (char *)"\" align=\"");
+  *xml_str = strapp(*xml_str, (char *)num_str);
   *xml_str = strapp(*xml_str, (char *)"\" type-name=\"");
   *xml_str = strapp(*xml_str, (char *)type_name_s);
   *xml_str = strapp(*xml_str, (char *)"\" unsigned=\"");
@@ -35,6 +35,10 @@
 #include "makefile.h"
 #include "readme.h"
 #include "doxygen.h"
+#include "layout.h"
+#include "options.h"
+#include "profile.h"
+#include "tuning.h"
 
   /*  Prototypes for functions in this module  */
 
@@ -91,6 +95,16 @@ int gen_code(char *file_name, char *base_name)
 
   type_cache = build_type_cache(doc);
 
+  if (option_profile() && profile_load(option_profile(), doc)) goto exit;
+  if (option_tuning() && tuning_load(option_tuning())) goto exit;
+
+  if (option_layout_report())
+  {
+    gen_layout_report(doc, stdout);
+    retval = 0;
+    goto exit;
+  }
+
   gen_header(doc, base_name);
   gen_source(doc, base_name);
   gen_makefile(doc, base_name);
@@ -104,6 +118,8 @@ exit:
   if (xml_buf) free(xml_buf);
   if (infile) fclose(infile);
   if (type_cache) aggregates_free(type_cache);
+  profile_free();
+  tuning_free();
 
   return retval;
 }
@@ -404,6 +420,39 @@ void emit_indent(FILE *outfile, int indent)
     fputc(' ', outfile);
 }
 
+  /**
+   *  @fn void emit_alloc(FILE *outfile, char *lvalue, char *type, bool aligned)
+   *
+   *  @brief emits statement allocating one @p type and assigning it to
+   *         @p lvalue
+   *
+   *  NOTE:  over-aligned types are allocated with aligned_alloc(), which
+   *         needs no size adjustment since sizeof() of a type is always a
+   *         multiple of its alignment
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param lvalue - string containing target of assignment
+   *  @param type - string containing name of allocated type
+   *  @param aligned - true if @p type is over-aligned
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_alloc(FILE *outfile, char *lvalue, char *type, bool aligned)
+{
+  if (!outfile || !lvalue || !type) return;
+
+  if (aligned)
+    fprintf(outfile,
+            "%s = aligned_alloc(_Alignof(%s), sizeof(%s));\n",
+            lvalue,
+            type,
+            type);
+  else
+    fprintf(outfile, "%s = malloc(sizeof(%s));\n", lvalue, type);
+}
+
   /**
    *  @fn aggregates *aggregates_new(void)
    *
@@ -948,6 +997,41 @@ char *function_prefix(char *project, char *declaration)
   else
     prefix = strdup(declaration);
 
+exit:
+  return prefix;
+}
+
+  /**
+   *  @fn char *container_prefix(char *project,
+   *                             char *declaration,
+   *                             char *container)
+   *
+   *  @brief creates the function prefix of a @p container of
+   *         @p declaration, as the array, list and avl generators do
+   *
+   *  The prefix is function_prefix() of @p project and @p declaration, plus
+   *  "_" + @p container.  A project named for its struct gets, ie.
+   *  "person_array", not "person_person_array".
+   *
+   *  @param project - string containing name of project
+   *  @param declaration - string containing name of declaration item
+   *  @param container - string containing container kind, ie. "array"
+   *
+   *  @return string containing proper function prefix
+   */
+
+char *container_prefix(char *project, char *declaration, char *container)
+{
+  char *prefix = NULL;
+
+  if (!container) goto exit;
+
+  prefix = function_prefix(project, declaration);
+  if (!prefix) goto exit;
+
+  prefix = strapp(prefix, "_");
+  prefix = strapp(prefix, container);
+
 exit:
   return prefix;
 }
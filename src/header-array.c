@@ -29,6 +29,9 @@
 #include "config.h"
 
 #include "header-array.h"
+#include "header-bitmap.h"
+#include "header-concurrent.h"
+#include "source-concurrent.h"
 #include "options.h"
 
 static void emit_aggregate_array_annotation(FILE *outfile,
@@ -90,6 +93,8 @@ bool emit_aggregate_array(FILE *outfile, xmlNodePtr node, int indent)
 
   len = strlen(name) + 10;
   if (len < 16) len = 16;
+  if (concurrent_container("array") && len < 24) len = 24;
+  if (len < bitmap_fields_width(node)) len = bitmap_fields_width(node);
 
   emit_indent(outfile, indent);
   fprintf(outfile,
@@ -118,6 +123,10 @@ bool emit_aggregate_array(FILE *outfile, xmlNodePtr node, int indent)
           field,
           is_doxygen ? "*<" : "");
 
+  emit_concurrent_fields(outfile, "array", len, indent);
+
+  emit_aggregate_bitmap_fields(outfile, node, len, indent);
+
   --indent;
 
   emit_indent(outfile, indent);
@@ -29,6 +29,8 @@
 #include "config.h"
 
 #include "header-avl.h"
+#include "header-concurrent.h"
+#include "source-concurrent.h"
 #include "options.h"
 
 static void emit_aggregate_avl_typedefs_annotation(FILE *outfile,
@@ -150,6 +152,7 @@ bool emit_aggregate_avl(FILE *outfile, xmlNodePtr node, int indent)
 
   len = strlen(name) + 10;
   if (len < 16) len = 16;
+  if (concurrent_container("avl") && len < 24) len = 24;
 
   emit_indent(outfile, indent);
   fprintf(outfile,
@@ -159,6 +162,8 @@ bool emit_aggregate_avl(FILE *outfile, xmlNodePtr node, int indent)
           "avl *_avl;",
           is_doxygen ? "*<" : "");
 
+  emit_concurrent_fields(outfile, "avl", len, indent);
+
   --indent;
 
   emit_indent(outfile, indent);
@@ -220,7 +225,7 @@ bool emit_aggregate_avl_node(FILE *outfile, xmlNodePtr node, int indent)
   len = strlen(node_name) + 11;
   if (len < 22) len = 22;
 
-  field = malloc(len);
+  field = malloc(len + 1);
   if (!field) goto exit;
 
   emit_aggregate_avl_node_annotation(outfile,
@@ -400,6 +405,11 @@ void emit_aggregate_avl_function_prototypes(FILE *outfile,
           "void %s_free_node_func(%s_node *node);\n",
           function_prefix,
           avl_name);
+  fprintf(outfile,
+          "int %s_cmp_data_func(%s *a, %s *b);\n",
+          function_prefix,
+          name,
+          name);
   fprintf(outfile,
           "int %s_cmp_node_func(%s_node *a, %s_node *b);\n",
           function_prefix,
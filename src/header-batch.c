@@ -0,0 +1,160 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file header-batch.c
+ *  @brief container batch insert and delete add-on to header.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "header-batch.h"
+#include "source-iter.h"
+#include "options.h"
+
+  /**
+   *  @fn void emit_aggregate_batch_function_prototypes(FILE *outfile,
+   *                                                    xmlNodePtr node,
+   *                                                    char *project_name)
+   *
+   *  @brief emits batch function prototypes of every container for struct
+   *         or union in @p node to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_batch_function_prototypes(FILE *outfile,
+                                              xmlNodePtr node,
+                                              char *project_name)
+{
+  static char *kinds[] = { "array", "list", "avl", NULL };
+  char *name = NULL;
+  char *project = NULL;
+  char *container_name = NULL;
+  char *fpre = NULL;
+  int i;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+
+  str_lower(project);
+
+  for (i = 0; kinds[i]; i++)
+  {
+    if (!iter_container(kinds[i])) continue;
+
+    container_name = strapp(container_name, name);
+    container_name = strapp(container_name, "_");
+    container_name = strapp(container_name, kinds[i]);
+
+    fpre = container_prefix(project, name, kinds[i]);
+
+    emit_indent(outfile, 1);
+    fprintf(outfile, "/*\n");
+
+    emit_indent(outfile, 1);
+    fprintf(outfile, " *  Batch functions for struct %s\n", container_name);
+
+    emit_indent(outfile, 1);
+    fprintf(outfile, " */\n");
+
+    fprintf(outfile, "\n");
+
+    if (!strcmp(kinds[i], "array"))
+    {
+      fprintf(outfile,
+              "size_t %s_add_many(%s *instance, %s **items, size_t n);\n",
+              fpre,
+              container_name,
+              name);
+      fprintf(outfile,
+              "size_t %s_remove_many(%s *instance, int *index, size_t n);\n",
+              fpre,
+              container_name);
+    }
+    else if (!strcmp(kinds[i], "list"))
+    {
+      fprintf(outfile,
+              "size_t %s_add_many(%s *instance,\n",
+              fpre,
+              container_name);
+      fprintf(outfile,
+              "%*sllist_position position,\n",
+              (int)strlen(fpre) + 17,
+              "");
+      fprintf(outfile,
+              "%*s%s *where,\n",
+              (int)strlen(fpre) + 17,
+              "",
+              name);
+      fprintf(outfile,
+              "%*s%s **items,\n",
+              (int)strlen(fpre) + 17,
+              "",
+              name);
+      fprintf(outfile, "%*ssize_t n);\n", (int)strlen(fpre) + 17, "");
+      fprintf(outfile,
+              "size_t %s_remove_many(%s *instance, %s **items, size_t n);\n",
+              fpre,
+              container_name,
+              name);
+    }
+    else
+    {
+      fprintf(outfile,
+              "size_t %s_insert_many(%s *instance, %s **items, size_t n);\n",
+              fpre,
+              container_name,
+              name);
+      fprintf(outfile,
+              "size_t %s_delete_many(%s *instance, %s **targets, size_t n);\n",
+              fpre,
+              container_name,
+              name);
+    }
+
+    fprintf(outfile, "\n");
+
+    free(container_name);
+    free(fpre);
+    container_name = fpre = NULL;
+  }
+
+exit:
+  if (name) free(name);
+  if (project) free(project);
+}
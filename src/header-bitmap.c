@@ -0,0 +1,499 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file header-bitmap.c
+ *  @brief bitmap index add-on to header.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "header-bitmap.h"
+#include "source-bitmap.h"
+#include "options.h"
+
+  /**
+   *  @typedef struct bitmap_combine
+   *  @brief name and C operator of a word-wide bitmap combination
+   */
+
+typedef struct
+{
+  char *op;           /**<  function name suffix        */
+  char *expression;   /**<  combination of a[i], b[i]   */
+  char *brief;        /**<  comment of function         */
+} bitmap_combine;
+
+static bitmap_combine _combines[] =
+{
+  { "and", "a[i] & b[i]", "items in both a and b" },
+  { "or", "a[i] | b[i]", "items in a, b or both" },
+  { "andnot", "a[i] & ~b[i]", "items in a but not in b" },
+  { NULL, NULL, NULL }
+};
+
+  /**
+   *  @fn int bitmap_fields_width(xmlNodePtr node)
+   *
+   *  @brief returns width of the widest bitmap index field declaration of
+   *         array of struct or union in @p node
+   *
+   *  @param node - xmlNodePtr containing struct or union element
+   *
+   *  @return width of declaration column, 0 if array keeps no index
+   */
+
+int bitmap_fields_width(xmlNodePtr node)
+{
+  xmlNodePtr field;
+  char *field_name = NULL;
+  int width = 0;
+  int len;
+
+  if (!bitmap_any(node)) return 0;
+
+  width = strlen("size_t bitmap_words;") + 1;
+
+  for (field = node->children; field; field = field->next)
+  {
+    if (!bitmap_field(field, NULL)) continue;
+
+    field_name = get_attribute(field, "name");
+    if (!field_name) continue;
+
+    len = strlen("uint64_t *_bits;") + strlen(field_name) + 1;
+    if (len > width) width = len;
+
+    free(field_name);
+  }
+
+  return width;
+}
+
+  /**
+   *  @fn void emit_aggregate_bitmap_fields(FILE *outfile,
+   *                                        xmlNodePtr node,
+   *                                        int len,
+   *                                        int indent)
+   *
+   *  @brief emits bitmap index fields of array struct for struct or union in
+   *         @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param len - width of field declaration column
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_bitmap_fields(FILE *outfile,
+                                  xmlNodePtr node,
+                                  int len,
+                                  int indent)
+{
+  xmlNodePtr field;
+  char *field_name = NULL;
+  char *declaration = NULL;
+  char *comment = NULL;
+  int is_doxygen = 0;
+
+  if (!outfile || !node) goto exit;
+
+  if (!bitmap_any(node)) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen: is_doxygen = 1; break;
+    default: is_doxygen = 0; break;
+  }
+
+  for (field = node->children; field; field = field->next)
+  {
+    if (!bitmap_field(field, NULL)) continue;
+
+    field_name = get_attribute(field, "name");
+    if (!field_name) continue;
+
+    declaration = strapp(declaration, "uint64_t *");
+    declaration = strapp(declaration, field_name);
+    declaration = strapp(declaration, "_bits;");
+
+    comment = strapp(comment, "index of ");
+    comment = strapp(comment, field_name);
+    comment = strapp(comment, ", a row per value  ");
+
+    if (declaration && comment)
+    {
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              "%-*.*s/*%s  %-33s*/\n",
+              len,
+              len,
+              declaration,
+              is_doxygen ? "*<" : "",
+              comment);
+    }
+
+    free(field_name);
+    if (declaration) free(declaration);
+    if (comment) free(comment);
+    field_name = declaration = comment = NULL;
+  }
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  %-33s*/\n",
+          len,
+          len,
+          "size_t bitmap_words;",
+          is_doxygen ? "*<" : "",
+          "words allocated per row  ");
+
+exit:
+}
+
+  /**
+   *  @fn void emit_bitmap_functions(FILE *outfile,
+   *                                 xmlNodePtr root,
+   *                                 char *project_name)
+   *
+   *  @brief emits static inline functions combining and counting rows of
+   *         bits copied out of bitmap indexes
+   *
+   *  NOTE:  nothing is emitted if no declaration in @p root keeps a bitmap
+   *         index
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param root - xmlNodePtr containing c-decls element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_bitmap_functions(FILE *outfile, xmlNodePtr root, char *project_name)
+{
+  xmlNodePtr node;
+  char *project = NULL;
+  char *fpre = NULL;
+  bitmap_combine *combine;
+  int indent = 0;
+
+  if (!outfile || !root || !project_name) goto exit;
+
+  for (node = root->children; node; node = node->next)
+    if ((node->type == XML_ELEMENT_NODE) && bitmap_any(node)) break;
+
+  if (!node) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+
+  str_lower(project);
+
+  fpre = function_prefix(project, "bitmap");
+  if (!fpre) goto exit;
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " *  Bitmap functions over rows of bits of indexes\n");
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  for (combine = _combines; combine->op; combine++)
+  {
+    emit_indent(outfile, 1);
+    fprintf(outfile, "/*  %s, returns their number  */\n", combine->brief);
+
+    fprintf(outfile, "\n");
+
+    fprintf(outfile,
+            "static inline size_t %s_%s(uint64_t *dst,\n",
+            fpre,
+            combine->op);
+    fprintf(outfile,
+            "%*sconst uint64_t *a,\n",
+            (int)(strlen(fpre) + strlen(combine->op) + 23),
+            "");
+    fprintf(outfile,
+            "%*sconst uint64_t *b,\n",
+            (int)(strlen(fpre) + strlen(combine->op) + 23),
+            "");
+    fprintf(outfile,
+            "%*ssize_t words)\n",
+            (int)(strlen(fpre) + strlen(combine->op) + 23),
+            "");
+    fprintf(outfile, "{\n");
+
+    ++indent;
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "size_t count = 0;\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "size_t i;\n");
+
+    fprintf(outfile, "\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "for (i = 0; i < words; i++)\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "{\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "dst[i] = %s;\n", combine->expression);
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "count += (size_t)__builtin_popcountll(dst[i]);\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "}\n");
+
+    fprintf(outfile, "\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "return count;\n");
+
+    --indent;
+
+    fprintf(outfile, "}\n");
+
+    fprintf(outfile, "\n");
+  }
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, "/*  number of items in bits  */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline size_t %s_count(const uint64_t *bits, "
+          "size_t words)\n",
+          fpre);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t count = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < words; i++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "count += (size_t)__builtin_popcountll(bits[i]);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return count;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, 1);
+  fprintf(outfile,
+          "/*  index of first item in bits at or after from, "
+          "SIZE_MAX if none  */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline size_t %s_next(const uint64_t *bits,\n",
+          fpre);
+  fprintf(outfile,
+          "%*ssize_t words,\n",
+          (int)(strlen(fpre) + 27),
+          "");
+  fprintf(outfile,
+          "%*ssize_t from)\n",
+          (int)(strlen(fpre) + 27),
+          "");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t w = from / 64;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint64_t word;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (w >= words) return SIZE_MAX;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "word = bits[w] & (~UINT64_C(0) << (from %% 64));\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "while (!word)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (++w >= words) return SIZE_MAX;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "word = bits[w];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "return w * 64 + (size_t)__builtin_ctzll(word);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (project) free(project);
+  if (fpre) free(fpre);
+}
+
+  /**
+   *  @fn void emit_aggregate_bitmap_function_prototypes(FILE *outfile,
+   *                                                     xmlNodePtr node,
+   *                                                     char *project_name)
+   *
+   *  @brief emits bitmap index function prototypes of array of struct or
+   *         union in @p node to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_bitmap_function_prototypes(FILE *outfile,
+                                               xmlNodePtr node,
+                                               char *project_name)
+{
+  xmlNodePtr field;
+  char *name = NULL;
+  char *project = NULL;
+  char *array_name = NULL;
+  char *fpre = NULL;
+  char *field_name = NULL;
+  char *type = NULL;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  if (!bitmap_any(node)) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+
+  str_lower(project);
+
+  array_name = strdup(name);
+  array_name = strapp(array_name, "_array");
+
+  fpre = container_prefix(project, name, "array");
+  if (!fpre) goto exit;
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, 1);
+  fprintf(outfile,
+          " *  Bitmap index functions for %s %s\n",
+          node->name,
+          array_name);
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "size_t %s_bitmap_words(%s *instance);\n",
+          fpre,
+          array_name);
+
+  for (field = node->children; field; field = field->next)
+  {
+    if (!bitmap_field(field, NULL)) continue;
+
+    field_name = get_attribute(field, "name");
+    type = bitmap_value_type(field);
+
+    if (field_name && type)
+      fprintf(outfile,
+              "size_t %s_%s_bits(%s *instance, %s value, uint64_t *bits);\n",
+              fpre,
+              field_name,
+              array_name,
+              type);
+
+    if (field_name) free(field_name);
+    if (type) free(type);
+    field_name = type = NULL;
+  }
+
+  fprintf(outfile,
+          "void %s_bitmap_refresh(%s *instance, int index);\n",
+          fpre,
+          array_name);
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (project) free(project);
+  if (array_name) free(array_name);
+  if (fpre) free(fpre);
+}
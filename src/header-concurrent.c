@@ -0,0 +1,122 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file header-concurrent.c
+ *  @brief thread-safe container add-on to header.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "header-concurrent.h"
+#include "source-concurrent.h"
+#include "source-parallel.h"
+#include "source-persistent.h"
+#include "options.h"
+
+  /**
+   *  @fn bool concurrent_any(void)
+   *
+   *  @brief determines if any container is generated thread-safe, sharded
+   *         maps, parallel walks, persistent avls and skip lists always need
+   *         threads, rings hand structs between threads
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return true if generated header needs pthread.h, false if not
+   */
+
+bool concurrent_any(void)
+{
+  return (option_gen_array() && option_concurrent_array()) ||
+         (option_gen_list() && option_concurrent_list()) ||
+         (option_gen_avl() && option_concurrent_avl()) ||
+         option_gen_shardmap() ||
+         parallel_any() ||
+         persistent_any() ||
+         option_gen_skiplist() ||
+         option_gen_ring();
+}
+
+  /**
+   *  @fn void emit_concurrent_fields(FILE *outfile,
+   *                                  char *kind,
+   *                                  int len,
+   *                                  int indent)
+   *
+   *  @brief emits lock fields of a concurrent container struct
+   *
+   *  NOTE:  array and list also get a cursor mutex, their cursor functions
+   *         move shared state even under the read lock
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param kind - string containing "array", "list" or "avl"
+   *  @param len - width of field declaration column
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_concurrent_fields(FILE *outfile, char *kind, int len, int indent)
+{
+  int is_doxygen = 0;
+  int width = 0;
+
+  if (!outfile || !kind) goto exit;
+
+  if (!concurrent_container(kind)) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen: is_doxygen = 1; break;
+    default: is_doxygen = 0; break;
+  }
+
+  if (!strcmp(kind, "array")) width = 33;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  %-*s*/\n",
+          len,
+          len,
+          "pthread_rwlock_t lock;",
+          is_doxygen ? "*<" : "",
+          width,
+          "guards container  ");
+
+  if (!strcmp(kind, "avl")) goto exit;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  %-*s*/\n",
+          len,
+          len,
+          "pthread_mutex_t cursor;",
+          is_doxygen ? "*<" : "",
+          width,
+          "guards current position  ");
+
+exit:
+}
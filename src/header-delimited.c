@@ -0,0 +1,132 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file header-delimited.c
+ *  @brief delimited text loader add-on to header.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "header-delimited.h"
+#include "options.h"
+
+  /**
+   *  @fn void emit_aggregate_delimited_function_prototypes(FILE *outfile,
+   *                                                        xmlNodePtr node,
+   *                                                        char *project_name)
+   *
+   *  @brief emits delimited text loader type and function prototypes for
+   *         struct in @p node to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_delimited_function_prototypes(FILE *outfile,
+                                                  xmlNodePtr node,
+                                                  char *project_name)
+{
+  char *name = NULL;
+  char *project = NULL;
+  char *fpre = NULL;
+  char *array_name = NULL;
+  char *array_fpre = NULL;
+
+  if (!option_gen_delimited()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  if (strcmp((char *)node->name, "struct")) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+
+  str_lower(project);
+
+  fpre = function_prefix(project, name);
+  if (!fpre) goto exit;
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, 1);
+  fprintf(outfile,
+          " *  Delimited text loader functions for struct %s\n",
+          name);
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "typedef size_t (*%s_load_action)(void *container,"
+          " %s **items, size_t n);\n",
+          name,
+          name);
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "size_t %s_load_delimited(FILE *fp,\n"
+          "%*schar delimiter,\n"
+          "%*s%s_load_action action,\n"
+          "%*svoid *container);\n",
+          fpre,
+          (int)strlen(fpre) + 23, "",
+          (int)strlen(fpre) + 23, "",
+          name,
+          (int)strlen(fpre) + 23, "");
+
+  if (option_gen_array())
+  {
+    array_name = strdup(name);
+    array_name = strapp(array_name, "_array");
+
+    array_fpre = container_prefix(project, name, "array");
+    if (!array_fpre) goto exit;
+
+    fprintf(outfile,
+            "size_t %s_load_delimited(FILE *fp,"
+            " char delimiter, %s *instance);\n",
+            array_fpre,
+            array_name);
+  }
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (project) free(project);
+  if (fpre) free(fpre);
+  if (array_name) free(array_name);
+  if (array_fpre) free(array_fpre);
+}
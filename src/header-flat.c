@@ -0,0 +1,261 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file header-flat.c
+ *  @brief flat view add-on to header.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "header-flat.h"
+#include "source-flat.h"
+#include "options.h"
+
+static void emit_aggregate_flat_macros(FILE *outfile,
+                                       xmlNodePtr node,
+                                       char *project,
+                                       char *name);
+
+  /**
+   *  @fn void emit_aggregate_flat_function_prototypes(FILE *outfile,
+   *                                                   xmlNodePtr node,
+   *                                                   char *project_name)
+   *
+   *  @brief emits flat view layout macros and function prototypes for struct
+   *         or union in @p node to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_flat_function_prototypes(FILE *outfile,
+                                             xmlNodePtr node,
+                                             char *project_name)
+{
+  xmlNodePtr child;
+  xmlNodePtr type;
+  serialize_kind kind;
+  char *name = NULL;
+  char *project = NULL;
+  char *fpre = NULL;
+  char *field_name = NULL;
+  char *return_type = NULL;
+
+  if (!option_gen_flat()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+
+  str_lower(project);
+
+  fpre = function_prefix(project, name);
+  if (!fpre) goto exit;
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " *  Flat view functions for %s %s\n", node->name, name);
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  emit_aggregate_flat_macros(outfile, node, project, name);
+
+  fprintf(outfile,
+          "size_t %s_flat_size(%s *instance);\n",
+          fpre,
+          name);
+  fprintf(outfile,
+          "unsigned char *%s_flat_store(%s *instance,"
+          " unsigned char *view, unsigned char *tail);\n",
+          fpre,
+          name);
+  fprintf(outfile,
+          "size_t %s_flatten(%s *instance, unsigned char *buf, size_t len);\n",
+          fpre,
+          name);
+  fprintf(outfile,
+          "bool %s_flat_verify(const unsigned char *view, size_t len);\n",
+          fpre);
+
+  if (strcmp((char *)node->name, "struct")) goto done;
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (strcmp((char *)child->name, "field")) continue;
+
+    kind = serialize_field_kind(child, &type);
+
+    return_type = flat_field_type(kind, type);
+    if (!return_type) continue;
+
+    field_name = get_attribute(child, "name");
+
+    fprintf(outfile,
+            "%s%s%s_flat_get_%s(const unsigned char *view%s);\n",
+            return_type,
+            return_type[strlen(return_type) - 1] == '*' ? "" : " ",
+            fpre,
+            field_name,
+            kind == serialize_kind_array ? ", size_t i" : "");
+
+    free(return_type);
+    return_type = NULL;
+
+    if (field_name) free(field_name);
+    field_name = NULL;
+  }
+
+done:
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (project) free(project);
+  if (fpre) free(fpre);
+}
+
+  /**
+   *  @fn void emit_aggregate_flat_macros(FILE *outfile,
+   *                                      xmlNodePtr node,
+   *                                      char *project,
+   *                                      char *name)
+   *
+   *  @brief emits flat view offset of every field, size of flat block and
+   *         layout hash for struct or union in @p node to @p outfile
+   *
+   *  NOTE:  each offset is the previous offset plus the size of the previous
+   *         field, so fields are packed without padding
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing lower case project name
+   *  @param name - string containing name of struct or union
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_flat_macros(FILE *outfile,
+                                       xmlNodePtr node,
+                                       char *project,
+                                       char *name)
+{
+  xmlNodePtr child;
+  xmlNodePtr type;
+  serialize_kind kind;
+  char *field_name = NULL;
+  char *suffix = NULL;
+  char *offset = NULL;
+  char *size = NULL;
+  char *next = NULL;
+
+  if (!outfile || !node || !project || !name) goto exit;
+
+  next = flat_macro(project, name, "SIZE");
+  if (!next) goto exit;
+
+  if (!strcmp((char *)node->name, "union"))
+  {
+    fprintf(outfile, "#define %s sizeof(%s)\n", next, name);
+    goto hash;
+  }
+
+  free(next);
+  next = strdup("0");
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (strcmp((char *)child->name, "field")) continue;
+
+    kind = serialize_field_kind(child, &type);
+
+    size = flat_field_size(project, name, child, kind, type);
+    if (!size) continue;
+
+    field_name = get_attribute(child, "name");
+
+    suffix = strapp(suffix, "OFFSET_");
+    suffix = strapp(suffix, field_name);
+
+    offset = flat_macro(project, name, suffix);
+
+    fprintf(outfile, "#define %s %s\n", offset, next);
+
+    free(next);
+    next = NULL;
+
+    next = strapp(next, "(");
+    next = strapp(next, offset);
+    next = strapp(next, " + ");
+    next = strapp(next, size);
+    next = strapp(next, ")");
+
+    if (field_name) free(field_name);
+    field_name = NULL;
+
+    if (suffix) free(suffix);
+    suffix = NULL;
+
+    if (offset) free(offset);
+    offset = NULL;
+
+    free(size);
+    size = NULL;
+  }
+
+  offset = flat_macro(project, name, "SIZE");
+
+  fprintf(outfile, "#define %s %s\n", offset, next);
+
+hash:
+  free(offset);
+  offset = flat_macro(project, name, "LAYOUT_HASH");
+
+  fprintf(outfile,
+          "#define %s UINT64_C(0x%016llx)\n",
+          offset,
+          (unsigned long long)flat_layout_hash(node));
+  fprintf(outfile, "\n");
+
+exit:
+  if (offset) free(offset);
+  if (next) free(next);
+}
@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file header-hash.c
+ *  @brief hash and equality add-on to header.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "header-hash.h"
+#include "options.h"
+
+  /**
+   *  @fn void emit_aggregate_hash_function_prototypes(FILE *outfile,
+   *                                                   xmlNodePtr node,
+   *                                                   char *project_name)
+   *
+   *  @brief emits hash and equality function prototypes for struct or union
+   *         in @p node to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_hash_function_prototypes(FILE *outfile,
+                                             xmlNodePtr node,
+                                             char *project_name)
+{
+  char *name = NULL;
+  char *project = NULL;
+  char *fpre = NULL;
+
+  if (!option_gen_hash()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+
+  str_lower(project);
+
+  fpre = function_prefix(project, name);
+  if (!fpre) goto exit;
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, 1);
+  fprintf(outfile,
+          " *  Hash and equality functions for %s %s\n",
+          node->name,
+          name);
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "uint64_t %s_hash(%s *instance);\n", fpre, name);
+  fprintf(outfile, "bool %s_equal(%s *a, %s *b);\n", fpre, name, name);
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (project) free(project);
+  if (fpre) free(fpre);
+}
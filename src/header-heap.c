@@ -0,0 +1,437 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file header-heap.c
+ *  @brief array backed heap add-on to header.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "header-heap.h"
+#include "source-heap.h"
+#include "options.h"
+
+static void emit_aggregate_heap_annotation(FILE *outfile,
+                                           char *aggregate_name,
+                                           char *type_name,
+                                           char *brief,
+                                           int indent);
+
+  /**
+   *  @fn bool emit_aggregate_heap_entry(FILE *outfile,
+   *                                     xmlNodePtr node,
+   *                                     int indent)
+   *
+   *  @brief emits heap entry struct for struct or union from @p node to
+   *         @p outfile
+   *
+   *  NOTE:  entries carry a copy of the key, so sifting never touches the
+   *         items themselves
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @return true if emitted, false otherwise
+   */
+
+bool emit_aggregate_heap_entry(FILE *outfile, xmlNodePtr node, int indent)
+{
+  char *name = NULL;
+  char *entry_name = NULL;
+  char *key_type = NULL;
+  char *field = NULL;
+  int len;
+  int is_doxygen = 0;
+  bool did_it = false;
+
+  if (!option_gen_heap()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  key_type = heap_key_type(node);
+  if (!key_type) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen: is_doxygen = 1; break;
+    default: is_doxygen = 0; break;
+  }
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  entry_name = strapp(entry_name, name);
+  entry_name = strapp(entry_name, "_heap_entry");
+  if (!entry_name) goto exit;
+
+  emit_aggregate_heap_annotation(outfile,
+                                 name,
+                                 entry_name,
+                                 "one position of a heap of",
+                                 indent + 1);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "struct %s\n", entry_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  field = strapp(field, key_type);
+  field = strapp(field, key_type[strlen(key_type) - 1] == '*' ? "" : " ");
+  field = strapp(field, "key;");
+  if (!field) goto exit;
+
+  len = strlen(name) + 8;
+  if ((int)strlen(field) + 1 > len) len = strlen(field) + 1;
+  if (len < 15) len = 15;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  copy of key of item    */\n",
+          len,
+          len,
+          field,
+          is_doxygen ? "*<" : "");
+
+  free(field);
+  field = NULL;
+
+  field = strapp(field, name);
+  field = strapp(field, " *item;");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  item at this position  */\n",
+          len,
+          len,
+          field,
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  handle of item         */\n",
+          len,
+          len,
+          "size_t handle;",
+          is_doxygen ? "*<" : "");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}");
+
+  did_it = true;
+
+exit:
+  if (name) free(name);
+  if (entry_name) free(entry_name);
+  if (key_type) free(key_type);
+  if (field) free(field);
+
+  return did_it;
+}
+
+  /**
+   *  @fn bool emit_aggregate_heap(FILE *outfile, xmlNodePtr node, int indent)
+   *
+   *  @brief emits heap struct for struct or union from @p node to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @return true if emitted, false otherwise
+   */
+
+bool emit_aggregate_heap(FILE *outfile, xmlNodePtr node, int indent)
+{
+  char *name = NULL;
+  char *heap_name = NULL;
+  char *field = NULL;
+  int len;
+  int is_doxygen = 0;
+  bool did_it = false;
+
+  if (!option_gen_heap()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  if (!heap_key(node, NULL)) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen: is_doxygen = 1; break;
+    default: is_doxygen = 0; break;
+  }
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  heap_name = strapp(heap_name, name);
+  heap_name = strapp(heap_name, "_heap");
+  if (!heap_name) goto exit;
+
+  emit_aggregate_heap_annotation(outfile,
+                                 name,
+                                 heap_name,
+                                 option_heap_max() ?
+                                 "4-ary max-heap, largest key on top, of" :
+                                 "4-ary min-heap, smallest key on top, of",
+                                 indent + 1);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "struct %s\n", heap_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  len = strlen(heap_name) + 15;
+
+  field = strapp(field, heap_name);
+  field = strapp(field, "_entry *entry;");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  items in heap order               */\n",
+          len,
+          len,
+          field,
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  position of each live handle      */\n",
+          len,
+          len,
+          "size_t *where;",
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  handles free for reuse            */\n",
+          len,
+          len,
+          "size_t *spare;",
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  number of items                   */\n",
+          len,
+          len,
+          "size_t n;",
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  number of handles free for reuse  */\n",
+          len,
+          len,
+          "size_t nspare;",
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  number of handles handed out      */\n",
+          len,
+          len,
+          "size_t handles;",
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  number of entries allocated       */\n",
+          len,
+          len,
+          "size_t size;",
+          is_doxygen ? "*<" : "");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}");
+
+  did_it = true;
+
+exit:
+  if (name) free(name);
+  if (heap_name) free(heap_name);
+  if (field) free(field);
+
+  return did_it;
+}
+
+  /**
+   *  @fn void emit_aggregate_heap_function_prototypes(FILE *outfile,
+   *                                                   xmlNodePtr node,
+   *                                                   char *project_name)
+   *
+   *  @brief emits heap function prototypes for struct or union in @p node
+   *         to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_heap_function_prototypes(FILE *outfile,
+                                             xmlNodePtr node,
+                                             char *project_name)
+{
+  char *name = NULL;
+  char *project = NULL;
+  char *heap_name = NULL;
+  char *fpre = NULL;
+
+  if (!option_gen_heap()) goto exit;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  if (!heap_key(node, NULL)) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+
+  str_lower(project);
+
+  heap_name = strdup(name);
+  heap_name = strapp(heap_name, "_heap");
+
+  fpre = container_prefix(project, name, "heap");
+  if (!heap_name || !fpre) goto exit;
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " *  Heap functions for struct %s\n", heap_name);
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "%s *%s_new(size_t capacity);\n", heap_name, fpre);
+  fprintf(outfile,
+          "%s *%s_heapify(%s **items, size_t n);\n",
+          heap_name,
+          fpre,
+          name);
+  fprintf(outfile, "void %s_free(%s *heap);\n", fpre, heap_name);
+  fprintf(outfile,
+          "bool %s_push(%s *heap, %s *item, size_t *handle);\n",
+          fpre,
+          heap_name,
+          name);
+  fprintf(outfile, "%s *%s_peek(%s *heap);\n", name, fpre, heap_name);
+  fprintf(outfile, "%s *%s_pop(%s *heap);\n", name, fpre, heap_name);
+  fprintf(outfile,
+          "bool %s_update(%s *heap, size_t handle);\n",
+          fpre,
+          heap_name);
+  fprintf(outfile, "size_t %s_count(%s *heap);\n", fpre, heap_name);
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (project) free(project);
+  if (heap_name) free(heap_name);
+  if (fpre) free(fpre);
+}
+
+  /**
+   *  @fn void emit_aggregate_heap_annotation(FILE *outfile,
+   *                                          char *aggregate_name,
+   *                                          char *type_name,
+   *                                          char *brief,
+   *                                          int indent)
+   *
+   *  @brief emits annotation for a heap, or an entry of one
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param aggregate_name - string containing typedef name of base aggregate
+   *  @param type_name - string containing typedef name of annotated struct
+   *  @param brief - string describing annotated struct
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_heap_annotation(FILE *outfile,
+                                           char *aggregate_name,
+                                           char *type_name,
+                                           char *brief,
+                                           int indent)
+{
+  if (!outfile || !aggregate_name || !type_name || !brief) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/**\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @struct %s\n", type_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @brief %s @a %s pointers\n", brief, aggregate_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    case annotation_type_text:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/*\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  %s %s pointers\n", brief, aggregate_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    default: break;
+  }
+
+exit:
+}
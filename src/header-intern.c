@@ -0,0 +1,98 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file header-intern.c
+ *  @brief string intern table add-on to header.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "header-intern.h"
+#include "header-concurrent.h"
+#include "source-intern.h"
+
+  /**
+   *  @fn void emit_intern_function_prototypes(FILE *outfile,
+   *                                           xmlNodePtr root,
+   *                                           char *project_name)
+   *
+   *  @brief emits string intern table function prototypes to @p outfile,
+   *         noting whether they are thread-safe
+   *
+   *  NOTE:  nothing is emitted if no field of declarations in @p root is
+   *         interned
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param root - xmlNodePtr containing c-decls element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_intern_function_prototypes(FILE *outfile,
+                                     xmlNodePtr root,
+                                     char *project_name)
+{
+  char *project = NULL;
+  char *fpre = NULL;
+
+  if (!outfile || !root || !project_name) goto exit;
+
+  if (!intern_needed(root)) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+
+  str_lower(project);
+
+  fpre = function_prefix(project, "intern");
+  if (!fpre) goto exit;
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " *  String intern table functions\n");
+
+  emit_indent(outfile, 1);
+  if (concurrent_any())
+    fprintf(outfile, " *  Safe from any thread, one mutex guards the table\n");
+  else
+    fprintf(outfile, " *  Not thread-safe, call from a single thread only\n");
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "char *%s(const char *s);\n", fpre);
+  fprintf(outfile, "void %s_release(char *s);\n", fpre);
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (project) free(project);
+  if (fpre) free(fpre);
+}
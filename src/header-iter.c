@@ -0,0 +1,497 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file header-iter.c
+ *  @brief caller owned container iterator add-on to header.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "header-iter.h"
+#include "source-concurrent.h"
+#include "source-iter.h"
+#include "options.h"
+
+static void emit_iter_inline_array_functions(FILE *outfile,
+                                             char *container_name,
+                                             char *fpre);
+static void emit_iter_inline_next_function(FILE *outfile,
+                                           char *name,
+                                           char *container_name,
+                                           char *fpre);
+static void emit_aggregate_iter_annotation(FILE *outfile,
+                                           char *container_name,
+                                           char *iter_name,
+                                           char *kind,
+                                           int indent);
+
+  /**
+   *  @fn bool emit_aggregate_iter(FILE *outfile,
+   *                               xmlNodePtr node,
+   *                               char *kind,
+   *                               int indent)
+   *
+   *  @brief emits iterator struct of container @p kind for struct or union
+   *         from @p node to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param kind - string containing "array", "list" or "avl"
+   *  @param indent - indent level for output
+   *
+   *  @return true if iterator struct emitted, false otherwise
+   */
+
+bool emit_aggregate_iter(FILE *outfile,
+                         xmlNodePtr node,
+                         char *kind,
+                         int indent)
+{
+  char *name = NULL;
+  char *container_name = NULL;
+  char *iter_name = NULL;
+  char *field = NULL;
+  int len;
+  int is_doxygen = 0;
+  bool concurrent;
+  bool did_it = false;
+
+  if (!outfile || !node || !kind) goto exit;
+
+  if (!iter_container(kind)) goto exit;
+
+  concurrent = concurrent_container(kind);
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen: is_doxygen = 1; break;
+    default: is_doxygen = 0; break;
+  }
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  container_name = strapp(container_name, name);
+  container_name = strapp(container_name, "_");
+  container_name = strapp(container_name, kind);
+
+  iter_name = strapp(iter_name, container_name);
+  iter_name = strapp(iter_name, "_iter");
+  if (!iter_name) goto exit;
+
+  emit_aggregate_iter_annotation(outfile,
+                                 container_name,
+                                 iter_name,
+                                 kind,
+                                 indent + 1);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "struct %s\n", iter_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  len = strlen(container_name) + 13;
+  if (len < 16) len = 16;
+
+  field = strapp(field, container_name);
+  field = strapp(field, " *container;");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  %s  */\n",
+          len,
+          len,
+          field,
+          is_doxygen ? "*<" : "",
+          concurrent ? "read locked container" : "container walked     ");
+
+  free(field);
+  field = NULL;
+
+  field = strapp(field, name);
+  field = strapp(field, " **item;");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  items to visit         */\n",
+          len,
+          len,
+          field,
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  number of items        */\n",
+          len,
+          len,
+          "size_t n;",
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  index of next item     */\n",
+          len,
+          len,
+          "size_t i;",
+          is_doxygen ? "*<" : "");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}");
+
+  did_it = true;
+
+exit:
+  if (name) free(name);
+  if (container_name) free(container_name);
+  if (iter_name) free(iter_name);
+  if (field) free(field);
+
+  return did_it;
+}
+
+  /**
+   *  @fn void emit_aggregate_iter_function_prototypes(FILE *outfile,
+   *                                                   xmlNodePtr node,
+   *                                                   char *project_name)
+   *
+   *  @brief emits iterator function prototypes of every container for struct
+   *         or union in @p node to @p outfile
+   *
+   *  NOTE:  _iter_next() is defined here as static inline, and so are
+   *         _iter_begin() and _iter_end() of an array that is not concurrent
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_iter_function_prototypes(FILE *outfile,
+                                             xmlNodePtr node,
+                                             char *project_name)
+{
+  static char *kinds[] = { "array", "list", "avl", NULL };
+  char *name = NULL;
+  char *project = NULL;
+  char *container_name = NULL;
+  char *fpre = NULL;
+  int i;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+
+  str_lower(project);
+
+  for (i = 0; kinds[i]; i++)
+  {
+    if (!iter_container(kinds[i])) continue;
+
+    container_name = strapp(container_name, name);
+    container_name = strapp(container_name, "_");
+    container_name = strapp(container_name, kinds[i]);
+
+    fpre = container_prefix(project, name, kinds[i]);
+
+    emit_indent(outfile, 1);
+    fprintf(outfile, "/*\n");
+
+    emit_indent(outfile, 1);
+    fprintf(outfile,
+            " *  Iterator functions for struct %s_iter\n",
+            container_name);
+
+    emit_indent(outfile, 1);
+    fprintf(outfile, " */\n");
+
+    fprintf(outfile, "\n");
+
+    if (!strcmp(kinds[i], "array") && !concurrent_container(kinds[i]))
+      emit_iter_inline_array_functions(outfile, container_name, fpre);
+    else
+    {
+      fprintf(outfile,
+              "bool %s_iter_begin(%s *instance,%s %s_iter *iter);\n",
+              fpre,
+              container_name,
+              strcmp(kinds[i], "avl") ? "" : " avl_order order,",
+              container_name);
+      fprintf(outfile,
+              "void %s_iter_end(%s_iter *iter);\n",
+              fpre,
+              container_name);
+
+      fprintf(outfile, "\n");
+    }
+
+    emit_iter_inline_next_function(outfile, name, container_name, fpre);
+
+    free(container_name);
+    free(fpre);
+    container_name = fpre = NULL;
+  }
+
+exit:
+  if (name) free(name);
+  if (project) free(project);
+}
+
+  /**
+   *  @fn void emit_iter_inline_array_functions(FILE *outfile,
+   *                                            char *container_name,
+   *                                            char *fpre)
+   *
+   *  @brief emits static inline _iter_begin() and _iter_end() of an array
+   *         that is not concurrent
+   *
+   *  NOTE:  the iterator walks the item array in place, so neither function
+   *         allocates
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param container_name - string containing typedef name of container
+   *  @param fpre - string containing function prefix of container
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_iter_inline_array_functions(FILE *outfile,
+                                             char *container_name,
+                                             char *fpre)
+{
+  int indent = 0;
+
+  fprintf(outfile,
+          "static inline bool %s_iter_begin(%s *instance, %s_iter *iter)\n",
+          fpre,
+          container_name,
+          container_name);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !iter) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "iter->container = instance;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "iter->item = instance->item;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "iter->n = instance->n;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "iter->i = 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return true;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline void %s_iter_end(%s_iter *iter)\n",
+          fpre,
+          container_name);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!iter) return;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "iter->container = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "iter->item = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "iter->n = iter->i = 0;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+}
+
+  /**
+   *  @fn void emit_iter_inline_next_function(FILE *outfile,
+   *                                          char *name,
+   *                                          char *container_name,
+   *                                          char *fpre)
+   *
+   *  @brief emits static inline _iter_next() of a container
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param name - string containing name of struct or union
+   *  @param container_name - string containing typedef name of container
+   *  @param fpre - string containing function prefix of container
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_iter_inline_next_function(FILE *outfile,
+                                           char *name,
+                                           char *container_name,
+                                           char *fpre)
+{
+  int indent = 0;
+
+  fprintf(outfile,
+          "static inline %s *%s_iter_next(%s_iter *iter)\n",
+          name,
+          fpre,
+          container_name);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!iter || iter->i >= iter->n) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return iter->item[iter->i++];\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+}
+
+  /**
+   *  @fn void emit_aggregate_iter_annotation(FILE *outfile,
+   *                                          char *container_name,
+   *                                          char *iter_name,
+   *                                          char *kind,
+   *                                          int indent)
+   *
+   *  @brief emits annotation for an iterator of a container
+   *
+   *  NOTE:  a plain list has no lock, and _iter_begin() snapshots it through
+   *         the shared list cursor, so the annotation warns that iterators
+   *         over one plain list must not begin on two threads at once
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param container_name - string containing typedef name of container
+   *  @param iter_name - string containing typedef name of iterator
+   *  @param kind - string containing "array", "list" or "avl"
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_iter_annotation(FILE *outfile,
+                                           char *container_name,
+                                           char *iter_name,
+                                           char *kind,
+                                           int indent)
+{
+  char *note = "";
+
+  if (!outfile || !container_name || !iter_name || !kind) goto exit;
+
+  if (concurrent_container(kind))
+    note = ", holds its read lock until _iter_end()";
+  else if (!strcmp(kind, "list"))
+    note = ", _iter_begin() is not thread-safe";
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/**\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @struct %s\n", iter_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  @brief caller owned iterator over a @a %s%s\n",
+              container_name,
+              note);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    case annotation_type_text:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/*\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  caller owned iterator over a %s%s\n",
+              container_name,
+              note);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    default: break;
+  }
+
+exit:
+}
@@ -29,6 +29,8 @@
 #include "config.h"
 
 #include "header-list.h"
+#include "header-concurrent.h"
+#include "source-concurrent.h"
 #include "options.h"
 
 static void emit_aggregate_list_node_annotation(FILE *outfile,
@@ -95,6 +97,7 @@ bool emit_aggregate_list(FILE *outfile, xmlNodePtr node, int indent)
 
   len = strlen(name) + 10;
   if (len < 16) len = 16;
+  if (concurrent_container("list") && len < 24) len = 24;
 
   emit_indent(outfile, indent);
   fprintf(outfile,
@@ -104,6 +107,8 @@ bool emit_aggregate_list(FILE *outfile, xmlNodePtr node, int indent)
           "llist *_llist;",
           is_doxygen ? "*<" : "");
 
+  emit_concurrent_fields(outfile, "list", len, indent);
+
   --indent;
 
   emit_indent(outfile, indent);
@@ -165,7 +170,7 @@ bool emit_aggregate_list_node(FILE *outfile, xmlNodePtr node, int indent)
   len = strlen(node_name) + 11;
   if (len < 22) len = 22;
 
-  field = malloc(len);
+  field = malloc(len + 1);
   if (!field) goto exit;
 
   emit_aggregate_list_node_annotation(outfile,
@@ -0,0 +1,295 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file header-mmap.c
+ *  @brief mapped array file add-on to header.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "header-mmap.h"
+#include "options.h"
+
+static void emit_aggregate_array_map_annotation(FILE *outfile,
+                                                xmlNodePtr node,
+                                                char *aggregate_name,
+                                                char *map_name,
+                                                int indent);
+
+  /**
+   *  @fn bool emit_aggregate_array_map(FILE *outfile,
+   *                                    xmlNodePtr node,
+   *                                    int indent)
+   *
+   *  @brief emits mapped array file struct for struct or union from @p node
+   *         to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @return true if aggregate_array_map emitted, false otherwise
+   */
+
+bool emit_aggregate_array_map(FILE *outfile, xmlNodePtr node, int indent)
+{
+  char *name = NULL;
+  char *map_name = NULL;
+  bool did_it = false;
+  int len = 28;
+  int is_doxygen = 0;
+
+  if (!option_gen_mmap()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen: is_doxygen = 1; break;
+    default: is_doxygen = 0; break;
+  }
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  map_name = strapp(map_name, name);
+  map_name = strapp(map_name, "_array_map");
+  if (!map_name) goto exit;
+
+  emit_aggregate_array_map_annotation(outfile,
+                                      node,
+                                      name,
+                                      map_name,
+                                      indent + 1);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "struct %s\n", map_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  start of mapped file             */\n",
+          len,
+          len,
+          "const unsigned char *base;",
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  size of mapped file in bytes     */\n",
+          len,
+          len,
+          "size_t size;",
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  number of items in mapped file   */\n",
+          len,
+          len,
+          "size_t n;",
+          is_doxygen ? "*<" : "");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}");
+
+  did_it = true;
+
+exit:
+  if (name) free(name);
+  if (map_name) free(map_name);
+
+  return did_it;
+}
+
+  /**
+   *  @fn void emit_aggregate_mmap_function_prototypes(FILE *outfile,
+   *                                                   xmlNodePtr node,
+   *                                                   char *project_name)
+   *
+   *  @brief emits mapped array file function prototypes for struct or union
+   *         in @p node to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_mmap_function_prototypes(FILE *outfile,
+                                             xmlNodePtr node,
+                                             char *project_name)
+{
+  char *name = NULL;
+  char *project = NULL;
+  char *array_name = NULL;
+  char *map_name = NULL;
+  char *fpre = NULL;
+
+  if (!option_gen_mmap()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+
+  str_lower(project);
+
+  array_name = strdup(name);
+  array_name = strapp(array_name, "_array");
+
+  map_name = strdup(array_name);
+  map_name = strapp(map_name, "_map");
+
+  fpre = container_prefix(project, name, "array");
+  if (!fpre || !map_name) goto exit;
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " *  Mapped file functions for struct %s\n", array_name);
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "bool %s_save(%s *instance, char *path);\n",
+          fpre,
+          array_name);
+  fprintf(outfile,
+          "%s *%s_open_mmap(char *path);\n",
+          map_name,
+          fpre);
+  fprintf(outfile,
+          "void %s_close_mmap(%s *map);\n",
+          fpre,
+          map_name);
+  fprintf(outfile,
+          "const unsigned char *%s_map_get(%s *map, size_t index);\n",
+          fpre,
+          map_name);
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (project) free(project);
+  if (array_name) free(array_name);
+  if (map_name) free(map_name);
+  if (fpre) free(fpre);
+}
+
+  /**
+   *  @fn void emit_aggregate_array_map_annotation(FILE *outfile,
+   *                                               xmlNodePtr node,
+   *                                               char *aggregate_name,
+   *                                               char *map_name,
+   *                                               int indent)
+   *
+   *  @brief emits annotation for a mapped file of structs or unions
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param aggregate_name - string containing typedef name of base aggregate
+   *  @param map_name - string containing typedef of mapped file
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_array_map_annotation(FILE *outfile,
+                                                xmlNodePtr node,
+                                                char *aggregate_name,
+                                                char *map_name,
+                                                int indent)
+{
+  if (!outfile || !node || !aggregate_name || !map_name) goto exit;
+
+  if (!option_annotation()) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/**\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @struct %s\n", map_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  @brief read-only file of flat @a %s %ss, mapped in place\n",
+              aggregate_name,
+              node->name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    case annotation_type_text:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/*\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  read-only file of flat @a %s %ss, mapped in place\n",
+              aggregate_name,
+              node->name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    default: break;
+  }
+
+exit:
+}
@@ -0,0 +1,289 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file header-parallel.c
+ *  @brief parallel container walk add-on to header.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "header-parallel.h"
+#include "source-iter.h"
+#include "source-parallel.h"
+#include "options.h"
+
+static void emit_aggregate_parallel_typedef_annotation(FILE *outfile,
+                                                       char *type_name,
+                                                       char *brief,
+                                                       char *more,
+                                                       int indent);
+
+  /**
+   *  @fn void emit_aggregate_parallel_typedefs(FILE *outfile,
+   *                                            xmlNodePtr node,
+   *                                            int indent)
+   *
+   *  @brief emits typedefs of the item and reduce functions taken by the
+   *         parallel walks of containers of struct or union in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_parallel_typedefs(FILE *outfile,
+                                      xmlNodePtr node,
+                                      int indent)
+{
+  char *name = NULL;
+  char *type_name = NULL;
+
+  if (!parallel_any()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  type_name = strapp(type_name, name);
+  type_name = strapp(type_name, "_parallel_fn");
+  if (!type_name) goto exit;
+
+  emit_aggregate_parallel_typedef_annotation(outfile,
+                                             type_name,
+                                             "creates type for function "
+                                             "applied to each item by a "
+                                             "parallel walk,",
+                                             "local is the zeroed scratch "
+                                             "area of the calling thread",
+                                             indent + 1);
+
+  fprintf(outfile,
+          "typedef void (*%s)(%s *item, void *ctx, void *local);\n",
+          type_name,
+          name);
+
+  fprintf(outfile, "\n");
+
+  free(type_name);
+  type_name = NULL;
+
+  type_name = strapp(type_name, name);
+  type_name = strapp(type_name, "_parallel_reduce");
+  if (!type_name) goto exit;
+
+  emit_aggregate_parallel_typedef_annotation(outfile,
+                                             type_name,
+                                             "creates type for function "
+                                             "folding the scratch area of "
+                                             "one thread",
+                                             "into ctx, called once per "
+                                             "thread after all have finished",
+                                             indent + 1);
+
+  fprintf(outfile,
+          "typedef void (*%s)(void *ctx, void *local);\n",
+          type_name);
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (type_name) free(type_name);
+}
+
+  /**
+   *  @fn void emit_aggregate_parallel_function_prototypes(FILE *outfile,
+   *                                                       xmlNodePtr node,
+   *                                                       char *project_name)
+   *
+   *  @brief emits parallel walk function prototypes of every container for
+   *         struct or union in @p node to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_parallel_function_prototypes(FILE *outfile,
+                                                 xmlNodePtr node,
+                                                 char *project_name)
+{
+  static char *kinds[] = { "array", "list", "avl", NULL };
+  char *name = NULL;
+  char *project = NULL;
+  char *container_name = NULL;
+  char *fpre = NULL;
+  char *order = NULL;
+  int i;
+
+  if (!parallel_any()) goto exit;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+
+  str_lower(project);
+
+  for (i = 0; kinds[i]; i++)
+  {
+    if (!iter_container(kinds[i])) continue;
+
+    container_name = strapp(container_name, name);
+    container_name = strapp(container_name, "_");
+    container_name = strapp(container_name, kinds[i]);
+
+    fpre = container_prefix(project, name, kinds[i]);
+
+    order = strcmp(kinds[i], "avl") ? "" : " avl_order order,";
+
+    emit_indent(outfile, 1);
+    fprintf(outfile, "/*\n");
+
+    emit_indent(outfile, 1);
+    fprintf(outfile,
+            " *  Parallel walk functions for struct %s\n",
+            container_name);
+
+    emit_indent(outfile, 1);
+    fprintf(outfile, " */\n");
+
+    fprintf(outfile, "\n");
+
+    fprintf(outfile,
+            "bool %s_parallel_for_each(%s *instance,%s %s_parallel_fn fn, "
+            "void *ctx, int nthreads);\n",
+            fpre,
+            container_name,
+            order,
+            name);
+    fprintf(outfile,
+            "bool %s_parallel_reduce(%s *instance,%s %s_parallel_fn fn, "
+            "%s_parallel_reduce reduce, void *ctx, int nthreads, "
+            "size_t local_size);\n",
+            fpre,
+            container_name,
+            order,
+            name,
+            name);
+
+    fprintf(outfile, "\n");
+
+    free(container_name);
+    free(fpre);
+    container_name = fpre = NULL;
+  }
+
+exit:
+  if (name) free(name);
+  if (project) free(project);
+}
+
+  /**
+   *  @fn void emit_aggregate_parallel_typedef_annotation(FILE *outfile,
+   *                                                      char *type_name,
+   *                                                      char *brief,
+   *                                                      char *more,
+   *                                                      int indent)
+   *
+   *  @brief emits annotation for a typedef of a parallel walk function
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param type_name - string containing name of typedef
+   *  @param brief - string containing first line of description
+   *  @param more - string containing second line of description
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_parallel_typedef_annotation(FILE *outfile,
+                                                       char *type_name,
+                                                       char *brief,
+                                                       char *more,
+                                                       int indent)
+{
+  if (!outfile || !type_name || !brief || !more) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/**\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @typedef %s\n", type_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @brief %s\n", brief);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *         %s\n", more);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    case annotation_type_text:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/*\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  %s\n", brief);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  %s\n", more);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    default: break;
+  }
+
+exit:
+}
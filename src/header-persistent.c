@@ -0,0 +1,633 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file header-persistent.c
+ *  @brief persistent avl add-on to header.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "header-persistent.h"
+#include "source-persistent.h"
+#include "options.h"
+
+  /**
+   *  @typedef struct persistent_field
+   *  @brief one field of a persistent avl struct
+   */
+
+typedef struct
+{
+  char *type;       /**<  C type, a leading "%s" is the struct name    */
+  char *name;       /**<  field name, with any '*'                     */
+  char *comment;    /**<  field comment                                */
+} persistent_field;
+
+static persistent_field _item_fields[] =
+{
+  { "%s", "*data;", "item, never changed once shared" },
+  { "_Atomic size_t", "refs;", "nodes holding item" },
+  { NULL, NULL, NULL }
+};
+
+static persistent_field _node_fields[] =
+{
+  { "%s_pavl_node", "*left;", "lesser items" },
+  { "%s_pavl_node", "*right;", "greater items" },
+  { "%s_pavl_item", "*item;", "item of node" },
+  { "_Atomic size_t", "refs;", "parents and snapshots holding node" },
+  { "int", "height;", "height of subtree" },
+  { NULL, NULL, NULL }
+};
+
+static persistent_field _snapshot_fields[] =
+{
+  { "%s_pavl_node", "*root;", "tree, never changed once published" },
+  { "size_t", "n;", "number of items in tree" },
+  { "_Atomic size_t", "refs;", "tree and readers holding snapshot" },
+  { NULL, NULL, NULL }
+};
+
+static persistent_field _pavl_fields[] =
+{
+  { "%s_pavl_snapshot", "*current;", "latest snapshot" },
+  { "pthread_mutex_t", "writer;", "serialises writers" },
+  { "pthread_mutex_t", "pin;", "guards taking current snapshot" },
+  { NULL, NULL, NULL }
+};
+
+static bool emit_aggregate_persistent_struct(FILE *outfile,
+                                             xmlNodePtr node,
+                                             char *suffix,
+                                             persistent_field *fields,
+                                             char *brief,
+                                             int indent);
+static void emit_aggregate_persistent_annotation(FILE *outfile,
+                                                 char *aggregate_name,
+                                                 char *type_name,
+                                                 char *brief,
+                                                 int indent);
+static void emit_aggregate_persistent_typedefs_annotation(FILE *outfile,
+                                                          char *pavl_name,
+                                                          int indent);
+
+  /**
+   *  @fn void emit_aggregate_persistent_typedefs(FILE *outfile,
+   *                                              xmlNodePtr node,
+   *                                              int indent)
+   *
+   *  @brief emits typedef of function called by _pavl_walk()
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_persistent_typedefs(FILE *outfile,
+                                        xmlNodePtr node,
+                                        int indent)
+{
+  char *name = NULL;
+  char *pavl_name = NULL;
+
+  if (!persistent_any()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  pavl_name = strapp(pavl_name, name);
+  pavl_name = strapp(pavl_name, "_pavl");
+  if (!pavl_name) goto exit;
+
+  emit_aggregate_persistent_typedefs_annotation(outfile, pavl_name, indent + 1);
+
+  fprintf(outfile,
+          "typedef int (*%s_action)(%s *item, void *arg);\n",
+          pavl_name,
+          name);
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (pavl_name) free(pavl_name);
+}
+
+  /**
+   *  @fn bool emit_aggregate_persistent_item(FILE *outfile,
+   *                                          xmlNodePtr node,
+   *                                          int indent)
+   *
+   *  @brief emits persistent avl item struct for struct or union from
+   *         @p node to @p outfile
+   *
+   *  NOTE:  path copying copies nodes, never items, so copies of a node
+   *         share its item and count it
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @return true if emitted, false otherwise
+   */
+
+bool emit_aggregate_persistent_item(FILE *outfile, xmlNodePtr node, int indent)
+{
+  return emit_aggregate_persistent_struct(outfile,
+                                          node,
+                                          "_pavl_item",
+                                          _item_fields,
+                                          "item shared by the nodes of a "
+                                          "persistent avl of",
+                                          indent);
+}
+
+  /**
+   *  @fn bool emit_aggregate_persistent_node(FILE *outfile,
+   *                                          xmlNodePtr node,
+   *                                          int indent)
+   *
+   *  @brief emits persistent avl node struct for struct or union from
+   *         @p node to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @return true if emitted, false otherwise
+   */
+
+bool emit_aggregate_persistent_node(FILE *outfile, xmlNodePtr node, int indent)
+{
+  return emit_aggregate_persistent_struct(outfile,
+                                          node,
+                                          "_pavl_node",
+                                          _node_fields,
+                                          "immutable node of a persistent "
+                                          "avl of",
+                                          indent);
+}
+
+  /**
+   *  @fn bool emit_aggregate_persistent_snapshot(FILE *outfile,
+   *                                              xmlNodePtr node,
+   *                                              int indent)
+   *
+   *  @brief emits persistent avl snapshot struct for struct or union from
+   *         @p node to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @return true if emitted, false otherwise
+   */
+
+bool emit_aggregate_persistent_snapshot(FILE *outfile,
+                                        xmlNodePtr node,
+                                        int indent)
+{
+  return emit_aggregate_persistent_struct(outfile,
+                                          node,
+                                          "_pavl_snapshot",
+                                          _snapshot_fields,
+                                          "read-only version of a "
+                                          "persistent avl of",
+                                          indent);
+}
+
+  /**
+   *  @fn bool emit_aggregate_persistent(FILE *outfile,
+   *                                     xmlNodePtr node,
+   *                                     int indent)
+   *
+   *  @brief emits persistent avl struct for struct or union from @p node to
+   *         @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @return true if emitted, false otherwise
+   */
+
+bool emit_aggregate_persistent(FILE *outfile, xmlNodePtr node, int indent)
+{
+  return emit_aggregate_persistent_struct(outfile,
+                                          node,
+                                          "_pavl",
+                                          _pavl_fields,
+                                          "copy-on-write avl, path copying "
+                                          "writers and snapshot readers, of",
+                                          indent);
+}
+
+  /**
+   *  @fn void emit_aggregate_persistent_function_prototypes(FILE *outfile,
+   *                                                         xmlNodePtr node,
+   *                                                         char *project_name)
+   *
+   *  @brief emits persistent avl function prototypes for struct or union in
+   *         @p node to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_persistent_function_prototypes(FILE *outfile,
+                                                   xmlNodePtr node,
+                                                   char *project_name)
+{
+  char *name = NULL;
+  char *project = NULL;
+  char *pavl_name = NULL;
+  char *fpre = NULL;
+
+  if (!persistent_any()) goto exit;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+
+  str_lower(project);
+
+  pavl_name = strdup(name);
+  pavl_name = strapp(pavl_name, "_pavl");
+
+  fpre = container_prefix(project, name, "pavl");
+  if (!pavl_name || !fpre) goto exit;
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " *  Persistent avl functions for struct %s\n", pavl_name);
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "%s *%s_new(void);\n", pavl_name, fpre);
+  fprintf(outfile, "void %s_free(%s *instance);\n", fpre, pavl_name);
+  fprintf(outfile,
+          "bool %s_insert(%s *instance, %s *item);\n",
+          fpre,
+          pavl_name,
+          name);
+  fprintf(outfile,
+          "bool %s_delete(%s *instance, %s *target);\n",
+          fpre,
+          pavl_name,
+          name);
+  fprintf(outfile,
+          "bool %s_insert_many(%s *instance, %s **items, size_t n);\n",
+          fpre,
+          pavl_name,
+          name);
+  fprintf(outfile,
+          "size_t %s_delete_many(%s *instance, %s **targets, size_t n);\n",
+          fpre,
+          pavl_name,
+          name);
+  fprintf(outfile,
+          "%s_snapshot *%s_acquire(%s *instance);\n",
+          pavl_name,
+          fpre,
+          pavl_name);
+  fprintf(outfile,
+          "void %s_release(%s_snapshot *snapshot);\n",
+          fpre,
+          pavl_name);
+  fprintf(outfile,
+          "size_t %s_count(%s_snapshot *snapshot);\n",
+          fpre,
+          pavl_name);
+  fprintf(outfile,
+          "%s *%s_find(%s_snapshot *snapshot, %s *needle);\n",
+          name,
+          fpre,
+          pavl_name,
+          name);
+  fprintf(outfile,
+          "size_t %s_walk(%s_snapshot *snapshot,\n",
+          fpre,
+          pavl_name);
+  fprintf(outfile,
+          "%*s%s_action action,\n",
+          (int)strlen(fpre) + 13,
+          "",
+          pavl_name);
+  fprintf(outfile, "%*svoid *arg);\n", (int)strlen(fpre) + 13, "");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (project) free(project);
+  if (pavl_name) free(pavl_name);
+  if (fpre) free(fpre);
+}
+
+  /**
+   *  @fn bool emit_aggregate_persistent_struct(FILE *outfile,
+   *                                            xmlNodePtr node,
+   *                                            char *suffix,
+   *                                            persistent_field *fields,
+   *                                            char *brief,
+   *                                            int indent)
+   *
+   *  @brief emits one persistent avl struct for struct or union from
+   *         @p node to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param suffix - string appended to struct or union name, ie. "_pavl"
+   *  @param fields - fields of struct, ending with a NULL type
+   *  @param brief - string describing struct
+   *  @param indent - indent level for output
+   *
+   *  @return true if emitted, false otherwise
+   */
+
+static bool emit_aggregate_persistent_struct(FILE *outfile,
+                                             xmlNodePtr node,
+                                             char *suffix,
+                                             persistent_field *fields,
+                                             char *brief,
+                                             int indent)
+{
+  persistent_field *field;
+  char *name = NULL;
+  char *type_name = NULL;
+  char *declaration = NULL;
+  int length;
+  int len = 0;
+  int width = 0;
+  int is_doxygen = 0;
+  bool did_it = false;
+
+  if (!persistent_any()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen: is_doxygen = 1; break;
+    default: is_doxygen = 0; break;
+  }
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  type_name = strapp(type_name, name);
+  type_name = strapp(type_name, suffix);
+  if (!type_name) goto exit;
+
+  for (field = fields; field->type; field++)
+  {
+    length = strlen(field->type) + strlen(field->name) + 2;
+    if (!strncmp(field->type, "%s", 2)) length += strlen(name) - 2;
+
+    if (length > len) len = length;
+    if ((int)strlen(field->comment) + 2 > width)
+      width = strlen(field->comment) + 2;
+  }
+
+  emit_aggregate_persistent_annotation(outfile,
+                                       name,
+                                       type_name,
+                                       brief,
+                                       indent + 1);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "struct %s\n", type_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  for (field = fields; field->type; field++)
+  {
+    if (!strncmp(field->type, "%s", 2))
+    {
+      declaration = strapp(declaration, name);
+      declaration = strapp(declaration, field->type + 2);
+    }
+    else
+      declaration = strapp(declaration, field->type);
+
+    declaration = strapp(declaration, " ");
+    declaration = strapp(declaration, field->name);
+    if (!declaration) goto exit;
+
+    emit_indent(outfile, indent);
+    fprintf(outfile,
+            "%-*.*s/*%s  %-*s*/\n",
+            len,
+            len,
+            declaration,
+            is_doxygen ? "*<" : "",
+            width,
+            field->comment);
+
+    free(declaration);
+    declaration = NULL;
+  }
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}");
+
+  did_it = true;
+
+exit:
+  if (name) free(name);
+  if (type_name) free(type_name);
+  if (declaration) free(declaration);
+
+  return did_it;
+}
+
+  /**
+   *  @fn void emit_aggregate_persistent_annotation(FILE *outfile,
+   *                                                char *aggregate_name,
+   *                                                char *type_name,
+   *                                                char *brief,
+   *                                                int indent)
+   *
+   *  @brief emits annotation for a persistent avl struct
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param aggregate_name - string containing typedef name of base aggregate
+   *  @param type_name - string containing typedef name of annotated struct
+   *  @param brief - string describing annotated struct
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_persistent_annotation(FILE *outfile,
+                                                 char *aggregate_name,
+                                                 char *type_name,
+                                                 char *brief,
+                                                 int indent)
+{
+  if (!outfile || !aggregate_name || !type_name || !brief) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/**\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @struct %s\n", type_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @brief %s @a %s items\n", brief, aggregate_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    case annotation_type_text:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/*\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  %s %s items\n", brief, aggregate_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    default: break;
+  }
+
+exit:
+}
+
+  /**
+   *  @fn void emit_aggregate_persistent_typedefs_annotation(FILE *outfile,
+   *                                                         char *pavl_name,
+   *                                                         int indent)
+   *
+   *  @brief emits annotation for typedef of function called by _pavl_walk()
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pavl_name - string containing typedef name of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_persistent_typedefs_annotation(FILE *outfile,
+                                                          char *pavl_name,
+                                                          int indent)
+{
+  if (!outfile || !pavl_name) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/**\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @typedef %s_action\n", pavl_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  @brief creates type for function called by "
+              "@a %s_walk() for each\n",
+              pavl_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *         item in order, a non-zero return stops the walk\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    case annotation_type_text:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/*\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  creates type for function called by %s_walk() for each\n",
+              pavl_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  item in order, a non-zero return stops the walk\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    default: break;
+  }
+
+exit:
+}
@@ -0,0 +1,428 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file header-ring.c
+ *  @brief lock-free ring queue add-on to header.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "header-ring.h"
+#include "layout.h"
+#include "options.h"
+
+static void emit_aggregate_ring_annotation(FILE *outfile,
+                                           xmlNodePtr node,
+                                           char *aggregate_name,
+                                           char *type_name,
+                                           char *brief,
+                                           int indent);
+
+  /**
+   *  @fn bool emit_aggregate_ring_cell(FILE *outfile,
+   *                                    xmlNodePtr node,
+   *                                    int indent)
+   *
+   *  @brief emits ring queue cell struct for struct or union from @p node to
+   *         @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @return true if emitted, false otherwise
+   */
+
+bool emit_aggregate_ring_cell(FILE *outfile, xmlNodePtr node, int indent)
+{
+  char *name = NULL;
+  char *cell_name = NULL;
+  char *field = NULL;
+  int len;
+  int is_doxygen = 0;
+  bool did_it = false;
+
+  if (!option_gen_ring()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen: is_doxygen = 1; break;
+    default: is_doxygen = 0; break;
+  }
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  cell_name = strapp(cell_name, name);
+  cell_name = strapp(cell_name, "_ring_cell");
+  if (!cell_name) goto exit;
+
+  emit_aggregate_ring_annotation(outfile,
+                                 node,
+                                 name,
+                                 cell_name,
+                                 "one slot of a ring queue of",
+                                 indent + 1);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "struct %s\n", cell_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  len = strlen(name) + 8;
+  if (len < 26) len = 26;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  position slot is ready for  */\n",
+          len,
+          len,
+          "_Atomic size_t sequence;",
+          is_doxygen ? "*<" : "");
+
+  field = strapp(field, name);
+  field = strapp(field, " *item;");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  queued item                 */\n",
+          len,
+          len,
+          field,
+          is_doxygen ? "*<" : "");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}");
+
+  did_it = true;
+
+exit:
+  if (name) free(name);
+  if (cell_name) free(cell_name);
+  if (field) free(field);
+
+  return did_it;
+}
+
+  /**
+   *  @fn bool emit_aggregate_ring(FILE *outfile, xmlNodePtr node, int indent)
+   *
+   *  @brief emits ring queue struct for struct or union from @p node to
+   *         @p outfile
+   *
+   *  NOTE:  push and pop positions each get a cache line of their own, so
+   *         producers and consumers do not contend for one line
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @return true if emitted, false otherwise
+   */
+
+bool emit_aggregate_ring(FILE *outfile, xmlNodePtr node, int indent)
+{
+  char *name = NULL;
+  char *ring_name = NULL;
+  char *field = NULL;
+  char position[64];
+  int len;
+  int is_doxygen = 0;
+  bool did_it = false;
+
+  if (!option_gen_ring()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen: is_doxygen = 1; break;
+    default: is_doxygen = 0; break;
+  }
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  ring_name = strapp(ring_name, name);
+  ring_name = strapp(ring_name, "_ring");
+  if (!ring_name) goto exit;
+
+  emit_aggregate_ring_annotation(outfile,
+                                 node,
+                                 name,
+                                 ring_name,
+                                 "bounded lock-free multi-producer, "
+                                 "multi-consumer queue of",
+                                 indent + 1);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "struct %s\n", ring_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  snprintf(position,
+           sizeof(position),
+           "_Atomic size_t push_pos __attribute__((aligned(%d)));",
+           LAYOUT_CACHE_LINE);
+
+  len = strlen(position) + 1;
+
+  field = strapp(field, ring_name);
+  field = strapp(field, "_cell *cell;");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  capacity slots          */\n",
+          len,
+          len,
+          field,
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  capacity - 1            */\n",
+          len,
+          len,
+          "size_t mask;",
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  next position to push   */\n",
+          len,
+          len,
+          position,
+          is_doxygen ? "*<" : "");
+
+  snprintf(position,
+           sizeof(position),
+           "_Atomic size_t pop_pos __attribute__((aligned(%d)));",
+           LAYOUT_CACHE_LINE);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  next position to pop    */\n",
+          len,
+          len,
+          position,
+          is_doxygen ? "*<" : "");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}");
+
+  did_it = true;
+
+exit:
+  if (name) free(name);
+  if (ring_name) free(ring_name);
+  if (field) free(field);
+
+  return did_it;
+}
+
+  /**
+   *  @fn void emit_aggregate_ring_function_prototypes(FILE *outfile,
+   *                                                   xmlNodePtr node,
+   *                                                   char *project_name)
+   *
+   *  @brief emits ring queue function prototypes for struct or union in
+   *         @p node to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_ring_function_prototypes(FILE *outfile,
+                                             xmlNodePtr node,
+                                             char *project_name)
+{
+  char *name = NULL;
+  char *project = NULL;
+  char *ring_name = NULL;
+  char *fpre = NULL;
+
+  if (!option_gen_ring()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+
+  str_lower(project);
+
+  ring_name = strdup(name);
+  ring_name = strapp(ring_name, "_ring");
+
+  fpre = container_prefix(project, name, "ring");
+  if (!fpre) goto exit;
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " *  Ring queue functions for struct %s\n", ring_name);
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "%s *%s_new(size_t capacity);\n", ring_name, fpre);
+  fprintf(outfile, "void %s_free(%s *instance);\n", fpre, ring_name);
+  fprintf(outfile,
+          "bool %s_try_push(%s *instance, %s *item);\n",
+          fpre,
+          ring_name,
+          name);
+  fprintf(outfile,
+          "%s *%s_try_pop(%s *instance);\n",
+          name,
+          fpre,
+          ring_name);
+  fprintf(outfile,
+          "size_t %s_push_batch(%s *instance, %s **items, size_t n);\n",
+          fpre,
+          ring_name,
+          name);
+  fprintf(outfile,
+          "size_t %s_pop_batch(%s *instance, %s **items, size_t n);\n",
+          fpre,
+          ring_name,
+          name);
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (project) free(project);
+  if (ring_name) free(ring_name);
+  if (fpre) free(fpre);
+}
+
+  /**
+   *  @fn void emit_aggregate_ring_annotation(FILE *outfile,
+   *                                          xmlNodePtr node,
+   *                                          char *aggregate_name,
+   *                                          char *type_name,
+   *                                          char *brief,
+   *                                          int indent)
+   *
+   *  @brief emits annotation for a ring queue, or a cell of one
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param aggregate_name - string containing typedef name of base aggregate
+   *  @param type_name - string containing typedef name of annotated struct
+   *  @param brief - string describing annotated struct
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_ring_annotation(FILE *outfile,
+                                           xmlNodePtr node,
+                                           char *aggregate_name,
+                                           char *type_name,
+                                           char *brief,
+                                           int indent)
+{
+  if (!outfile || !node || !aggregate_name || !type_name || !brief)
+    goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/**\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @struct %s\n", type_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  @brief %s @a %s %s pointers\n",
+              brief,
+              aggregate_name,
+              node->name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    case annotation_type_text:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/*\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  %s %s %s pointers\n",
+              brief,
+              aggregate_name,
+              node->name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    default: break;
+  }
+
+exit:
+}
@@ -0,0 +1,659 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file header-shardmap.c
+ *  @brief sharded concurrent map add-on to header.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "header-shardmap.h"
+#include "source-shardmap.h"
+#include "layout.h"
+#include "options.h"
+
+static void emit_aggregate_shardmap_annotation(FILE *outfile,
+                                               char *aggregate_name,
+                                               char *type_name,
+                                               char *brief,
+                                               int indent);
+static void emit_aggregate_shardmap_typedefs_annotation(FILE *outfile,
+                                                        char *map_name,
+                                                        int indent);
+
+  /**
+   *  @fn void emit_aggregate_shardmap_typedefs(FILE *outfile,
+   *                                            xmlNodePtr node,
+   *                                            int indent)
+   *
+   *  @brief emits typedef for sharded map update functions
+   *
+   *  NOTE:  nothing is emitted for a struct or union without the key field
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_shardmap_typedefs(FILE *outfile,
+                                      xmlNodePtr node,
+                                      int indent)
+{
+  char *name = NULL;
+  char *map_name = NULL;
+
+  if (!option_gen_shardmap()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  if (!shardmap_key(node, NULL)) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  map_name = strapp(map_name, name);
+  map_name = strapp(map_name, "_shardmap");
+  if (!map_name) goto exit;
+
+  emit_aggregate_shardmap_typedefs_annotation(outfile, map_name, indent + 1);
+
+  fprintf(outfile,
+          "typedef void (*%s_update_action)(%s *item, bool inserted, "
+          "void *ctx);\n",
+          map_name,
+          name);
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (map_name) free(map_name);
+}
+
+  /**
+   *  @fn bool emit_aggregate_shardmap_shard(FILE *outfile,
+   *                                         xmlNodePtr node,
+   *                                         int indent)
+   *
+   *  @brief emits sharded map shard struct for struct or union from @p node
+   *         to @p outfile
+   *
+   *  NOTE:  shards are aligned to a cache line, so locking one does not
+   *         disturb its neighbours
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @return true if emitted, false otherwise
+   */
+
+bool emit_aggregate_shardmap_shard(FILE *outfile, xmlNodePtr node, int indent)
+{
+  char *name = NULL;
+  char *shard_name = NULL;
+  char *field = NULL;
+  int len;
+  int is_doxygen = 0;
+  bool did_it = false;
+
+  if (!option_gen_shardmap()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  if (!shardmap_key(node, NULL)) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen: is_doxygen = 1; break;
+    default: is_doxygen = 0; break;
+  }
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  shard_name = strapp(shard_name, name);
+  shard_name = strapp(shard_name, "_shardmap_shard");
+  if (!shard_name) goto exit;
+
+  emit_aggregate_shardmap_annotation(outfile,
+                                     name,
+                                     shard_name,
+                                     "independently locked part of a "
+                                     "sharded map of",
+                                     indent + 1);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "struct %s\n", shard_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  len = strlen(name) + 9;
+  if (len < 24) len = 24;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  guards shard                     */\n",
+          len,
+          len,
+          "pthread_mutex_t lock;",
+          is_doxygen ? "*<" : "");
+
+  field = strapp(field, name);
+  field = strapp(field, " **slot;");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  open-addressed table, NULL empty  */\n",
+          len,
+          len,
+          field,
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  number of slots - 1              */\n",
+          len,
+          len,
+          "size_t mask;",
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  number of items in table         */\n",
+          len,
+          len,
+          "size_t n;",
+          is_doxygen ? "*<" : "");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "} __attribute__((aligned(%d)))", LAYOUT_CACHE_LINE);
+
+  did_it = true;
+
+exit:
+  if (name) free(name);
+  if (shard_name) free(shard_name);
+  if (field) free(field);
+
+  return did_it;
+}
+
+  /**
+   *  @fn bool emit_aggregate_shardmap(FILE *outfile,
+   *                                   xmlNodePtr node,
+   *                                   int indent)
+   *
+   *  @brief emits sharded map struct for struct or union from @p node to
+   *         @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @return true if emitted, false otherwise
+   */
+
+bool emit_aggregate_shardmap(FILE *outfile, xmlNodePtr node, int indent)
+{
+  char *name = NULL;
+  char *map_name = NULL;
+  char *field = NULL;
+  int len;
+  int is_doxygen = 0;
+  bool did_it = false;
+
+  if (!option_gen_shardmap()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  if (!shardmap_key(node, NULL)) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen: is_doxygen = 1; break;
+    default: is_doxygen = 0; break;
+  }
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  map_name = strapp(map_name, name);
+  map_name = strapp(map_name, "_shardmap");
+  if (!map_name) goto exit;
+
+  emit_aggregate_shardmap_annotation(outfile,
+                                     name,
+                                     map_name,
+                                     "concurrent hash map, keyed by field "
+                                     "of",
+                                     indent + 1);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "struct %s\n", map_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  len = strlen(map_name) + 15;
+
+  field = strapp(field, map_name);
+  field = strapp(field, "_shard *shard;");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  shards, a power of two of them  */\n",
+          len,
+          len,
+          field,
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  number of shards - 1            */\n",
+          len,
+          len,
+          "size_t mask;",
+          is_doxygen ? "*<" : "");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}");
+
+  did_it = true;
+
+exit:
+  if (name) free(name);
+  if (map_name) free(map_name);
+  if (field) free(field);
+
+  return did_it;
+}
+
+  /**
+   *  @fn bool emit_aggregate_shardmap_iter(FILE *outfile,
+   *                                        xmlNodePtr node,
+   *                                        int indent)
+   *
+   *  @brief emits sharded map snapshot iterator struct for struct or union
+   *         from @p node to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @return true if emitted, false otherwise
+   */
+
+bool emit_aggregate_shardmap_iter(FILE *outfile, xmlNodePtr node, int indent)
+{
+  char *name = NULL;
+  char *iter_name = NULL;
+  char *field = NULL;
+  int len;
+  int is_doxygen = 0;
+  bool did_it = false;
+
+  if (!option_gen_shardmap()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  if (!shardmap_key(node, NULL)) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen: is_doxygen = 1; break;
+    default: is_doxygen = 0; break;
+  }
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  iter_name = strapp(iter_name, name);
+  iter_name = strapp(iter_name, "_shardmap_iter");
+  if (!iter_name) goto exit;
+
+  emit_aggregate_shardmap_annotation(outfile,
+                                     name,
+                                     iter_name,
+                                     "caller owned snapshot, holding "
+                                     "copies of every item, of a sharded "
+                                     "map of",
+                                     indent + 1);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "struct %s\n", iter_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  len = strlen(name) + 9;
+  if (len < 16) len = 16;
+
+  field = strapp(field, name);
+  field = strapp(field, " **item;");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  copies of items     */\n",
+          len,
+          len,
+          field,
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  number of items     */\n",
+          len,
+          len,
+          "size_t n;",
+          is_doxygen ? "*<" : "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%-*.*s/*%s  index of next item  */\n",
+          len,
+          len,
+          "size_t i;",
+          is_doxygen ? "*<" : "");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}");
+
+  did_it = true;
+
+exit:
+  if (name) free(name);
+  if (iter_name) free(iter_name);
+  if (field) free(field);
+
+  return did_it;
+}
+
+  /**
+   *  @fn void emit_aggregate_shardmap_function_prototypes(FILE *outfile,
+   *                                                       xmlNodePtr node,
+   *                                                       char *project_name)
+   *
+   *  @brief emits sharded map function prototypes for struct or union in
+   *         @p node to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_shardmap_function_prototypes(FILE *outfile,
+                                                 xmlNodePtr node,
+                                                 char *project_name)
+{
+  char *name = NULL;
+  char *project = NULL;
+  char *map_name = NULL;
+  char *fpre = NULL;
+  char *param = NULL;
+
+  if (!option_gen_shardmap()) goto exit;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  param = shardmap_key_param(node);
+  if (!param) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+
+  str_lower(project);
+
+  map_name = strdup(name);
+  map_name = strapp(map_name, "_shardmap");
+
+  fpre = container_prefix(project, name, "shardmap");
+  if (!map_name || !fpre) goto exit;
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " *  Sharded map functions for struct %s\n", map_name);
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "%s *%s_new(size_t shards);\n", map_name, fpre);
+  fprintf(outfile, "void %s_free(%s *map);\n", fpre, map_name);
+  fprintf(outfile,
+          "%s *%s_get_or_insert(%s *map, %s, bool *inserted);\n",
+          name,
+          fpre,
+          map_name,
+          param);
+  fprintf(outfile,
+          "bool %s_update(%s *map,\n",
+          fpre,
+          map_name);
+  fprintf(outfile,
+          "%*s%s,\n",
+          (int)strlen(fpre) + 13,
+          "",
+          param);
+  fprintf(outfile,
+          "%*s%s_update_action update,\n",
+          (int)strlen(fpre) + 13,
+          "",
+          map_name);
+  fprintf(outfile,
+          "%*svoid *ctx);\n",
+          (int)strlen(fpre) + 13,
+          "");
+  fprintf(outfile,
+          "%s *%s_get_copy(%s *map, %s);\n",
+          name,
+          fpre,
+          map_name,
+          param);
+  fprintf(outfile, "size_t %s_count(%s *map);\n", fpre, map_name);
+  fprintf(outfile,
+          "bool %s_iter_begin(%s *map, %s_iter *iter);\n",
+          fpre,
+          map_name,
+          map_name);
+  fprintf(outfile,
+          "%s *%s_iter_next(%s_iter *iter);\n",
+          name,
+          fpre,
+          map_name);
+  fprintf(outfile,
+          "void %s_iter_end(%s_iter *iter);\n",
+          fpre,
+          map_name);
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (project) free(project);
+  if (map_name) free(map_name);
+  if (fpre) free(fpre);
+  if (param) free(param);
+}
+
+  /**
+   *  @fn void emit_aggregate_shardmap_annotation(FILE *outfile,
+   *                                              char *aggregate_name,
+   *                                              char *type_name,
+   *                                              char *brief,
+   *                                              int indent)
+   *
+   *  @brief emits annotation for a sharded map, or a part of one
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param aggregate_name - string containing typedef name of base aggregate
+   *  @param type_name - string containing typedef name of annotated struct
+   *  @param brief - string describing annotated struct
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_shardmap_annotation(FILE *outfile,
+                                               char *aggregate_name,
+                                               char *type_name,
+                                               char *brief,
+                                               int indent)
+{
+  if (!outfile || !aggregate_name || !type_name || !brief) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/**\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @struct %s\n", type_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @brief %s @a %s\n", brief, aggregate_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    case annotation_type_text:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/*\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  %s %s\n", brief, aggregate_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    default: break;
+  }
+
+exit:
+}
+
+  /**
+   *  @fn void emit_aggregate_shardmap_typedefs_annotation(FILE *outfile,
+   *                                                       char *map_name,
+   *                                                       int indent)
+   *
+   *  @brief emits annotation for typedef of sharded map update functions
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param map_name - string containing typedef name of sharded map
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_shardmap_typedefs_annotation(FILE *outfile,
+                                                        char *map_name,
+                                                        int indent)
+{
+  if (!outfile || !map_name) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/**\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @typedef %s_update_action\n", map_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  @brief creates type for function changing an item in "
+              "place, called by\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *         @a %s_update() with its shard locked\n",
+              map_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    case annotation_type_text:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/*\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  creates type for function changing an item in place, "
+              "called by\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  %s_update() with its shard locked\n",
+              map_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    default: break;
+  }
+
+exit:
+}
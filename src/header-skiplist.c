@@ -0,0 +1,628 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file header-skiplist.c
+ *  @brief concurrent skip list add-on to header.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "header-skiplist.h"
+#include "source-skiplist.h"
+#include "options.h"
+
+  /**
+   *  @typedef struct skiplist_field
+   *  @brief one field of a skip list struct
+   */
+
+typedef struct
+{
+  char *type;       /**<  C type, "%s" prefix is struct name, "%k" key  */
+  char *name;       /**<  field name, with any '*'                      */
+  char *comment;    /**<  field comment                                 */
+} skiplist_field;
+
+static skiplist_field _node_fields[] =
+{
+  { "%k", "key;", "copy of key of item" },
+  { "%s", "*item;", "indexed item" },
+  { "%s_skiplist_node", "*retired;", "next node awaiting _reclaim()" },
+  { "pthread_mutex_t", "lock;", "guards links out of node" },
+  { "_Atomic bool", "marked;", "erased, being unlinked" },
+  { "_Atomic bool", "linked;", "linked at every level" },
+  { "int", "height;", "number of levels" },
+  { "%s_skiplist_node", "*_Atomic next[];", "next node at each level" },
+  { NULL, NULL, NULL }
+};
+
+static skiplist_field _skiplist_fields[] =
+{
+  { "%s_skiplist_node", "*head;", "node before every key" },
+  { "%s_skiplist_node", "*_Atomic retired;", "nodes awaiting _reclaim()" },
+  { "_Atomic size_t", "n;", "number of items" },
+  { "_Atomic uint32_t", "seed;", "state of level generator" },
+  { NULL, NULL, NULL }
+};
+
+static bool emit_aggregate_skiplist_struct(FILE *outfile,
+                                           xmlNodePtr node,
+                                           char *suffix,
+                                           skiplist_field *fields,
+                                           char *brief,
+                                           int indent);
+static char *skiplist_field_type(skiplist_field *field,
+                                 char *name,
+                                 char *key_type);
+static void emit_aggregate_skiplist_annotation(FILE *outfile,
+                                               char *aggregate_name,
+                                               char *type_name,
+                                               char *brief,
+                                               int indent);
+static void emit_aggregate_skiplist_typedefs_annotation(FILE *outfile,
+                                                        char *skiplist_name,
+                                                        int indent);
+
+  /**
+   *  @fn void emit_aggregate_skiplist_typedefs(FILE *outfile,
+   *                                            xmlNodePtr node,
+   *                                            int indent)
+   *
+   *  @brief emits typedef of function called by _skiplist_walk() and
+   *         _skiplist_range()
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_skiplist_typedefs(FILE *outfile,
+                                      xmlNodePtr node,
+                                      int indent)
+{
+  char *name = NULL;
+  char *skiplist_name = NULL;
+
+  if (!option_gen_skiplist()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  if (!skiplist_key(node, NULL)) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  skiplist_name = strapp(skiplist_name, name);
+  skiplist_name = strapp(skiplist_name, "_skiplist");
+  if (!skiplist_name) goto exit;
+
+  emit_aggregate_skiplist_typedefs_annotation(outfile,
+                                              skiplist_name,
+                                              indent + 1);
+
+  fprintf(outfile,
+          "typedef int (*%s_action)(%s *item, void *arg);\n",
+          skiplist_name,
+          name);
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (skiplist_name) free(skiplist_name);
+}
+
+  /**
+   *  @fn bool emit_aggregate_skiplist_node(FILE *outfile,
+   *                                        xmlNodePtr node,
+   *                                        int indent)
+   *
+   *  @brief emits skip list node struct for struct or union from @p node to
+   *         @p outfile
+   *
+   *  NOTE:  nodes carry a copy of the key, so searches never touch the items
+   *         themselves
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @return true if emitted, false otherwise
+   */
+
+bool emit_aggregate_skiplist_node(FILE *outfile, xmlNodePtr node, int indent)
+{
+  return emit_aggregate_skiplist_struct(outfile,
+                                        node,
+                                        "_skiplist_node",
+                                        _node_fields,
+                                        "one node of a skip list of",
+                                        indent);
+}
+
+  /**
+   *  @fn bool emit_aggregate_skiplist(FILE *outfile,
+   *                                   xmlNodePtr node,
+   *                                   int indent)
+   *
+   *  @brief emits skip list struct for struct or union from @p node to
+   *         @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *
+   *  @return true if emitted, false otherwise
+   */
+
+bool emit_aggregate_skiplist(FILE *outfile, xmlNodePtr node, int indent)
+{
+  return emit_aggregate_skiplist_struct(outfile,
+                                        node,
+                                        "_skiplist",
+                                        _skiplist_fields,
+                                        "concurrent skip list, lock-free "
+                                        "readers, of",
+                                        indent);
+}
+
+  /**
+   *  @fn void emit_aggregate_skiplist_function_prototypes(FILE *outfile,
+   *                                                       xmlNodePtr node,
+   *                                                       char *project_name)
+   *
+   *  @brief emits skip list function prototypes for struct or union in
+   *         @p node to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_skiplist_function_prototypes(FILE *outfile,
+                                                 xmlNodePtr node,
+                                                 char *project_name)
+{
+  char *name = NULL;
+  char *project = NULL;
+  char *skiplist_name = NULL;
+  char *fpre = NULL;
+  char *key_type = NULL;
+  char *space;
+
+  if (!option_gen_skiplist()) goto exit;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  key_type = skiplist_key_type(node);
+  if (!key_type) goto exit;
+
+  space = key_type[strlen(key_type) - 1] == '*' ? "" : " ";
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+
+  str_lower(project);
+
+  skiplist_name = strdup(name);
+  skiplist_name = strapp(skiplist_name, "_skiplist");
+
+  fpre = container_prefix(project, name, "skiplist");
+  if (!skiplist_name || !fpre) goto exit;
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " *  Skip list functions for struct %s\n", skiplist_name);
+
+  emit_indent(outfile, 1);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "%s *%s_new(void);\n", skiplist_name, fpre);
+  fprintf(outfile, "void %s_free(%s *instance);\n", fpre, skiplist_name);
+  fprintf(outfile,
+          "bool %s_insert(%s *instance, %s *item);\n",
+          fpre,
+          skiplist_name,
+          name);
+  fprintf(outfile,
+          "%s *%s_erase(%s *instance, %s%skey);\n",
+          name,
+          fpre,
+          skiplist_name,
+          key_type,
+          space);
+  fprintf(outfile,
+          "%s *%s_find(%s *instance, %s%skey);\n",
+          name,
+          fpre,
+          skiplist_name,
+          key_type,
+          space);
+  fprintf(outfile,
+          "size_t %s_range(%s *instance,\n",
+          fpre,
+          skiplist_name);
+  fprintf(outfile,
+          "%*s%s%slow,\n",
+          (int)strlen(fpre) + 14,
+          "",
+          key_type,
+          space);
+  fprintf(outfile,
+          "%*s%s%shigh,\n",
+          (int)strlen(fpre) + 14,
+          "",
+          key_type,
+          space);
+  fprintf(outfile,
+          "%*s%s_action action,\n",
+          (int)strlen(fpre) + 14,
+          "",
+          skiplist_name);
+  fprintf(outfile, "%*svoid *arg);\n", (int)strlen(fpre) + 14, "");
+  fprintf(outfile,
+          "size_t %s_walk(%s *instance,\n",
+          fpre,
+          skiplist_name);
+  fprintf(outfile,
+          "%*s%s_action action,\n",
+          (int)strlen(fpre) + 13,
+          "",
+          skiplist_name);
+  fprintf(outfile, "%*svoid *arg);\n", (int)strlen(fpre) + 13, "");
+  fprintf(outfile, "size_t %s_count(%s *instance);\n", fpre, skiplist_name);
+  fprintf(outfile, "size_t %s_reclaim(%s *instance);\n", fpre, skiplist_name);
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (project) free(project);
+  if (skiplist_name) free(skiplist_name);
+  if (fpre) free(fpre);
+  if (key_type) free(key_type);
+}
+
+  /**
+   *  @fn bool emit_aggregate_skiplist_struct(FILE *outfile,
+   *                                          xmlNodePtr node,
+   *                                          char *suffix,
+   *                                          skiplist_field *fields,
+   *                                          char *brief,
+   *                                          int indent)
+   *
+   *  @brief emits one skip list struct for struct or union from @p node to
+   *         @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param suffix - string appended to struct or union name
+   *  @param fields - @a skiplist_field array, ended by a NULL type
+   *  @param brief - string describing struct
+   *  @param indent - indent level for output
+   *
+   *  @return true if emitted, false otherwise
+   */
+
+static bool emit_aggregate_skiplist_struct(FILE *outfile,
+                                           xmlNodePtr node,
+                                           char *suffix,
+                                           skiplist_field *fields,
+                                           char *brief,
+                                           int indent)
+{
+  skiplist_field *field;
+  char *name = NULL;
+  char *type_name = NULL;
+  char *key_type = NULL;
+  char *declaration = NULL;
+  int length;
+  int len = 0;
+  int width = 0;
+  int is_doxygen = 0;
+  bool did_it = false;
+
+  if (!option_gen_skiplist()) goto exit;
+
+  if (!outfile || !node) goto exit;
+
+  key_type = skiplist_key_type(node);
+  if (!key_type) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen: is_doxygen = 1; break;
+    default: is_doxygen = 0; break;
+  }
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  type_name = strapp(type_name, name);
+  type_name = strapp(type_name, suffix);
+  if (!type_name) goto exit;
+
+  for (field = fields; field->type; field++)
+  {
+    declaration = skiplist_field_type(field, name, key_type);
+    if (!declaration) goto exit;
+
+    length = strlen(declaration) + strlen(field->name) + 1;
+
+    if (length > len) len = length;
+    if ((int)strlen(field->comment) + 2 > width)
+      width = strlen(field->comment) + 2;
+
+    free(declaration);
+    declaration = NULL;
+  }
+
+  emit_aggregate_skiplist_annotation(outfile,
+                                     name,
+                                     type_name,
+                                     brief,
+                                     indent + 1);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "struct %s\n", type_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  for (field = fields; field->type; field++)
+  {
+    declaration = skiplist_field_type(field, name, key_type);
+    declaration = strapp(declaration, field->name);
+    if (!declaration) goto exit;
+
+    emit_indent(outfile, indent);
+    fprintf(outfile,
+            "%-*.*s/*%s  %-*s*/\n",
+            len,
+            len,
+            declaration,
+            is_doxygen ? "*<" : "",
+            width,
+            field->comment);
+
+    free(declaration);
+    declaration = NULL;
+  }
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}");
+
+  did_it = true;
+
+exit:
+  if (name) free(name);
+  if (type_name) free(type_name);
+  if (key_type) free(key_type);
+  if (declaration) free(declaration);
+
+  return did_it;
+}
+
+  /**
+   *  @fn char *skiplist_field_type(skiplist_field *field,
+   *                                char *name,
+   *                                char *key_type)
+   *
+   *  @brief builds C type of @p field, followed by the space before its
+   *         name
+   *
+   *  NOTE:  caller must free returned string
+   *
+   *  @param field - pointer to @a skiplist_field
+   *  @param name - string containing typedef name of struct or union
+   *  @param key_type - string containing C type of key
+   *
+   *  @return type string on success, NULL on failure
+   */
+
+static char *skiplist_field_type(skiplist_field *field,
+                                 char *name,
+                                 char *key_type)
+{
+  char *type = NULL;
+
+  if (!strcmp(field->type, "%k"))
+    type = strapp(type, key_type);
+  else if (!strncmp(field->type, "%s", 2))
+  {
+    type = strapp(type, name);
+    type = strapp(type, field->type + 2);
+  }
+  else
+    type = strapp(type, field->type);
+
+  if (type && (type[strlen(type) - 1] != '*')) type = strapp(type, " ");
+
+  return type;
+}
+
+  /**
+   *  @fn void emit_aggregate_skiplist_annotation(FILE *outfile,
+   *                                              char *aggregate_name,
+   *                                              char *type_name,
+   *                                              char *brief,
+   *                                              int indent)
+   *
+   *  @brief emits annotation for a skip list struct
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param aggregate_name - string containing typedef name of base aggregate
+   *  @param type_name - string containing typedef name of annotated struct
+   *  @param brief - string describing annotated struct
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_skiplist_annotation(FILE *outfile,
+                                               char *aggregate_name,
+                                               char *type_name,
+                                               char *brief,
+                                               int indent)
+{
+  if (!outfile || !aggregate_name || !type_name || !brief) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/**\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @struct %s\n", type_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  @brief %s @a %s pointers\n",
+              brief,
+              aggregate_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    case annotation_type_text:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/*\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  %s %s pointers\n", brief, aggregate_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    default: break;
+  }
+
+exit:
+}
+
+  /**
+   *  @fn void emit_aggregate_skiplist_typedefs_annotation(FILE *outfile,
+   *                                                       char *skiplist_name,
+   *                                                       int indent)
+   *
+   *  @brief emits annotation for typedef of function called by
+   *         _skiplist_walk() and _skiplist_range()
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param skiplist_name - string containing typedef name of skip list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_skiplist_typedefs_annotation(FILE *outfile,
+                                                        char *skiplist_name,
+                                                        int indent)
+{
+  if (!outfile || !skiplist_name) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/**\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @typedef %s_action\n", skiplist_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  @brief creates type for function called by "
+              "@a %s_walk() and\n",
+              skiplist_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *         @a %s_range() for each item in key order, a "
+              "non-zero\n",
+              skiplist_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *         return stops the scan\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    case annotation_type_text:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/*\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  creates type for function called by %s_walk() and\n",
+              skiplist_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  %s_range() for each item in key order, a non-zero return\n",
+              skiplist_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  stops the scan\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    default: break;
+  }
+
+exit:
+}
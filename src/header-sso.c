@@ -0,0 +1,117 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file header-sso.c
+ *  @brief small string inline buffer add-on to header.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "header-sso.h"
+#include "options.h"
+
+  /**
+   *  @fn void emit_sso_field(FILE *outfile,
+   *                          xmlNodePtr node,
+   *                          int size,
+   *                          int indent,
+   *                          int align)
+   *
+   *  @brief emits char * field in @p node to @p outfile as a heap pointer
+   *         and an inline buffer of @p size bytes
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing field element
+   *  @param size - size of inline buffer in bytes
+   *  @param indent - indent level for output
+   *  @param align - alignment of field in bytes, 0 for natural alignment
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_sso_field(FILE *outfile,
+                    xmlNodePtr node,
+                    int size,
+                    int indent,
+                    int align)
+{
+  char *name = NULL;
+  char *buf = NULL;
+  char tmp[32];
+  int is_doxygen = 0;
+  int len = 16;
+
+  if (!outfile || !node || (size <= 0)) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  is_doxygen = (option_annotation() == annotation_type_doxygen);
+
+  snprintf(tmp, sizeof(tmp), "char buf[%d];", size);
+  buf = strdup(tmp);
+  if (!buf) goto exit;
+
+  if ((int)strlen(buf) >= len) len = strlen(buf) + 1;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "struct\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  if (is_doxygen)
+    fprintf(outfile,
+            "%-*s/**<  string too long for buf, NULL if none  */\n",
+            len,
+            "char *heap;");
+  else
+    fprintf(outfile, "char *heap;\n");
+
+  emit_indent(outfile, indent + 1);
+  if (is_doxygen)
+    fprintf(outfile,
+            "%-*s/**<  string shorter than %d bytes, inline    */\n",
+            len,
+            buf,
+            size);
+  else
+    fprintf(outfile, "%s\n", buf);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "} %s", name);
+
+  if (align) fprintf(outfile, " __attribute__((aligned(%d)))", align);
+
+  if (is_doxygen)
+    fprintf(outfile, ";  /**<  USER ANNOTATION */\n");
+  else
+    fprintf(outfile, ";\n");
+
+exit:
+  if (name) free(name);
+  if (buf) free(buf);
+}
@@ -40,7 +40,46 @@
 #include "header-array.h"
 #include "header-list.h"
 #include "header-avl.h"
+#include "header-batch.h"
+#include "header-bitmap.h"
+#include "header-concurrent.h"
+#include "header-iter.h"
+#include "header-serialize.h"
+#include "header-flat.h"
+#include "header-mmap.h"
+#include "header-delimited.h"
+#include "header-json.h"
+#include "header-hash.h"
+#include "header-ring.h"
+#include "header-shardmap.h"
+#include "header-parallel.h"
+#include "header-persistent.h"
+#include "header-heap.h"
+#include "source-heap.h"
+#include "header-skiplist.h"
+#include "source-skiplist.h"
+#include "source-persistent.h"
+#include "source-shardmap.h"
+#include "header-intern.h"
+#include "header-sso.h"
+#include "source-sso.h"
 #include "options.h"
+#include "source.h"
+#include "layout.h"
+#include "profile.h"
+#include "tuning.h"
+
+  /**
+   *  @typedef field_part
+   *  @brief selects which fields of a hot/cold split struct are emitted
+   */
+
+typedef enum
+{
+  field_part_all = 0,  /**<  all fields, struct is not split  */
+  field_part_hot,      /**<  only fields of the hot half      */
+  field_part_cold      /**<  only fields of the cold half     */
+} field_part;
 
   /*  Module specific function prototypes  */
 
@@ -51,6 +90,10 @@ static void emit_header_cpp_compat_end(FILE *outfile);
 static void emit_header_annotation(FILE *outfile, char *file_name);
 static void emit_header_includes(FILE *outfile);
 static void emit_typedef(FILE *outfile, xmlNodePtr node, int indent);
+static void emit_iter_typedef(FILE *outfile,
+                              xmlNodePtr node,
+                              char *container_name,
+                              int indent);
 static void emit_typedef_annotation(FILE *outfile,
                                     xmlNodePtr node,
                                     char *name,
@@ -62,11 +105,24 @@ static void emit_enum_annotation(FILE *outfile,
                                  int indent);
 static void emit_enum_items(FILE *outfile, xmlNodePtr node, int indent);
 static bool emit_aggregate(FILE *outfile, xmlNodePtr node, int indent);
+static bool emit_aggregate_cold(FILE *outfile, xmlNodePtr node, int indent);
 static void emit_aggregate_annotation(FILE *outfile,
                                       xmlNodePtr node,
                                       char *name,
                                       int indent);
-static void emit_fields(FILE *outfile, xmlNodePtr node, int indent);
+static void emit_ordered_fields(FILE *outfile,
+                                xmlNodePtr node,
+                                int indent,
+                                field_part part);
+static void emit_selected_field(FILE *outfile,
+                                char *aggregate_name,
+                                xmlNodePtr node,
+                                int indent,
+                                field_part part);
+static void emit_field(FILE *outfile,
+                       xmlNodePtr node,
+                       int indent,
+                       int align);
 static void emit_type_reference(FILE *outfile, xmlNodePtr node, int indent);
 static void emit_function_prototypes(FILE *outfile,
                                      xmlNodePtr node,
@@ -199,16 +255,52 @@ void gen_header(xmlDocPtr doc, char *base_name)
     {
       if (emit_aggregate(outfile, node, 0))
         fprintf(outfile, ";\n\n");
+      if (emit_aggregate_cold(outfile, node, 0))
+        fprintf(outfile, ";\n\n");
       if (emit_aggregate_array(outfile, node, 0))
         fprintf(outfile, ";\n\n");
+      if (emit_aggregate_iter(outfile, node, "array", 0))
+        fprintf(outfile, ";\n\n");
+      if (emit_aggregate_array_map(outfile, node, 0))
+        fprintf(outfile, ";\n\n");
       if (emit_aggregate_list_node(outfile, node, 0))
         fprintf(outfile, ";\n\n");
       if (emit_aggregate_list(outfile, node, 0))
         fprintf(outfile, ";\n\n");
+      if (emit_aggregate_iter(outfile, node, "list", 0))
+        fprintf(outfile, ";\n\n");
       if (emit_aggregate_avl_node(outfile, node, 0))
         fprintf(outfile, ";\n\n");
       if (emit_aggregate_avl(outfile, node, 0))
         fprintf(outfile, ";\n\n");
+      if (emit_aggregate_iter(outfile, node, "avl", 0))
+        fprintf(outfile, ";\n\n");
+      if (emit_aggregate_persistent_item(outfile, node, 0))
+        fprintf(outfile, ";\n\n");
+      if (emit_aggregate_persistent_node(outfile, node, 0))
+        fprintf(outfile, ";\n\n");
+      if (emit_aggregate_persistent_snapshot(outfile, node, 0))
+        fprintf(outfile, ";\n\n");
+      if (emit_aggregate_persistent(outfile, node, 0))
+        fprintf(outfile, ";\n\n");
+      if (emit_aggregate_ring_cell(outfile, node, 0))
+        fprintf(outfile, ";\n\n");
+      if (emit_aggregate_ring(outfile, node, 0))
+        fprintf(outfile, ";\n\n");
+      if (emit_aggregate_shardmap_shard(outfile, node, 0))
+        fprintf(outfile, ";\n\n");
+      if (emit_aggregate_shardmap(outfile, node, 0))
+        fprintf(outfile, ";\n\n");
+      if (emit_aggregate_shardmap_iter(outfile, node, 0))
+        fprintf(outfile, ";\n\n");
+      if (emit_aggregate_heap_entry(outfile, node, 0))
+        fprintf(outfile, ";\n\n");
+      if (emit_aggregate_heap(outfile, node, 0))
+        fprintf(outfile, ";\n\n");
+      if (emit_aggregate_skiplist_node(outfile, node, 0))
+        fprintf(outfile, ";\n\n");
+      if (emit_aggregate_skiplist(outfile, node, 0))
+        fprintf(outfile, ";\n\n");
     }
     else
       continue;
@@ -226,6 +318,10 @@ void gen_header(xmlDocPtr doc, char *base_name)
   fprintf(outfile, " */\n");
   fprintf(outfile, "\n");
 
+  emit_intern_function_prototypes(outfile, root, project_name);
+
+  emit_bitmap_functions(outfile, root, project_name);
+
   for (node = root->children; node; node = node->next)
     emit_function_prototypes(outfile, node, project_name);
 
@@ -454,17 +550,84 @@ static bool emit_aggregate(FILE *outfile, xmlNodePtr node, int indent)
 
   ++indent;
 
-  emit_fields(outfile, node->children, indent);
+  if (name && profile_split(name))
+  {
+    emit_ordered_fields(outfile, node, indent, field_part_hot);
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "%s_cold *_cold;", name);
+    if (option_annotation() == annotation_type_doxygen)
+      fprintf(outfile, "  /**<  fields split off by access profile  */");
+    fprintf(outfile, "\n");
+  }
+  else
+    emit_ordered_fields(outfile, node, indent, field_part_all);
 
   --indent;
 
   emit_indent(outfile, indent);
   fprintf(outfile, "}");
 
+  if (tuning_align(name))
+    fprintf(outfile, " __attribute__((aligned(%d)))", tuning_align(name));
+
+  did_it = true;
+
+exit:
+  if (name) free(name);
+
+  return did_it;
+}
+
+  /**
+   *  @fn bool emit_aggregate_cold(FILE *outfile, xmlNodePtr node, int indent)
+   *
+   *  @brief emits cold half of a hot/cold split struct in @p node to
+   *         @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct element
+   *  @param indent - indent level for output
+   *
+   *  @return true if cold struct emitted, false if not
+   */
+  
+static bool emit_aggregate_cold(FILE *outfile, xmlNodePtr node, int indent)
+{
+  char *name = NULL;
+  char *cold_name = NULL;
+  bool did_it = false;
+
+  if (!outfile || !node) goto exit;
+
+  if (strcmp((char *)node->name, "struct")) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  if (!profile_split(name)) goto exit;
+
+  cold_name = strapp(cold_name, name);
+  cold_name = strapp(cold_name, "_cold");
+
+  emit_aggregate_annotation(outfile, node, cold_name, indent + 1);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "struct %s\n", cold_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_ordered_fields(outfile, node, indent + 1, field_part_cold);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}");
+
   did_it = true;
 
 exit:
   if (name) free(name);
+  if (cold_name) free(cold_name);
 
   return did_it;
 }
@@ -538,26 +701,158 @@ exit:
 }
 
   /**
-   *  @fn void emit_fields(FILE *outfile, xmlNodePtr node, int indent)
+   *  @fn void emit_ordered_fields(FILE *outfile,
+   *                               xmlNodePtr node,
+   *                               int indent,
+   *                               field_part part)
+   *
+   *  @brief emits fields of struct or union in @p node to @p outfile
    *
-   *  @brief emits struct or union fields from @p node and siblings to @p outfile
+   *  Fields are emitted in declared order, or ordered to minimize padding
+   *  when packing is on.  For hot/cold split structs, @p part selects which
+   *  half is emitted.
+   *
+   *  NOTE:  falls back to declared order if layout can not be computed
    *
    *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param indent - indent level for output
+   *  @param part - which fields to emit
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+  
+static void emit_ordered_fields(FILE *outfile,
+                                xmlNodePtr node,
+                                int indent,
+                                field_part part)
+{
+  layout *lo = NULL;
+  layout *packed = NULL;
+  xmlNodePtr child;
+  char *name = NULL;
+  int i;
+
+  if (!outfile || !node) goto exit;
+
+  name = get_attribute(node, "name");
+
+  if (option_pack())
+  {
+    lo = layout_new(node);
+    if (lo) packed = layout_pack(lo);
+  }
+
+  if (packed)
+  {
+    for (i = 0; i < packed->n; i++)
+      emit_selected_field(outfile,
+                          name,
+                          packed->members[i].field,
+                          indent,
+                          part);
+  }
+  else
+  {
+    for (child = node->children; child; child = child->next)
+      emit_selected_field(outfile, name, child, indent, part);
+  }
+
+exit:
+  if (packed) layout_free(packed);
+  if (lo) layout_free(lo);
+  if (name) free(name);
+}
+
+  /**
+   *  @fn void emit_selected_field(FILE *outfile,
+   *                               char *aggregate_name,
+   *                               xmlNodePtr node,
+   *                               int indent,
+   *                               field_part part)
+   *
+   *  @brief emits field in @p node to @p outfile if it belongs to @p part
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param aggregate_name - string containing name of struct or union
    *  @param node - xmlNodePtr containing field element
    *  @param indent - indent level for output
+   *  @param part - which fields to emit
    *
    *  @par Returns
    *  Nothing.
    */
   
-static void emit_fields(FILE *outfile, xmlNodePtr node, int indent)
+static void emit_selected_field(FILE *outfile,
+                                char *aggregate_name,
+                                xmlNodePtr node,
+                                int indent,
+                                field_part part)
+{
+  char *name = NULL;
+  bool cold;
+
+  if (!outfile || !node) goto exit;
+
+  if (strcmp((char *)node->name, "field")) goto exit;
+
+  name = get_attribute(node, "name");
+
+  if (part != field_part_all)
+  {
+    cold = profile_field_is_cold(aggregate_name, name);
+
+    if ((part == field_part_hot) && cold) goto exit;
+    if ((part == field_part_cold) && !cold) goto exit;
+  }
+
+  if (sso_size(aggregate_name, node))
+    emit_sso_field(outfile,
+                   node,
+                   sso_size(aggregate_name, node),
+                   indent,
+                   tuning_field_align(aggregate_name, name));
+  else
+    emit_field(outfile,
+               node,
+               indent,
+               tuning_field_align(aggregate_name, name));
+
+exit:
+  if (name) free(name);
+}
+
+  /**
+   *  @fn void emit_field(FILE *outfile,
+   *                      xmlNodePtr node,
+   *                      int indent,
+   *                      int align)
+   *
+   *  @brief emits a single struct or union field from @p node to @p outfile
+   *
+   *  NOTE:  @p align is ignored for bitfields, which can not be aligned
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing field element
+   *  @param indent - indent level for output
+   *  @param align - alignment of field in bytes, 0 for natural alignment
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+  
+static void emit_field(FILE *outfile,
+                       xmlNodePtr node,
+                       int indent,
+                       int align)
 {
   char *name = NULL;
   xmlNodePtr child = NULL;
   xmlNodePtr type_child = NULL;
   xmlNodePtr scalar = NULL;
   xmlNodePtr reference = NULL;
-  unsigned int n_pointers;
+  unsigned int n_pointers = 0;
   arrays *arrs = NULL;
   char *type_name = NULL;
   int i;
@@ -566,117 +861,102 @@ static void emit_fields(FILE *outfile, xmlNodePtr node, int indent)
 
   if (!outfile || !node) goto exit;
 
-  while (node)
-  {
-    name = NULL;
-    n_pointers = 0;
-    type_child = NULL;
-    bitlen = 0;
-
-    if (!strcmp((char *)node->name, "field"))
-    {
-        // Extract field name, can be anonymous for some types
-
-      name = get_attribute(node, "name");
+  if (strcmp((char *)node->name, "field")) goto exit;
 
-        // Iterate over children, getting type, pointers and array indices
+    // Extract field name, can be anonymous for some types
 
-      for (child = node->children; child; child = child->next)
-      {
-        if (!strcmp((char *)child->name, "text")) continue;
+  name = get_attribute(node, "name");
 
-        if (!strcmp((char *)child->name, "array"))
-        {
-          arrs = array_levels(child);
-          n_pointers = array_pointer_count(child);
-          scalar = array_find_scalar(child);
-          reference = array_find_reference(child);
-        }
-        else if (!strcmp((char *)child->name, "pointer"))
-        {
-          n_pointers = pointer_count(child);
-          scalar = pointer_find_scalar(child);
-          reference = pointer_find_reference(child);
-        }
-        else if (!strcmp((char *)child->name, "scalar"))
-          type_name = get_attribute(child, "type-name");
-        else if (!strcmp((char *)child->name, "bitfield"))
-        {
-          type_name = strdup("uint32_t");
-          bitlen = atoi(t = get_attribute(child, "size"));
-          if (t) free(t);
-        }
-        else if (!strcmp((char *)child->name, "enum") ||
-                 !strcmp((char *)child->name, "struct") ||
-                 !strcmp((char *)child->name, "union") ||
-                 !strcmp((char *)child->name, "type-reference"))
-          type_child = child;
-      }
+    // Iterate over children, getting type, pointers and array indices
 
-        // Output field components in proper order:
-        //   Type name, pointers, field name, array indices
+  for (child = node->children; child; child = child->next)
+  {
+    if (!strcmp((char *)child->name, "text")) continue;
 
-      if (scalar)
-        type_name = get_attribute(scalar, "type-name");
-      else if (reference)
-        type_name = get_attribute(reference, "name");
+    if (!strcmp((char *)child->name, "array"))
+    {
+      arrs = array_levels(child);
+      n_pointers = array_pointer_count(child);
+      scalar = array_find_scalar(child);
+      reference = array_find_reference(child);
+    }
+    else if (!strcmp((char *)child->name, "pointer"))
+    {
+      n_pointers = pointer_count(child);
+      scalar = pointer_find_scalar(child);
+      reference = pointer_find_reference(child);
+    }
+    else if (!strcmp((char *)child->name, "scalar"))
+      type_name = get_attribute(child, "type-name");
+    else if (!strcmp((char *)child->name, "bitfield"))
+    {
+      type_name = strdup("uint32_t");
+      bitlen = atoi(t = get_attribute(child, "size"));
+      if (t) free(t);
+    }
+    else if (!strcmp((char *)child->name, "enum") ||
+             !strcmp((char *)child->name, "struct") ||
+             !strcmp((char *)child->name, "union") ||
+             !strcmp((char *)child->name, "type-reference"))
+      type_child = child;
+  }
 
-      if (type_name)
-      {
-        emit_indent(outfile, indent);
-        fprintf(outfile, "%s", type_name);
-      }
-      else if (type_child)
-      {
-        if (!strcmp((char *)type_child->name, "enum"))
-          emit_enum(outfile, type_child, indent);
-        else if (!strcmp((char *)type_child->name, "struct"))
-          emit_aggregate(outfile, type_child, indent);
-        else if (!strcmp((char *)type_child->name, "union"))
-          emit_aggregate(outfile, type_child, indent);
-        else if (!strcmp((char *)type_child->name, "type-reference"))
-          emit_type_reference(outfile, type_child, indent);
-      }
+    // Output field components in proper order:
+    //   Type name, pointers, field name, array indices
 
-      if (name) fputc(' ', outfile);
+  if (scalar)
+    type_name = get_attribute(scalar, "type-name");
+  else if (reference)
+    type_name = get_attribute(reference, "name");
 
-      for (i = 0; i < n_pointers; i++)
-        fputc('*', outfile);
+  if (type_name)
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "%s", type_name);
+  }
+  else if (type_child)
+  {
+    if (!strcmp((char *)type_child->name, "enum"))
+      emit_enum(outfile, type_child, indent);
+    else if (!strcmp((char *)type_child->name, "struct"))
+      emit_aggregate(outfile, type_child, indent);
+    else if (!strcmp((char *)type_child->name, "union"))
+      emit_aggregate(outfile, type_child, indent);
+    else if (!strcmp((char *)type_child->name, "type-reference"))
+      emit_type_reference(outfile, type_child, indent);
+  }
 
-      if (name) fprintf(outfile, "%s", name);
+  if (name) fputc(' ', outfile);
 
-      if (arrs)
-      {
-        for (i = 0; i < arrs->n; i++)
-        {
-          if (arrs->array[i])
-            fprintf(outfile, "[%d]", arrs->array[i]);
-          else
-            fprintf(outfile, "[]");
-        }
-      }
+  for (i = 0; i < n_pointers; i++)
+    fputc('*', outfile);
 
-      if (bitlen) fprintf(outfile, ":%d", bitlen);
+  if (name) fprintf(outfile, "%s", name);
 
-      if ((option_annotation() == annotation_type_doxygen) &&
-          (!type_child || (type_child && name)))
-        fprintf(outfile, ";  /**<  USER ANNOTATION */\n");
+  if (arrs)
+  {
+    for (i = 0; i < arrs->n; i++)
+    {
+      if (arrs->array[i])
+        fprintf(outfile, "[%d]", arrs->array[i]);
       else
-        fprintf(outfile, ";\n");
-
-      if (name) free(name);
-      if (type_name) free(type_name);
-      name = type_name = NULL;
-      if (arrs) arrays_free(arrs);
-      arrs = NULL;
-      scalar = NULL;
-      reference = NULL;
+        fprintf(outfile, "[]");
     }
-
-    node = node->next;
   }
 
+  if (bitlen) fprintf(outfile, ":%d", bitlen);
+  else if (align) fprintf(outfile, " __attribute__((aligned(%d)))", align);
+
+  if ((option_annotation() == annotation_type_doxygen) &&
+      (!type_child || (type_child && name)))
+    fprintf(outfile, ";  /**<  USER ANNOTATION */\n");
+  else
+    fprintf(outfile, ";\n");
+
 exit:
+  if (name) free(name);
+  if (type_name) free(type_name);
+  if (arrs) arrays_free(arrs);
 }
 
   /**
@@ -698,7 +978,13 @@ static void emit_typedef(FILE *outfile, xmlNodePtr node, int indent)
   char *array_name = NULL;
   char *list_name = NULL;
   char *avl_name = NULL;
+  char *pavl_name = NULL;
+  char *ring_name = NULL;
+  char *map_name = NULL;
+  char *heap_name = NULL;
+  char *skiplist_name = NULL;
   char *node_name = NULL;
+  char *cold_name = NULL;
 
   if (!outfile || !node) goto exit;
 
@@ -719,6 +1005,15 @@ static void emit_typedef(FILE *outfile, xmlNodePtr node, int indent)
 
     fprintf(outfile, "\n");
 
+    if (profile_split(name))
+    {
+      cold_name = strapp(cold_name, name);
+      cold_name = strapp(cold_name, "_cold");
+      emit_typedef_annotation(outfile, node, cold_name, indent + 1);
+      fprintf(outfile, "typedef struct %s %s;\n", cold_name, cold_name);
+      fprintf(outfile, "\n");
+    }
+
     if (option_gen_array())
     {
       array_name = strapp(array_name, name);
@@ -726,6 +1021,16 @@ static void emit_typedef(FILE *outfile, xmlNodePtr node, int indent)
       emit_typedef_annotation(outfile, node, array_name, indent + 1);
       fprintf(outfile, "typedef struct %s %s;\n", array_name, array_name);
       fprintf(outfile, "\n");
+
+      emit_iter_typedef(outfile, node, array_name, indent);
+
+      if (option_gen_mmap())
+      {
+        array_name = strapp(array_name, "_map");
+        emit_typedef_annotation(outfile, node, array_name, indent + 1);
+        fprintf(outfile, "typedef struct %s %s;\n", array_name, array_name);
+        fprintf(outfile, "\n");
+      }
     }
 
     if (option_gen_list())
@@ -744,6 +1049,8 @@ static void emit_typedef(FILE *outfile, xmlNodePtr node, int indent)
       fprintf(outfile, "typedef struct %s %s;\n", list_name, list_name);
       fprintf(outfile, "\n");
 
+      emit_iter_typedef(outfile, node, list_name, indent);
+
       free(list_name);
       free(node_name);
       list_name = node_name = NULL;
@@ -765,6 +1072,8 @@ static void emit_typedef(FILE *outfile, xmlNodePtr node, int indent)
       fprintf(outfile, "typedef struct %s %s;\n", avl_name, avl_name);
       fprintf(outfile, "\n");
 
+      emit_iter_typedef(outfile, node, avl_name, indent);
+
       emit_aggregate_avl_typedefs(outfile, node, indent);
       fprintf(outfile, ";\n");
       fprintf(outfile, "\n");
@@ -773,11 +1082,193 @@ static void emit_typedef(FILE *outfile, xmlNodePtr node, int indent)
       free(node_name);
       avl_name = node_name = NULL;
     }
+
+    if (persistent_any())
+    {
+      pavl_name = strapp(pavl_name, name);
+      pavl_name = strapp(pavl_name, "_pavl");
+
+      node_name = strapp(node_name, pavl_name);
+      node_name = strapp(node_name, "_item");
+
+      emit_typedef_annotation(outfile, node, node_name, indent + 1);
+      fprintf(outfile, "typedef struct %s %s;\n", node_name, node_name);
+      fprintf(outfile, "\n");
+
+      free(node_name);
+      node_name = NULL;
+
+      node_name = strapp(node_name, pavl_name);
+      node_name = strapp(node_name, "_node");
+
+      emit_typedef_annotation(outfile, node, node_name, indent + 1);
+      fprintf(outfile, "typedef struct %s %s;\n", node_name, node_name);
+      fprintf(outfile, "\n");
+
+      free(node_name);
+      node_name = NULL;
+
+      node_name = strapp(node_name, pavl_name);
+      node_name = strapp(node_name, "_snapshot");
+
+      emit_typedef_annotation(outfile, node, node_name, indent + 1);
+      fprintf(outfile, "typedef struct %s %s;\n", node_name, node_name);
+      fprintf(outfile, "\n");
+
+      emit_typedef_annotation(outfile, node, pavl_name, indent + 1);
+      fprintf(outfile, "typedef struct %s %s;\n", pavl_name, pavl_name);
+      fprintf(outfile, "\n");
+
+      emit_aggregate_persistent_typedefs(outfile, node, indent);
+
+      free(pavl_name);
+      free(node_name);
+      pavl_name = node_name = NULL;
+    }
+
+    if (option_gen_ring())
+    {
+      ring_name = strapp(ring_name, name);
+      ring_name = strapp(ring_name, "_ring");
+
+      node_name = strapp(node_name, ring_name);
+      node_name = strapp(node_name, "_cell");
+
+      emit_typedef_annotation(outfile, node, node_name, indent + 1);
+      fprintf(outfile, "typedef struct %s %s;\n", node_name, node_name);
+      fprintf(outfile, "\n");
+
+      emit_typedef_annotation(outfile, node, ring_name, indent + 1);
+      fprintf(outfile, "typedef struct %s %s;\n", ring_name, ring_name);
+      fprintf(outfile, "\n");
+
+      free(ring_name);
+      free(node_name);
+      ring_name = node_name = NULL;
+    }
+
+    if (option_gen_shardmap() && shardmap_key(node, NULL))
+    {
+      map_name = strapp(map_name, name);
+      map_name = strapp(map_name, "_shardmap");
+
+      node_name = strapp(node_name, map_name);
+      node_name = strapp(node_name, "_shard");
+
+      emit_typedef_annotation(outfile, node, node_name, indent + 1);
+      fprintf(outfile, "typedef struct %s %s;\n", node_name, node_name);
+      fprintf(outfile, "\n");
+
+      emit_typedef_annotation(outfile, node, map_name, indent + 1);
+      fprintf(outfile, "typedef struct %s %s;\n", map_name, map_name);
+      fprintf(outfile, "\n");
+
+      free(node_name);
+      node_name = NULL;
+
+      node_name = strapp(node_name, map_name);
+      node_name = strapp(node_name, "_iter");
+
+      emit_typedef_annotation(outfile, node, node_name, indent + 1);
+      fprintf(outfile, "typedef struct %s %s;\n", node_name, node_name);
+      fprintf(outfile, "\n");
+
+      emit_aggregate_shardmap_typedefs(outfile, node, indent);
+
+      free(map_name);
+      free(node_name);
+      map_name = node_name = NULL;
+    }
+
+    emit_aggregate_parallel_typedefs(outfile, node, indent);
+
+    if (option_gen_heap() && heap_key(node, NULL))
+    {
+      heap_name = strapp(heap_name, name);
+      heap_name = strapp(heap_name, "_heap");
+
+      node_name = strapp(node_name, heap_name);
+      node_name = strapp(node_name, "_entry");
+
+      emit_typedef_annotation(outfile, node, node_name, indent + 1);
+      fprintf(outfile, "typedef struct %s %s;\n", node_name, node_name);
+      fprintf(outfile, "\n");
+
+      emit_typedef_annotation(outfile, node, heap_name, indent + 1);
+      fprintf(outfile, "typedef struct %s %s;\n", heap_name, heap_name);
+      fprintf(outfile, "\n");
+
+      free(heap_name);
+      free(node_name);
+      heap_name = node_name = NULL;
+    }
+
+    if (option_gen_skiplist() && skiplist_key(node, NULL))
+    {
+      skiplist_name = strapp(skiplist_name, name);
+      skiplist_name = strapp(skiplist_name, "_skiplist");
+
+      node_name = strapp(node_name, skiplist_name);
+      node_name = strapp(node_name, "_node");
+
+      emit_typedef_annotation(outfile, node, node_name, indent + 1);
+      fprintf(outfile, "typedef struct %s %s;\n", node_name, node_name);
+      fprintf(outfile, "\n");
+
+      emit_typedef_annotation(outfile, node, skiplist_name, indent + 1);
+      fprintf(outfile,
+              "typedef struct %s %s;\n",
+              skiplist_name,
+              skiplist_name);
+      fprintf(outfile, "\n");
+
+      emit_aggregate_skiplist_typedefs(outfile, node, indent);
+
+      free(skiplist_name);
+      free(node_name);
+      skiplist_name = node_name = NULL;
+    }
   }
 
 exit:
   if (name) free(name);
   if (array_name) free(array_name);
+  if (cold_name) free(cold_name);
+}
+
+  /**
+   *  @fn void emit_iter_typedef(FILE *outfile,
+   *                             xmlNodePtr node,
+   *                             char *container_name,
+   *                             int indent)
+   *
+   *  @brief emits typedef of iterator over @p container_name
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param container_name - string containing typedef name of container
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_iter_typedef(FILE *outfile,
+                              xmlNodePtr node,
+                              char *container_name,
+                              int indent)
+{
+  char *iter_name = NULL;
+
+  iter_name = strapp(iter_name, container_name);
+  iter_name = strapp(iter_name, "_iter");
+  if (!iter_name) return;
+
+  emit_typedef_annotation(outfile, node, iter_name, indent + 1);
+  fprintf(outfile, "typedef struct %s %s;\n", iter_name, iter_name);
+  fprintf(outfile, "\n");
+
+  free(iter_name);
 }
 
   /**
@@ -1054,6 +1545,23 @@ static void emit_header_includes(FILE *outfile)
 
   fprintf(outfile, "#include <stdbool.h>\n");
   fprintf(outfile, "#include <stdint.h>\n");
+  if (option_inline_accessors() ||
+      option_gen_serialize() ||
+      option_gen_flat() ||
+      option_gen_delimited() ||
+      option_gen_json() ||
+      option_gen_hash() ||
+      option_gen_ring() ||
+      option_gen_array() ||
+      option_gen_list() ||
+      option_gen_avl() ||
+      option_gen_shardmap() ||
+      option_gen_heap() ||
+      option_gen_skiplist() ||
+      concurrent_any())
+    fprintf(outfile, "#include <stddef.h>\n");
+  if (option_gen_delimited())
+    fprintf(outfile, "#include <stdio.h>\n");
 
   if (option_gen_list())
     fprintf(outfile, "#include <llist.h>\n");
@@ -1061,6 +1569,12 @@ static void emit_header_includes(FILE *outfile)
   if (option_gen_avl())
     fprintf(outfile, "#include <avl.h>\n");
 
+  if (concurrent_any())
+    fprintf(outfile, "#include <pthread.h>\n");
+
+  if (option_gen_ring() || persistent_any() || option_gen_skiplist())
+    fprintf(outfile, "#include <stdatomic.h>\n");
+
   fprintf(outfile, "\n");
 
   for (incl = option_get_first_include();
@@ -1108,6 +1622,25 @@ static void emit_function_prototypes(FILE *outfile,
     emit_aggregate_array_function_prototypes(outfile, node, project_name);
     emit_aggregate_list_function_prototypes(outfile, node, project_name);
     emit_aggregate_avl_function_prototypes(outfile, node, project_name);
+    emit_aggregate_persistent_function_prototypes(outfile,
+                                                  node,
+                                                  project_name);
+    emit_aggregate_iter_function_prototypes(outfile, node, project_name);
+    emit_aggregate_batch_function_prototypes(outfile, node, project_name);
+    emit_aggregate_bitmap_function_prototypes(outfile, node, project_name);
+    emit_aggregate_serialize_function_prototypes(outfile, node, project_name);
+    emit_aggregate_flat_function_prototypes(outfile, node, project_name);
+    emit_aggregate_mmap_function_prototypes(outfile, node, project_name);
+    emit_aggregate_delimited_function_prototypes(outfile,
+                                                 node,
+                                                 project_name);
+    emit_aggregate_json_function_prototypes(outfile, node, project_name);
+    emit_aggregate_hash_function_prototypes(outfile, node, project_name);
+    emit_aggregate_ring_function_prototypes(outfile, node, project_name);
+    emit_aggregate_shardmap_function_prototypes(outfile, node, project_name);
+    emit_aggregate_parallel_function_prototypes(outfile, node, project_name);
+    emit_aggregate_heap_function_prototypes(outfile, node, project_name);
+    emit_aggregate_skiplist_function_prototypes(outfile, node, project_name);
   }
 }
 
@@ -1251,6 +1784,8 @@ static void emit_aggregate_function_prototypes(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_aggregate_inline_accessors(outfile, node, project);
+
 exit:
   if (project) free(project);
   if (name) free(name);
@@ -1396,18 +1931,23 @@ static void emit_aggregate_field_function_prototypes(FILE *outfile,
   else
     function_prefix = strdup(new_sub_field_name);
 
-  fprintf(outfile, "%s%s_get_%s(%s *instance);\n",
-                   type_name,
-                   function_prefix,
-                   field_name,
-                   aggregate_name);
-
-  fprintf(outfile, "void %s_set_%s(%s *instance, %s%s);\n",
-                   function_prefix,
-                   field_name,
-                   aggregate_name,
-                   type_name,
-                   field_name);
+    // inlined accessors are defined in full by
+    // emit_aggregate_inline_accessors() instead
+
+  if (sub_field_name || !aggregate_accessor_is_inline(node, false))
+    fprintf(outfile, "%s%s_get_%s(%s *instance);\n",
+                     type_name,
+                     function_prefix,
+                     field_name,
+                     aggregate_name);
+
+  if (sub_field_name || !aggregate_accessor_is_inline(node, true))
+    fprintf(outfile, "void %s_set_%s(%s *instance, %s%s);\n",
+                     function_prefix,
+                     field_name,
+                     aggregate_name,
+                     type_name,
+                     field_name);
 
 exit:
   if (type_name) free(type_name);
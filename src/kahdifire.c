@@ -38,6 +38,8 @@
 
 #include "kahdifire.h"
 #include "options.h"
+#include "profile.h"
+#include "layout.h"
 
   /*
    *  Prototypes for functions in this module
@@ -45,6 +47,22 @@
 
 void usage(void);
 
+  /*
+   *  Long command line options, each maps to a short option
+   */
+
+static struct option long_options[] =
+{
+  { "layout-report",    no_argument,       NULL, 'L' },
+  { "pack",             no_argument,       NULL, 'p' },
+  { "inline-accessors", no_argument,       NULL, 'I' },
+  { "profile",          required_argument, NULL, 'P' },
+  { "tuning",           required_argument, NULL, 'T' },
+  { "split-source",     optional_argument, NULL, 's' },
+  { "help",             no_argument,       NULL, 'h' },
+  { NULL,               0,                 NULL, 0   }
+};
+
   /**
    *  @fn int main(int argc, char **argv)
    *
@@ -63,10 +81,38 @@ int main(int argc, char **argv)
   char *input_name = NULL;
   int retval = 0;
 
-  while ((c = getopt(argc, argv, "b:a:l:g:hmM:i:tcr")) != EOF)
+  while ((c = getopt_long(argc,
+                          argv,
+                          "b:a:l:g:hmM:i:tcrLpP:T:Is::",
+                          long_options,
+                          NULL)) != EOF)
   {
     switch (c)
     {
+      case 'L':
+        option_layout_report_on();
+        break;
+
+      case 'p':
+        option_pack_on();
+        break;
+
+      case 'I':
+        option_inline_accessors_on();
+        break;
+
+      case 'P':
+        option_set_profile(optarg);
+        break;
+
+      case 'T':
+        option_set_tuning(optarg);
+        break;
+
+      case 's':
+        option_set_split_source(optarg);
+        break;
+
       case 'r':
         option_gen_readme_on();
         break;
@@ -115,7 +161,10 @@ int main(int argc, char **argv)
     }
   }
 
-  if (optind >= argc)
+  if ((optind >= argc) ||
+      (option_gen_shardmap() && !option_shardmap_key()) ||
+      (option_gen_heap() && !option_heap_key()) ||
+      (option_gen_skiplist() && !option_skiplist_key()))
   {
     usage();
     goto exit;
@@ -157,7 +206,8 @@ void usage(void)
   printf("    kahdifire [-a <annotation>] [-b <base name>] [-l <license type>] "
          "[-m]\n"
          "              [-M <makefile options>] [-r] [-g <generator options>]\n" 
-         "              [-t] [-i <include list>] <input file>\n");
+         "              [-t] [-i <include list>] [-L] [-p] [-I] [-s[<count>]]\n"
+         "              [-P <profile file>] [-T <tuning file>] <input file>\n");
   printf("\n");
   printf("    kahdifire -h\n");
   printf("\n");
@@ -187,13 +237,66 @@ void usage(void)
   printf("      array - generate code for a dynamic array handler\n");
   printf("      list - generate code for a doubly linked list handler\n");
   printf("      avl - generate code for an AVL (balanced b-tree) handler\n");
+  printf("      serialize - generate code for a binary encoder and decoder\n");
+  printf("      flat - generate code for zero-copy flat views of records\n");
+  printf("      mmap - generate code to save arrays to a file and map them\n");
+  printf("        back in place (implies array and flat)\n");
+  printf("      delimited - generate code to load CSV/TSV text into structs\n");
+  printf("      json - generate code for a JSON encoder and decoder\n");
+  printf("      hash - generate type-aware hash and equality functions\n");
+  printf("      ring - generate bounded lock-free multi-producer, multi-consumer\n");
+  printf("        queues of struct pointers\n");
+  printf("      shardmap:key=<field> - generate sharded concurrent hash maps\n");
+  printf("        of structs holding <field>, keyed by it\n");
+  printf("      parallel - generate _parallel_for_each/_parallel_reduce\n");
+  printf("        over arrays, lists and avls, split across threads\n");
+  printf("      heap:key=<field>[:max] - generate 4-ary min-heaps, or\n");
+  printf("        max-heaps, of struct pointers ordered by <field>\n");
+  printf("      bitmap - generate bitmap indexes over enum and bool fields\n");
+  printf("        of arrays, with word-wide AND/OR/count queries (implies\n");
+  printf("        array)\n");
+  printf("      skiplist:key=<field> - generate concurrent skip lists of\n");
+  printf("        struct pointers ordered by <field>, with lock-free\n");
+  printf("        _find/_range/_walk\n");
+  printf("      array, list and avl get caller owned _iter_begin/_next/_end\n");
+  printf("        iterators and batch _add_many/_remove_many functions (avl\n");
+  printf("        _insert_many/_delete_many), and accept a ':concurrent'\n");
+  printf("        suffix, ie. avl:concurrent, for thread-safe functions\n");
+  printf("        locking an embedded rwlock\n");
+  printf("      avl also accepts ':persistent', ie. avl:concurrent:persistent,\n");
+  printf("        for a copy-on-write _pavl tree, path copying writers and\n");
+  printf("        readers holding O(1) reference counted snapshots, large\n");
+  printf("        _insert_many batches rebuild it balanced bottom-up\n");
   printf("\n");
   printf("    <input file> is name of XML file containing C declarations\n");
   printf("\n");
   printf("    <include list> is ':' separated list of include files for "
          "header\n");
   printf("\n");
-  printf("    -m = generate a makefile\n");
+  printf("    <profile file> lists field access counts, one per line as\n"
+         "      <struct>.<field> <count>\n"
+         "      fields below %d%% of the hottest field of a struct are moved\n"
+         "      to a separately allocated <struct>_cold half\n",
+         PROFILE_HOT_PERCENT);
+  printf("\n");
+  printf("    <tuning file> lists layout directives, one per line as\n"
+         "      align <struct> [<bytes>]\n"
+         "      separate <struct>.<field> [<bytes>]\n"
+         "      intern <struct>.<field>\n"
+         "      inline <struct>.<field> <bytes>\n"
+         "      align aligns every instance of a struct or union, separate "
+         "starts\n"
+         "      a field on its own cache line to avoid false sharing, "
+         "<bytes>\n"
+         "      defaults to %d, intern shares one reference counted copy of "
+         "equal\n"
+         "      strings among char * fields, inline keeps strings shorter than\n"
+         "      <bytes> inside the struct and longer ones on the heap\n",
+         LAYOUT_CACHE_LINE);
+  printf("\n");
+  printf("    -m = generate a makefile, with targets for a static and a shared\n"
+         "         library, an LTO build (lto) and a two stage PGO build\n"
+         "         (pgo-gen, run a training program, pgo-use)\n");
   printf("\n");
   printf("    -r = generate a README.md file\n");
   printf("\n");
@@ -201,6 +304,20 @@ void usage(void)
   printf("\n");
   printf("    -c = add C++ compatibility #defines to header\n");
   printf("\n");
+  printf("    -L, --layout-report = print padding, hole and cache line report\n"
+         "                          for each struct and union, no code is "
+         "generated\n");
+  printf("\n");
+  printf("    -p, --pack = reorder struct fields to minimize padding\n");
+  printf("\n");
+  printf("    -I, --inline-accessors = emit trivial getters and setters as\n"
+         "                             static inline functions in header\n");
+  printf("\n");
+  printf("    -s, --split-source[=<count>] = emit functions of every <count>\n"
+         "                                   structs and unions, default 1, in\n"
+         "                                   a source file of their own, so\n"
+         "                                   they compile in parallel\n");
+  printf("\n");
   printf("    -h = this help display\n");
   printf("\n");
 }
@@ -0,0 +1,981 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file layout.c
+ *  @brief Computes memory layout of struct and union declarations
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is a layout report, or layout information for other modules
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "layout.h"
+#include "tuning.h"
+#include "source-sso.h"
+
+  /*  Module specific function prototypes  */
+
+static xmlNodePtr field_type_node(xmlNodePtr field);
+static char *type_string(xmlNodePtr node);
+static int round_up(int value, int align);
+static void emit_layout(FILE *outfile, layout *lo);
+static void emit_layout_hole(FILE *outfile, int hole);
+static void emit_layout_boundary(FILE *outfile, int line, int ago);
+static void emit_layout_summary(FILE *outfile, layout *lo);
+
+  /**
+   *  @fn layout *layout_new(xmlNodePtr node)
+   *
+   *  @brief computes layout of struct or union element in @p node
+   *
+   *  Field offsets are taken from the declarations.  Sizes and alignments
+   *  come from the @a size and @a align attributes when present, otherwise
+   *  the natural alignment of the field type is assumed.  Alignments from
+   *  the tuning file raise these when larger.
+   *
+   *  @param node - xmlNodePtr containing struct or union element
+   *
+   *  @return pointer to new @a layout struct on success
+   *          NULL on failure
+   */
+
+layout *layout_new(xmlNodePtr node)
+{
+  layout *lo = NULL;
+  layout_member *tmp;
+  layout_member *m;
+  xmlNodePtr child;
+  xmlNodePtr type;
+  char *s;
+
+  if (!node) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  lo = malloc(sizeof(layout));
+  if (!lo) goto exit;
+  memset(lo, 0, sizeof(layout));
+
+  lo->node = node;
+  lo->name = get_attribute(node, "name");
+  lo->is_union = !strcmp((char *)node->name, "union");
+  lo->size = layout_type_size(node);
+  lo->align = layout_type_align(node);
+  if (tuning_align(lo->name) * 8 > lo->align)
+    lo->align = tuning_align(lo->name) * 8;
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (strcmp((char *)child->name, "field")) continue;
+
+    type = field_type_node(child);
+    if (!type) continue;
+
+    tmp = realloc(lo->members, sizeof(layout_member) * (lo->n + 1));
+    if (!tmp) break;
+    lo->members = tmp;
+
+    m = &lo->members[lo->n];
+    memset(m, 0, sizeof(layout_member));
+
+    m->field = child;
+    m->name = get_attribute(child, "name");
+    m->type_name = type_string(type);
+
+    s = get_attribute(child, "offset");
+    if (s)
+    {
+      m->offset = atoi(s);
+      free(s);
+    }
+
+    m->size = layout_type_size(type);
+    m->bitfield = !strcmp((char *)type->name, "bitfield");
+    m->align = m->bitfield ? 1 : layout_type_align(type);
+
+      // inline string fields hold a heap pointer followed by their buffer
+
+    if (sso_size(lo->name, child))
+      m->size = round_up(m->size + sso_size(lo->name, child) * 8, m->align);
+    if (!m->bitfield &&
+        (tuning_field_align(lo->name, m->name) * 8 > m->align))
+      m->align = tuning_field_align(lo->name, m->name) * 8;
+
+    ++lo->n;
+  }
+
+exit:
+  return lo;
+}
+
+  /**
+   *  @fn void layout_free(layout *lo)
+   *
+   *  @brief frees all memory allocated to @p lo
+   *
+   *  @param lo - pointer to @a layout struct
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void layout_free(layout *lo)
+{
+  int i;
+
+  if (!lo) return;
+
+  for (i = 0; i < lo->n; i++)
+  {
+    if (lo->members[i].name) free(lo->members[i].name);
+    if (lo->members[i].type_name) free(lo->members[i].type_name);
+  }
+
+  if (lo->members) free(lo->members);
+  if (lo->name) free(lo->name);
+
+  free(lo);
+}
+
+  /**
+   *  @fn layout *layout_pack(layout *lo)
+   *
+   *  @brief creates a new @a layout with members of @p lo reordered to
+   *         minimize padding
+   *
+   *  Members are placed in order of decreasing alignment, then decreasing
+   *  size.  Runs of adjacent bitfields are kept together and placed on a
+   *  32 bit boundary, which matches the uint32_t bitfields emitted in the
+   *  generated header.
+   *
+   *  NOTE:  if reordering does not make the aggregate smaller, the members
+   *         are left in declared order.  Unions are never reordered.
+   *
+   *  @param lo - pointer to @a layout struct
+   *
+   *  @return pointer to new @a layout struct on success
+   *          NULL on failure
+   */
+
+layout *layout_pack(layout *lo)
+{
+  layout *packed = NULL;
+  int *unit_start = NULL;
+  int *unit_len = NULL;
+  int *unit_size = NULL;
+  int *unit_align = NULL;
+  int *order = NULL;
+  int *perm = NULL;
+  int *offsets = NULL;
+  int n_units = 0;
+  int offset = 0;
+  int size = 0;
+  int declared_size;
+  int i, j, k, t;
+
+  if (!lo) goto exit;
+
+  perm = malloc(sizeof(int) * (lo->n + 1));
+  offsets = malloc(sizeof(int) * (lo->n + 1));
+  unit_start = malloc(sizeof(int) * (lo->n + 1));
+  unit_len = malloc(sizeof(int) * (lo->n + 1));
+  unit_size = malloc(sizeof(int) * (lo->n + 1));
+  unit_align = malloc(sizeof(int) * (lo->n + 1));
+  order = malloc(sizeof(int) * (lo->n + 1));
+  if (!perm || !offsets || !unit_start || !unit_len || !unit_size ||
+      !unit_align || !order)
+    goto exit;
+
+  for (i = 0; i < lo->n; i++)
+  {
+    perm[i] = i;
+    offsets[i] = lo->members[i].offset;
+  }
+
+  size = lo->size;
+
+  if (lo->is_union || (lo->n < 2)) goto build;
+
+    // Gather members into placement units
+
+  for (i = 0; i < lo->n; i = j)
+  {
+    unit_start[n_units] = i;
+
+    if (lo->members[i].bitfield)
+    {
+      for (j = i, t = 0; (j < lo->n) && lo->members[j].bitfield; j++)
+      {
+        if ((t % 32) + lo->members[j].size > 32) t = round_up(t, 32);
+        t += lo->members[j].size;
+      }
+      unit_size[n_units] = round_up(t, 8);
+      unit_align[n_units] = 32;
+    }
+    else
+    {
+      j = i + 1;
+      unit_size[n_units] = lo->members[i].size;
+      unit_align[n_units] = lo->members[i].align ? lo->members[i].align : 8;
+    }
+
+    unit_len[n_units] = j - i;
+    order[n_units] = n_units;
+
+    ++n_units;
+  }
+
+    // Size of declared order under the same alignments, which differs from
+    // the declared size when the tuning file raises alignments
+
+  for (i = 0, offset = 0; i < n_units; i++)
+    offset = round_up(offset, unit_align[i]) + unit_size[i];
+
+  declared_size = round_up(offset, lo->align ? lo->align : 8);
+  offset = 0;
+
+    // Stable insertion sort, largest alignment first, then largest size
+
+  for (i = 1; i < n_units; i++)
+  {
+    t = order[i];
+
+    for (j = i - 1; j >= 0; j--)
+    {
+      if (unit_align[order[j]] > unit_align[t]) break;
+      if ((unit_align[order[j]] == unit_align[t]) &&
+          (unit_size[order[j]] >= unit_size[t]))
+        break;
+      order[j + 1] = order[j];
+    }
+
+    order[j + 1] = t;
+  }
+
+    // Place units, bitfields are laid out bit by bit inside their unit
+
+  for (i = 0, k = 0; i < n_units; i++)
+  {
+    t = order[i];
+    offset = round_up(offset, unit_align[t]);
+
+    for (j = unit_start[t], size = 0;
+         j < unit_start[t] + unit_len[t];
+         j++, k++)
+    {
+      if (lo->members[j].bitfield &&
+          ((size % 32) + lo->members[j].size > 32))
+        size = round_up(size, 32);
+
+      perm[k] = j;
+      offsets[k] = offset + size;
+      if (lo->members[j].bitfield) size += lo->members[j].size;
+    }
+
+    offset += unit_size[t];
+  }
+
+  size = round_up(offset, lo->align ? lo->align : 8);
+
+    // Keep declared order when reordering gains nothing
+
+  if (size >= declared_size)
+  {
+    for (i = 0; i < lo->n; i++)
+    {
+      perm[i] = i;
+      offsets[i] = lo->members[i].offset;
+    }
+
+    size = lo->size;
+  }
+
+build:
+  packed = malloc(sizeof(layout));
+  if (!packed) goto exit;
+  memcpy(packed, lo, sizeof(layout));
+
+  packed->name = lo->name ? strdup(lo->name) : NULL;
+  packed->size = size;
+  packed->members = NULL;
+
+  if (!lo->n) goto exit;
+
+  packed->members = malloc(sizeof(layout_member) * lo->n);
+  if (!packed->members)
+  {
+    packed->n = 0;
+    goto exit;
+  }
+
+  for (i = 0; i < lo->n; i++)
+  {
+    packed->members[i] = lo->members[perm[i]];
+    packed->members[i].offset = offsets[i];
+    if (lo->members[perm[i]].name)
+      packed->members[i].name = strdup(lo->members[perm[i]].name);
+    if (lo->members[perm[i]].type_name)
+      packed->members[i].type_name = strdup(lo->members[perm[i]].type_name);
+  }
+
+exit:
+  if (perm) free(perm);
+  if (offsets) free(offsets);
+  if (unit_start) free(unit_start);
+  if (unit_len) free(unit_len);
+  if (unit_size) free(unit_size);
+  if (unit_align) free(unit_align);
+  if (order) free(order);
+
+  return packed;
+}
+
+  /**
+   *  @fn int layout_hole_bits(layout *lo)
+   *
+   *  @brief returns total padding in @p lo, including trailing padding
+   *
+   *  @param lo - pointer to @a layout struct
+   *
+   *  @return number of padding bits
+   */
+
+int layout_hole_bits(layout *lo)
+{
+  int used = 0;
+  int i;
+
+  if (!lo) return 0;
+
+  for (i = 0; i < lo->n; i++)
+  {
+    if (lo->is_union)
+    {
+      if (lo->members[i].size > used) used = lo->members[i].size;
+    }
+    else
+      used += lo->members[i].size;
+  }
+
+  return lo->size > used ? lo->size - used : 0;
+}
+
+  /**
+   *  @fn int layout_type_size(xmlNodePtr node)
+   *
+   *  @brief returns size in bits of type element in @p node
+   *
+   *  NOTE:  type-reference elements are resolved against the enum, struct
+   *         and union declarations in the same document
+   *
+   *  @param node - xmlNodePtr containing a type element
+   *
+   *  @return size in bits on success
+   *          0 on failure
+   */
+
+int layout_type_size(xmlNodePtr node)
+{
+  xmlNodePtr decl;
+  char *s = NULL;
+  int size = 0;
+
+  if (!node) goto exit;
+
+  if (!strcmp((char *)node->name, "type-reference"))
+  {
+    s = get_attribute(node, "name");
+    decl = layout_find_declaration(node->doc, s);
+    if (decl) size = layout_type_size(decl);
+    goto exit;
+  }
+
+  s = get_attribute(node, "size");
+  if (s) size = atoi(s);
+
+exit:
+  if (s) free(s);
+
+  return size;
+}
+
+  /**
+   *  @fn int layout_type_align(xmlNodePtr node)
+   *
+   *  @brief returns required alignment in bits of type element in @p node
+   *
+   *  Uses the @a align attribute when the declarations carry one, otherwise
+   *  scalars, pointers and enums are aligned to their size, arrays to their
+   *  element type and aggregates to their most aligned field.
+   *
+   *  @param node - xmlNodePtr containing a type element
+   *
+   *  @return alignment in bits on success
+   *          8 if alignment can not be determined
+   */
+
+int layout_type_align(xmlNodePtr node)
+{
+  xmlNodePtr child;
+  xmlNodePtr decl;
+  char *s = NULL;
+  int align = 0;
+  int a;
+
+  if (!node) goto exit;
+
+  s = get_attribute(node, "align");
+  if (s)
+  {
+    align = atoi(s);
+    goto exit;
+  }
+
+  if (!strcmp((char *)node->name, "scalar") ||
+      !strcmp((char *)node->name, "pointer") ||
+      !strcmp((char *)node->name, "enum"))
+    align = layout_type_size(node);
+  else if (!strcmp((char *)node->name, "bitfield"))
+    align = 1;
+  else if (!strcmp((char *)node->name, "array"))
+  {
+    for (child = node->children; child; child = child->next)
+    {
+      if (child->type != XML_ELEMENT_NODE) continue;
+      align = layout_type_align(child);
+      break;
+    }
+  }
+  else if (!strcmp((char *)node->name, "type-reference"))
+  {
+    s = get_attribute(node, "name");
+    decl = layout_find_declaration(node->doc, s);
+    if (decl) align = layout_type_align(decl);
+  }
+  else if (!strcmp((char *)node->name, "struct") ||
+           !strcmp((char *)node->name, "union"))
+  {
+    for (child = node->children; child; child = child->next)
+    {
+      if (strcmp((char *)child->name, "field")) continue;
+      a = layout_type_align(field_type_node(child));
+      if (a > align) align = a;
+    }
+  }
+
+exit:
+  if (s) free(s);
+
+  return align > 8 ? align : 8;
+}
+
+  /**
+   *  @fn xmlNodePtr layout_find_declaration(xmlDocPtr doc, char *name)
+   *
+   *  @brief locates top level enum, struct or union named @p name in @p doc
+   *
+   *  @param doc - xmlDocPtr containing declarations
+   *  @param name - string containing name of declaration
+   *
+   *  @return xmlNodePtr containing declaration on success
+   *          NULL on failure
+   */
+
+xmlNodePtr layout_find_declaration(xmlDocPtr doc, char *name)
+{
+  xmlNodePtr root;
+  xmlNodePtr node;
+  xmlNodePtr found = NULL;
+  char *s;
+
+  if (!doc || !name) goto exit;
+
+  root = xmlDocGetRootElement(doc);
+  if (!root) goto exit;
+
+  for (node = root->children; node && !found; node = node->next)
+  {
+    if (strcmp((char *)node->name, "enum") &&
+        strcmp((char *)node->name, "struct") &&
+        strcmp((char *)node->name, "union"))
+      continue;
+
+    s = get_attribute(node, "name");
+    if (!s) continue;
+
+    if (!strcmp(s, name)) found = node;
+
+    free(s);
+  }
+
+exit:
+  return found;
+}
+
+  /**
+   *  @fn void gen_layout_report(xmlDocPtr doc, FILE *outfile)
+   *
+   *  @brief writes layout report for every struct and union in @p doc
+   *
+   *  For each aggregate the report lists field offsets and sizes, padding
+   *  holes, cache line boundaries and fields that straddle them.  When a
+   *  different field order would make the aggregate smaller, the suggested
+   *  order follows.
+   *
+   *  @param doc - xmlDocPtr containing declarations
+   *  @param outfile - open FILE * for writing
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void gen_layout_report(xmlDocPtr doc, FILE *outfile)
+{
+  xmlNodePtr root;
+  xmlNodePtr node;
+  layout *lo = NULL;
+  layout *packed = NULL;
+
+  if (!doc || !outfile) goto exit;
+
+  root = xmlDocGetRootElement(doc);
+  if (!root) goto exit;
+
+  if (strcmp((char *)root->name, "c-decls")) goto exit;
+
+  for (node = root->children; node; node = node->next)
+  {
+    lo = layout_new(node);
+    if (!lo) continue;
+
+    emit_layout(outfile, lo);
+
+    packed = layout_pack(lo);
+    if (packed && (packed->size < lo->size))
+    {
+      fprintf(outfile,
+              "  /* suggested reordering saves %d bytes: */\n\n",
+              (lo->size - packed->size) / 8);
+      emit_layout(outfile, packed);
+    }
+
+    layout_free(packed);
+    layout_free(lo);
+    packed = lo = NULL;
+  }
+
+exit:
+}
+
+  /**
+   *  @fn static xmlNodePtr field_type_node(xmlNodePtr field)
+   *
+   *  @brief returns type element of field element in @p field
+   *
+   *  @param field - xmlNodePtr containing field element
+   *
+   *  @return xmlNodePtr containing type element on success
+   *          NULL on failure
+   */
+
+static xmlNodePtr field_type_node(xmlNodePtr field)
+{
+  xmlNodePtr child = NULL;
+
+  if (!field) goto exit;
+
+  for (child = field->children; child; child = child->next)
+  {
+    if (child->type == XML_ELEMENT_NODE) break;
+  }
+
+exit:
+  return child;
+}
+
+  /**
+   *  @fn static char *type_string(xmlNodePtr node)
+   *
+   *  @brief creates printable C type name from type element in @p node
+   *
+   *  NOTE:  the caller is responsible for freeing the returned string
+   *
+   *  @param node - xmlNodePtr containing a type element
+   *
+   *  @return string containing type name on success
+   *          NULL on failure
+   */
+
+static char *type_string(xmlNodePtr node)
+{
+  xmlNodePtr child;
+  char *type = NULL;
+  char *dims = NULL;
+  char *s = NULL;
+
+  if (!node) goto exit;
+
+  if (!strcmp((char *)node->name, "scalar"))
+    type = get_attribute(node, "type-name");
+  else if (!strcmp((char *)node->name, "bitfield"))
+    type = strdup("uint32_t");
+  else if (!strcmp((char *)node->name, "void"))
+    type = strdup("void");
+  else if (!strcmp((char *)node->name, "function"))
+    type = strdup("void (*)()");
+  else if (!strcmp((char *)node->name, "type-reference"))
+  {
+    type = get_attribute(node, "type");
+    type = strapp(type, " ");
+    s = get_attribute(node, "name");
+    type = strapp(type, s);
+  }
+  else if (!strcmp((char *)node->name, "pointer") ||
+           !strcmp((char *)node->name, "array"))
+  {
+    for (child = node->children; child; child = child->next)
+    {
+      if (child->type != XML_ELEMENT_NODE) continue;
+      type = type_string(child);
+      break;
+    }
+
+    if (!strcmp((char *)node->name, "pointer"))
+      type = strapp(type, (type && type[strlen(type) - 1] == '*') ? "*" : " *");
+    else
+    {
+        // the outer dimension comes first, ie. int[2][3]
+
+      s = get_attribute(node, "n-elements");
+      dims = strdup((type && strchr(type, '[')) ? strchr(type, '[') : "");
+      if (type && strchr(type, '[')) *strchr(type, '[') = '\0';
+      type = strapp(type, "[");
+      type = strapp(type, s ? s : "");
+      type = strapp(type, "]");
+      type = strapp(type, dims);
+    }
+  }
+  else
+  {
+    type = strapp(type, (char *)node->name);
+    type = strapp(type, " {...}");
+  }
+
+exit:
+  if (dims) free(dims);
+  if (s) free(s);
+
+  return type;
+}
+
+  /**
+   *  @fn static int round_up(int value, int align)
+   *
+   *  @brief rounds @p value up to next multiple of @p align
+   *
+   *  @param value - value to round
+   *  @param align - alignment, must be greater than zero
+   *
+   *  @return rounded value
+   */
+
+static int round_up(int value, int align)
+{
+  if (align <= 0) return value;
+
+  return ((value + align - 1) / align) * align;
+}
+
+  /**
+   *  @fn static void emit_layout(FILE *outfile, layout *lo)
+   *
+   *  @brief writes pahole style listing of @p lo to @p outfile
+   *
+   *  NOTE:  a cache line boundary is marked where it falls, a hole crossing
+   *         one is split around the marker, and a member crossing one is
+   *         followed by the marker, saying how many bytes ago it was
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param lo - pointer to @a layout struct
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_layout(FILE *outfile, layout *lo)
+{
+  layout_member *m;
+  char *type;
+  char *dims;
+  int type_width = 0;
+  int name_width = 0;
+  int end = 0;
+  int line = 0;
+  int boundary;
+  int next;
+  int first_line, last_line;
+  int i, w;
+
+  if (!outfile || !lo) goto exit;
+
+  for (i = 0; i < lo->n; i++)
+  {
+    m = &lo->members[i];
+
+      // array dimensions follow the name, as in a declaration
+
+    type = m->type_name ? m->type_name : "";
+    dims = strchr(type, '[');
+
+    w = dims ? dims - type : strlen(type);
+    if (w > type_width) type_width = w;
+
+    w = (m->name ? strlen(m->name) : 0) + 1;
+    if (dims) w += strlen(dims);
+    if (m->bitfield) w += 4;
+    if (w > name_width) name_width = w;
+  }
+
+  fprintf(outfile,
+          "%s %s\n{\n",
+          lo->is_union ? "union" : "struct",
+          lo->name ? lo->name : "");
+
+  for (i = 0; i < lo->n; i++)
+  {
+    m = &lo->members[i];
+
+      // Holes between end of previous member and this one, split at the
+      // cache line boundaries they cross
+
+    while (!lo->is_union && (m->offset > end))
+    {
+      boundary = (line + 1) * LAYOUT_CACHE_LINE * 8;
+      next = ((boundary > end) && (boundary < m->offset)) ? boundary
+                                                          : m->offset;
+
+      emit_layout_hole(outfile, next - end);
+      end = next;
+
+      if (end == boundary) emit_layout_boundary(outfile, ++line, 0);
+    }
+
+      // Cache line boundaries at the start of this member
+
+    while ((line + 1) * LAYOUT_CACHE_LINE * 8 <= m->offset)
+      emit_layout_boundary(outfile, ++line, 0);
+
+    first_line = m->offset / 8 / LAYOUT_CACHE_LINE;
+    last_line = m->size ? (m->offset + m->size - 1) / 8 / LAYOUT_CACHE_LINE
+                        : first_line;
+
+    type = m->type_name ? m->type_name : "";
+    dims = strchr(type, '[');
+
+    fprintf(outfile,
+            "  %-*.*s ",
+            type_width,
+            dims ? (int)(dims - type) : (int)strlen(type),
+            type);
+
+    if (m->bitfield)
+    {
+      w = fprintf(outfile, "%s:%d;", m->name ? m->name : "", m->size);
+      fprintf(outfile,
+              "%*s/* %5d:%-2d %4d bits",
+              name_width + 4 - w,
+              "",
+              m->offset / 8,
+              m->offset % 8,
+              m->size);
+    }
+    else
+    {
+      w = fprintf(outfile,
+                  "%s%s;",
+                  m->name ? m->name : "",
+                  dims ? dims : "");
+      fprintf(outfile,
+              "%*s/* %5d    %4d",
+              name_width + 4 - w,
+              "",
+              m->offset / 8,
+              m->size / 8);
+    }
+
+    if ((last_line != first_line) && (m->size <= LAYOUT_CACHE_LINE * 8))
+      fprintf(outfile, ", straddles cacheline %d */\n", last_line);
+    else
+      fprintf(outfile, " */\n");
+
+    if (m->offset + m->size > end) end = m->offset + m->size;
+
+      // Cache line boundaries inside this member
+
+    while ((line + 1) * LAYOUT_CACHE_LINE * 8 < end)
+    {
+      boundary = (line + 1) * LAYOUT_CACHE_LINE * 8;
+      emit_layout_boundary(outfile, ++line, (end - boundary) / 8);
+    }
+  }
+
+  fprintf(outfile, "\n");
+
+  emit_layout_summary(outfile, lo);
+
+  fprintf(outfile, "};\n\n");
+
+exit:
+}
+
+  /**
+   *  @fn static void emit_layout_hole(FILE *outfile, int hole)
+   *
+   *  @brief writes pahole style note of a hole of @p hole bits
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param hole - size of hole in bits
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_layout_hole(FILE *outfile, int hole)
+{
+  if (hole >= 8)
+    fprintf(outfile,
+            "\n  /* XXX %d byte%s hole, try to pack */\n\n",
+            hole / 8,
+            hole / 8 == 1 ? "" : "s");
+  if (hole % 8)
+    fprintf(outfile,
+            "\n  /* XXX %d bit%s hole, try to pack */\n\n",
+            hole % 8,
+            hole % 8 == 1 ? "" : "s");
+}
+
+  /**
+   *  @fn static void emit_layout_boundary(FILE *outfile, int line, int ago)
+   *
+   *  @brief writes pahole style marker of the start of cache line @p line
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param line - number of cache line starting at boundary
+   *  @param ago - bytes written since boundary, 0 if marker is at boundary
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_layout_boundary(FILE *outfile, int line, int ago)
+{
+  fprintf(outfile,
+          "  /* --- cacheline %d boundary (%d bytes)",
+          line,
+          line * LAYOUT_CACHE_LINE);
+
+  if (ago) fprintf(outfile, " was %d byte%s ago", ago, ago == 1 ? "" : "s");
+
+  fprintf(outfile, " --- */\n");
+}
+
+  /**
+   *  @fn static void emit_layout_summary(FILE *outfile, layout *lo)
+   *
+   *  @brief writes size, hole and cache line totals of @p lo to @p outfile
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param lo - pointer to @a layout struct
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_layout_summary(FILE *outfile, layout *lo)
+{
+  layout_member *m;
+  int sum_members = 0;
+  int n_holes = 0;
+  int sum_holes = 0;
+  int n_straddles = 0;
+  int end = 0;
+  int padding;
+  int bytes;
+  int i;
+
+  if (!outfile || !lo) return;
+
+  for (i = 0; i < lo->n; i++)
+  {
+    m = &lo->members[i];
+
+    sum_members += m->size;
+
+    if (!lo->is_union && (m->offset > end))
+    {
+      ++n_holes;
+      sum_holes += m->offset - end;
+    }
+
+    if (m->size && (m->size <= LAYOUT_CACHE_LINE * 8) &&
+        ((m->offset / 8 / LAYOUT_CACHE_LINE) !=
+         ((m->offset + m->size - 1) / 8 / LAYOUT_CACHE_LINE)))
+      ++n_straddles;
+
+    if (m->offset + m->size > end) end = m->offset + m->size;
+  }
+
+  padding = lo->size > end ? lo->size - end : 0;
+  bytes = lo->size / 8;
+
+  fprintf(outfile,
+          "  /* size: %d, cachelines: %d, members: %d */\n",
+          bytes,
+          (bytes + LAYOUT_CACHE_LINE - 1) / LAYOUT_CACHE_LINE,
+          lo->n);
+
+  if (lo->is_union)
+    fprintf(outfile, "  /* largest member: %d */\n", end / 8);
+  else
+    fprintf(outfile,
+            "  /* sum members: %d%s, holes: %d, sum holes: %d%s */\n",
+            sum_members / 8,
+            sum_members % 8 ? "+" : "",
+            n_holes,
+            sum_holes / 8,
+            sum_holes % 8 ? "+" : "");
+
+  if (padding)
+    fprintf(outfile, "  /* padding: %d */\n", padding / 8);
+
+  if (n_straddles)
+    fprintf(outfile, "  /* fields straddling cachelines: %d */\n", n_straddles);
+
+  if (bytes % LAYOUT_CACHE_LINE)
+    fprintf(outfile,
+            "  /* last cacheline: %d bytes */\n",
+            bytes % LAYOUT_CACHE_LINE);
+}
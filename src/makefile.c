@@ -37,21 +37,36 @@
 #include "config.h"
 
 #include "makefile.h"
+#include "header-concurrent.h"
+#include "source.h"
 #include "options.h"
 
   /*  Module specific function prototypes  */
 
 static void emit_blank(FILE *outfile);
 static void emit_options(FILE *outfile);
+static void emit_build_options(FILE *outfile);
 static void emit_install_dir(FILE *outfile);
+static void emit_objects(FILE *outfile, char *project_name);
 static void emit_all(FILE *outfile, char *project_name);
 static void emit_doxygen(FILE *outfile, char *project_name);
 static void emit_library(FILE *outfile, char *project_name);
+static void emit_shared(FILE *outfile, char *project_name);
 static void emit_object(FILE *outfile, char *project_name);
+static void emit_lto(FILE *outfile, char *project_name);
+static void emit_pgo(FILE *outfile, char *project_name);
 static void emit_clean(FILE *outfile, char *project_name);
 static void emit_install(FILE *outfile, char *project_name);
 static void emit_uninstall(FILE *outfile, char *project_name);
 
+  /*  Number of split source files, 0 if source is not split  */
+
+static int split_files = 0;
+
+  /*  Object files of library, as listed in rules  */
+
+static char *objects = NULL;
+
 /**
  *  @fn void gen_makefile(xmlDocPtr doc, char *base_name)
  *
@@ -100,16 +115,35 @@ void gen_makefile(xmlDocPtr doc, char *base_name)
   project_name = get_project_name(base_name);
   if (!project_name) goto exit;
 
+  split_files = source_split_files(root);
+
+  if (split_files)
+    objects = strapp(objects, "$(OBJS)");
+  else
+  {
+    objects = strapp(objects, project_name);
+    objects = strapp(objects, ".o");
+  }
+  if (!objects) goto exit;
+
   emit_options(outfile);
+  emit_build_options(outfile);
   emit_install_dir(outfile);
+  emit_objects(outfile, project_name);
   emit_blank(outfile);
   emit_all(outfile, project_name);
   emit_blank(outfile);
   emit_doxygen(outfile, project_name);
   emit_library(outfile, project_name);
   emit_blank(outfile);
+  emit_shared(outfile, project_name);
+  emit_blank(outfile);
   emit_object(outfile, project_name);
   emit_blank(outfile);
+  emit_lto(outfile, project_name);
+  emit_blank(outfile);
+  emit_pgo(outfile, project_name);
+  emit_blank(outfile);
   emit_clean(outfile, project_name);
   emit_blank(outfile);
   emit_install(outfile, project_name);
@@ -121,6 +155,8 @@ exit:
   if (outfile_name) free(outfile_name);
   if (project_name) free(project_name);
   if (base_dir) free(base_dir);
+  if (objects) free(objects);
+  objects = NULL;
 }
 
 /**
@@ -145,6 +181,8 @@ void emit_blank(FILE *outfile)
  *  @brief adds 'CC = compiler'
  *         and  'COPTS = compiler options' line to makefile
  *
+ *  NOTE:  -pthread is appended to COPTS if any container is concurrent
+ *
  *  @param outfile - FILE * open for writing
  *
  *  @par Returns
@@ -154,7 +192,31 @@ void emit_blank(FILE *outfile)
 void emit_options(FILE *outfile)
 {
   fprintf(outfile, "CC = %s\n", option_makefile_cc());
-  fprintf(outfile, "COPTS = %s\n", option_makefile_copts());
+  fprintf(outfile,
+          "COPTS = %s%s\n",
+          option_makefile_copts(),
+          concurrent_any() ? " -pthread" : "");
+}
+
+/**
+ *  @fn void emit_build_options(FILE *outfile)
+ *
+ *  @brief adds 'LTO = link time optimization options'
+ *         and  'PGO_DIR = profile directory' lines to makefile
+ *
+ *  NOTE:  fat LTO objects keep the static library usable by builds that do
+ *         not use -flto themselves
+ *
+ *  @param outfile - FILE * open for writing
+ *
+ *  @par Returns
+ *  Nothing.
+ */
+
+void emit_build_options(FILE *outfile)
+{
+  fprintf(outfile, "LTO = -flto -ffat-lto-objects\n");
+  fprintf(outfile, "PGO_DIR = pgo\n");
 }
 
 /**
@@ -173,6 +235,35 @@ void emit_install_dir(FILE *outfile)
   fprintf(outfile, "INSTALL_DIR = %s\n", option_makefile_install_dir());
 }
 
+/**
+ *  @fn void emit_objects(FILE *outfile, char *project_name)
+ *
+ *  @brief adds 'OBJS = object files' line to makefile, one object for
+ *         every split source file, so make -j compiles them in parallel
+ *
+ *  NOTE:  nothing is added if source is not split
+ *
+ *  @param outfile - FILE * open for writing
+ *  @param project_name - string containing name of project for rule names
+ *
+ *  @par Returns
+ *  Nothing.
+ */
+
+void emit_objects(FILE *outfile, char *project_name)
+{
+  int i;
+
+  if (!split_files) return;
+
+  fprintf(outfile, "OBJS = %s.o", project_name);
+
+  for (i = 1; i <= split_files; i++)
+    fprintf(outfile, " \\\n       %s-%d.o", project_name, i);
+
+  fprintf(outfile, "\n");
+}
+
 /**
  *  @fn void emit_all(FILE *outfile, char *project_name);
  *
@@ -227,10 +318,47 @@ void emit_doxygen(FILE *outfile, char *project_name)
 
 void emit_library(FILE *outfile, char *project_name)
 {
-  fprintf(outfile, "lib%s.a: %s.o\n", project_name, project_name);
+  fprintf(outfile, "lib%s.a: %s\n", project_name, objects);
   fprintf(outfile, "\t@echo Creating lib%s.a\n", project_name);
   fprintf(outfile,
-          "\t@ar r lib%s.a %s.o 2> /dev/null\n",
+          "\t@ar r lib%s.a %s 2> /dev/null\n",
+          project_name,
+          objects);
+}
+
+/**
+ *  @fn void emit_shared(FILE *outfile, char *project_name)
+ *
+ *  @brief adds target rule to create a shared (.so) library
+ *
+ *  @param outfile - FILE * open for writing
+ *  @param project_name - string containing name of project for rule names
+ *
+ *  @par Returns
+ *  Nothing.
+ */
+
+void emit_shared(FILE *outfile, char *project_name)
+{
+  if (split_files)
+  {
+    fprintf(outfile, "lib%s.so: $(OBJS:.o=.c) %s.h\n",
+            project_name,
+            project_name);
+    fprintf(outfile, "\t@echo Creating lib%s.so\n", project_name);
+    fprintf(outfile,
+            "\t@$(CC) $(COPTS) -fPIC -shared -o lib%s.so $(OBJS:.o=.c)\n",
+            project_name);
+    return;
+  }
+
+  fprintf(outfile, "lib%s.so: %s.c %s.h\n",
+          project_name,
+          project_name,
+          project_name);
+  fprintf(outfile, "\t@echo Creating lib%s.so\n", project_name);
+  fprintf(outfile,
+          "\t@$(CC) $(COPTS) -fPIC -shared -o lib%s.so %s.c\n",
           project_name,
           project_name);
 }
@@ -238,7 +366,8 @@ void emit_library(FILE *outfile, char *project_name)
 /**
  *  @fn void emit_object(FILE *outfile, char *project_name)
  *
- *  @brief adds target rule to object (.o)
+ *  @brief adds target rule to object (.o), or a pattern rule for the
+ *         objects of split source files
  *
  *  @param outfile - FILE * open for writing
  *  @param project_name - string containing name of project for rule names
@@ -249,6 +378,14 @@ void emit_library(FILE *outfile, char *project_name)
 
 void emit_object(FILE *outfile, char *project_name)
 {
+  if (split_files)
+  {
+    fprintf(outfile, "%%.o: %%.c %s.h\n", project_name);
+    fprintf(outfile, "\t@echo Creating $@\n");
+    fprintf(outfile, "\t@$(CC) $(COPTS) -c $<\n");
+    return;
+  }
+
   fprintf(outfile, "%s.o: %s.c %s.h\n",
           project_name,
           project_name,
@@ -257,6 +394,75 @@ void emit_object(FILE *outfile, char *project_name)
   fprintf(outfile, "\t@$(CC) $(COPTS) -c %s.c\n", project_name);
 }
 
+/**
+ *  @fn void emit_lto(FILE *outfile, char *project_name)
+ *
+ *  @brief adds target rule to rebuild static and shared libraries with link
+ *         time optimization
+ *
+ *  @param outfile - FILE * open for writing
+ *  @param project_name - string containing name of project for rule names
+ *
+ *  @par Returns
+ *  Nothing.
+ */
+
+void emit_lto(FILE *outfile, char *project_name)
+{
+  fprintf(outfile, "lto:\n");
+  fprintf(outfile,
+          "\t@rm -f %s lib%s.a lib%s.so\n",
+          objects,
+          project_name,
+          project_name);
+  fprintf(outfile,
+          "\t@$(MAKE) --no-print-directory COPTS=\"$(COPTS) $(LTO)\""
+          " lib%s.a lib%s.so\n",
+          project_name,
+          project_name);
+}
+
+/**
+ *  @fn void emit_pgo(FILE *outfile, char *project_name)
+ *
+ *  @brief adds target rules to build an instrumented static library
+ *         (pgo-gen) and to rebuild it from the recorded profile (pgo-use)
+ *
+ *  NOTE:  a training program linked with the pgo-gen library, and with
+ *         -fprofile-generate itself, writes the profile to $(PGO_DIR) when
+ *         it exits
+ *
+ *  @param outfile - FILE * open for writing
+ *  @param project_name - string containing name of project for rule names
+ *
+ *  @par Returns
+ *  Nothing.
+ */
+
+void emit_pgo(FILE *outfile, char *project_name)
+{
+  fprintf(outfile, "pgo-gen:\n");
+  fprintf(outfile,
+          "\t@rm -f %s lib%s.a\n",
+          objects,
+          project_name);
+  fprintf(outfile,
+          "\t@$(MAKE) --no-print-directory"
+          " COPTS=\"$(COPTS) -fprofile-generate=$(PGO_DIR)\" lib%s.a\n",
+          project_name);
+  fprintf(outfile, "\n");
+  fprintf(outfile, "pgo-use:\n");
+  fprintf(outfile,
+          "\t@rm -f %s lib%s.a\n",
+          objects,
+          project_name);
+  fprintf(outfile,
+          "\t@$(MAKE) --no-print-directory"
+          " COPTS=\"$(COPTS) -fprofile-use=$(PGO_DIR) -fprofile-correction\""
+          " lib%s.a\n",
+          project_name);
+}
+
 /**
  *  @fn void emit_clean(FILE *outfile, char *project_name)
  *
@@ -272,10 +478,11 @@ void emit_object(FILE *outfile, char *project_name)
 void emit_clean(FILE *outfile, char *project_name)
 {
   fprintf(outfile, "clean:\n");
-	fprintf(outfile, "\t@rm -f %s.o lib%s.a\n",
+	fprintf(outfile, "\t@rm -f %s lib%s.a lib%s.so\n",
+          objects,
           project_name,
           project_name);
-	fprintf(outfile, "\t@rm -rf doxygen\n");
+	fprintf(outfile, "\t@rm -rf doxygen $(PGO_DIR)\n");
 }
 
 /**
@@ -298,6 +505,10 @@ void emit_install(FILE *outfile, char *project_name)
           project_name,
           project_name);
   fprintf(outfile, "\t@cp lib%s.a $(INSTALL_DIR)/lib\n", project_name);
+  fprintf(outfile,
+          "\t@if [ -f lib%s.so ]; then cp lib%s.so $(INSTALL_DIR)/lib; fi\n",
+          project_name,
+          project_name);
   fprintf(outfile, "\t@cp %s.h $(INSTALL_DIR)/include\n", project_name);
 }
 
@@ -323,6 +534,9 @@ void emit_uninstall(FILE *outfile, char *project_name)
   fprintf(outfile,
           "\t@rm $(INSTALL_DIR)/lib/lib%s.a\n",
           project_name);
+  fprintf(outfile,
+          "\t@rm -f $(INSTALL_DIR)/lib/lib%s.so\n",
+          project_name);
   fprintf(outfile,
           "\t@rm $(INSTALL_DIR)/include/%s.h\n",
           project_name);
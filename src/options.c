@@ -90,6 +90,35 @@ void option_set_license(char *type)
    *                       array
    *                       list
    *                       avl
+   *                       serialize
+   *                       flat
+   *                       mmap, which implies array and flat
+   *                       delimited
+   *                       json
+   *                       hash
+   *                       ring
+   *                       shardmap
+   *                       parallel
+   *                       heap
+   *                       bitmap, which implies array
+   *                       skiplist
+   *
+   *                       array, list and avl accept a ":concurrent"
+   *                       suffix, ie. "avl:concurrent", for thread-safe
+   *                       functions guarded by an embedded rwlock
+   *
+   *                       avl also accepts ":persistent", ie.
+   *                       "avl:concurrent:persistent", for a copy-on-write
+   *                       avl read through snapshots
+   *
+   *                       shardmap takes its key field as a ":key=<field>"
+   *                       suffix, ie. "shardmap:key=id"
+   *
+   *                       heap takes its key field the same way, followed
+   *                       by ":max" for a max-heap, ie. "heap:key=due:max"
+   *
+   *                       skiplist takes its key field the same way, ie.
+   *                       "skiplist:key=id"
    *
    *  @par Returns
    *       Nothing.
@@ -98,18 +127,105 @@ void option_set_license(char *type)
 void option_set_generator_options(char *generators)
 {
   char *opt = NULL;
+  char *suffix = NULL;
+  char *order = NULL;
+  char *next = NULL;
 
   option_gen_array_off();
   option_gen_list_off();
   option_gen_avl_off();
+  option_concurrent_array_off();
+  option_concurrent_list_off();
+  option_concurrent_avl_off();
+  option_persistent_avl_off();
+  option_gen_serialize_off();
+  option_gen_flat_off();
+  option_gen_mmap_off();
+  option_gen_delimited_off();
+  option_gen_json_off();
+  option_gen_hash_off();
+  option_gen_ring_off();
+  option_gen_shardmap_off();
+  option_set_shardmap_key(NULL);
+  option_gen_parallel_off();
+  option_gen_heap_off();
+  option_set_heap_key(NULL);
+  option_heap_max_off();
+  option_gen_bitmap_off();
+  option_gen_skiplist_off();
+  option_set_skiplist_key(NULL);
 
   if (!generators) return;
 
   for (opt = strtok(generators, ","); opt; opt = strtok(NULL, ","))
   {
-    if (!strcasecmp(opt, "array")) option_gen_array_on();
-    else if (!strcasecmp(opt, "list")) option_gen_list_on();
-    else if (!strcasecmp(opt, "avl")) option_gen_avl_on();
+    suffix = strchr(opt, ':');
+    if (suffix) *suffix++ = '\0';
+
+    if (!strcasecmp(opt, "array"))
+    {
+      option_gen_array_on();
+      if (suffix && !strcasecmp(suffix, "concurrent"))
+        option_concurrent_array_on();
+    }
+    else if (!strcasecmp(opt, "list"))
+    {
+      option_gen_list_on();
+      if (suffix && !strcasecmp(suffix, "concurrent"))
+        option_concurrent_list_on();
+    }
+    else if (!strcasecmp(opt, "avl"))
+    {
+      option_gen_avl_on();
+      for (; suffix; suffix = next)
+      {
+        next = strchr(suffix, ':');
+        if (next) *next++ = '\0';
+        if (!strcasecmp(suffix, "concurrent")) option_concurrent_avl_on();
+        else if (!strcasecmp(suffix, "persistent")) option_persistent_avl_on();
+      }
+    }
+    else if (!strcasecmp(opt, "serialize")) option_gen_serialize_on();
+    else if (!strcasecmp(opt, "flat")) option_gen_flat_on();
+    else if (!strcasecmp(opt, "mmap"))
+    {
+      option_gen_array_on();
+      option_gen_flat_on();
+      option_gen_mmap_on();
+    }
+    else if (!strcasecmp(opt, "delimited")) option_gen_delimited_on();
+    else if (!strcasecmp(opt, "json")) option_gen_json_on();
+    else if (!strcasecmp(opt, "hash")) option_gen_hash_on();
+    else if (!strcasecmp(opt, "ring")) option_gen_ring_on();
+    else if (!strcasecmp(opt, "shardmap"))
+    {
+      option_gen_shardmap_on();
+      if (suffix && !strncasecmp(suffix, "key=", 4))
+        option_set_shardmap_key(suffix + 4);
+    }
+    else if (!strcasecmp(opt, "parallel")) option_gen_parallel_on();
+    else if (!strcasecmp(opt, "heap"))
+    {
+      option_gen_heap_on();
+      if (suffix && !strncasecmp(suffix, "key=", 4))
+      {
+        order = strchr(suffix, ':');
+        if (order) *order++ = '\0';
+        if (order && !strcasecmp(order, "max")) option_heap_max_on();
+        option_set_heap_key(suffix + 4);
+      }
+    }
+    else if (!strcasecmp(opt, "bitmap"))
+    {
+      option_gen_array_on();
+      option_gen_bitmap_on();
+    }
+    else if (!strcasecmp(opt, "skiplist"))
+    {
+      option_gen_skiplist_on();
+      if (suffix && !strncasecmp(suffix, "key=", 4))
+        option_set_skiplist_key(suffix + 4);
+    }
   }
 }
 
@@ -355,23 +471,23 @@ void option_gen_avl_on(void) { _gen_avl = true; }
 
 void option_gen_avl_off(void) { _gen_avl = false; }
 
-static bool _gen_readme = false;
+static bool _gen_serialize = false;
 
   /**
-   *  @fn bool option_gen_readme(void)
-   *  @brief  returns gen readme setting
+   *  @fn bool option_gen_serialize(void)
+   *  @brief  returns gen serialize setting
    *
    *  @par Parameters
    *       None.
    *
-   *  @return current readme generation setting
+   *  @return current serializer generation setting
    */
 
-bool option_gen_readme(void) { return _gen_readme; }
+bool option_gen_serialize(void) { return _gen_serialize; }
 
   /**
-   *  @fn void option_gen_readme_on(void)
-   *  @brief  turns readme generation on
+   *  @fn void option_gen_serialize_on(void)
+   *  @brief  turns serializer generation on
    *
    *  @par Parameters
    *       None.
@@ -380,11 +496,11 @@ bool option_gen_readme(void) { return _gen_readme; }
    *       Nothing.
    */
 
-void option_gen_readme_on(void) { _gen_readme = true; }
+void option_gen_serialize_on(void) { _gen_serialize = true; }
 
   /**
-   *  @fn void option_gen_readme_off(void)
-   *  @brief  turns readme generation off
+   *  @fn void option_gen_serialize_off(void)
+   *  @brief  turns serializer generation off
    *
    *  @par Parameters
    *       None.
@@ -393,25 +509,25 @@ void option_gen_readme_on(void) { _gen_readme = true; }
    *       Nothing.
    */
 
-void option_gen_readme_off(void) { _gen_readme = false; }
+void option_gen_serialize_off(void) { _gen_serialize = false; }
 
-static bool _assume_typedefs = false;
+static bool _gen_flat = false;
 
   /**
-   *  @fn bool option_assume_typedefs(void)
-   *  @brief  returns gen readme setting
+   *  @fn bool option_gen_flat(void)
+   *  @brief  returns gen flat setting
    *
    *  @par Parameters
    *       None.
    *
-   *  @return current readme generation setting
+   *  @return current flat view generation setting
    */
 
-bool option_assume_typedefs(void) { return _assume_typedefs; }
+bool option_gen_flat(void) { return _gen_flat; }
 
   /**
-   *  @fn void option_assume_typedefs_on(void)
-   *  @brief  turns readme generation on
+   *  @fn void option_gen_flat_on(void)
+   *  @brief  turns flat view generation on
    *
    *  @par Parameters
    *       None.
@@ -420,11 +536,11 @@ bool option_assume_typedefs(void) { return _assume_typedefs; }
    *       Nothing.
    */
 
-void option_assume_typedefs_on(void) { _assume_typedefs = true; }
+void option_gen_flat_on(void) { _gen_flat = true; }
 
   /**
-   *  @fn void option_assume_typedefs_off(void)
-   *  @brief  turns readme generation off
+   *  @fn void option_gen_flat_off(void)
+   *  @brief  turns flat view generation off
    *
    *  @par Parameters
    *       None.
@@ -433,116 +549,145 @@ void option_assume_typedefs_on(void) { _assume_typedefs = true; }
    *       Nothing.
    */
 
-void option_assume_typedefs_off(void) { _assume_typedefs = false; }
+void option_gen_flat_off(void) { _gen_flat = false; }
 
-char **_include_files = NULL;
-unsigned _n_include_files = 0;
-unsigned _curr_include_file = 0;
+static bool _gen_mmap = false;
 
   /**
-   *  @fn void option_set_includes(char *inc_list);
-   *  @brief  sets list of include files to be emitted in header
+   *  @fn bool option_gen_mmap(void)
+   *  @brief  returns gen mmap setting
    *
-   *  @param inc_list - ':' separated list of include file names
+   *  @par Parameters
+   *       None.
+   *
+   *  @return current mapped array file generation setting
+   */
+
+bool option_gen_mmap(void) { return _gen_mmap; }
+
+  /**
+   *  @fn void option_gen_mmap_on(void)
+   *  @brief  turns mapped array file generation on
+   *
+   *  @par Parameters
+   *       None.
    *
    *  @par Returns
    *       Nothing.
    */
 
-void option_set_includes(char *inc_list)
-{
-  char *fn;
-  char *fn_end;
-  int n_fns = 0;
-  int i;
+void option_gen_mmap_on(void) { _gen_mmap = true; }
 
-  if (_n_include_files)
-  {
-    for (i = 0; i < _n_include_files; i++)
-      free(_include_files[i]);
-    free(_include_files);
-    _include_files = NULL;
-    _n_include_files = 0;
-  }
+  /**
+   *  @fn void option_gen_mmap_off(void)
+   *  @brief  turns mapped array file generation off
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
 
-  if (!inc_list) goto exit;
+void option_gen_mmap_off(void) { _gen_mmap = false; }
 
-  n_fns = 1;
+static bool _gen_delimited = false;
 
-  fn = inc_list;
-  while (*fn)
-  {
-    if (*fn == ':') ++n_fns;
-    ++fn;
-  }
+  /**
+   *  @fn bool option_gen_delimited(void)
+   *  @brief  returns gen delimited setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return current delimited text loader generation setting
+   */
 
-  _include_files = malloc(sizeof(char *) * (n_fns + 1));
-  if (!_include_files) goto exit;
-  _n_include_files = n_fns;
-  memset(_include_files, 0, sizeof(char *) * (n_fns + 1));
+bool option_gen_delimited(void) { return _gen_delimited; }
 
-  for (fn = fn_end = inc_list, i = 0; i < n_fns; i++)
-  {
-    while (*fn_end && (*fn_end != ':')) ++fn_end;
-    _include_files[i] = strndup(fn, fn_end - fn);
-    if (*fn_end == ':') ++fn_end;
-    fn = fn_end;
-  }
+  /**
+   *  @fn void option_gen_delimited_on(void)
+   *  @brief  turns delimited text loader generation on
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
 
-exit:
-  return;
-}
+void option_gen_delimited_on(void) { _gen_delimited = true; }
 
   /**
-   *  @fn char *option_get_first_include(void);
-   *  @brief  returns first include file in list
+   *  @fn void option_gen_delimited_off(void)
+   *  @brief  turns delimited text loader generation off
    *
    *  @par Parameters
    *       None.
    *
-   *  @return string containing include file name
+   *  @par Returns
+   *       Nothing.
    */
 
-char *option_get_first_include(void)
-{
-  if (!_n_include_files) return NULL;
-  return _include_files[_curr_include_file++];
-}
+void option_gen_delimited_off(void) { _gen_delimited = false; }
+
+static bool _gen_json = false;
 
   /**
-   *  @fn char *option_get_next_include(void);
-   *  @brief  returns next include file in list
+   *  @fn bool option_gen_json(void)
+   *  @brief  returns gen json setting
    *
    *  @par Parameters
    *       None.
    *
-   *  @return string containing include file name
+   *  @return current JSON encoder and decoder generation setting
    */
 
-char *option_get_next_include(void)
-{
-  if (_curr_include_file >= _n_include_files) return NULL;
-  if (!_include_files[_curr_include_file]) return NULL;
-  return _include_files[_curr_include_file++];
-}
+bool option_gen_json(void) { return _gen_json; }
 
-bool _cpp_compatible = false;
+  /**
+   *  @fn void option_gen_json_on(void)
+   *  @brief  turns JSON encoder and decoder generation on
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_gen_json_on(void) { _gen_json = true; }
 
   /**
-   *  @fn bool option_cpp_compatible(void)
-   *  @brief  returns cpp compatible setting
+   *  @fn void option_gen_json_off(void)
+   *  @brief  turns JSON encoder and decoder generation off
    *
    *  @par Parameters
    *       None.
    *
-   *  @return current cpp compatible setting
+   *  @par Returns
+   *       Nothing.
    */
 
-bool option_cpp_compatible(void) { return _cpp_compatible; }
+void option_gen_json_off(void) { _gen_json = false; }
+
+static bool _gen_hash = false;
 
   /**
-   *  @fn void option_cpp_compatible_on(void)
-   *  @brief  turns cpp compatibility on
+   *  @fn bool option_gen_hash(void)
+   *  @brief  returns gen hash setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return current hash and equality function generation setting
+   */
+
+bool option_gen_hash(void) { return _gen_hash; }
+
+  /**
+   *  @fn void option_gen_hash_on(void)
+   *  @brief  turns hash and equality function generation on
    *
    *  @par Parameters
    *       None.
@@ -551,11 +696,11 @@ bool option_cpp_compatible(void) { return _cpp_compatible; }
    *       Nothing.
    */
 
-void option_cpp_compatible_on(void) { _cpp_compatible = true; }
+void option_gen_hash_on(void) { _gen_hash = true; }
 
   /**
-   *  @fn void option_cpp_compatible_off(void)
-   *  @brief  turns cpp compatibility off
+   *  @fn void option_gen_hash_off(void)
+   *  @brief  turns hash and equality function generation off
    *
    *  @par Parameters
    *       None.
@@ -564,5 +709,966 @@ void option_cpp_compatible_on(void) { _cpp_compatible = true; }
    *       Nothing.
    */
 
-void option_cpp_compatible_off(void) { _cpp_compatible = false; }
+void option_gen_hash_off(void) { _gen_hash = false; }
+
+static bool _gen_ring = false;
+
+  /**
+   *  @fn bool option_gen_ring(void)
+   *  @brief  returns gen ring setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return current ring queue generation setting
+   */
+
+bool option_gen_ring(void) { return _gen_ring; }
+
+  /**
+   *  @fn void option_gen_ring_on(void)
+   *  @brief  turns ring queue generation on
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_gen_ring_on(void) { _gen_ring = true; }
+
+  /**
+   *  @fn void option_gen_ring_off(void)
+   *  @brief  turns ring queue generation off
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
 
+void option_gen_ring_off(void) { _gen_ring = false; }
+
+static bool _gen_shardmap = false;
+
+  /**
+   *  @fn bool option_gen_shardmap(void)
+   *  @brief  returns gen shardmap setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return current sharded map generation setting
+   */
+
+bool option_gen_shardmap(void) { return _gen_shardmap; }
+
+  /**
+   *  @fn void option_gen_shardmap_on(void)
+   *  @brief  turns sharded map generation on
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_gen_shardmap_on(void) { _gen_shardmap = true; }
+
+  /**
+   *  @fn void option_gen_shardmap_off(void)
+   *  @brief  turns sharded map generation off
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_gen_shardmap_off(void) { _gen_shardmap = false; }
+
+static char *_shardmap_key = NULL;
+
+  /**
+   *  @fn char *option_shardmap_key(void)
+   *  @brief  returns name of key field of sharded maps
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return string with field name, NULL if none
+   */
+
+char *option_shardmap_key(void) { return _shardmap_key; }
+
+  /**
+   *  @fn void option_set_shardmap_key(char *field)
+   *  @brief  sets name of key field of sharded maps, structs and unions
+   *          with no such field get no sharded map
+   *
+   *  @param  field - string containing field name, NULL for none
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_set_shardmap_key(char *field)
+{
+  if (_shardmap_key) free(_shardmap_key);
+  _shardmap_key = (field && *field) ? strdup(field) : NULL;
+}
+
+static bool _gen_parallel = false;
+
+  /**
+   *  @fn bool option_gen_parallel(void)
+   *  @brief  returns gen parallel setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return current parallel walk generation setting
+   */
+
+bool option_gen_parallel(void) { return _gen_parallel; }
+
+  /**
+   *  @fn void option_gen_parallel_on(void)
+   *  @brief  turns parallel walk generation on
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_gen_parallel_on(void) { _gen_parallel = true; }
+
+  /**
+   *  @fn void option_gen_parallel_off(void)
+   *  @brief  turns parallel walk generation off
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_gen_parallel_off(void) { _gen_parallel = false; }
+
+static bool _gen_heap = false;
+
+  /**
+   *  @fn bool option_gen_heap(void)
+   *  @brief  returns gen heap setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return current heap generation setting
+   */
+
+bool option_gen_heap(void) { return _gen_heap; }
+
+  /**
+   *  @fn void option_gen_heap_on(void)
+   *  @brief  turns heap generation on
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_gen_heap_on(void) { _gen_heap = true; }
+
+  /**
+   *  @fn void option_gen_heap_off(void)
+   *  @brief  turns heap generation off
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_gen_heap_off(void) { _gen_heap = false; }
+
+static char *_heap_key = NULL;
+
+  /**
+   *  @fn char *option_heap_key(void)
+   *  @brief  returns name of key field of heaps
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return string with field name, NULL if none
+   */
+
+char *option_heap_key(void) { return _heap_key; }
+
+  /**
+   *  @fn void option_set_heap_key(char *field)
+   *  @brief  sets name of key field of heaps, structs and unions with no
+   *          such field get no heap
+   *
+   *  @param  field - string containing field name, NULL for none
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_set_heap_key(char *field)
+{
+  if (_heap_key) free(_heap_key);
+  _heap_key = (field && *field) ? strdup(field) : NULL;
+}
+
+static bool _heap_max = false;
+
+  /**
+   *  @fn bool option_heap_max(void)
+   *  @brief  returns heap max setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return true if heaps keep their largest key on top, false if their
+   *          smallest
+   */
+
+bool option_heap_max(void) { return _heap_max; }
+
+  /**
+   *  @fn void option_heap_max_on(void)
+   *  @brief  makes heaps keep their largest key on top
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_heap_max_on(void) { _heap_max = true; }
+
+  /**
+   *  @fn void option_heap_max_off(void)
+   *  @brief  makes heaps keep their smallest key on top
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_heap_max_off(void) { _heap_max = false; }
+
+static bool _gen_bitmap = false;
+
+  /**
+   *  @fn bool option_gen_bitmap(void)
+   *  @brief  returns gen bitmap setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return current bitmap index generation setting
+   */
+
+bool option_gen_bitmap(void) { return _gen_bitmap; }
+
+  /**
+   *  @fn void option_gen_bitmap_on(void)
+   *  @brief  turns bitmap index generation on
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_gen_bitmap_on(void) { _gen_bitmap = true; }
+
+  /**
+   *  @fn void option_gen_bitmap_off(void)
+   *  @brief  turns bitmap index generation off
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_gen_bitmap_off(void) { _gen_bitmap = false; }
+
+static bool _gen_skiplist = false;
+
+  /**
+   *  @fn bool option_gen_skiplist(void)
+   *  @brief  returns gen skiplist setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return current skip list generation setting
+   */
+
+bool option_gen_skiplist(void) { return _gen_skiplist; }
+
+  /**
+   *  @fn void option_gen_skiplist_on(void)
+   *  @brief  turns skip list generation on
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_gen_skiplist_on(void) { _gen_skiplist = true; }
+
+  /**
+   *  @fn void option_gen_skiplist_off(void)
+   *  @brief  turns skip list generation off
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_gen_skiplist_off(void) { _gen_skiplist = false; }
+
+static char *_skiplist_key = NULL;
+
+  /**
+   *  @fn char *option_skiplist_key(void)
+   *  @brief  returns name of key field of skip lists
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return string with field name, NULL if none
+   */
+
+char *option_skiplist_key(void) { return _skiplist_key; }
+
+  /**
+   *  @fn void option_set_skiplist_key(char *field)
+   *  @brief  sets name of key field of skip lists, structs and unions with
+   *          no such field get no skip list
+   *
+   *  @param  field - string containing field name, NULL for none
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_set_skiplist_key(char *field)
+{
+  if (_skiplist_key) free(_skiplist_key);
+  _skiplist_key = (field && *field) ? strdup(field) : NULL;
+}
+
+static bool _concurrent_array = false;
+
+  /**
+   *  @fn bool option_concurrent_array(void)
+   *  @brief  returns concurrent array setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return true if dynamic array functions lock an embedded rwlock
+   */
+
+bool option_concurrent_array(void) { return _concurrent_array; }
+
+  /**
+   *  @fn void option_concurrent_array_on(void)
+   *  @brief  turns thread-safe dynamic array functions on
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_concurrent_array_on(void) { _concurrent_array = true; }
+
+  /**
+   *  @fn void option_concurrent_array_off(void)
+   *  @brief  turns thread-safe dynamic array functions off
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_concurrent_array_off(void) { _concurrent_array = false; }
+
+static bool _concurrent_list = false;
+
+  /**
+   *  @fn bool option_concurrent_list(void)
+   *  @brief  returns concurrent list setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return true if list functions lock an embedded rwlock
+   */
+
+bool option_concurrent_list(void) { return _concurrent_list; }
+
+  /**
+   *  @fn void option_concurrent_list_on(void)
+   *  @brief  turns thread-safe list functions on
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_concurrent_list_on(void) { _concurrent_list = true; }
+
+  /**
+   *  @fn void option_concurrent_list_off(void)
+   *  @brief  turns thread-safe list functions off
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_concurrent_list_off(void) { _concurrent_list = false; }
+
+static bool _concurrent_avl = false;
+
+  /**
+   *  @fn bool option_concurrent_avl(void)
+   *  @brief  returns concurrent avl setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return true if avl tree functions lock an embedded rwlock
+   */
+
+bool option_concurrent_avl(void) { return _concurrent_avl; }
+
+  /**
+   *  @fn void option_concurrent_avl_on(void)
+   *  @brief  turns thread-safe avl tree functions on
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_concurrent_avl_on(void) { _concurrent_avl = true; }
+
+  /**
+   *  @fn void option_concurrent_avl_off(void)
+   *  @brief  turns thread-safe avl tree functions off
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_concurrent_avl_off(void) { _concurrent_avl = false; }
+
+static bool _persistent_avl = false;
+
+  /**
+   *  @fn bool option_persistent_avl(void)
+   *  @brief  returns persistent avl setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return true if avls also get a copy-on-write _pavl with snapshots
+   */
+
+bool option_persistent_avl(void) { return _persistent_avl; }
+
+  /**
+   *  @fn void option_persistent_avl_on(void)
+   *  @brief  turns copy-on-write avl generation on
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_persistent_avl_on(void) { _persistent_avl = true; }
+
+  /**
+   *  @fn void option_persistent_avl_off(void)
+   *  @brief  turns copy-on-write avl generation off
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_persistent_avl_off(void) { _persistent_avl = false; }
+
+static bool _gen_readme = false;
+
+  /**
+   *  @fn bool option_gen_readme(void)
+   *  @brief  returns gen readme setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return current readme generation setting
+   */
+
+bool option_gen_readme(void) { return _gen_readme; }
+
+  /**
+   *  @fn void option_gen_readme_on(void)
+   *  @brief  turns readme generation on
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_gen_readme_on(void) { _gen_readme = true; }
+
+  /**
+   *  @fn void option_gen_readme_off(void)
+   *  @brief  turns readme generation off
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_gen_readme_off(void) { _gen_readme = false; }
+
+static bool _assume_typedefs = false;
+
+  /**
+   *  @fn bool option_assume_typedefs(void)
+   *  @brief  returns gen readme setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return current readme generation setting
+   */
+
+bool option_assume_typedefs(void) { return _assume_typedefs; }
+
+  /**
+   *  @fn void option_assume_typedefs_on(void)
+   *  @brief  turns readme generation on
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_assume_typedefs_on(void) { _assume_typedefs = true; }
+
+  /**
+   *  @fn void option_assume_typedefs_off(void)
+   *  @brief  turns readme generation off
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_assume_typedefs_off(void) { _assume_typedefs = false; }
+
+char **_include_files = NULL;
+unsigned _n_include_files = 0;
+unsigned _curr_include_file = 0;
+
+  /**
+   *  @fn void option_set_includes(char *inc_list);
+   *  @brief  sets list of include files to be emitted in header
+   *
+   *  @param inc_list - ':' separated list of include file names
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_set_includes(char *inc_list)
+{
+  char *fn;
+  char *fn_end;
+  int n_fns = 0;
+  int i;
+
+  if (_n_include_files)
+  {
+    for (i = 0; i < _n_include_files; i++)
+      free(_include_files[i]);
+    free(_include_files);
+    _include_files = NULL;
+    _n_include_files = 0;
+  }
+
+  if (!inc_list) goto exit;
+
+  n_fns = 1;
+
+  fn = inc_list;
+  while (*fn)
+  {
+    if (*fn == ':') ++n_fns;
+    ++fn;
+  }
+
+  _include_files = malloc(sizeof(char *) * (n_fns + 1));
+  if (!_include_files) goto exit;
+  _n_include_files = n_fns;
+  memset(_include_files, 0, sizeof(char *) * (n_fns + 1));
+
+  for (fn = fn_end = inc_list, i = 0; i < n_fns; i++)
+  {
+    while (*fn_end && (*fn_end != ':')) ++fn_end;
+    _include_files[i] = strndup(fn, fn_end - fn);
+    if (*fn_end == ':') ++fn_end;
+    fn = fn_end;
+  }
+
+exit:
+  return;
+}
+
+  /**
+   *  @fn char *option_get_first_include(void);
+   *  @brief  returns first include file in list
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return string containing include file name
+   */
+
+char *option_get_first_include(void)
+{
+  if (!_n_include_files) return NULL;
+  return _include_files[_curr_include_file++];
+}
+
+  /**
+   *  @fn char *option_get_next_include(void);
+   *  @brief  returns next include file in list
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return string containing include file name
+   */
+
+char *option_get_next_include(void)
+{
+  if (_curr_include_file >= _n_include_files) return NULL;
+  if (!_include_files[_curr_include_file]) return NULL;
+  return _include_files[_curr_include_file++];
+}
+
+bool _cpp_compatible = false;
+
+  /**
+   *  @fn bool option_cpp_compatible(void)
+   *  @brief  returns cpp compatible setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return current cpp compatible setting
+   */
+
+bool option_cpp_compatible(void) { return _cpp_compatible; }
+
+  /**
+   *  @fn void option_cpp_compatible_on(void)
+   *  @brief  turns cpp compatibility on
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_cpp_compatible_on(void) { _cpp_compatible = true; }
+
+  /**
+   *  @fn void option_cpp_compatible_off(void)
+   *  @brief  turns cpp compatibility off
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_cpp_compatible_off(void) { _cpp_compatible = false; }
+
+
+static bool _layout_report = false;
+
+  /**
+   *  @fn bool option_layout_report(void)
+   *  @brief  returns layout report setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return current layout report setting
+   */
+
+bool option_layout_report(void) { return _layout_report; }
+
+  /**
+   *  @fn void option_layout_report_on(void)
+   *  @brief  turns layout report on, code generation is skipped
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_layout_report_on(void) { _layout_report = true; }
+
+  /**
+   *  @fn void option_layout_report_off(void)
+   *  @brief  turns layout report off
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_layout_report_off(void) { _layout_report = false; }
+
+static bool _pack = false;
+
+  /**
+   *  @fn bool option_pack(void)
+   *  @brief  returns pack setting
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return current pack setting
+   */
+
+bool option_pack(void) { return _pack; }
+
+  /**
+   *  @fn void option_pack_on(void)
+   *  @brief  turns field reordering to minimize padding on
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_pack_on(void) { _pack = true; }
+
+  /**
+   *  @fn void option_pack_off(void)
+   *  @brief  turns field reordering off
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_pack_off(void) { _pack = false; }
+
+static char *_profile = NULL;
+
+  /**
+   *  @fn char *option_profile(void)
+   *  @brief  returns name of field access profile file
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return string with profile file name, NULL if none
+   */
+
+char *option_profile(void) { return _profile; }
+
+  /**
+   *  @fn void option_set_profile(char *file_name)
+   *  @brief  sets name of field access profile file used to split structs
+   *          into hot and cold halves
+   *
+   *  @param  file_name - string containing profile file name
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_set_profile(char *file_name)
+{
+  if (_profile) free(_profile);
+  _profile = file_name ? strdup(file_name) : NULL;
+}
+
+static char *_tuning = NULL;
+
+  /**
+   *  @fn char *option_tuning(void)
+   *  @brief  returns name of layout tuning file
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return string with tuning file name, NULL if none
+   */
+
+char *option_tuning(void) { return _tuning; }
+
+  /**
+   *  @fn void option_set_tuning(char *file_name)
+   *  @brief  sets name of layout tuning file with alignment and cache line
+   *          separation directives
+   *
+   *  @param  file_name - string containing tuning file name
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_set_tuning(char *file_name)
+{
+  if (_tuning) free(_tuning);
+  _tuning = file_name ? strdup(file_name) : NULL;
+}
+
+static bool _inline_accessors = false;
+
+  /**
+   *  @fn bool option_inline_accessors(void)
+   *  @brief  returns state of inline accessors option
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return true if trivial accessors are inlined, false if not
+   */
+
+bool option_inline_accessors(void) { return _inline_accessors; }
+
+  /**
+   *  @fn void option_inline_accessors_on(void)
+   *  @brief  turns inline accessors option on, trivial getters and setters
+   *          are emitted as static inline functions in header
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_inline_accessors_on(void) { _inline_accessors = true; }
+
+  /**
+   *  @fn void option_inline_accessors_off(void)
+   *  @brief  turns inline accessors option off, all getters and setters
+   *          are emitted in source
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_inline_accessors_off(void) { _inline_accessors = false; }
+
+static int _split_source = 0;
+
+  /**
+   *  @fn int option_split_source(void)
+   *  @brief  returns number of structs and unions per split source file
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return structs and unions per source file, 0 if source is not split
+   */
+
+int option_split_source(void) { return _split_source; }
+
+  /**
+   *  @fn void option_set_split_source(char *count)
+   *  @brief  turns split source on, functions of every @p count structs and
+   *          unions are emitted in a source file of their own
+   *
+   *  @param  count - string containing structs and unions per source file,
+   *                  NULL for one
+   *
+   *  @par Returns
+   *       Nothing.
+   */
+
+void option_set_split_source(char *count)
+{
+  _split_source = count ? atoi(count) : 1;
+  if (_split_source < 1) _split_source = 1;
+}
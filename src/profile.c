@@ -0,0 +1,332 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file profile.c
+ *  @brief tracks field access profile used for hot/cold struct splitting
+ *
+ *  A profile file contains one field per line:
+ *
+ *    &lt;struct name&gt;.&lt;field name&gt; &lt;access count&gt;
+ *
+ *  Blank lines and lines starting with '#' are ignored.
+ *
+ *  A field is hot when its count is at least @a PROFILE_HOT_PERCENT percent
+ *  of the hottest field of the same struct.  Fields of a profiled struct
+ *  which are not listed in the profile are cold.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "profile.h"
+#include "layout.h"
+
+  /**
+   *  @typedef profile_entry
+   *  @brief creates a type for a @a profile_entry struct
+   */
+
+typedef struct profile_entry profile_entry;
+
+  /**
+   *  @struct profile_entry
+   *  @brief defines access count of one field
+   */
+
+struct profile_entry
+{
+  char *aggregate;           /**<  name of struct              */
+  char *field;               /**<  name of field               */
+  unsigned long long count;  /**<  number of recorded accesses  */
+};
+
+  /*  static module variables  */
+
+static profile_entry *_entries = NULL;  /**<  module, loaded profile       */
+static int _n_entries = 0;              /**<  module, number of entries    */
+static xmlDocPtr _doc = NULL;           /**<  module, profiled declarations */
+
+  /*  Module specific function prototypes  */
+
+static profile_entry *profile_find(char *aggregate, char *field);
+static unsigned long long profile_max_count(char *aggregate);
+static bool profile_has_struct(char *aggregate);
+
+  /**
+   *  @fn int profile_load(char *file_name, xmlDocPtr doc)
+   *
+   *  @brief loads access profile from @p file_name for declarations in @p doc
+   *
+   *  @param file_name - string containing name of profile file
+   *  @param doc - xmlDocPtr containing declarations
+   *
+   *  @return 0 on success
+   *         -1 on failure
+   */
+
+int profile_load(char *file_name, xmlDocPtr doc)
+{
+  FILE *infile = NULL;
+  char line[1024];
+  char *name;
+  char *dot;
+  char *count;
+  profile_entry *tmp;
+  int retval = -1;
+
+  profile_free();
+
+  if (!file_name || !doc) goto exit;
+
+  _doc = doc;
+
+  infile = fopen(file_name, "r");
+  if (!infile) goto exit;
+
+  while (fgets(line, sizeof(line), infile))
+  {
+    name = strtok(line, " \t\r\n");
+    if (!name || (*name == '#')) continue;
+
+    count = strtok(NULL, " \t\r\n");
+    if (!count) continue;
+
+    dot = strchr(name, '.');
+    if (!dot || (dot == name) || !dot[1]) continue;
+    *dot = 0;
+
+    tmp = realloc(_entries, sizeof(profile_entry) * (_n_entries + 1));
+    if (!tmp) goto exit;
+    _entries = tmp;
+
+    _entries[_n_entries].aggregate = strdup(name);
+    _entries[_n_entries].field = strdup(dot + 1);
+    _entries[_n_entries].count = strtoull(count, NULL, 10);
+
+    ++_n_entries;
+  }
+
+  retval = 0;
+
+exit:
+  if (infile) fclose(infile);
+
+  return retval;
+}
+
+  /**
+   *  @fn void profile_free(void)
+   *
+   *  @brief frees all memory allocated to loaded profile
+   *
+   *  @par Parameters
+   *  None.
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void profile_free(void)
+{
+  int i;
+
+  for (i = 0; i < _n_entries; i++)
+  {
+    free(_entries[i].aggregate);
+    free(_entries[i].field);
+  }
+
+  if (_entries) free(_entries);
+
+  _entries = NULL;
+  _n_entries = 0;
+  _doc = NULL;
+}
+
+  /**
+   *  @fn bool profile_split(char *aggregate)
+   *
+   *  @brief determines if struct @p aggregate is split into hot and cold
+   *         halves
+   *
+   *  NOTE:  a struct is split only if the profile names it and at least one
+   *         of its named fields is cold.  Unions are never split.
+   *
+   *  @param aggregate - string containing name of struct
+   *
+   *  @return true if struct is split, false if not
+   */
+
+bool profile_split(char *aggregate)
+{
+  xmlNodePtr node;
+  xmlNodePtr child;
+  char *field;
+  bool split = false;
+
+  if (!profile_has_struct(aggregate)) goto exit;
+
+  node = layout_find_declaration(_doc, aggregate);
+
+  for (child = node->children; child && !split; child = child->next)
+  {
+    if (strcmp((char *)child->name, "field")) continue;
+
+    field = get_attribute(child, "name");
+    if (!field) continue;
+
+    if (profile_field_is_cold(aggregate, field)) split = true;
+
+    free(field);
+  }
+
+exit:
+  return split;
+}
+
+  /**
+   *  @fn bool profile_field_is_cold(char *aggregate, char *field)
+   *
+   *  @brief determines if @p field of struct @p aggregate belongs in the
+   *         cold half
+   *
+   *  @param aggregate - string containing name of struct
+   *  @param field - string containing name of field
+   *
+   *  @return true if field is cold, false if not
+   */
+
+bool profile_field_is_cold(char *aggregate, char *field)
+{
+  profile_entry *entry;
+  unsigned long long max;
+
+  if (!field || !profile_has_struct(aggregate)) return false;
+
+  entry = profile_find(aggregate, field);
+  if (!entry) return true;
+
+  max = profile_max_count(aggregate);
+
+  return (entry->count * 100) < (max * PROFILE_HOT_PERCENT);
+}
+
+  /**
+   *  @fn char *profile_field_path(char *aggregate, char *field)
+   *
+   *  @brief returns member access path to @p field from an instance of
+   *         struct @p aggregate
+   *
+   *  NOTE:  the returned string is static and must not be freed
+   *
+   *  @param aggregate - string containing name of struct
+   *  @param field - string containing name of field
+   *
+   *  @return "_cold->" for cold fields, "" for all others
+   */
+
+char *profile_field_path(char *aggregate, char *field)
+{
+  return profile_field_is_cold(aggregate, field) ? "_cold->" : "";
+}
+
+  /**
+   *  @fn static profile_entry *profile_find(char *aggregate, char *field)
+   *
+   *  @brief locates profile entry for @p field of @p aggregate
+   *
+   *  @param aggregate - string containing name of struct
+   *  @param field - string containing name of field
+   *
+   *  @return pointer to @a profile_entry on success
+   *          NULL on failure
+   */
+
+static profile_entry *profile_find(char *aggregate, char *field)
+{
+  int i;
+
+  if (!aggregate || !field) return NULL;
+
+  for (i = 0; i < _n_entries; i++)
+  {
+    if (!strcmp(_entries[i].aggregate, aggregate) &&
+        !strcmp(_entries[i].field, field))
+      return &_entries[i];
+  }
+
+  return NULL;
+}
+
+  /**
+   *  @fn static unsigned long long profile_max_count(char *aggregate)
+   *
+   *  @brief returns access count of hottest field of @p aggregate
+   *
+   *  @param aggregate - string containing name of struct
+   *
+   *  @return highest access count, 0 if none
+   */
+
+static unsigned long long profile_max_count(char *aggregate)
+{
+  unsigned long long max = 0;
+  int i;
+
+  if (!aggregate) return 0;
+
+  for (i = 0; i < _n_entries; i++)
+  {
+    if (!strcmp(_entries[i].aggregate, aggregate) &&
+        (_entries[i].count > max))
+      max = _entries[i].count;
+  }
+
+  return max;
+}
+
+  /**
+   *  @fn static bool profile_has_struct(char *aggregate)
+   *
+   *  @brief determines if the profile covers struct @p aggregate
+   *
+   *  @param aggregate - string containing name of struct
+   *
+   *  @return true if profiled struct, false if not
+   */
+
+static bool profile_has_struct(char *aggregate)
+{
+  xmlNodePtr node;
+  int i;
+
+  if (!aggregate || !_doc) return false;
+
+  node = layout_find_declaration(_doc, aggregate);
+  if (!node || strcmp((char *)node->name, "struct")) return false;
+
+  for (i = 0; i < _n_entries; i++)
+  {
+    if (!strcmp(_entries[i].aggregate, aggregate)) return true;
+  }
+
+  return false;
+}
@@ -29,7 +29,11 @@
 #include "config.h"
 
 #include "source-array.h"
+#include "source-batch.h"
+#include "source-bitmap.h"
 #include "options.h"
+#include "source-concurrent.h"
+#include "source-iter.h"
 
 static void emit_aggregate_array_new_function(FILE *outfile,
                                               xmlNodePtr node,
@@ -153,6 +157,8 @@ void emit_aggregate_array_functions(FILE *outfile,
 {
   char *project = NULL;
   char *name = NULL;
+  char *item_name = NULL;
+  char *fpre = NULL;
   int indent = 0;
 
   if (!option_gen_array()) goto exit;
@@ -170,6 +176,9 @@ void emit_aggregate_array_functions(FILE *outfile,
   name = get_attribute(node, "name");
   if (!name) goto exit;
 
+  item_name = strdup(name);
+  if (!item_name) goto exit;
+
   name = strapp(name, "_array");
 
   emit_indent(outfile, indent + 2);
@@ -183,6 +192,21 @@ void emit_aggregate_array_functions(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  if (option_concurrent_array())
+  {
+    fpre = container_prefix(project, item_name, "array");
+
+    fprintf(outfile,
+            "static void %s_add_unlocked(%s *instance, %s *item);\n",
+            fpre,
+            name,
+            item_name);
+
+    fprintf(outfile, "\n");
+  }
+
+  emit_aggregate_bitmap_functions(outfile, node, project);
+
   emit_aggregate_array_new_function(outfile, node, project, indent);
   emit_aggregate_array_dup_function(outfile, node, project, indent);
   emit_aggregate_array_free_function(outfile, node, project, indent);
@@ -195,9 +219,14 @@ void emit_aggregate_array_functions(FILE *outfile,
   emit_aggregate_array_last_function(outfile, node, project, indent);
   emit_aggregate_array_current_function(outfile, node, project, indent);
 
+  emit_aggregate_batch_functions(outfile, node, project, "array");
+  emit_aggregate_iter_functions(outfile, node, project, "array");
+
 exit:
   if (project) free(project);
   if (name) free(name);
+  if (item_name) free(item_name);
+  if (fpre) free(fpre);
 }
 
   /**
@@ -247,9 +276,11 @@ static void emit_aggregate_array_new_function(FILE *outfile,
   emit_aggregate_array_new_annotation(outfile, node, name, fpre2, indent + 1);
 
   fprintf(outfile,
-          "%s *%s_new(void)\n",
+          "%s%s *%s_new%s(void)\n",
+          concurrent_storage(option_concurrent_array()),
           list_name,
-          fpre);
+          fpre,
+          concurrent_suffix(option_concurrent_array()));
   fprintf(outfile, "{\n");
 
   ++indent;
@@ -276,6 +307,16 @@ static void emit_aggregate_array_new_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_create,
+                          "array",
+                          list_name,
+                          true,
+                          fpre,
+                          "new",
+                          "",
+                          "void");
+
 exit:
   if (name) free(name);
   if (fpre) free(fpre);
@@ -328,9 +369,11 @@ static void emit_aggregate_array_dup_function(FILE *outfile,
 
   emit_aggregate_array_dup_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "%s *%s_dup(%s *instance)\n",
+  fprintf(outfile, "%s%s *%s_dup%s(%s *instance)\n",
+                   concurrent_storage(option_concurrent_array()),
                    list_name,
                    fpre,
+                   concurrent_suffix(option_concurrent_array()),
                    list_name);
   fprintf(outfile, "{\n");
 
@@ -355,6 +398,9 @@ static void emit_aggregate_array_dup_function(FILE *outfile,
   emit_indent(outfile, indent);
   fprintf(outfile, "if (!new_instance) goto exit;\n");
 
+  emit_indent(outfile, indent);
+  fprintf(outfile, "memset(new_instance, 0, sizeof(%s));\n", list_name);
+
   fprintf(outfile, "\n");
 
   emit_indent(outfile, indent);
@@ -362,8 +408,9 @@ static void emit_aggregate_array_dup_function(FILE *outfile,
 
   emit_indent(outfile, indent + 1);
   fprintf(outfile,
-          "%s_add(new_instance, instance->item[i]);\n",
-          fpre);
+          "%s_add%s(new_instance, instance->item[i]);\n",
+          fpre,
+          concurrent_suffix(option_concurrent_array()));
 
   fprintf(outfile, "\n");
 
@@ -378,6 +425,17 @@ static void emit_aggregate_array_dup_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_copy,
+                          "array",
+                          list_name,
+                          true,
+                          fpre,
+                          "dup",
+                          "instance",
+                          "%s *instance",
+                          list_name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -435,9 +493,11 @@ static void emit_aggregate_array_free_function(FILE *outfile,
                                        indent + 1);
 
   fprintf(outfile,
-          "void %s_free(%s *instance)\n",
-           fpre,
-           list_name);
+          "%svoid %s_free%s(%s *instance)\n",
+          concurrent_storage(option_concurrent_array()),
+          fpre,
+          concurrent_suffix(option_concurrent_array()),
+          list_name);
   fprintf(outfile, "{\n");
 
   ++indent;
@@ -462,6 +522,12 @@ static void emit_aggregate_array_free_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  if (bitmap_any(node))
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "%s_bitmap_free(instance);\n", fpre);
+  }
+
   emit_indent(outfile, indent);
   fprintf(outfile, "free(instance->item);\n");
 
@@ -478,6 +544,17 @@ static void emit_aggregate_array_free_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_destroy,
+                          "array",
+                          "void",
+                          false,
+                          fpre,
+                          "free",
+                          "instance",
+                          "%s *instance",
+                          list_name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -535,8 +612,10 @@ static void emit_aggregate_array_get_current_function(FILE *outfile,
                                              fpre2,
                                              indent + 1);
 
-  fprintf(outfile, "int %s_get_current(%s *instance)\n",
+  fprintf(outfile, "%sint %s_get_current%s(%s *instance)\n",
+                   concurrent_storage(option_concurrent_array()),
                    fpre,
+                   concurrent_suffix(option_concurrent_array()),
                    list_name);
   fprintf(outfile, "{\n");
 
@@ -551,6 +630,17 @@ static void emit_aggregate_array_get_current_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_cursor,
+                          "array",
+                          "int",
+                          false,
+                          fpre,
+                          "get_current",
+                          "instance",
+                          "%s *instance",
+                          list_name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -604,8 +694,10 @@ static void emit_aggregate_array_add_function(FILE *outfile,
 
   emit_aggregate_array_add_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "void %s_add(%s *instance, %s *item)\n",
+  fprintf(outfile, "%svoid %s_add%s(%s *instance, %s *item)\n",
+                   concurrent_storage(option_concurrent_array()),
                    fpre,
+                   concurrent_suffix(option_concurrent_array()),
                    list_name,
                    name);
 
@@ -621,6 +713,15 @@ static void emit_aggregate_array_add_function(FILE *outfile,
   emit_indent(outfile, indent);
   fprintf(outfile, "if (!instance || !item) return;\n");
 
+  if (bitmap_any(node))
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile,
+            "if (!%s_bitmap_reserve(instance, (size_t)instance->n + 1)) "
+            "return;\n",
+            fpre);
+  }
+
   fprintf(outfile, "\n");
 
   emit_indent(outfile, indent);
@@ -642,6 +743,14 @@ static void emit_aggregate_array_add_function(FILE *outfile,
           "instance->item[instance->n] = %s_dup(item);\n",
           fpre2);
 
+  if (bitmap_any(node))
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile,
+            "%s_bitmap_set(instance, (size_t)instance->n);\n",
+            fpre);
+  }
+
   fprintf(outfile, "\n");
 
   emit_indent(outfile, indent);
@@ -653,6 +762,18 @@ static void emit_aggregate_array_add_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_write,
+                          "array",
+                          "void",
+                          false,
+                          fpre,
+                          "add",
+                          "instance, item",
+                          "%s *instance, %s *item",
+                          list_name,
+                          name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -705,8 +826,10 @@ static void emit_aggregate_array_remove_function(FILE *outfile,
 
   emit_aggregate_array_remove_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "void %s_remove(%s *instance, int index)\n",
+  fprintf(outfile, "%svoid %s_remove%s(%s *instance, int index)\n",
+                   concurrent_storage(option_concurrent_array()),
                    fpre,
+                   concurrent_suffix(option_concurrent_array()),
                    list_name);
 
   fprintf(outfile, "{\n");
@@ -747,6 +870,12 @@ static void emit_aggregate_array_remove_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  if (bitmap_any(node))
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "%s_bitmap_remove(instance, (size_t)index);\n", fpre);
+  }
+
   emit_indent(outfile, indent);
   fprintf(outfile, "--instance->n;\n");
 
@@ -772,6 +901,17 @@ static void emit_aggregate_array_remove_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_write,
+                          "array",
+                          "void",
+                          false,
+                          fpre,
+                          "remove",
+                          "instance, index",
+                          "%s *instance, int index",
+                          list_name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -825,9 +965,11 @@ static void emit_aggregate_array_first_function(FILE *outfile,
 
   emit_aggregate_array_first_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "%s *%s_first(%s *instance)\n",
-                   name, 
+  fprintf(outfile, "%s%s *%s_first%s(%s *instance)\n",
+                   concurrent_storage(option_concurrent_array()),
+                   name,
                    fpre,
+                   concurrent_suffix(option_concurrent_array()),
                    list_name);
 
   fprintf(outfile, "{\n");
@@ -866,6 +1008,17 @@ static void emit_aggregate_array_first_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_cursor,
+                          "array",
+                          name,
+                          true,
+                          fpre,
+                          "first",
+                          "instance",
+                          "%s *instance",
+                          list_name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -919,9 +1072,11 @@ static void emit_aggregate_array_next_function(FILE *outfile,
 
   emit_aggregate_array_next_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "%s *%s_next(%s *instance)\n",
-                   name, 
+  fprintf(outfile, "%s%s *%s_next%s(%s *instance)\n",
+                   concurrent_storage(option_concurrent_array()),
+                   name,
                    fpre,
+                   concurrent_suffix(option_concurrent_array()),
                    list_name);
 
   fprintf(outfile, "{\n");
@@ -980,6 +1135,17 @@ static void emit_aggregate_array_next_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_cursor,
+                          "array",
+                          name,
+                          true,
+                          fpre,
+                          "next",
+                          "instance",
+                          "%s *instance",
+                          list_name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -1037,9 +1203,11 @@ static void emit_aggregate_array_previous_function(FILE *outfile,
                                           fpre2, 
                                           indent + 1);
 
-  fprintf(outfile, "%s *%s_previous(%s *instance)\n",
-                   name, 
+  fprintf(outfile, "%s%s *%s_previous%s(%s *instance)\n",
+                   concurrent_storage(option_concurrent_array()),
+                   name,
                    fpre,
+                   concurrent_suffix(option_concurrent_array()),
                    list_name);
 
   fprintf(outfile, "{\n");
@@ -1098,6 +1266,17 @@ static void emit_aggregate_array_previous_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_cursor,
+                          "array",
+                          name,
+                          true,
+                          fpre,
+                          "previous",
+                          "instance",
+                          "%s *instance",
+                          list_name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -1151,9 +1330,11 @@ static void emit_aggregate_array_last_function(FILE *outfile,
 
   emit_aggregate_array_last_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "%s *%s_last(%s *instance)\n",
-                   name, 
+  fprintf(outfile, "%s%s *%s_last%s(%s *instance)\n",
+                   concurrent_storage(option_concurrent_array()),
+                   name,
                    fpre,
+                   concurrent_suffix(option_concurrent_array()),
                    list_name);
 
   fprintf(outfile, "{\n");
@@ -1192,6 +1373,17 @@ static void emit_aggregate_array_last_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_cursor,
+                          "array",
+                          name,
+                          true,
+                          fpre,
+                          "last",
+                          "instance",
+                          "%s *instance",
+                          list_name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -1249,9 +1441,11 @@ static void emit_aggregate_array_current_function(FILE *outfile,
                                          fpre2,
                                          indent + 1);
 
-  fprintf(outfile, "%s *%s_current(%s *instance)\n",
-                   name, 
+  fprintf(outfile, "%s%s *%s_current%s(%s *instance)\n",
+                   concurrent_storage(option_concurrent_array()),
+                   name,
                    fpre,
+                   concurrent_suffix(option_concurrent_array()),
                    list_name);
 
   fprintf(outfile, "{\n");
@@ -1296,6 +1490,17 @@ static void emit_aggregate_array_current_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_cursor,
+                          "array",
+                          name,
+                          true,
+                          fpre,
+                          "current",
+                          "instance",
+                          "%s *instance",
+                          list_name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
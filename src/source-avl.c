@@ -29,7 +29,11 @@
 #include "config.h"
 
 #include "source-avl.h"
+#include "source-batch.h"
 #include "options.h"
+#include "source-concurrent.h"
+#include "source-iter.h"
+#include "tuning.h"
 
 static void emit_aggregate_avl_new_function(FILE *outfile,
                                             xmlNodePtr node,
@@ -75,6 +79,10 @@ static void emit_aggregate_avl_cmp_node_function(FILE *outfile,
                                                  xmlNodePtr node,
                                                  char *project,
                                                  int indent);
+static void emit_aggregate_avl_cmp_data_function(FILE *outfile,
+                                                 xmlNodePtr node,
+                                                 char *project,
+                                                 int indent);
 
 static void emit_aggregate_avl_new_annotation(FILE *outfile,
                                               xmlNodePtr node,
@@ -131,6 +139,11 @@ static void emit_aggregate_avl_cmp_node_annotation(FILE *outfile,
                                                    char *aggregate_name,
                                                    char *function_prefix,
                                                    int indent);
+static void emit_aggregate_avl_cmp_data_annotation(FILE *outfile,
+                                                   xmlNodePtr node,
+                                                   char *aggregate_name,
+                                                   char *function_prefix,
+                                                   int indent);
 
   /**
    *  @fn void emit_aggregate_avl_functions(FILE *outfile,
@@ -194,8 +207,12 @@ void emit_aggregate_avl_functions(FILE *outfile,
   emit_aggregate_avl_new_node_function(outfile, node, project, indent);
   emit_aggregate_avl_dup_node_function(outfile, node, project, indent);
   emit_aggregate_avl_free_node_function(outfile, node, project, indent);
+  emit_aggregate_avl_cmp_data_function(outfile, node, project, indent);
   emit_aggregate_avl_cmp_node_function(outfile, node, project, indent);
 
+  emit_aggregate_batch_functions(outfile, node, project, "avl");
+  emit_aggregate_iter_functions(outfile, node, project, "avl");
+
 exit:
   if (project) free(project);
   if (name) free(name);
@@ -248,9 +265,11 @@ static void emit_aggregate_avl_new_function(FILE *outfile,
   emit_aggregate_avl_new_annotation(outfile, node, name, fpre2, indent + 1);
 
   fprintf(outfile,
-          "%s *%s_new(void)\n",
+          "%s%s *%s_new%s(void)\n",
+          concurrent_storage(option_concurrent_avl()),
           avl_name,
-          fpre);
+          fpre,
+          concurrent_suffix(option_concurrent_avl()));
   fprintf(outfile, "{\n");
 
   ++indent;
@@ -329,6 +348,16 @@ static void emit_aggregate_avl_new_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_create,
+                          "avl",
+                          avl_name,
+                          true,
+                          fpre,
+                          "new",
+                          "",
+                          "void");
+
 exit:
   if (name) free(name);
   if (fpre) free(fpre);
@@ -381,9 +410,11 @@ static void emit_aggregate_avl_dup_function(FILE *outfile,
 
   emit_aggregate_avl_dup_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "%s *%s_dup(%s *instance)\n",
+  fprintf(outfile, "%s%s *%s_dup%s(%s *instance)\n",
+                   concurrent_storage(option_concurrent_avl()),
                    avl_name,
                    fpre,
+                   concurrent_suffix(option_concurrent_avl()),
                    avl_name);
   fprintf(outfile, "{\n");
 
@@ -426,6 +457,17 @@ static void emit_aggregate_avl_dup_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_copy,
+                          "avl",
+                          avl_name,
+                          true,
+                          fpre,
+                          "dup",
+                          "instance",
+                          "%s *instance",
+                          avl_name);
+
 exit:
   if (name) free(name);
   if (avl_name) free(avl_name);
@@ -483,9 +525,11 @@ static void emit_aggregate_avl_free_function(FILE *outfile,
                                        indent + 1);
 
   fprintf(outfile,
-          "void %s_free(%s *instance)\n",
-           fpre,
-           avl_name);
+          "%svoid %s_free%s(%s *instance)\n",
+          concurrent_storage(option_concurrent_avl()),
+          fpre,
+          concurrent_suffix(option_concurrent_avl()),
+          avl_name);
   fprintf(outfile, "{\n");
 
   ++indent;
@@ -511,6 +555,17 @@ static void emit_aggregate_avl_free_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_destroy,
+                          "avl",
+                          "void",
+                          false,
+                          fpre,
+                          "free",
+                          "instance",
+                          "%s *instance",
+                          avl_name);
+
 exit:
   if (name) free(name);
   if (avl_name) free(avl_name);
@@ -564,8 +619,10 @@ static void emit_aggregate_avl_insert_function(FILE *outfile,
 
   emit_aggregate_avl_insert_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "void %s_insert(%s *instance, %s *item)\n",
+  fprintf(outfile, "%svoid %s_insert%s(%s *instance, %s *item)\n",
+                   concurrent_storage(option_concurrent_avl()),
                    fpre,
+                   concurrent_suffix(option_concurrent_avl()),
                    avl_name,
                    name);
 
@@ -587,6 +644,18 @@ static void emit_aggregate_avl_insert_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_write,
+                          "avl",
+                          "void",
+                          false,
+                          fpre,
+                          "insert",
+                          "instance, item",
+                          "%s *instance, %s *item",
+                          avl_name,
+                          name);
+
 exit:
   if (name) free(name);
   if (avl_name) free(avl_name);
@@ -639,8 +708,10 @@ static void emit_aggregate_avl_delete_function(FILE *outfile,
 
   emit_aggregate_avl_delete_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "void %s_delete(%s *instance, %s *target)\n",
+  fprintf(outfile, "%svoid %s_delete%s(%s *instance, %s *target)\n",
+                   concurrent_storage(option_concurrent_avl()),
                    fpre,
+                   concurrent_suffix(option_concurrent_avl()),
                    avl_name,
                    name);
 
@@ -671,6 +742,18 @@ static void emit_aggregate_avl_delete_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_write,
+                          "avl",
+                          "void",
+                          false,
+                          fpre,
+                          "delete",
+                          "instance, target",
+                          "%s *instance, %s *target",
+                          avl_name,
+                          name);
+
 exit:
   if (name) free(name);
   if (avl_name) free(avl_name);
@@ -724,9 +807,11 @@ static void emit_aggregate_avl_find_function(FILE *outfile,
 
   emit_aggregate_avl_find_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "%s *%s_find(%s *instance, %s *needle)\n",
-                   name, 
+  fprintf(outfile, "%s%s *%s_find%s(%s *instance, %s *needle)\n",
+                   concurrent_storage(option_concurrent_avl()),
+                   name,
                    fpre,
+                   concurrent_suffix(option_concurrent_avl()),
                    avl_name,
                    name);
 
@@ -760,6 +845,18 @@ static void emit_aggregate_avl_find_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_read,
+                          "avl",
+                          name,
+                          true,
+                          fpre,
+                          "find",
+                          "instance, needle",
+                          "%s *instance, %s *needle",
+                          avl_name,
+                          name);
+
 exit:
   if (name) free(name);
   if (avl_name) free(avl_name);
@@ -813,11 +910,16 @@ static void emit_aggregate_avl_walk_function(FILE *outfile,
 
   emit_aggregate_avl_walk_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "void %s_walk(%s *instance,\n", fpre, avl_name);
+  fprintf(outfile,
+          "%svoid %s_walk%s(%s *instance,\n",
+          concurrent_storage(option_concurrent_avl()),
+          fpre,
+          concurrent_suffix(option_concurrent_avl()),
+          avl_name);
 
   fprintf(outfile, "          avl_order order,\n");
 
-  fprintf(outfile, "          %s_action action)\n", fpre);
+  fprintf(outfile, "          %s_action action)\n", avl_name);
 
   fprintf(outfile, "{\n");
 
@@ -837,6 +939,20 @@ static void emit_aggregate_avl_walk_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_read,
+                          "avl",
+                          "void",
+                          false,
+                          fpre,
+                          "walk",
+                          "instance, order, action",
+                          "%s *instance,\n"
+                          "          avl_order order,\n"
+                          "          %s_action action",
+                          avl_name,
+                          avl_name);
+
 exit:
   if (name) free(name);
   if (avl_name) free(avl_name);
@@ -871,6 +987,7 @@ static void emit_aggregate_avl_new_node_function(FILE *outfile,
   char *avl_name = NULL;
   char *fpre = NULL;
   char *fpre2 = NULL;
+  char *node_name = NULL;
 
   if (!outfile || !node || !project) goto exit;
   if (strcmp((char *)node->name, "struct") &&
@@ -901,8 +1018,11 @@ static void emit_aggregate_avl_new_node_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  node_name = strdup(avl_name);
+  node_name = strapp(node_name, "_node");
+
   emit_indent(outfile, indent);
-  fprintf(outfile, "new_node = malloc(sizeof(%s_node));\n", avl_name);
+  emit_alloc(outfile, "new_node", node_name, tuning_aligned(name));
 
   emit_indent(outfile, indent);
   fprintf(outfile, "if (!new_node) goto exit;\n");
@@ -930,6 +1050,7 @@ exit:
   if (avl_name) free(avl_name);
   if (fpre) free(fpre);
   if (fpre2) free(fpre2);
+  if (node_name) free(node_name);
 }
 
   /**
@@ -1185,6 +1306,80 @@ static void emit_aggregate_avl_cmp_node_function(FILE *outfile,
 
   ++indent;
 
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!a || !b) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return %s_cmp_data_func(&a->data, &b->data);\n", fpre);
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (avl_name) free(avl_name);
+  if (fpre) free(fpre);
+  if (fpre2) free(fpre2);
+}
+
+  /**
+   *  @fn void emit_aggregate_avl_cmp_data_function(FILE *outfile,
+   *                                                xmlNodePtr node,
+   *                                                char *project,
+   *                                                int indent)
+   *
+   *  @brief generates C source code to compare the data of two avl nodes
+   *         from element in @p node, shared by node comparison and the
+   *         persistent avl
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+  
+static void emit_aggregate_avl_cmp_data_function(FILE *outfile,
+                                                 xmlNodePtr node,
+                                                 char *project,
+                                                 int indent)
+{
+  char *name = NULL;
+  char *fpre = NULL;
+  char *fpre2 = NULL;
+
+  if (!outfile || !node || !project) goto exit;
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+  fpre = strapp(fpre, "_avl");
+
+  fpre2 = function_prefix(project, name);
+
+  emit_aggregate_avl_cmp_data_annotation(outfile, node, name, fpre2, indent+1);
+
+  fprintf(outfile,
+          "int %s_cmp_data_func(%s *a, %s *b)\n",
+          fpre,
+          name,
+          name);
+
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
   emit_indent(outfile, indent);
   fprintf(outfile, "int rv = 0;\n");
 
@@ -1203,7 +1398,7 @@ static void emit_aggregate_avl_cmp_node_function(FILE *outfile,
   fprintf(outfile, "\n");
 
   emit_indent(outfile, indent);
-  fprintf(outfile, "rv = memcmp(&a->data, &b->data, sizeof(%s));\n", name);
+  fprintf(outfile, "rv = memcmp(a, b, sizeof(%s));\n", name);
 
   emit_indent(outfile, indent);
   fprintf(outfile, "if (rv < 0) return -1;\n");
@@ -1222,7 +1417,6 @@ static void emit_aggregate_avl_cmp_node_function(FILE *outfile,
 
 exit:
   if (name) free(name);
-  if (avl_name) free(avl_name);
   if (fpre) free(fpre);
   if (fpre2) free(fpre2);
 }
@@ -2641,6 +2835,136 @@ static void emit_aggregate_avl_cmp_node_annotation(FILE *outfile,
     default: break;
   }
 
+exit:
+}
+
+  /**
+   *  @fn void emit_aggregate_avl_cmp_data_annotation(FILE *outfile,
+   *                                                  xmlNodePtr node,
+   *                                                  char *aggregate_name,
+   *                                                  char *function_prefix,
+   *                                                  int indent)
+   *
+   *  @brief emits annotation for aggregate avl cmp data function
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param aggregate_name - string containing aggregate name
+   *  @param function_prefix - string containing leading part of function name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+  
+static void emit_aggregate_avl_cmp_data_annotation(FILE *outfile,
+                                                   xmlNodePtr node,
+                                                   char *aggregate_name,
+                                                   char *function_prefix,
+                                                   int indent)
+{
+  if (!outfile || !node || !aggregate_name || !function_prefix) goto exit;
+  if (!node->name) goto exit;
+
+  if (!option_annotation()) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/**\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  @fn int %s_avl_cmp_data_func(%s *a, "
+              "%s *b)\n",
+              function_prefix,
+              aggregate_name,
+              aggregate_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  @brief avl helper function, compares data @p a to @p b\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  @param a - pointer to @a %s struct\n",
+              aggregate_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  @param b - pointer to @a %s struct\n",
+              aggregate_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @return -1 if a<b, 0 if a==b, 1 if a>b\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    case annotation_type_text:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/*\n");
+
+      fprintf(outfile,
+              " *  int %s_avl_cmp_data_func(%s *a, %s *b)\n",
+              function_prefix,
+              aggregate_name,
+              aggregate_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  avl helper function, compares data a to b\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  Parameters\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  a - pointer to %s struct\n",
+              aggregate_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              " *  b - pointer to %s struct\n",
+              aggregate_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  Returns\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *    -1 if a<b, 0 if a==b, 1 if a>b\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    default: break;
+  }
+
 exit:
 }
 
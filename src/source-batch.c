@@ -0,0 +1,1034 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-batch.c
+ *  @brief container batch insert and delete add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  Every array, list and avl gets functions adding or removing many items
+ *  in one call, checking arguments and, for concurrent containers, taking
+ *  the write lock once for the whole batch.  An array grows its item array
+ *  and bitmap index once for all added items, and compacts itself in one
+ *  pass however many items are removed.  llist and libavl offer no bulk
+ *  operations of their own, so lists and avls still add and delete an item
+ *  at a time underneath.
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "source-batch.h"
+#include "source-bitmap.h"
+#include "source-concurrent.h"
+#include "source-iter.h"
+#include "source-serialize.h"
+#include "options.h"
+
+  /**
+   *  @typedef struct batch_names
+   *  @brief names shared by all batch functions of one container
+   */
+
+typedef struct
+{
+  xmlNodePtr node;        /**<  struct or union element              */
+  char *name;             /**<  typedef name of struct or union      */
+  char *container_name;   /**<  typedef name of container            */
+  char *fpre;             /**<  function prefix of container         */
+  char *item_fpre;        /**<  function prefix of struct or union   */
+  char *kind;             /**<  "array", "list" or "avl"             */
+  bool concurrent;        /**<  true if container is concurrent      */
+} batch_names;
+
+static void emit_batch_array_add_many_function(FILE *outfile,
+                                               batch_names *bn,
+                                               int indent);
+static void emit_batch_array_remove_many_function(FILE *outfile,
+                                                  batch_names *bn,
+                                                  int indent);
+static void emit_batch_list_add_many_function(FILE *outfile,
+                                              batch_names *bn,
+                                              int indent);
+static void emit_batch_list_remove_many_function(FILE *outfile,
+                                                 batch_names *bn,
+                                                 int indent);
+static void emit_batch_avl_insert_many_function(FILE *outfile,
+                                                batch_names *bn,
+                                                int indent);
+static void emit_batch_avl_delete_many_function(FILE *outfile,
+                                                batch_names *bn,
+                                                int indent);
+static char *batch_prototype(batch_names *bn, char *op, char *params);
+
+  /**
+   *  @fn void emit_aggregate_batch_functions(FILE *outfile,
+   *                                          xmlNodePtr node,
+   *                                          char *project,
+   *                                          char *kind)
+   *
+   *  @brief generates batch insert and delete functions for container
+   *         @p kind of struct or union in @p node
+   *
+   *  NOTE:  array functions use the static bitmap index functions, so they
+   *         must follow emit_aggregate_bitmap_functions()
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing lower case project name
+   *  @param kind - string containing "array", "list" or "avl"
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_batch_functions(FILE *outfile,
+                                    xmlNodePtr node,
+                                    char *project,
+                                    char *kind)
+{
+  batch_names bn;
+  int indent = 0;
+
+  memset(&bn, 0, sizeof(bn));
+
+  if (!outfile || !node || !project || !kind) goto exit;
+
+  if (!iter_container(kind)) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  bn.node = node;
+  bn.kind = kind;
+  bn.concurrent = concurrent_container(kind);
+
+  bn.name = get_attribute(node, "name");
+  if (!bn.name) goto exit;
+
+  bn.container_name = strapp(bn.container_name, bn.name);
+  bn.container_name = strapp(bn.container_name, "_");
+  bn.container_name = strapp(bn.container_name, kind);
+
+  bn.fpre = container_prefix(project, bn.name, kind);
+  bn.item_fpre = function_prefix(project, bn.name);
+  if (!bn.container_name || !bn.fpre || !bn.item_fpre) goto exit;
+
+  if (!strcmp(kind, "array"))
+  {
+    emit_batch_array_add_many_function(outfile, &bn, indent);
+    emit_batch_array_remove_many_function(outfile, &bn, indent);
+  }
+  else if (!strcmp(kind, "list"))
+  {
+    emit_batch_list_add_many_function(outfile, &bn, indent);
+    emit_batch_list_remove_many_function(outfile, &bn, indent);
+  }
+  else
+  {
+    emit_batch_avl_insert_many_function(outfile, &bn, indent);
+    emit_batch_avl_delete_many_function(outfile, &bn, indent);
+  }
+
+exit:
+  if (bn.name) free(bn.name);
+  if (bn.container_name) free(bn.container_name);
+  if (bn.fpre) free(bn.fpre);
+  if (bn.item_fpre) free(bn.item_fpre);
+}
+
+  /**
+   *  @fn void emit_batch_array_add_many_function(FILE *outfile,
+   *                                              batch_names *bn,
+   *                                              int indent)
+   *
+   *  @brief generates C function adding copies of many items to an array,
+   *         growing the item array and bitmap index once
+   *
+   *  NOTE:  NULL items are skipped, a failed copy stops the batch, items
+   *         copied before it stay in the array
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param bn - pointer to names of array
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_batch_array_add_many_function(FILE *outfile,
+                                               batch_names *bn,
+                                               int indent)
+{
+  char *prototype = NULL;
+  char *params = NULL;
+  char *param_list[] =
+  {
+    "instance - pointer to array",
+    "items - array of pointers to items to copy in",
+    "n - number of items",
+    NULL
+  };
+  bool bitmap;
+
+  bitmap = bitmap_any(bn->node);
+
+  params = strapp(params, bn->name);
+  params = strapp(params, " **items, size_t n");
+
+  prototype = batch_prototype(bn, "add_many", params);
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "adds copies of items to array",
+                                      param_list,
+                                      "number of items added",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "void *tmp = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t added = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !items || !n) return 0;\n");
+
+  if (bitmap)
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile,
+            "if (!%s_bitmap_reserve(instance, (size_t)instance->n + n)) "
+            "return 0;\n",
+            bn->fpre);
+  }
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "tmp = realloc(instance->item, "
+          "sizeof(%s *) * ((size_t)instance->n + n));\n",
+          bn->name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!tmp) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "instance->item = tmp;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < n; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!items[i]) continue;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "instance->item[instance->n] = %s_dup(items[i]);\n",
+          bn->item_fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance->item[instance->n]) break;\n");
+
+  if (bitmap)
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile,
+            "%s_bitmap_set(instance, (size_t)instance->n);\n",
+            bn->fpre);
+  }
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "++instance->n;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "++added;\n");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return added;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_write,
+                          "array",
+                          "size_t",
+                          false,
+                          bn->fpre,
+                          "add_many",
+                          "instance, items, n",
+                          "%s *instance, %s",
+                          bn->container_name,
+                          params);
+
+exit:
+  if (prototype) free(prototype);
+  if (params) free(params);
+}
+
+  /**
+   *  @fn void emit_batch_array_remove_many_function(FILE *outfile,
+   *                                                 batch_names *bn,
+   *                                                 int indent)
+   *
+   *  @brief generates C function removing many items from an array in one
+   *         compacting pass
+   *
+   *  NOTE:  indexes are of the array before the call, in any order, those
+   *         out of range or repeated are ignored
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param bn - pointer to names of array
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_batch_array_remove_many_function(FILE *outfile,
+                                                  batch_names *bn,
+                                                  int indent)
+{
+  char *prototype = NULL;
+  char *param_list[] =
+  {
+    "instance - pointer to array",
+    "index - array of indexes of items to remove",
+    "n - number of indexes",
+    NULL
+  };
+
+  prototype = batch_prototype(bn, "remove_many", "int *index, size_t n");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "removes items at many indexes, "
+                                      "keeping the order of the others",
+                                      param_list,
+                                      "number of items removed",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "unsigned char *doomed = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "void *tmp = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t removed = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int from;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int to;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (!instance || !index || !n || (instance->n <= 0)) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "doomed = calloc((size_t)instance->n, 1);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!doomed) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < n; i++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "if ((index[i] >= 0) && (index[i] < instance->n)) "
+          "doomed[index[i]] = 1;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (from = to = 0; from < instance->n; from++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (doomed[from])\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "%s_free(instance->item[from]);\n", bn->item_fpre);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "++removed;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "else\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "instance->item[to++] = instance->item[from];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(doomed);\n");
+
+  if (bitmap_any(bn->node))
+  {
+    fprintf(outfile, "\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "for (from = 0; from < instance->n; from++)\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "{\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "if (from >= to) instance->item[from] = NULL;\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "%s_bitmap_set(instance, (size_t)from);\n", bn->fpre);
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "}\n");
+  }
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "instance->n = to;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!to)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "free(instance->item);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "instance->item = NULL;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return removed;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "tmp = realloc(instance->item, sizeof(%s *) * (size_t)to);\n",
+          bn->name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (tmp) instance->item = tmp;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return removed;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_write,
+                          "array",
+                          "size_t",
+                          false,
+                          bn->fpre,
+                          "remove_many",
+                          "instance, index, n",
+                          "%s *instance, int *index, size_t n",
+                          bn->container_name);
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_batch_list_add_many_function(FILE *outfile,
+   *                                             batch_names *bn,
+   *                                             int indent)
+   *
+   *  @brief generates C function adding many items to a list
+   *
+   *  NOTE:  each item is added as _list_add() would add it, in order, NULL
+   *         items are skipped
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param bn - pointer to names of list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_batch_list_add_many_function(FILE *outfile,
+                                              batch_names *bn,
+                                              int indent)
+{
+  char *prototype = NULL;
+  char *params = NULL;
+  char *param_list[] =
+  {
+    "instance - pointer to list",
+    "position - llist_position value",
+    "where - pointer to item to add next to, may be NULL",
+    "items - array of pointers to items to add",
+    "n - number of items",
+    NULL
+  };
+
+  params = strapp(params, "llist_position position, ");
+  params = strapp(params, bn->name);
+  params = strapp(params, " *where, ");
+  params = strapp(params, bn->name);
+  params = strapp(params, " **items, size_t n");
+
+  prototype = batch_prototype(bn, "add_many", params);
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "adds items to list in turn, "
+                                      "as _add() does",
+                                      param_list,
+                                      "number of items added",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t added = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (!instance || !instance->_llist || !items) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < n; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!items[i]) continue;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "llist_add(instance->_llist, position, "
+          "(void *)where, (void *)items[i]);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "++added;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return added;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_write,
+                          "list",
+                          "size_t",
+                          false,
+                          bn->fpre,
+                          "add_many",
+                          "instance, position, where, items, n",
+                          "%s *instance, %s",
+                          bn->container_name,
+                          params);
+
+exit:
+  if (prototype) free(prototype);
+  if (params) free(params);
+}
+
+  /**
+   *  @fn void emit_batch_list_remove_many_function(FILE *outfile,
+   *                                                batch_names *bn,
+   *                                                int indent)
+   *
+   *  @brief generates C function removing many items from a list
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param bn - pointer to names of list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_batch_list_remove_many_function(FILE *outfile,
+                                                 batch_names *bn,
+                                                 int indent)
+{
+  char *prototype = NULL;
+  char *params = NULL;
+  char *param_list[] =
+  {
+    "instance - pointer to list",
+    "items - array of pointers to items to remove",
+    "n - number of items",
+    NULL
+  };
+
+  params = strapp(params, bn->name);
+  params = strapp(params, " **items, size_t n");
+
+  prototype = batch_prototype(bn, "remove_many", params);
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "removes items from list",
+                                      param_list,
+                                      "number of items found and removed",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "void *found = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t removed = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (!instance || !instance->_llist || !items) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < n; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!items[i]) continue;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "found = llist_find_payload(instance->_llist, (void *)items[i]);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!found) continue;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "llist_remove(instance->_llist, found);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "++removed;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return removed;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_write,
+                          "list",
+                          "size_t",
+                          false,
+                          bn->fpre,
+                          "remove_many",
+                          "instance, items, n",
+                          "%s *instance, %s",
+                          bn->container_name,
+                          params);
+
+exit:
+  if (prototype) free(prototype);
+  if (params) free(params);
+}
+
+  /**
+   *  @fn void emit_batch_avl_insert_many_function(FILE *outfile,
+   *                                               batch_names *bn,
+   *                                               int indent)
+   *
+   *  @brief generates C function inserting many items into an avl
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param bn - pointer to names of avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_batch_avl_insert_many_function(FILE *outfile,
+                                                batch_names *bn,
+                                                int indent)
+{
+  char *prototype = NULL;
+  char *params = NULL;
+  char *param_list[] =
+  {
+    "instance - pointer to avl",
+    "items - array of pointers to items to insert",
+    "n - number of items",
+    NULL
+  };
+
+  params = strapp(params, bn->name);
+  params = strapp(params, " **items, size_t n");
+
+  prototype = batch_prototype(bn, "insert_many", params);
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "inserts items into avl",
+                                      param_list,
+                                      "number of items inserted",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t inserted = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !instance->_avl || !items) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < n; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!items[i]) continue;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "avl_insert(instance->_avl, (void *)items[i]);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "++inserted;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return inserted;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_write,
+                          "avl",
+                          "size_t",
+                          false,
+                          bn->fpre,
+                          "insert_many",
+                          "instance, items, n",
+                          "%s *instance, %s",
+                          bn->container_name,
+                          params);
+
+exit:
+  if (prototype) free(prototype);
+  if (params) free(params);
+}
+
+  /**
+   *  @fn void emit_batch_avl_delete_many_function(FILE *outfile,
+   *                                               batch_names *bn,
+   *                                               int indent)
+   *
+   *  @brief generates C function deleting many items from an avl
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param bn - pointer to names of avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_batch_avl_delete_many_function(FILE *outfile,
+                                                batch_names *bn,
+                                                int indent)
+{
+  char *prototype = NULL;
+  char *params = NULL;
+  char *param_list[] =
+  {
+    "instance - pointer to avl",
+    "targets - array of pointers to items to delete",
+    "n - number of items",
+    NULL
+  };
+
+  params = strapp(params, bn->name);
+  params = strapp(params, " **targets, size_t n");
+
+  prototype = batch_prototype(bn, "delete_many", params);
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "deletes items from avl",
+                                      param_list,
+                                      "number of items found and deleted",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "void *found = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t deleted = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (!instance || !instance->_avl || !targets) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < n; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!targets[i]) continue;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "found = avl_find(instance->_avl, (void *)targets[i]);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!found) continue;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "avl_delete(instance->_avl, found);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "++deleted;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return deleted;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_write,
+                          "avl",
+                          "size_t",
+                          false,
+                          bn->fpre,
+                          "delete_many",
+                          "instance, targets, n",
+                          "%s *instance, %s",
+                          bn->container_name,
+                          params);
+
+exit:
+  if (prototype) free(prototype);
+  if (params) free(params);
+}
+
+  /**
+   *  @fn char *batch_prototype(batch_names *bn, char *op, char *params)
+   *
+   *  @brief builds prototype of batch function @p op, static and suffixed
+   *         "_unlocked" for a concurrent container
+   *
+   *  NOTE:  caller must free returned string
+   *
+   *  @param bn - pointer to names of container
+   *  @param op - string containing operation name, ie. "add_many"
+   *  @param params - string containing C parameters after "instance"
+   *
+   *  @return prototype string on success, NULL on failure
+   */
+
+static char *batch_prototype(batch_names *bn, char *op, char *params)
+{
+  char *prototype = NULL;
+
+  prototype = strapp(prototype, concurrent_storage(bn->concurrent));
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, bn->fpre);
+  prototype = strapp(prototype, "_");
+  prototype = strapp(prototype, op);
+  prototype = strapp(prototype, concurrent_suffix(bn->concurrent));
+  prototype = strapp(prototype, "(");
+  prototype = strapp(prototype, bn->container_name);
+  prototype = strapp(prototype, " *instance, ");
+  prototype = strapp(prototype, params);
+  prototype = strapp(prototype, ")");
+
+  return prototype;
+}
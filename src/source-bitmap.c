@@ -0,0 +1,1387 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-bitmap.c
+ *  @brief bitmap index add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  An array of a struct or union with enum or bool fields keeps a bitmap
+ *  index of each of them, one row of bits per enum value, or per false and
+ *  true, where bit i is set if item i holds that value.  _array_add(),
+ *  _array_remove() and loading delimited text keep the rows up to date,
+ *  callers changing a field of an item already in the array tell the index
+ *  with _array_bitmap_refresh().  Queries copy rows out with
+ *  _array_<field>_bits() and combine them with the <project>_bitmap_*()
+ *  functions of the header, a 64 bit word at a time.
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "source-bitmap.h"
+#include "source-concurrent.h"
+#include "source-serialize.h"
+#include "options.h"
+#include "profile.h"
+
+  /**
+   *  @typedef struct bitmap_names
+   *  @brief names shared by all bitmap functions of one array
+   */
+
+typedef struct
+{
+  xmlNodePtr node;    /**<  struct or union element              */
+  char *name;         /**<  typedef name of struct or union      */
+  char *array_name;   /**<  typedef name of array                */
+  char *fpre;         /**<  function prefix of array             */
+  bool concurrent;    /**<  true if array is concurrent          */
+} bitmap_names;
+
+static int bitmap_slots(xmlNodePtr enumeration);
+static void emit_bitmap_slot_function(FILE *outfile,
+                                      bitmap_names *bn,
+                                      xmlNodePtr field,
+                                      int indent);
+static void emit_bitmap_shift_function(FILE *outfile,
+                                       bitmap_names *bn,
+                                       int indent);
+static void emit_bitmap_reserve_function(FILE *outfile,
+                                         bitmap_names *bn,
+                                         int indent);
+static void emit_bitmap_set_function(FILE *outfile,
+                                     bitmap_names *bn,
+                                     int indent);
+static void emit_bitmap_remove_function(FILE *outfile,
+                                        bitmap_names *bn,
+                                        int indent);
+static void emit_bitmap_free_function(FILE *outfile,
+                                      bitmap_names *bn,
+                                      int indent);
+static void emit_bitmap_words_function(FILE *outfile,
+                                       bitmap_names *bn,
+                                       int indent);
+static void emit_bitmap_bits_function(FILE *outfile,
+                                      bitmap_names *bn,
+                                      xmlNodePtr field,
+                                      int indent);
+static void emit_bitmap_refresh_function(FILE *outfile,
+                                         bitmap_names *bn,
+                                         int indent);
+
+  /**
+   *  @fn bool bitmap_field(xmlNodePtr field, xmlNodePtr *enumeration)
+   *
+   *  @brief determines if @p field of a struct or union gets a bitmap index
+   *
+   *  @param field - xmlNodePtr containing field element
+   *  @param enumeration - address of xmlNodePtr receiving enum element of
+   *                       field, NULL for a bool field, may be NULL
+   *
+   *  @return true if field is a named enum or a bool, false if not
+   */
+
+bool bitmap_field(xmlNodePtr field, xmlNodePtr *enumeration)
+{
+  xmlNodePtr type;
+  xmlNodePtr node;
+  char *s = NULL;
+  char *n = NULL;
+  bool is_indexed = false;
+
+  if (enumeration) *enumeration = NULL;
+
+  if (!field || strcmp((char *)field->name, "field")) goto exit;
+
+  for (type = field->children; type; type = type->next)
+    if (type->type == XML_ELEMENT_NODE) break;
+
+  if (!type) goto exit;
+
+  if (!strcmp((char *)type->name, "scalar"))
+  {
+    s = get_attribute(type, "type-name");
+    is_indexed = s && (!strcmp(s, "_Bool") || !strcmp(s, "bool"));
+    goto exit;
+  }
+
+  if (strcmp((char *)type->name, "type-reference")) goto exit;
+
+  s = get_attribute(type, "type");
+  if (!s || strcmp(s, "enum")) goto exit;
+
+  free(s);
+  s = get_attribute(type, "name");
+  if (!s) goto exit;
+
+  if (!field->parent || !field->parent->parent) goto exit;
+
+  for (node = field->parent->parent->children; node; node = node->next)
+  {
+    if (node->type != XML_ELEMENT_NODE) continue;
+    if (strcmp((char *)node->name, "enum")) continue;
+
+    n = get_attribute(node, "name");
+    if (n && !strcmp(n, s)) is_indexed = bitmap_slots(node) > 0;
+    if (n) free(n);
+    n = NULL;
+
+    if (!is_indexed) continue;
+
+    if (enumeration) *enumeration = node;
+    break;
+  }
+
+exit:
+  if (s) free(s);
+
+  return is_indexed;
+}
+
+  /**
+   *  @fn bool bitmap_any(xmlNodePtr node)
+   *
+   *  @brief determines if array of struct or union in @p node keeps a
+   *         bitmap index
+   *
+   *  @param node - xmlNodePtr containing struct or union element
+   *
+   *  @return true if it does, false if not
+   */
+
+bool bitmap_any(xmlNodePtr node)
+{
+  xmlNodePtr field;
+
+  if (!option_gen_bitmap() || !option_gen_array() || !node) return false;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    return false;
+
+  for (field = node->children; field; field = field->next)
+    if (bitmap_field(field, NULL)) return true;
+
+  return false;
+}
+
+  /**
+   *  @fn char *bitmap_value_type(xmlNodePtr field)
+   *
+   *  @brief returns C type of values of a bitmap indexed @p field
+   *
+   *  NOTE:  caller must free returned string
+   *
+   *  @param field - xmlNodePtr containing field element
+   *
+   *  @return string such as "color" or "bool", NULL if field is not indexed
+   */
+
+char *bitmap_value_type(xmlNodePtr field)
+{
+  xmlNodePtr enumeration;
+
+  if (!bitmap_field(field, &enumeration)) return NULL;
+
+  if (!enumeration) return strdup("bool");
+
+  return get_attribute(enumeration, "name");
+}
+
+  /**
+   *  @fn void emit_aggregate_bitmap_functions(FILE *outfile,
+   *                                           xmlNodePtr node,
+   *                                           char *project)
+   *
+   *  @brief generates bitmap index C source code for array of struct or
+   *         union element in @p node
+   *
+   *  NOTE:  called from the array add-on ahead of the array functions, which
+   *         use the static functions emitted here
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing lower case project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_bitmap_functions(FILE *outfile,
+                                     xmlNodePtr node,
+                                     char *project)
+{
+  bitmap_names bn;
+  xmlNodePtr field;
+  int indent = 0;
+
+  memset(&bn, 0, sizeof(bn));
+
+  if (!outfile || !node || !project) goto exit;
+
+  if (!bitmap_any(node)) goto exit;
+
+  bn.node = node;
+  bn.concurrent = concurrent_container("array");
+
+  bn.name = get_attribute(node, "name");
+  if (!bn.name) goto exit;
+
+  bn.array_name = strapp(bn.array_name, bn.name);
+  bn.array_name = strapp(bn.array_name, "_array");
+
+  bn.fpre = container_prefix(project, bn.name, "array");
+  if (!bn.array_name || !bn.fpre) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          " *  Bitmap index functions for %s %s\n",
+          node->name,
+          bn.array_name);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  for (field = node->children; field; field = field->next)
+    if (bitmap_field(field, NULL))
+      emit_bitmap_slot_function(outfile, &bn, field, indent);
+
+  emit_bitmap_shift_function(outfile, &bn, indent);
+  emit_bitmap_reserve_function(outfile, &bn, indent);
+  emit_bitmap_set_function(outfile, &bn, indent);
+  emit_bitmap_remove_function(outfile, &bn, indent);
+  emit_bitmap_free_function(outfile, &bn, indent);
+  emit_bitmap_words_function(outfile, &bn, indent);
+
+  for (field = node->children; field; field = field->next)
+    if (bitmap_field(field, NULL))
+      emit_bitmap_bits_function(outfile, &bn, field, indent);
+
+  emit_bitmap_refresh_function(outfile, &bn, indent);
+
+exit:
+  if (bn.name) free(bn.name);
+  if (bn.array_name) free(bn.array_name);
+  if (bn.fpre) free(bn.fpre);
+}
+
+  /**
+   *  @fn int bitmap_slots(xmlNodePtr enumeration)
+   *
+   *  @brief counts rows of bits of a bitmap index
+   *
+   *  NOTE:  enumerators sharing a value share a row
+   *
+   *  @param enumeration - xmlNodePtr containing enum element, NULL for bool
+   *
+   *  @return number of distinct values
+   */
+
+static int bitmap_slots(xmlNodePtr enumeration)
+{
+  xmlNodePtr item;
+  xmlNodePtr prior;
+  char *value = NULL;
+  char *s = NULL;
+  bool seen;
+  int n = 0;
+
+  if (!enumeration) return 2;
+
+  for (item = enumeration->children; item; item = item->next)
+  {
+    if (item->type != XML_ELEMENT_NODE) continue;
+    if (strcmp((char *)item->name, "item")) continue;
+
+    value = get_attribute(item, "value");
+    if (!value) continue;
+
+    seen = false;
+
+    for (prior = enumeration->children; prior != item; prior = prior->next)
+    {
+      if (prior->type != XML_ELEMENT_NODE) continue;
+      if (strcmp((char *)prior->name, "item")) continue;
+
+      s = get_attribute(prior, "value");
+      if (s && !strcmp(s, value)) seen = true;
+      if (s) free(s);
+      s = NULL;
+    }
+
+    if (!seen) ++n;
+
+    free(value);
+    value = NULL;
+  }
+
+  return n;
+}
+
+  /**
+   *  @fn void emit_bitmap_slot_function(FILE *outfile,
+   *                                     bitmap_names *bn,
+   *                                     xmlNodePtr field,
+   *                                     int indent)
+   *
+   *  @brief generates static C function mapping a value of @p field to its
+   *         row of bits
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param bn - pointer to names of array
+   *  @param field - xmlNodePtr containing field element
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_bitmap_slot_function(FILE *outfile,
+                                      bitmap_names *bn,
+                                      xmlNodePtr field,
+                                      int indent)
+{
+  xmlNodePtr enumeration;
+  xmlNodePtr item;
+  xmlNodePtr prior;
+  char *field_name = NULL;
+  char *type = NULL;
+  char *prototype = NULL;
+  char *value = NULL;
+  char *label = NULL;
+  char *s = NULL;
+  bool seen;
+  int slot = 0;
+  char *params[] =
+  {
+    "value - value of field",
+    NULL
+  };
+
+  field_name = get_attribute(field, "name");
+  type = bitmap_value_type(field);
+  if (!field_name || !type) goto exit;
+
+  bitmap_field(field, &enumeration);
+
+  prototype = strapp(prototype, "static inline int ");
+  prototype = strapp(prototype, bn->fpre);
+  prototype = strapp(prototype, "_");
+  prototype = strapp(prototype, field_name);
+  prototype = strapp(prototype, "_slot(");
+  prototype = strapp(prototype, type);
+  prototype = strapp(prototype, " value)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "maps value to its row of bits",
+                                      params,
+                                      "row of value, -1 if it has none",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  if (!enumeration)
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "return value ? 1 : 0;\n");
+  }
+  else
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "switch (value)\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "{\n");
+
+    for (item = enumeration->children; item; item = item->next)
+    {
+      if (item->type != XML_ELEMENT_NODE) continue;
+      if (strcmp((char *)item->name, "item")) continue;
+
+      value = get_attribute(item, "value");
+      label = get_attribute(item, "name");
+
+      seen = !value || !label;
+
+      for (prior = enumeration->children;
+           !seen && (prior != item);
+           prior = prior->next)
+      {
+        if (prior->type != XML_ELEMENT_NODE) continue;
+        if (strcmp((char *)prior->name, "item")) continue;
+
+        s = get_attribute(prior, "value");
+        if (s && !strcmp(s, value)) seen = true;
+        if (s) free(s);
+        s = NULL;
+      }
+
+      if (!seen)
+      {
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "case %s: return %d;\n", label, slot++);
+      }
+
+      if (value) free(value);
+      if (label) free(label);
+      value = label = NULL;
+    }
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "default: return -1;\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "}\n");
+  }
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (field_name) free(field_name);
+  if (type) free(type);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_bitmap_shift_function(FILE *outfile,
+   *                                      bitmap_names *bn,
+   *                                      int indent)
+   *
+   *  @brief generates static C function dropping one bit from a row, moving
+   *         every bit above it down by one
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param bn - pointer to names of array
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_bitmap_shift_function(FILE *outfile,
+                                       bitmap_names *bn,
+                                       int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "row - row of bits",
+    "n - number of bits in use",
+    "index - bit to drop",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static void ");
+  prototype = strapp(prototype, bn->fpre);
+  prototype = strapp(prototype,
+                     "_bitmap_shift(uint64_t *row, size_t n, size_t index)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "drops bit index, moving the bits above "
+                                      "it down by one",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t w = index / 64;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t last = (n + 63) / 64;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "unsigned b = index %% 64;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint64_t low = row[w] & ((UINT64_C(1) << b) - 1);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "uint64_t high = (b == 63) ? 0 : (row[w] >> (b + 1)) << b;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "row[w] = low | high;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (; w + 1 < last; w++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "row[w] |= row[w + 1] << 63;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "row[w + 1] >>= 1;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_bitmap_reserve_function(FILE *outfile,
+   *                                        bitmap_names *bn,
+   *                                        int indent)
+   *
+   *  @brief generates static C function making room in every row for a
+   *         number of items
+   *
+   *  NOTE:  rows are reallocated all or none, so a failure leaves the index
+   *         as it was
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param bn - pointer to names of array
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_bitmap_reserve_function(FILE *outfile,
+                                         bitmap_names *bn,
+                                         int indent)
+{
+  xmlNodePtr field;
+  xmlNodePtr enumeration;
+  char *field_name = NULL;
+  char *prototype = NULL;
+  bool first;
+  char *params[] =
+  {
+    "instance - pointer to array",
+    "n - number of items room is needed for",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static bool ");
+  prototype = strapp(prototype, bn->fpre);
+  prototype = strapp(prototype, "_bitmap_reserve(");
+  prototype = strapp(prototype, bn->array_name);
+  prototype = strapp(prototype, " *instance, size_t n)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "grows every row of bits to hold n "
+                                      "items",
+                                      params,
+                                      "true on success, false on failure, "
+                                      "index unchanged",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  for (field = bn->node->children; field; field = field->next)
+  {
+    if (!bitmap_field(field, NULL)) continue;
+
+    field_name = get_attribute(field, "name");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "uint64_t *%s_bits = NULL;\n", field_name);
+
+    free(field_name);
+  }
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "size_t words = instance->bitmap_words ? "
+          "instance->bitmap_words : 1;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (n <= instance->bitmap_words * 64) return true;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "while (words * 64 < n) words *= 2;\n");
+
+  fprintf(outfile, "\n");
+
+  for (field = bn->node->children; field; field = field->next)
+  {
+    if (!bitmap_field(field, &enumeration)) continue;
+
+    field_name = get_attribute(field, "name");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile,
+            "%s_bits = calloc(%d * words, sizeof(uint64_t));\n",
+            field_name,
+            bitmap_slots(enumeration));
+
+    free(field_name);
+  }
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (");
+
+  first = true;
+
+  for (field = bn->node->children; field; field = field->next)
+  {
+    if (!bitmap_field(field, NULL)) continue;
+
+    field_name = get_attribute(field, "name");
+
+    if (!first)
+    {
+      fprintf(outfile, " ||\n");
+      emit_indent(outfile, indent);
+      fprintf(outfile, "    ");
+    }
+    fprintf(outfile, "!%s_bits", field_name);
+
+    first = false;
+
+    free(field_name);
+  }
+
+  fprintf(outfile, ")\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  for (field = bn->node->children; field; field = field->next)
+  {
+    if (!bitmap_field(field, NULL)) continue;
+
+    field_name = get_attribute(field, "name");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "free(%s_bits);\n", field_name);
+
+    free(field_name);
+  }
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return false;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  for (field = bn->node->children; field; field = field->next)
+  {
+    if (!bitmap_field(field, &enumeration)) continue;
+
+    field_name = get_attribute(field, "name");
+
+    fprintf(outfile, "\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "if (instance->bitmap_words)\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "for (i = 0; i < %d; i++)\n", bitmap_slots(enumeration));
+
+    emit_indent(outfile, indent + 2);
+    fprintf(outfile, "memcpy(%s_bits + i * words,\n", field_name);
+
+    emit_indent(outfile, indent + 2);
+    fprintf(outfile,
+            "       instance->%s_bits + i * instance->bitmap_words,\n",
+            field_name);
+
+    emit_indent(outfile, indent + 2);
+    fprintf(outfile,
+            "       instance->bitmap_words * sizeof(uint64_t));\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "free(instance->%s_bits);\n", field_name);
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "instance->%s_bits = %s_bits;\n", field_name, field_name);
+
+    free(field_name);
+  }
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "instance->bitmap_words = words;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return true;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_bitmap_set_function(FILE *outfile,
+   *                                    bitmap_names *bn,
+   *                                    int indent)
+   *
+   *  @brief generates static C function recording the values of one item
+   *         in every row of bits
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param bn - pointer to names of array
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_bitmap_set_function(FILE *outfile,
+                                     bitmap_names *bn,
+                                     int indent)
+{
+  xmlNodePtr field;
+  xmlNodePtr enumeration;
+  char *field_name = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to array with room for item i in its index",
+    "i - index of item",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static void ");
+  prototype = strapp(prototype, bn->fpre);
+  prototype = strapp(prototype, "_bitmap_set(");
+  prototype = strapp(prototype, bn->array_name);
+  prototype = strapp(prototype, " *instance, size_t i)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "sets bit i in the row of each value "
+                                      "item i holds, clears it in the others",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint64_t bit = UINT64_C(1) << (i %% 64);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t w = i / 64;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t s;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int slot;\n");
+
+  for (field = bn->node->children; field; field = field->next)
+  {
+    if (!bitmap_field(field, &enumeration)) continue;
+
+    field_name = get_attribute(field, "name");
+
+    fprintf(outfile, "\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "for (s = 0; s < %d; s++)\n", bitmap_slots(enumeration));
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile,
+            "instance->%s_bits[s * instance->bitmap_words + w] &= ~bit;\n",
+            field_name);
+
+    free(field_name);
+  }
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance->item[i]) return;\n");
+
+  for (field = bn->node->children; field; field = field->next)
+  {
+    if (!bitmap_field(field, NULL)) continue;
+
+    field_name = get_attribute(field, "name");
+
+    fprintf(outfile, "\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile,
+            "slot = %s_%s_slot(instance->item[i]->%s%s);\n",
+            bn->fpre,
+            field_name,
+            profile_field_path(bn->name, field_name),
+            field_name);
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "if (slot >= 0)\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile,
+            "instance->%s_bits[(size_t)slot * instance->bitmap_words + w] "
+            "|= bit;\n",
+            field_name);
+
+    free(field_name);
+  }
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_bitmap_remove_function(FILE *outfile,
+   *                                       bitmap_names *bn,
+   *                                       int indent)
+   *
+   *  @brief generates static C function dropping one item from every row of
+   *         bits
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param bn - pointer to names of array
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_bitmap_remove_function(FILE *outfile,
+                                        bitmap_names *bn,
+                                        int indent)
+{
+  xmlNodePtr field;
+  xmlNodePtr enumeration;
+  char *field_name = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to array, still holding item index",
+    "index - index of item",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static void ");
+  prototype = strapp(prototype, bn->fpre);
+  prototype = strapp(prototype, "_bitmap_remove(");
+  prototype = strapp(prototype, bn->array_name);
+  prototype = strapp(prototype, " *instance, size_t index)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "drops bit index from every row, as "
+                                      "the items above it move down",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t s;\n");
+
+  for (field = bn->node->children; field; field = field->next)
+  {
+    if (!bitmap_field(field, &enumeration)) continue;
+
+    field_name = get_attribute(field, "name");
+
+    fprintf(outfile, "\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "for (s = 0; s < %d; s++)\n", bitmap_slots(enumeration));
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile,
+            "%s_bitmap_shift(instance->%s_bits + s * instance->bitmap_words,\n",
+            bn->fpre,
+            field_name);
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile,
+            "%*s(size_t)instance->n,\n",
+            (int)strlen(bn->fpre) + 14,
+            "");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "%*sindex);\n", (int)strlen(bn->fpre) + 14, "");
+
+    free(field_name);
+  }
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_bitmap_free_function(FILE *outfile,
+   *                                     bitmap_names *bn,
+   *                                     int indent)
+   *
+   *  @brief generates static C function freeing every row of bits
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param bn - pointer to names of array
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_bitmap_free_function(FILE *outfile,
+                                      bitmap_names *bn,
+                                      int indent)
+{
+  xmlNodePtr field;
+  char *field_name = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to array",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static void ");
+  prototype = strapp(prototype, bn->fpre);
+  prototype = strapp(prototype, "_bitmap_free(");
+  prototype = strapp(prototype, bn->array_name);
+  prototype = strapp(prototype, " *instance)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "frees bitmap index",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  for (field = bn->node->children; field; field = field->next)
+  {
+    if (!bitmap_field(field, NULL)) continue;
+
+    field_name = get_attribute(field, "name");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "free(instance->%s_bits);\n", field_name);
+
+    free(field_name);
+  }
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_bitmap_words_function(FILE *outfile,
+   *                                      bitmap_names *bn,
+   *                                      int indent)
+   *
+   *  @brief generates C function returning number of words of a row of bits
+   *         copied out of array
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param bn - pointer to names of array
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_bitmap_words_function(FILE *outfile,
+                                       bitmap_names *bn,
+                                       int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to array",
+    NULL
+  };
+
+  prototype = strapp(prototype, concurrent_storage(bn->concurrent));
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, bn->fpre);
+  prototype = strapp(prototype, "_bitmap_words");
+  prototype = strapp(prototype, concurrent_suffix(bn->concurrent));
+  prototype = strapp(prototype, "(");
+  prototype = strapp(prototype, bn->array_name);
+  prototype = strapp(prototype, " *instance)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "sizes the bits buffers taken by "
+                                      "queries",
+                                      params,
+                                      "number of 64 bit words covering every "
+                                      "item",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return instance ? ((size_t)instance->n + 63) / 64 : 0;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_read,
+                          "array",
+                          "size_t",
+                          false,
+                          bn->fpre,
+                          "bitmap_words",
+                          "instance",
+                          "%s *instance",
+                          bn->array_name);
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_bitmap_bits_function(FILE *outfile,
+   *                                     bitmap_names *bn,
+   *                                     xmlNodePtr field,
+   *                                     int indent)
+   *
+   *  @brief generates C function copying the row of bits of one value of
+   *         @p field out of array
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param bn - pointer to names of array
+   *  @param field - xmlNodePtr containing field element
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_bitmap_bits_function(FILE *outfile,
+                                      bitmap_names *bn,
+                                      xmlNodePtr field,
+                                      int indent)
+{
+  char *field_name = NULL;
+  char *type = NULL;
+  char *prototype = NULL;
+  char *op = NULL;
+  char *params[] =
+  {
+    "instance - pointer to array",
+    "value - value to select",
+    "bits - buffer of _bitmap_words() words, receiving bit i set for",
+    "       each item i holding value",
+    NULL
+  };
+
+  field_name = get_attribute(field, "name");
+  type = bitmap_value_type(field);
+  if (!field_name || !type) goto exit;
+
+  op = strapp(op, field_name);
+  op = strapp(op, "_bits");
+
+  prototype = strapp(prototype, concurrent_storage(bn->concurrent));
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, bn->fpre);
+  prototype = strapp(prototype, "_");
+  prototype = strapp(prototype, op);
+  prototype = strapp(prototype, concurrent_suffix(bn->concurrent));
+  prototype = strapp(prototype, "(");
+  prototype = strapp(prototype, bn->array_name);
+  prototype = strapp(prototype, " *instance, ");
+  prototype = strapp(prototype, type);
+  prototype = strapp(prototype, " value, uint64_t *bits)");
+  if (!op || !prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "selects items by value of field",
+                                      params,
+                                      "number of items selected",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint64_t *row;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t words;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t count = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int slot;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !bits) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "words = ((size_t)instance->n + 63) / 64;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "slot = %s_%s_slot(value);\n", bn->fpre, field_name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if ((slot < 0) || !instance->%s_bits)\n", field_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "memset(bits, 0, words * sizeof(uint64_t));\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "row = instance->%s_bits + (size_t)slot * instance->bitmap_words;\n",
+          field_name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < words; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "bits[i] = row[i];\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "count += (size_t)__builtin_popcountll(row[i]);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return count;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_read,
+                          "array",
+                          "size_t",
+                          false,
+                          bn->fpre,
+                          op,
+                          "instance, value, bits",
+                          "%s *instance, %s value, uint64_t *bits",
+                          bn->array_name,
+                          type);
+
+exit:
+  if (field_name) free(field_name);
+  if (type) free(type);
+  if (prototype) free(prototype);
+  if (op) free(op);
+}
+
+  /**
+   *  @fn void emit_bitmap_refresh_function(FILE *outfile,
+   *                                        bitmap_names *bn,
+   *                                        int indent)
+   *
+   *  @brief generates C function rereading the indexed fields of one item
+   *         after the caller changed them
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param bn - pointer to names of array
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_bitmap_refresh_function(FILE *outfile,
+                                         bitmap_names *bn,
+                                         int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to array",
+    "index - index of changed item",
+    NULL
+  };
+
+  prototype = strapp(prototype, concurrent_storage(bn->concurrent));
+  prototype = strapp(prototype, "void ");
+  prototype = strapp(prototype, bn->fpre);
+  prototype = strapp(prototype, "_bitmap_refresh");
+  prototype = strapp(prototype, concurrent_suffix(bn->concurrent));
+  prototype = strapp(prototype, "(");
+  prototype = strapp(prototype, bn->array_name);
+  prototype = strapp(prototype, " *instance, int index)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "updates bitmap index after an item "
+                                      "in array changed",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (!instance || (index < 0) || (index >= instance->n)) return;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_bitmap_set(instance, (size_t)index);\n", bn->fpre);
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_write,
+                          "array",
+                          "void",
+                          false,
+                          bn->fpre,
+                          "bitmap_refresh",
+                          "instance, index",
+                          "%s *instance, int index",
+                          bn->array_name);
+
+exit:
+  if (prototype) free(prototype);
+}
@@ -0,0 +1,348 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-concurrent.c
+ *  @brief thread-safe container add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  A concurrent array, list or avl keeps its functions as static
+ *  <name>_unlocked() versions and wraps each one in a public function of the
+ *  original name that takes the container's embedded rwlock.  Cursor
+ *  functions also take a cursor mutex, so readers never race on the shared
+ *  position.  Iterators, see source-iter.c, hold the read lock from
+ *  _iter_begin() to _iter_end().
+ */
+
+#include <stdarg.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "source-concurrent.h"
+#include "options.h"
+
+static void emit_concurrent_lock_init(FILE *outfile,
+                                      char *kind,
+                                      char *instance,
+                                      int indent);
+
+  /**
+   *  @fn bool concurrent_container(char *kind)
+   *
+   *  @brief determines if container @p kind is generated thread-safe
+   *
+   *  @param kind - string containing "array", "list" or "avl"
+   *
+   *  @return true if @p kind is concurrent, false if not
+   */
+
+bool concurrent_container(char *kind)
+{
+  if (!kind) return false;
+
+  if (!strcmp(kind, "array")) return option_concurrent_array();
+  if (!strcmp(kind, "list")) return option_concurrent_list();
+  if (!strcmp(kind, "avl")) return option_concurrent_avl();
+
+  return false;
+}
+
+  /**
+   *  @fn char *concurrent_storage(bool concurrent)
+   *
+   *  @brief returns storage class for a container function that may be
+   *         wrapped
+   *
+   *  @param concurrent - true if container is concurrent
+   *
+   *  @return "static " if @p concurrent, "" if not
+   */
+
+char *concurrent_storage(bool concurrent)
+{
+  return concurrent ? "static " : "";
+}
+
+  /**
+   *  @fn char *concurrent_suffix(bool concurrent)
+   *
+   *  @brief returns name suffix for a container function that may be wrapped
+   *
+   *  @param concurrent - true if container is concurrent
+   *
+   *  @return "_unlocked" if @p concurrent, "" if not
+   */
+
+char *concurrent_suffix(bool concurrent)
+{
+  return concurrent ? "_unlocked" : "";
+}
+
+  /**
+   *  @fn void emit_concurrent_wrapper(FILE *outfile,
+   *                                   concurrent_lock lock,
+   *                                   char *kind,
+   *                                   char *return_type,
+   *                                   bool pointer,
+   *                                   char *fpre,
+   *                                   char *op,
+   *                                   char *args,
+   *                                   char *params,
+   *                                   ...)
+   *
+   *  @brief generates public function @p fpre_@p op, which calls
+   *         @p fpre_@p op_unlocked under @p lock
+   *
+   *  NOTE:  nothing is emitted unless container @p kind is concurrent, the
+   *         first parameter is always the container "instance"
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param lock - @a concurrent_lock taken around the call
+   *  @param kind - string containing "array", "list" or "avl"
+   *  @param return_type - string containing C return type, without '*'
+   *  @param pointer - true if a pointer to @p return_type is returned
+   *  @param fpre - string containing function prefix of container
+   *  @param op - string containing operation name, ie. "add"
+   *  @param args - string containing argument list passed through
+   *  @param params - printf() format of C parameter list, followed by its
+   *                  arguments
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_concurrent_wrapper(FILE *outfile,
+                             concurrent_lock lock,
+                             char *kind,
+                             char *return_type,
+                             bool pointer,
+                             char *fpre,
+                             char *op,
+                             char *args,
+                             char *params,
+                             ...)
+{
+  va_list ap;
+  char *space = NULL;
+  char *result = NULL;
+  bool is_void = false;
+  bool has_cursor = false;
+  int indent = 0;
+
+  if (!outfile || !kind || !return_type || !fpre || !op) goto exit;
+  if (!args || !params) goto exit;
+
+  if (!concurrent_container(kind)) goto exit;
+
+  space = pointer ? " *" : " ";
+  is_void = !pointer && !strcmp(return_type, "void");
+  has_cursor = strcmp(kind, "avl");
+
+  fprintf(outfile, "%s%s%s_%s(", return_type, space, fpre, op);
+
+  va_start(ap, params);
+  vfprintf(outfile, params, ap);
+  va_end(ap);
+
+  fprintf(outfile, ")\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  switch (lock)
+  {
+    case concurrent_lock_create:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "%s%sinstance = NULL;\n", return_type, space);
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "instance = %s_%s_unlocked(%s);\n", fpre, op, args);
+
+      emit_concurrent_lock_init(outfile, kind, "instance", indent);
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "return instance;\n");
+      break;
+
+    case concurrent_lock_copy:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "%s%snew_instance = NULL;\n", return_type, space);
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "if (!instance) return NULL;\n");
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "pthread_rwlock_rdlock(&instance->lock);\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              "new_instance = %s_%s_unlocked(%s);\n",
+              fpre,
+              op,
+              args);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "pthread_rwlock_unlock(&instance->lock);\n");
+
+      emit_concurrent_lock_init(outfile, kind, "new_instance", indent);
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "return new_instance;\n");
+      break;
+
+    case concurrent_lock_destroy:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "if (!instance) return;\n");
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "pthread_rwlock_destroy(&instance->lock);\n");
+
+      if (has_cursor)
+      {
+        emit_indent(outfile, indent);
+        fprintf(outfile, "pthread_mutex_destroy(&instance->cursor);\n");
+      }
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "%s_%s_unlocked(%s);\n", fpre, op, args);
+      break;
+
+    default:
+      if (is_void)
+      {
+        emit_indent(outfile, indent);
+        fprintf(outfile, "if (!instance) return;\n");
+      }
+      else
+      {
+        emit_indent(outfile, indent);
+        fprintf(outfile,
+                "%s%srv = %s;\n",
+                return_type,
+                space,
+                pointer ? "NULL" : "0");
+
+        fprintf(outfile, "\n");
+
+        emit_indent(outfile, indent);
+        fprintf(outfile, "if (!instance) return rv;\n");
+      }
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              "pthread_rwlock_%slock(&instance->lock);\n",
+              lock == concurrent_lock_write ? "wr" : "rd");
+
+      if (lock == concurrent_lock_cursor && has_cursor)
+      {
+        emit_indent(outfile, indent);
+        fprintf(outfile, "pthread_mutex_lock(&instance->cursor);\n");
+      }
+
+      result = is_void ? "" : "rv = ";
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "%s%s_%s_unlocked(%s);\n", result, fpre, op, args);
+
+      if (lock == concurrent_lock_cursor && has_cursor)
+      {
+        emit_indent(outfile, indent);
+        fprintf(outfile, "pthread_mutex_unlock(&instance->cursor);\n");
+      }
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "pthread_rwlock_unlock(&instance->lock);\n");
+
+      if (!is_void)
+      {
+        fprintf(outfile, "\n");
+
+        emit_indent(outfile, indent);
+        fprintf(outfile, "return rv;\n");
+      }
+      break;
+  }
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+}
+
+  /**
+   *  @fn void emit_concurrent_lock_init(FILE *outfile,
+   *                                     char *kind,
+   *                                     char *instance,
+   *                                     int indent)
+   *
+   *  @brief generates initialisation of the locks of a new container
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param kind - string containing "array", "list" or "avl"
+   *  @param instance - string containing container variable name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_concurrent_lock_init(FILE *outfile,
+                                      char *kind,
+                                      char *instance,
+                                      int indent)
+{
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (%s)\n", instance);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "pthread_rwlock_init(&%s->lock, NULL);\n", instance);
+
+  if (strcmp(kind, "avl"))
+  {
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "pthread_mutex_init(&%s->cursor, NULL);\n", instance);
+  }
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+}
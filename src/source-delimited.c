@@ -0,0 +1,1252 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-delimited.c
+ *  @brief delimited text loader add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  Loaded text is CSV, TSV or any other single character delimited text.
+ *  Its first line names a field for every column, columns naming no
+ *  loadable field are skipped.  A value may be enclosed in double quotes,
+ *  with "" standing for a quote, but may not span lines.
+ *
+ *  Loadable fields are scalars, enums, bitfields, char * and char arrays.
+ *  Integers, plain char included as in the JSON and serialize generators,
+ *  and bitfields are decimal, so zero padded values such as "08" are not
+ *  read as octal.  A bool is true for "true" or "1", else false.
+ *  Records are read through a block buffer and handed to the container in
+ *  batches of DELIMITED_BATCH.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "source-delimited.h"
+#include "source-bitmap.h"
+#include "source-serialize.h"
+#include "source-intern.h"
+#include "source-sso.h"
+#include "options.h"
+#include "profile.h"
+
+static void emit_aggregate_load_field_index_function(FILE *outfile,
+                                                     xmlNodePtr node,
+                                                     char *project,
+                                                     int indent);
+static void emit_aggregate_load_field_function(FILE *outfile,
+                                               xmlNodePtr node,
+                                               char *project,
+                                               int indent);
+static void emit_aggregate_load_delimited_function(FILE *outfile,
+                                                   xmlNodePtr node,
+                                                   char *project,
+                                                   int indent);
+static void emit_aggregate_array_load_delimited_function(FILE *outfile,
+                                                         xmlNodePtr node,
+                                                         char *project,
+                                                         int indent);
+static serialize_kind delimited_field_kind(xmlNodePtr node, xmlNodePtr *type);
+
+  /**
+   *  @fn void emit_delimited_helpers(FILE *outfile, xmlNodePtr root)
+   *
+   *  @brief generates block buffered line reader, field splitter and bool
+   *         parser used by all delimited text loader functions of a source
+   *         file
+   *
+   *  NOTE:  nothing is emitted if declarations in @p root contain no struct,
+   *         so that the helpers are never unused
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param root - xmlNodePtr containing c-decls element
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_delimited_helpers(FILE *outfile, xmlNodePtr root)
+{
+  xmlNodePtr node;
+  bool has_struct = false;
+  int indent = 0;
+
+  if (!option_gen_delimited()) goto exit;
+
+  if (!outfile || !root) goto exit;
+
+  for (node = root->children; node; node = node->next)
+  {
+    if (!strcmp((char *)node->name, "struct")) has_struct = true;
+  }
+
+  if (!has_struct) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " *  Helpers for delimited text loader functions\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "#define DELIMITED_BUFFER 65536\n");
+  fprintf(outfile, "#define DELIMITED_BATCH 1024\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "typedef struct\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "FILE *fp;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char *buf;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t size;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t start;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t end;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool eof;\n");
+
+  --indent;
+
+  fprintf(outfile, "} delimited_reader;\n");
+
+  fprintf(outfile, "\n");
+
+    // delimited_read_line()
+
+  fprintf(outfile,
+          "static inline char *delimited_read_line(delimited_reader "
+          "*reader)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char *line = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char *nl;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "void *tmp;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t n;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (;;)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "nl = reader->buf ? memchr(reader->buf + reader->start,\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "                          '\\n',\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "                          reader->end - reader->start)"
+          " : NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "if (nl || (reader->eof && (reader->start < reader->end)))\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (!nl) nl = reader->buf + reader->end;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "*nl = '\\0';\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "line = reader->buf + reader->start;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          "reader->start = (size_t)(nl - reader->buf) + 1;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          "if (reader->start > reader->end)"
+          " reader->start = reader->end;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          "if ((nl > line) && (nl[-1] == '\\r')) nl[-1] = '\\0';\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "break;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (reader->eof) break;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "// keep partial line, growing buffer if it is full\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (reader->start)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "memmove(reader->buf,\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "        reader->buf + reader->start,\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "        reader->end - reader->start);\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "reader->end -= reader->start;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "reader->start = 0;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (reader->end + 1 >= reader->size)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          "n = reader->size ? reader->size * 2 : DELIMITED_BUFFER;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "tmp = realloc(reader->buf, n);\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (!tmp) break;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "reader->buf = tmp;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "reader->size = n;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "n = fread(reader->buf + reader->end,\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "          1,\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "          reader->size - reader->end - 1,\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "          reader->fp);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!n) reader->eof = true;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "reader->end += n;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return line;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+    // delimited_next_field()
+
+  fprintf(outfile,
+          "static inline char *delimited_next_field(char **p, "
+          "char delimiter)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char *field = *p;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char *in;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char *out;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!field) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (*field == '\"')\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "in = out = ++field;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "while (*in)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if ((in[0] == '\"') && (in[1] == '\"')) in++;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "else if (in[0] == '\"') break;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "*out++ = *in++;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "in = strchr(in, delimiter);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "*out = '\\0';\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "else\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "in = strchr(field, delimiter);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (in) *in++ = '\\0';\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*p = in;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return field;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+    // delimited_bool()
+
+  fprintf(outfile, "static inline bool delimited_bool(char *value)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "return !strcmp(value, \"true\") || !strcmp(value, \"1\");\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+}
+
+  /**
+   *  @fn void emit_aggregate_delimited_functions(FILE *outfile,
+   *                                              xmlNodePtr node,
+   *                                              char *project_name)
+   *
+   *  @brief generates delimited text loader C source code from struct
+   *         element in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_delimited_functions(FILE *outfile,
+                                        xmlNodePtr node,
+                                        char *project_name)
+{
+  char *project = NULL;
+  char *name = NULL;
+  int indent = 0;
+
+  if (!option_gen_delimited()) goto exit;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  if (strcmp((char *)node->name, "struct")) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+  str_lower(project);
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          " *  Delimited text loader functions for struct %s\n",
+          name);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  emit_aggregate_load_field_index_function(outfile, node, project, indent);
+  emit_aggregate_load_field_function(outfile, node, project, indent);
+  emit_aggregate_load_delimited_function(outfile, node, project, indent);
+
+  if (option_gen_array())
+    emit_aggregate_array_load_delimited_function(outfile,
+                                                 node,
+                                                 project,
+                                                 indent);
+
+exit:
+  if (project) free(project);
+  if (name) free(name);
+}
+
+  /**
+   *  @fn void emit_aggregate_load_field_index_function(FILE *outfile,
+   *                                                    xmlNodePtr node,
+   *                                                    char *project,
+   *                                                    int indent)
+   *
+   *  @brief generates static C source code mapping a column name to a
+   *         loadable field of struct from element in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_load_field_index_function(FILE *outfile,
+                                                     xmlNodePtr node,
+                                                     char *project,
+                                                     int indent)
+{
+  xmlNodePtr child;
+  xmlNodePtr type;
+  char *name = NULL;
+  char *fpre = NULL;
+  char *field_name = NULL;
+  int field = 0;
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+  if (!fpre) goto exit;
+
+  fprintf(outfile, "static int %s_load_field_index(char *name)\n", fpre);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (strcmp((char *)child->name, "field")) continue;
+
+    if (delimited_field_kind(child, &type) == serialize_kind_none) continue;
+
+    field_name = get_attribute(child, "name");
+    if (!field_name) continue;
+
+    emit_indent(outfile, indent);
+    fprintf(outfile,
+            "if (!strcmp(name, \"%s\")) return %d;\n",
+            field_name,
+            field++);
+
+    free(field_name);
+    field_name = NULL;
+  }
+
+  if (field) fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return -1;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+}
+
+  /**
+   *  @fn void emit_aggregate_load_field_function(FILE *outfile,
+   *                                              xmlNodePtr node,
+   *                                              char *project,
+   *                                              int indent)
+   *
+   *  @brief generates static C source code converting a column value into
+   *         a field of struct from element in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_load_field_function(FILE *outfile,
+                                               xmlNodePtr node,
+                                               char *project,
+                                               int indent)
+{
+  xmlNodePtr child;
+  xmlNodePtr type;
+  serialize_kind kind;
+  char *name = NULL;
+  char *fpre = NULL;
+  char *field_name = NULL;
+  char *lvalue = NULL;
+  char *type_name = NULL;
+  char *enum_fpre = NULL;
+  char *s = NULL;
+  int field = 0;
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+  if (!fpre) goto exit;
+
+  fprintf(outfile,
+          "static void %s_load_field(%s *instance, int field, char *value)\n",
+          fpre,
+          name);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "switch (field)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (strcmp((char *)child->name, "field")) continue;
+
+    kind = delimited_field_kind(child, &type);
+    if (kind == serialize_kind_none) continue;
+
+    field_name = get_attribute(child, "name");
+    if (!field_name) continue;
+
+    lvalue = strapp(lvalue, "instance->");
+    lvalue = strapp(lvalue, profile_field_path(name, field_name));
+    lvalue = strapp(lvalue, field_name);
+
+    type_name = get_attribute(type, "type-name");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "case %d:\n", field++);
+
+    emit_indent(outfile, indent + 1);
+
+    switch (kind)
+    {
+      case serialize_kind_string:
+        if (sso_size(name, child))
+        {
+          s = sso_store(lvalue, "value");
+          fprintf(outfile, "%s;\n", s);
+          break;
+        }
+
+        if (intern_field(name, child))
+        {
+          fprintf(outfile, "intern_release(%s);\n", lvalue);
+
+          emit_indent(outfile, indent + 1);
+          fprintf(outfile, "%s = intern_string(value);\n", lvalue);
+          break;
+        }
+
+        fprintf(outfile, "free(%s);\n", lvalue);
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "%s = strdup(value);\n", lvalue);
+        break;
+
+      case serialize_kind_bytes:
+        fprintf(outfile,
+                "snprintf(%s, sizeof(%s), \"%%s\", value);\n",
+                lvalue,
+                lvalue);
+        break;
+
+      case serialize_kind_float:
+        fprintf(outfile, "%s = strtof(value, NULL);\n", lvalue);
+        break;
+
+      case serialize_kind_double:
+        fprintf(outfile, "%s = strtod(value, NULL);\n", lvalue);
+        break;
+
+      case serialize_kind_bitfield:
+        fprintf(outfile,
+                "%s = (uint32_t)strtoul(value, NULL, 10);\n",
+                lvalue);
+        break;
+
+      default:
+        if (!strcmp((char *)type->name, "type-reference"))
+        {
+          s = get_attribute(type, "name");
+          enum_fpre = function_prefix(project, s);
+
+          fprintf(outfile, "%s = %s_from_str(value);\n", lvalue, enum_fpre);
+        }
+        else if (type_name &&
+                 (!strcmp(type_name, "_Bool") || !strcmp(type_name, "bool")))
+          fprintf(outfile, "%s = delimited_bool(value);\n", lvalue);
+        else if (type_name)
+        {
+          if (s) free(s);
+          s = get_attribute(type, "unsigned");
+
+          fprintf(outfile,
+                  "%s = (%s)%s(value, NULL, 10);\n",
+                  lvalue,
+                  type_name,
+                  (s && !strcmp(s, "true")) ? "strtoull" : "strtoll");
+        }
+        else
+          fprintf(outfile, "%s = strtol(value, NULL, 10);\n", lvalue);
+        break;
+    }
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "break;\n");
+
+    fprintf(outfile, "\n");
+
+    if (s) free(s);
+    if (enum_fpre) free(enum_fpre);
+    if (type_name) free(type_name);
+    free(lvalue);
+    free(field_name);
+    s = enum_fpre = type_name = lvalue = field_name = NULL;
+  }
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "default: break;\n");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+}
+
+  /**
+   *  @fn void emit_aggregate_load_delimited_function(FILE *outfile,
+   *                                                  xmlNodePtr node,
+   *                                                  char *project,
+   *                                                  int indent)
+   *
+   *  @brief generates C source code loading delimited text into structs
+   *         from element in @p node, handed to a container in batches
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_load_delimited_function(FILE *outfile,
+                                                   xmlNodePtr node,
+                                                   char *project,
+                                                   int indent)
+{
+  char *name = NULL;
+  char *fpre = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "fp - open FILE * to read from",
+    "delimiter - column delimiter, such as ',' or '\\t'",
+    "action - function adding a batch of structs to container, and",
+    "         returning how many it took, the rest are freed",
+    "container - pointer passed to action",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+  if (!fpre) goto exit;
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_load_delimited(FILE *fp, char delimiter, ");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, "_load_action action, void *container)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "loads every line of fp after the "
+                                      "header line into new structs",
+                                      params,
+                                      "number of structs taken by action",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "delimited_reader reader;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s *batch[DELIMITED_BATCH];\n", name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int *columns = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int n_columns = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t n = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t loaded = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t taken;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char *line;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char *p;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char *value;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "void *tmp;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!fp || !action) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "memset(&reader, 0, sizeof(reader));\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "reader.fp = fp;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "// header line maps every column to a field\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "line = delimited_read_line(&reader);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!line) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "p = line;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "while ((value = delimited_next_field(&p, delimiter)))\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "tmp = realloc(columns, sizeof(int) * (n_columns + 1));\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!tmp) goto exit;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "columns = tmp;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "columns[n_columns++] = %s_load_field_index(value);\n",
+          fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "do\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "line = delimited_read_line(&reader);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (line && *line)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "batch[n] = %s_new();\n", fpre);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (!batch[n]) line = NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "p = line;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "for (i = 0; (i < n_columns) && line; i++)\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "value = delimited_next_field(&p, delimiter);\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "if (!value) break;\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile,
+          "%s_load_field(batch[n], columns[i], value);\n",
+          fpre);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (line) n++;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if ((n == DELIMITED_BATCH) || (!line && n))\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "taken = action(container, batch, n);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "while (n > taken) %s_free(batch[--n]);\n", fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "loaded += taken;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "n = 0;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "} while (line);\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "exit:\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (columns) free(columns);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (reader.buf) free(reader.buf);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return loaded;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_aggregate_array_load_delimited_function(FILE *outfile,
+   *                                                        xmlNodePtr node,
+   *                                                        char *project,
+   *                                                        int indent)
+   *
+   *  @brief generates C source code loading delimited text into an array
+   *         of struct from element in @p node
+   *
+   *  NOTE:  loaded structs are moved into the array a batch at a time, not
+   *         copied one at a time as _array_add() does
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_array_load_delimited_function(FILE *outfile,
+                                                         xmlNodePtr node,
+                                                         char *project,
+                                                         int indent)
+{
+  char *name = NULL;
+  char *fpre = NULL;
+  char *array_name = NULL;
+  char *array_fpre = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "fp - open FILE * to read from",
+    "delimiter - column delimiter, such as ',' or '\\t'",
+    "instance - pointer to array to add structs to",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  array_name = strdup(name);
+  array_name = strapp(array_name, "_array");
+
+  fpre = function_prefix(project, name);
+  array_fpre = container_prefix(project, name, "array");
+  if (!fpre || !array_fpre) goto exit;
+
+    // static batch action moving structs into the array
+
+  fprintf(outfile,
+          "static size_t %s_load_batch(void *container,"
+          " %s **items, size_t n)\n",
+          array_fpre,
+          name);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s *instance = container;\n", array_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "void *tmp;\n");
+
+  if (bitmap_any(node))
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "size_t i;\n");
+  }
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !n) return 0;\n");
+
+  if (bitmap_any(node))
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile,
+            "if (!%s_bitmap_reserve(instance, (size_t)instance->n + n)) "
+            "return 0;\n",
+            array_fpre);
+  }
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "tmp = realloc(instance->item, sizeof(%s *) * (instance->n + n));\n",
+          name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!tmp) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "instance->item = tmp;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "memcpy(instance->item + instance->n, items, sizeof(%s *) * n);\n",
+          name);
+
+  if (bitmap_any(node))
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "for (i = 0; i < n; i++)\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile,
+            "%s_bitmap_set(instance, (size_t)instance->n + i);\n",
+            array_fpre);
+  }
+
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "instance->n += (int)n;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return n;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, array_fpre);
+  prototype = strapp(prototype, "_load_delimited(FILE *fp, char delimiter, ");
+  prototype = strapp(prototype, array_name);
+  prototype = strapp(prototype, " *instance)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "loads every line of fp after the "
+                                      "header line into instance",
+                                      params,
+                                      "number of structs added",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "return %s_load_delimited(fp, delimiter, %s_load_batch, instance);\n",
+          fpre,
+          array_fpre);
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+  if (array_name) free(array_name);
+  if (array_fpre) free(array_fpre);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn serialize_kind delimited_field_kind(xmlNodePtr node,
+   *                                          xmlNodePtr *type)
+   *
+   *  @brief determines how field element in @p node is loaded from text
+   *
+   *  @param node - xmlNodePtr containing field element
+   *  @param type - address of xmlNodePtr receiving type element of field
+   *
+   *  @return @a serialize_kind of field, serialize_kind_bytes for char
+   *          arrays, serialize_kind_none if field can not be loaded
+   */
+
+static serialize_kind delimited_field_kind(xmlNodePtr node, xmlNodePtr *type)
+{
+  serialize_kind kind;
+  char *type_name = NULL;
+
+  kind = serialize_field_kind(node, type);
+
+  switch (kind)
+  {
+    case serialize_kind_integer:
+    case serialize_kind_float:
+    case serialize_kind_double:
+    case serialize_kind_bitfield:
+    case serialize_kind_string:
+      break;
+
+    case serialize_kind_bytes:
+        // only char arrays hold text
+
+      type_name = get_attribute(*type, "type-name");
+
+      if (!type_name ||
+          strcmp(type_name, "char") ||
+          ((*type)->parent == node))
+        kind = serialize_kind_none;
+      break;
+
+    default:
+      kind = serialize_kind_none;
+      break;
+  }
+
+  if (type_name) free(type_name);
+
+  return kind;
+}
@@ -0,0 +1,1600 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-flat.c
+ *  @brief flat view add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  Flat format of a struct is a fixed size block, <PREFIX>_FLAT_SIZE bytes,
+ *  holding every field at the constant offset <PREFIX>_FLAT_OFFSET_<FIELD>,
+ *  followed by a tail holding the characters of all strings.  Integers are
+ *  little-endian and use the same widths as the serializer:
+ *
+ *    integers, enums      sizeof(field) bytes
+ *    bitfields            4 bytes
+ *    float, double        IEEE bits, 4 or 8 bytes
+ *    char *               32 bit offset of string, relative to the field
+ *                         itself, 0 for NULL
+ *    nested struct/union  flat block of nested type, in place
+ *    arrays of scalars    each element as above
+ *
+ *  Because string offsets are relative, a flat record can be read wherever
+ *  it is, from a received buffer or from a mapped file, without being
+ *  decoded first.  Unions, and scalars with no portable representation, are
+ *  copied byte for byte.  Other pointers are not followed.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "source-flat.h"
+#include "source-sso.h"
+#include "options.h"
+#include "profile.h"
+
+#define FLAT_FORMAT_VERSION "kahdifire flat 1"  /**<  bump on format change  */
+#define FLAT_HASH_SEED 0xcbf29ce484222325ULL     /**<  FNV-1a offset basis    */
+#define FLAT_HASH_PRIME 0x100000001b3ULL         /**<  FNV-1a prime           */
+
+  /**
+   *  @typedef enum flat_mode
+   *  @brief selects which flat view function code is emitted for
+   */
+
+typedef enum
+{
+  flat_mode_size = 0,  /**<  code adding tail size of field    */
+  flat_mode_store,     /**<  code storing field in a flat view  */
+  flat_mode_verify     /**<  code checking field of a flat view */
+} flat_mode;
+
+static uint64_t flat_hash_string(uint64_t hash, char *str);
+static uint64_t flat_hash_node(uint64_t hash, xmlNodePtr node);
+static void emit_aggregate_flat_size_function(FILE *outfile,
+                                              xmlNodePtr node,
+                                              char *project,
+                                              int indent);
+static void emit_aggregate_flat_store_function(FILE *outfile,
+                                               xmlNodePtr node,
+                                               char *project,
+                                               int indent);
+static void emit_aggregate_flatten_function(FILE *outfile,
+                                            xmlNodePtr node,
+                                            char *project,
+                                            int indent);
+static void emit_aggregate_flat_verify_function(FILE *outfile,
+                                                xmlNodePtr node,
+                                                char *project,
+                                                int indent);
+static void emit_flat_fields(FILE *outfile,
+                             xmlNodePtr node,
+                             char *project,
+                             flat_mode mode,
+                             int indent);
+static void emit_flat_field(FILE *outfile,
+                            xmlNodePtr node,
+                            char *project,
+                            char *aggregate_name,
+                            flat_mode mode,
+                            int indent);
+static void emit_flat_store_value(FILE *outfile,
+                                  char *lvalue,
+                                  char *position,
+                                  char *size,
+                                  serialize_kind kind,
+                                  int indent);
+static void emit_aggregate_flat_getter(FILE *outfile,
+                                       xmlNodePtr node,
+                                       char *project,
+                                       char *aggregate_name,
+                                       int indent);
+
+  /**
+   *  @fn void emit_flat_helpers(FILE *outfile, xmlNodePtr root)
+   *
+   *  @brief generates static little-endian helper functions used by all
+   *         flat view functions of a source file
+   *
+   *  NOTE:  helpers are static inline, so that they are never reported as
+   *         unused
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param root - xmlNodePtr containing c-decls element
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_flat_helpers(FILE *outfile, xmlNodePtr root)
+{
+  int indent = 0;
+
+  if (!option_gen_flat()) goto exit;
+
+  if (!outfile || !root) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " *  Little-endian helpers for flat view functions\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline void flat_put_le(unsigned char *p,\n"
+          "                               uint64_t value,\n"
+          "                               size_t n)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < n; i++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "p[i] = (unsigned char)(value >> (8 * i));\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline uint64_t flat_get_le(const unsigned char *p,"
+          " size_t n)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint64_t value = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < n; i++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "value |= (uint64_t)p[i] << (8 * i);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return value;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+}
+
+  /**
+   *  @fn void emit_aggregate_flat_functions(FILE *outfile,
+   *                                         xmlNodePtr node,
+   *                                         char *project_name)
+   *
+   *  @brief generates flat view C source code from struct or union element
+   *         in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_flat_functions(FILE *outfile,
+                                   xmlNodePtr node,
+                                   char *project_name)
+{
+  xmlNodePtr child;
+  char *project = NULL;
+  char *name = NULL;
+  int indent = 0;
+
+  if (!option_gen_flat()) goto exit;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+  str_lower(project);
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " *  Flat view functions for %s %s\n", node->name, name);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  emit_aggregate_flat_size_function(outfile, node, project, indent);
+  emit_aggregate_flat_store_function(outfile, node, project, indent);
+  emit_aggregate_flatten_function(outfile, node, project, indent);
+  emit_aggregate_flat_verify_function(outfile, node, project, indent);
+
+    // a union has no way to tell which member is in use, so it only has
+    // its raw bytes
+
+  if (!strcmp((char *)node->name, "union")) goto exit;
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (strcmp((char *)child->name, "field")) continue;
+    emit_aggregate_flat_getter(outfile, child, project, name, indent);
+  }
+
+exit:
+  if (project) free(project);
+  if (name) free(name);
+}
+
+  /**
+   *  @fn char *flat_macro(char *project, char *aggregate_name, char *suffix)
+   *
+   *  @brief builds name of a flat view macro of struct or union
+   *
+   *  @param project - string containing project name
+   *  @param aggregate_name - string containing name of struct or union
+   *  @param suffix - string containing macro suffix, such as "SIZE" or
+   *                  "OFFSET_<field>"
+   *
+   *  @return string containing upper case macro name, NULL on failure
+   *
+   *  NOTE:  caller is responsible for freeing the returned string
+   */
+
+char *flat_macro(char *project, char *aggregate_name, char *suffix)
+{
+  char *macro = NULL;
+
+  if (!project || !aggregate_name || !suffix) goto exit;
+
+  macro = function_prefix(project, aggregate_name);
+  macro = strapp(macro, "_FLAT_");
+  macro = strapp(macro, suffix);
+  if (!macro) goto exit;
+
+  str_upper(macro);
+
+exit:
+  return macro;
+}
+
+  /**
+   *  @fn char *flat_field_size(char *project,
+   *                            char *aggregate_name,
+   *                            xmlNodePtr field,
+   *                            serialize_kind kind,
+   *                            xmlNodePtr type)
+   *
+   *  @brief builds constant C expression of number of bytes field in
+   *         @p field occupies in flat block of its struct
+   *
+   *  @param project - string containing project name
+   *  @param aggregate_name - string containing name of struct
+   *  @param field - xmlNodePtr containing field element
+   *  @param kind - @a serialize_kind of field
+   *  @param type - xmlNodePtr containing type element of field
+   *
+   *  @return string containing C expression, NULL on failure
+   *
+   *  NOTE:  caller is responsible for freeing the returned string
+   */
+
+char *flat_field_size(char *project,
+                      char *aggregate_name,
+                      xmlNodePtr field,
+                      serialize_kind kind,
+                      xmlNodePtr type)
+{
+  char *size = NULL;
+  char *field_name = NULL;
+  char *type_name = NULL;
+
+  if (!project || !aggregate_name || !field) goto exit;
+
+  switch (kind)
+  {
+    case serialize_kind_none:
+      break;
+
+    case serialize_kind_bitfield:
+    case serialize_kind_string:
+      size = strdup("4");
+      break;
+
+    case serialize_kind_aggregate:
+      type_name = get_attribute(type, "name");
+      size = flat_macro(project, type_name, "SIZE");
+      break;
+
+    default:
+        // the field may have been moved to the cold half of its struct
+
+      field_name = get_attribute(field, "name");
+      if (!field_name) goto exit;
+
+      size = strapp(size, "sizeof(((");
+      size = strapp(size, aggregate_name);
+      if (profile_field_is_cold(aggregate_name, field_name))
+        size = strapp(size, "_cold");
+      size = strapp(size, " *)0)->");
+      size = strapp(size, field_name);
+      size = strapp(size, ")");
+      break;
+  }
+
+exit:
+  if (field_name) free(field_name);
+  if (type_name) free(type_name);
+
+  return size;
+}
+
+  /**
+   *  @fn char *flat_field_type(serialize_kind kind, xmlNodePtr type)
+   *
+   *  @brief builds C type returned by flat view getter of a field
+   *
+   *  @param kind - @a serialize_kind of field
+   *  @param type - xmlNodePtr containing type element of field
+   *
+   *  @return string containing C type, NULL if field has no getter
+   *
+   *  NOTE:  caller is responsible for freeing the returned string
+   */
+
+char *flat_field_type(serialize_kind kind, xmlNodePtr type)
+{
+  char *type_name = NULL;
+  char *s = NULL;
+
+  if (!type) goto exit;
+
+  switch (kind)
+  {
+    case serialize_kind_integer:
+      if (!strcmp((char *)type->name, "enum"))
+        type_name = strdup("int");
+      else if (!strcmp((char *)type->name, "type-reference"))
+        type_name = get_attribute(type, "name");
+      else
+        type_name = get_attribute(type, "type-name");
+      break;
+
+    case serialize_kind_float:
+    case serialize_kind_double:
+    case serialize_kind_array:
+      type_name = get_attribute(type, "type-name");
+      break;
+
+    case serialize_kind_bitfield:
+      type_name = strdup("uint32_t");
+      break;
+
+    case serialize_kind_string:
+      type_name = strdup("const char *");
+      break;
+
+    case serialize_kind_aggregate:
+      type_name = strdup("const unsigned char *");
+      break;
+
+    case serialize_kind_bytes:
+        // arrays of one byte scalars, such as char arrays, can be pointed
+        // at directly, anything else could be misaligned
+
+      s = get_attribute(type, "size");
+
+      if (!strcmp((char *)type->name, "scalar") && s && (atoi(s) == 8))
+      {
+        free(s);
+        s = get_attribute(type, "type-name");
+
+        type_name = strapp(type_name, "const ");
+        type_name = strapp(type_name, s);
+        type_name = strapp(type_name, " *");
+      }
+      else
+        type_name = strdup("const unsigned char *");
+      break;
+
+    default: break;
+  }
+
+exit:
+  if (s) free(s);
+
+  return type_name;
+}
+
+  /**
+   *  @fn uint64_t flat_layout_hash(xmlNodePtr node)
+   *
+   *  @brief computes hash of everything that determines flat format of
+   *         struct or union in @p node, nested structs and unions included
+   *
+   *  @param node - xmlNodePtr containing struct or union element
+   *
+   *  @return 64 bit FNV-1a hash, 0 on failure
+   */
+
+uint64_t flat_layout_hash(xmlNodePtr node)
+{
+  uint64_t hash = 0;
+
+  if (!node) goto exit;
+
+  hash = flat_hash_string(FLAT_HASH_SEED, FLAT_FORMAT_VERSION);
+  hash = flat_hash_node(hash, node);
+
+exit:
+  return hash;
+}
+
+  /**
+   *  @fn uint64_t flat_hash_string(uint64_t hash, char *str)
+   *
+   *  @brief adds @p str, and a terminator, to FNV-1a @p hash
+   *
+   *  @param hash - hash so far
+   *  @param str - string to add
+   *
+   *  @return updated hash
+   */
+
+static uint64_t flat_hash_string(uint64_t hash, char *str)
+{
+  for (; str && *str; str++)
+  {
+    hash ^= (unsigned char)*str;
+    hash *= FLAT_HASH_PRIME;
+  }
+
+  hash ^= 0xff;
+  hash *= FLAT_HASH_PRIME;
+
+  return hash;
+}
+
+  /**
+   *  @fn uint64_t flat_hash_node(uint64_t hash, xmlNodePtr node)
+   *
+   *  @brief adds name, attributes and child elements of element in @p node
+   *         to FNV-1a @p hash
+   *
+   *  NOTE:  a struct or union referenced by a field is added in place of
+   *         the reference, a struct or union referenced through a pointer
+   *         is not, since pointers are not followed
+   *
+   *  @param hash - hash so far
+   *  @param node - xmlNodePtr containing element
+   *
+   *  @return updated hash
+   */
+
+static uint64_t flat_hash_node(uint64_t hash, xmlNodePtr node)
+{
+  xmlAttrPtr attr;
+  xmlNodePtr child;
+  xmlNodePtr aggregate;
+  char *value = NULL;
+  char *name = NULL;
+
+  if (!node) goto exit;
+
+  hash = flat_hash_string(hash, (char *)node->name);
+
+  for (attr = node->properties; attr; attr = attr->next)
+  {
+    value = get_attribute(node, (char *)attr->name);
+
+    hash = flat_hash_string(hash, (char *)attr->name);
+    hash = flat_hash_string(hash, value);
+
+    if (value) free(value);
+    value = NULL;
+  }
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (child->type != XML_ELEMENT_NODE) continue;
+
+    if (!strcmp((char *)node->name, "field") &&
+        !strcmp((char *)child->name, "type-reference"))
+    {
+      name = get_attribute(child, "name");
+
+      for (aggregate = xmlDocGetRootElement(node->doc)->children;
+           aggregate;
+           aggregate = aggregate->next)
+      {
+        if (aggregate->type != XML_ELEMENT_NODE) continue;
+
+        if (strcmp((char *)aggregate->name, "struct") &&
+            strcmp((char *)aggregate->name, "union"))
+          continue;
+
+        value = get_attribute(aggregate, "name");
+
+        if (value && name && !strcmp(value, name))
+          hash = flat_hash_node(hash, aggregate);
+
+        if (value) free(value);
+        value = NULL;
+      }
+
+      if (name) free(name);
+      name = NULL;
+    }
+
+    hash = flat_hash_node(hash, child);
+  }
+
+exit:
+  return hash;
+}
+
+  /**
+   *  @fn void emit_aggregate_flat_size_function(FILE *outfile,
+   *                                             xmlNodePtr node,
+   *                                             char *project,
+   *                                             int indent)
+   *
+   *  @brief generates C source code returning flat size of struct or union
+   *         from element in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_flat_size_function(FILE *outfile,
+                                              xmlNodePtr node,
+                                              char *project,
+                                              int indent)
+{
+  char *name = NULL;
+  char *fpre = NULL;
+  char *size = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to struct or union to flatten",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+  size = flat_macro(project, name, "SIZE");
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_flat_size(");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, " *instance)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "returns number of bytes needed to "
+                                      "flatten instance, strings included",
+                                      params,
+                                      "size in bytes, 0 on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t size = %s;\n", size);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_flat_fields(outfile, node, project, flat_mode_size, indent);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return size;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+  if (size) free(size);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_aggregate_flat_store_function(FILE *outfile,
+   *                                              xmlNodePtr node,
+   *                                              char *project,
+   *                                              int indent)
+   *
+   *  @brief generates C source code storing struct or union from element
+   *         in @p node as a flat block, and its strings in a tail
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_flat_store_function(FILE *outfile,
+                                               xmlNodePtr node,
+                                               char *project,
+                                               int indent)
+{
+  char *name = NULL;
+  char *fpre = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to struct or union to flatten",
+    "view - pointer to flat block to store instance in",
+    "tail - pointer to where strings are stored",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+
+  prototype = strapp(prototype, "unsigned char *");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_flat_store(");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, " *instance, unsigned char *view, "
+                                "unsigned char *tail)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "stores instance in flat block at view, "
+                                      "and its strings at tail",
+                                      params,
+                                      "pointer past last byte stored in tail",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !view || !tail) return tail;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_flat_fields(outfile, node, project, flat_mode_store, indent);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return tail;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_aggregate_flatten_function(FILE *outfile,
+   *                                           xmlNodePtr node,
+   *                                           char *project,
+   *                                           int indent)
+   *
+   *  @brief generates C source code flattening struct or union from element
+   *         in @p node into a caller provided buffer
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_flatten_function(FILE *outfile,
+                                            xmlNodePtr node,
+                                            char *project,
+                                            int indent)
+{
+  char *name = NULL;
+  char *fpre = NULL;
+  char *size = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to struct or union to flatten",
+    "buf - pointer to buffer receiving flat view",
+    "len - size of buf in bytes",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+  size = flat_macro(project, name, "SIZE");
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_flatten(");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, " *instance, unsigned char *buf, size_t len)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "flattens instance into buf, which can "
+                                      "then be read in place",
+                                      params,
+                                      "number of bytes written, 0 on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t size = %s_flat_size(instance);\n", fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!buf || !size || (len < size)) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_flat_store(instance, buf, buf + %s);\n", fpre, size);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return size;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+  if (size) free(size);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_aggregate_flat_verify_function(FILE *outfile,
+   *                                               xmlNodePtr node,
+   *                                               char *project,
+   *                                               int indent)
+   *
+   *  @brief generates C source code checking that a flat view of struct or
+   *         union from element in @p node can be read safely
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_flat_verify_function(FILE *outfile,
+                                                xmlNodePtr node,
+                                                char *project,
+                                                int indent)
+{
+  char *name = NULL;
+  char *fpre = NULL;
+  char *size = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "view - pointer to flat view",
+    "len - number of bytes available at view",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+  size = flat_macro(project, name, "SIZE");
+
+  prototype = strapp(prototype, "bool ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_flat_verify(const unsigned char *view, "
+                                "size_t len)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "checks that every field and string of "
+                                      "view lies within len bytes",
+                                      params,
+                                      "true if view can be read, false if not",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!view || (len < %s)) return false;\n", size);
+
+  fprintf(outfile, "\n");
+
+  emit_flat_fields(outfile, node, project, flat_mode_verify, indent);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return true;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+  if (size) free(size);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_flat_fields(FILE *outfile,
+   *                            xmlNodePtr node,
+   *                            char *project,
+   *                            flat_mode mode,
+   *                            int indent)
+   *
+   *  @brief generates flat view C source code for all fields of struct or
+   *         union in @p node
+   *
+   *  NOTE:  a union has no way to tell which member is in use, so its bytes
+   *         are copied as is
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param mode - which flat view function code is emitted for
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_flat_fields(FILE *outfile,
+                             xmlNodePtr node,
+                             char *project,
+                             flat_mode mode,
+                             int indent)
+{
+  xmlNodePtr child;
+  char *name = NULL;
+
+  if (!outfile || !node || !project) goto exit;
+
+  if (!strcmp((char *)node->name, "union"))
+  {
+    if (mode == flat_mode_store)
+    {
+      emit_flat_store_value(outfile,
+                            "*instance",
+                            "view",
+                            "sizeof(*instance)",
+                            serialize_kind_bytes,
+                            indent);
+      fprintf(outfile, "\n");
+    }
+    goto exit;
+  }
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (strcmp((char *)child->name, "field")) continue;
+    emit_flat_field(outfile, child, project, name, mode, indent);
+  }
+
+exit:
+  if (name) free(name);
+}
+
+  /**
+   *  @fn void emit_flat_field(FILE *outfile,
+   *                           xmlNodePtr node,
+   *                           char *project,
+   *                           char *aggregate_name,
+   *                           flat_mode mode,
+   *                           int indent)
+   *
+   *  @brief generates flat view C source code for field element in @p node
+   *
+   *  NOTE:  only strings and nested structs or unions need code for the
+   *         size and verify functions, every other field lies entirely
+   *         within the flat block
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing field element
+   *  @param project - string containing project name
+   *  @param aggregate_name - string containing name of struct
+   *  @param mode - which flat view function code is emitted for
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_flat_field(FILE *outfile,
+                            xmlNodePtr node,
+                            char *project,
+                            char *aggregate_name,
+                            flat_mode mode,
+                            int indent)
+{
+  char *field_name = NULL;
+  char *lvalue = NULL;
+  char *position = NULL;
+  char *offset = NULL;
+  char *size = NULL;
+  char *suffix = NULL;
+  char *element = NULL;
+  char *element_position = NULL;
+  char *type_name = NULL;
+  char *fpre = NULL;
+  char *nested_size = NULL;
+  char *read;
+  xmlNodePtr type = NULL;
+  serialize_kind kind;
+  bool inline_string;
+
+  if (!outfile || !node || !project || !aggregate_name) goto exit;
+
+  field_name = get_attribute(node, "name");
+  if (!field_name) goto exit;
+
+  kind = serialize_field_kind(node, &type);
+
+  if (kind == serialize_kind_none)
+  {
+    if (mode == flat_mode_store)
+      fprintf(outfile,
+              "#warning Flatten field %s of %s here,"
+              " in _flat_size(), _flat_store() and _flat_verify()"
+              " OR remove this warning\n",
+              field_name,
+              aggregate_name);
+    goto exit;
+  }
+
+  if ((mode != flat_mode_store) &&
+      (kind != serialize_kind_string) &&
+      (kind != serialize_kind_aggregate))
+    goto exit;
+
+  lvalue = strapp(lvalue, "instance->");
+  lvalue = strapp(lvalue, profile_field_path(aggregate_name, field_name));
+  lvalue = strapp(lvalue, field_name);
+
+    // strings of inline fields are only read, through their buffer or heap,
+    // and are never NULL
+
+  inline_string = (kind == serialize_kind_string) &&
+                  (sso_size(aggregate_name, node) > 0);
+
+  if (inline_string)
+  {
+    read = sso_read(lvalue);
+    free(lvalue);
+    lvalue = read;
+  }
+
+  suffix = strapp(suffix, "OFFSET_");
+  suffix = strapp(suffix, field_name);
+
+  offset = flat_macro(project, aggregate_name, suffix);
+  if (!offset) goto exit;
+
+  position = strapp(position, "view + ");
+  position = strapp(position, offset);
+
+  size = flat_field_size(project, aggregate_name, node, kind, type);
+  if (!size) goto exit;
+
+  if (kind == serialize_kind_string)
+  {
+    switch (mode)
+    {
+      case flat_mode_size:
+        emit_indent(outfile, indent);
+        if (inline_string)
+          fprintf(outfile, "size += strlen(%s) + 1;\n", lvalue);
+        else
+          fprintf(outfile,
+                  "if (%s) size += strlen(%s) + 1;\n",
+                  lvalue,
+                  lvalue);
+        break;
+
+      case flat_mode_store:
+        if (!inline_string)
+        {
+          emit_indent(outfile, indent);
+          fprintf(outfile, "if (%s)\n", lvalue);
+        }
+
+        emit_indent(outfile, indent);
+        fprintf(outfile, "{\n");
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "size_t n = strlen(%s) + 1;\n", lvalue);
+
+        fprintf(outfile, "\n");
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile,
+                "flat_put_le(%s, (uint64_t)(tail - (%s)), 4);\n",
+                position,
+                position);
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "memcpy(tail, %s, n);\n", lvalue);
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "tail += n;\n");
+
+        emit_indent(outfile, indent);
+        fprintf(outfile, "}\n");
+
+        if (inline_string) break;
+
+        emit_indent(outfile, indent);
+        fprintf(outfile, "else\n");
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "flat_put_le(%s, 0, 4);\n", position);
+        break;
+
+      case flat_mode_verify:
+        emit_indent(outfile, indent);
+        fprintf(outfile, "{\n");
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile,
+                "size_t offset = (size_t)flat_get_le(%s, 4);\n",
+                position);
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "size_t left = len - %s;\n", offset);
+
+        fprintf(outfile, "\n");
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile,
+                "if (offset && ((offset >= left) ||\n");
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile,
+                "               !memchr(%s + offset, 0, left - offset)))\n",
+                position);
+
+        emit_indent(outfile, indent + 2);
+        fprintf(outfile, "return false;\n");
+
+        emit_indent(outfile, indent);
+        fprintf(outfile, "}\n");
+        break;
+    }
+  }
+  else if (kind == serialize_kind_aggregate)
+  {
+    type_name = get_attribute(type, "name");
+    fpre = function_prefix(project, type_name);
+    if (!fpre) goto exit;
+
+    switch (mode)
+    {
+      case flat_mode_size:
+        emit_indent(outfile, indent);
+        fprintf(outfile,
+                "size += %s_flat_size(&%s) - %s;\n",
+                fpre,
+                lvalue,
+                size);
+        break;
+
+      case flat_mode_store:
+        emit_indent(outfile, indent);
+        fprintf(outfile,
+                "tail = %s_flat_store(&%s, %s, tail);\n",
+                fpre,
+                lvalue,
+                position);
+        break;
+
+      case flat_mode_verify:
+        emit_indent(outfile, indent);
+        fprintf(outfile,
+                "if (!%s_flat_verify(%s, len - %s)) return false;\n",
+                fpre,
+                position,
+                offset);
+        break;
+    }
+  }
+  else if (kind == serialize_kind_array)
+  {
+    type_name = get_attribute(type, "type-name");
+    if (!type_name) goto exit;
+
+    element = strapp(element, "((");
+    element = strapp(element, type_name);
+    element = strapp(element, " *)&");
+    element = strapp(element, lvalue);
+    element = strapp(element, ")[i]");
+
+    element_position = strapp(element_position, position);
+    element_position = strapp(element_position, " + i * sizeof(");
+    element_position = strapp(element_position, type_name);
+    element_position = strapp(element_position, ")");
+
+    nested_size = strapp(nested_size, "sizeof(");
+    nested_size = strapp(nested_size, type_name);
+    nested_size = strapp(nested_size, ")");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "{\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "size_t i;\n");
+
+    fprintf(outfile, "\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile,
+            "for (i = 0; i < sizeof(%s) / sizeof(%s); i++)\n",
+            lvalue,
+            type_name);
+
+    emit_flat_store_value(outfile,
+                          element,
+                          element_position,
+                          nested_size,
+                          serialize_scalar_kind(type),
+                          indent + 2);
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "}\n");
+  }
+  else
+    emit_flat_store_value(outfile, lvalue, position, size, kind, indent);
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (field_name) free(field_name);
+  if (lvalue) free(lvalue);
+  if (position) free(position);
+  if (offset) free(offset);
+  if (size) free(size);
+  if (suffix) free(suffix);
+  if (element) free(element);
+  if (element_position) free(element_position);
+  if (type_name) free(type_name);
+  if (fpre) free(fpre);
+  if (nested_size) free(nested_size);
+}
+
+  /**
+   *  @fn void emit_flat_store_value(FILE *outfile,
+   *                                 char *lvalue,
+   *                                 char *position,
+   *                                 char *size,
+   *                                 serialize_kind kind,
+   *                                 int indent)
+   *
+   *  @brief generates C source code storing a single scalar value in a flat
+   *         view
+   *
+   *  NOTE:  the code emitted is a single statement, so that it can be the
+   *         body of a loop
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param lvalue - string containing C expression of value
+   *  @param position - string containing C expression of where value is
+   *                    stored
+   *  @param size - string containing C expression of size of value in bytes
+   *  @param kind - encoding of value, one of integer, float, double, bytes
+   *                or bitfield
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_flat_store_value(FILE *outfile,
+                                  char *lvalue,
+                                  char *position,
+                                  char *size,
+                                  serialize_kind kind,
+                                  int indent)
+{
+  char *bits_type;
+
+  if (!outfile || !lvalue || !position || !size) goto exit;
+
+  bits_type = (kind == serialize_kind_float) ? "uint32_t" : "uint64_t";
+
+  switch (kind)
+  {
+    case serialize_kind_integer:
+    case serialize_kind_bitfield:
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              "flat_put_le(%s, (uint64_t)%s, %s);\n",
+              position,
+              lvalue,
+              size);
+      break;
+
+    case serialize_kind_float:
+    case serialize_kind_double:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "{\n");
+
+      emit_indent(outfile, indent + 1);
+      fprintf(outfile, "%s bits;\n", bits_type);
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent + 1);
+      fprintf(outfile, "memcpy(&bits, &%s, sizeof(bits));\n", lvalue);
+
+      emit_indent(outfile, indent + 1);
+      fprintf(outfile, "flat_put_le(%s, bits, sizeof(bits));\n", position);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "}\n");
+      break;
+
+    default:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "memcpy(%s, &%s, %s);\n", position, lvalue, size);
+      break;
+  }
+
+exit:
+}
+
+  /**
+   *  @fn void emit_aggregate_flat_getter(FILE *outfile,
+   *                                      xmlNodePtr node,
+   *                                      char *project,
+   *                                      char *aggregate_name,
+   *                                      int indent)
+   *
+   *  @brief generates C source code reading field element in @p node
+   *         directly from a flat view
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing field element
+   *  @param project - string containing project name
+   *  @param aggregate_name - string containing name of struct
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_flat_getter(FILE *outfile,
+                                       xmlNodePtr node,
+                                       char *project,
+                                       char *aggregate_name,
+                                       int indent)
+{
+  char *field_name = NULL;
+  char *fpre = NULL;
+  char *suffix = NULL;
+  char *offset = NULL;
+  char *size = NULL;
+  char *return_type = NULL;
+  char *element_type = NULL;
+  char *prototype = NULL;
+  char *brief = NULL;
+  char *bits_type;
+  xmlNodePtr type = NULL;
+  serialize_kind kind;
+  serialize_kind element_kind = serialize_kind_none;
+  char *params[] =
+  {
+    "view - pointer to flat view",
+    NULL,
+    NULL
+  };
+
+  if (!outfile || !node || !project || !aggregate_name) goto exit;
+
+  field_name = get_attribute(node, "name");
+  if (!field_name) goto exit;
+
+  kind = serialize_field_kind(node, &type);
+
+  return_type = flat_field_type(kind, type);
+  if (!return_type) goto exit;
+
+  fpre = function_prefix(project, aggregate_name);
+
+  suffix = strapp(suffix, "OFFSET_");
+  suffix = strapp(suffix, field_name);
+
+  offset = flat_macro(project, aggregate_name, suffix);
+  size = flat_field_size(project, aggregate_name, node, kind, type);
+  if (!fpre || !offset || !size) goto exit;
+
+  prototype = strapp(prototype, return_type);
+  if (return_type[strlen(return_type) - 1] != '*')
+    prototype = strapp(prototype, " ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_flat_get_");
+  prototype = strapp(prototype, field_name);
+  prototype = strapp(prototype, "(const unsigned char *view");
+  if (kind == serialize_kind_array)
+  {
+    prototype = strapp(prototype, ", size_t i");
+    params[1] = "i - index of element";
+  }
+  prototype = strapp(prototype, ")");
+
+  brief = strapp(brief, "returns ");
+  brief = strapp(brief, field_name);
+  brief = strapp(brief, " read in place from flat view");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      brief,
+                                      params,
+                                      kind == serialize_kind_aggregate ?
+                                        "flat view of field" :
+                                        "value of field",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  switch (kind)
+  {
+    case serialize_kind_integer:
+    case serialize_kind_bitfield:
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              "return view ? (%s)flat_get_le(view + %s, %s) : 0;\n",
+              return_type,
+              offset,
+              size);
+      break;
+
+    case serialize_kind_float:
+    case serialize_kind_double:
+      bits_type = (kind == serialize_kind_float) ? "uint32_t" : "uint64_t";
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "%s value = 0;\n", return_type);
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "if (view)\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "{\n");
+
+      emit_indent(outfile, indent + 1);
+      fprintf(outfile,
+              "%s bits = (%s)flat_get_le(view + %s, sizeof(bits));\n",
+              bits_type,
+              bits_type,
+              offset);
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent + 1);
+      fprintf(outfile, "memcpy(&value, &bits, sizeof(value));\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "}\n");
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "return value;\n");
+      break;
+
+    case serialize_kind_string:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "size_t offset = view ? "
+                       "(size_t)flat_get_le(view + %s, 4) : 0;\n",
+              offset);
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              "return offset ? (const char *)view + %s + offset : NULL;\n",
+              offset);
+      break;
+
+    case serialize_kind_aggregate:
+    case serialize_kind_bytes:
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              "return view ? (%s)(view + %s) : NULL;\n",
+              return_type,
+              offset);
+      break;
+
+    case serialize_kind_array:
+      element_kind = serialize_scalar_kind(type);
+
+      element_type = strapp(element_type, "sizeof(");
+      element_type = strapp(element_type, return_type);
+      element_type = strapp(element_type, ")");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "%s value = 0;\n", return_type);
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "if (view && (i < %s / %s))\n", size, element_type);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "{\n");
+
+      emit_indent(outfile, indent + 1);
+      fprintf(outfile,
+              "uint64_t bits = flat_get_le(view + %s + i * %s, %s);\n",
+              offset,
+              element_type,
+              element_type);
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent + 1);
+      if (element_kind == serialize_kind_float)
+      {
+        fprintf(outfile, "uint32_t bits32 = (uint32_t)bits;\n");
+
+        fprintf(outfile, "\n");
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "memcpy(&value, &bits32, sizeof(value));\n");
+      }
+      else if (element_kind == serialize_kind_double)
+        fprintf(outfile, "memcpy(&value, &bits, sizeof(value));\n");
+      else
+        fprintf(outfile, "value = (%s)bits;\n", return_type);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "}\n");
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "return value;\n");
+      break;
+
+    default: break;
+  }
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (field_name) free(field_name);
+  if (fpre) free(fpre);
+  if (suffix) free(suffix);
+  if (offset) free(offset);
+  if (size) free(size);
+  if (return_type) free(return_type);
+  if (element_type) free(element_type);
+  if (prototype) free(prototype);
+  if (brief) free(brief);
+}
@@ -0,0 +1,1127 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-hash.c
+ *  @brief hash and equality add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  Fields are compared and hashed by type:
+ *
+ *    integers, enums, pointers   by value, runs of adjacent fields with no
+ *    and arrays of these         padding between them as one memcmp()
+ *    bitfields                   by value, one at a time
+ *    float, double               by ==, -0.0 hashing as 0.0
+ *    char *                      by string contents, NULL equal to NULL,
+ *                                or by address when interned
+ *    char arrays                 by string contents, up to first NUL
+ *    nested structs              by their own _equal() and _hash()
+ *
+ *  Unions, and scalars with no portable representation, are compared byte
+ *  for byte.  Pointers other than char * are compared by address.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "source-hash.h"
+#include "source-serialize.h"
+#include "source-intern.h"
+#include "source-sso.h"
+#include "layout.h"
+#include "options.h"
+#include "profile.h"
+
+  /**
+   *  @typedef enum hash_mode
+   *  @brief selects which of hash or equality function code is emitted for
+   */
+
+typedef enum
+{
+  hash_mode_hash = 0,  /**<  code adding to hash          */
+  hash_mode_equal      /**<  code comparing two structs   */
+} hash_mode;
+
+static void emit_aggregate_hash_function(FILE *outfile,
+                                         xmlNodePtr node,
+                                         char *project,
+                                         int indent);
+static void emit_aggregate_equal_function(FILE *outfile,
+                                          xmlNodePtr node,
+                                          char *project,
+                                          int indent);
+static void emit_hash_fields(FILE *outfile,
+                             xmlNodePtr node,
+                             char *project,
+                             hash_mode mode,
+                             int indent);
+static void emit_hash_run(FILE *outfile,
+                          char *aggregate_name,
+                          char *first,
+                          char *last,
+                          hash_mode mode,
+                          int indent);
+static void emit_hash_field(FILE *outfile,
+                            xmlNodePtr node,
+                            char *project,
+                            char *aggregate_name,
+                            hash_mode mode,
+                            int indent);
+
+  /**
+   *  @fn void emit_hash_helpers(FILE *outfile, xmlNodePtr root)
+   *
+   *  @brief generates static mixing and comparison helper functions used by
+   *         all hash and equality functions of a source file
+   *
+   *  NOTE:  sharded maps hash their keys with these helpers too, nothing is
+   *         emitted if declarations in @p root contain no struct or union
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param root - xmlNodePtr containing c-decls element
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_hash_helpers(FILE *outfile, xmlNodePtr root)
+{
+  xmlNodePtr node;
+  bool has_aggregate = false;
+  int indent = 0;
+
+  if (!option_gen_hash() && !option_gen_shardmap()) goto exit;
+
+  if (!outfile || !root) goto exit;
+
+  for (node = root->children; node; node = node->next)
+  {
+    if (!strcmp((char *)node->name, "struct") ||
+        !strcmp((char *)node->name, "union"))
+      has_aggregate = true;
+  }
+
+  if (!has_aggregate) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " *  Mixing helpers for hash and equality functions\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "#define HASH_SEED UINT64_C(0x9e3779b97f4a7c15)\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline uint64_t hash_mix(uint64_t hash, uint64_t value)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "hash ^= value;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "hash *= UINT64_C(0xff51afd7ed558ccd);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return hash ^ (hash >> 32);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline uint64_t hash_bytes(uint64_t hash, const void *p, "
+          "size_t n)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "const unsigned char *s = p;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint64_t word;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "hash = hash_mix(hash, n);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (; n >= 8; s += 8, n -= 8)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "memcpy(&word, s, 8);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "hash = hash_mix(hash, word);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (n)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "word = 0;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "memcpy(&word, s, n);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "hash = hash_mix(hash, word);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return hash;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline uint64_t hash_string(uint64_t hash, const char "
+          "*s)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "return s ? hash_bytes(hash, s, strlen(s)) : hash_mix(hash, "
+          "UINT64_MAX);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline uint64_t hash_double(uint64_t hash, double value)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint64_t bits;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "// -0.0 equals 0.0, so both must hash alike\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (value == 0) value = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "memcpy(&bits, &value, sizeof(bits));\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return hash_mix(hash, bits);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "static inline uint64_t hash_final(uint64_t hash)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "hash ^= hash >> 33;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "hash *= UINT64_C(0xff51afd7ed558ccd);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "hash ^= hash >> 33;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "hash *= UINT64_C(0xc4ceb9fe1a85ec53);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return hash ^ (hash >> 33);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline bool hash_string_equal(const char *a, const char "
+          "*b)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return (a == b) || (a && b && !strcmp(a, b));\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+
+exit:
+}
+
+  /**
+   *  @fn void emit_aggregate_hash_functions(FILE *outfile,
+   *                                         xmlNodePtr node,
+   *                                         char *project_name)
+   *
+   *  @brief generates hash and equality C source code from struct or union
+   *         element in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_hash_functions(FILE *outfile,
+                                   xmlNodePtr node,
+                                   char *project_name)
+{
+  char *project = NULL;
+  char *name = NULL;
+  int indent = 0;
+
+  if (!option_gen_hash()) goto exit;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+  str_lower(project);
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          " *  Hash and equality functions for %s %s\n",
+          node->name,
+          name);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  emit_aggregate_hash_function(outfile, node, project, indent);
+  emit_aggregate_equal_function(outfile, node, project, indent);
+
+exit:
+  if (project) free(project);
+  if (name) free(name);
+}
+
+  /**
+   *  @fn void emit_aggregate_hash_function(FILE *outfile,
+   *                                        xmlNodePtr node,
+   *                                        char *project,
+   *                                        int indent)
+   *
+   *  @brief generates C source code hashing struct or union from element in
+   *         @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_hash_function(FILE *outfile,
+                                         xmlNodePtr node,
+                                         char *project,
+                                         int indent)
+{
+  char *name = NULL;
+  char *fpre = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to struct or union to hash",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+  if (!fpre) goto exit;
+
+  prototype = strapp(prototype, "uint64_t ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_hash(");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, " *instance)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "hashes contents of instance",
+                                      params,
+                                      "64 bit hash, equal for instances "
+                                      "that _equal() finds equal",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint64_t hash = HASH_SEED;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_hash_fields(outfile, node, project, hash_mode_hash, indent);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return hash_final(hash);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_aggregate_equal_function(FILE *outfile,
+   *                                         xmlNodePtr node,
+   *                                         char *project,
+   *                                         int indent)
+   *
+   *  @brief generates C source code comparing two structs or unions from
+   *         element in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_equal_function(FILE *outfile,
+                                          xmlNodePtr node,
+                                          char *project,
+                                          int indent)
+{
+  char *name = NULL;
+  char *fpre = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "a - pointer to struct or union",
+    "b - pointer to struct or union",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+  if (!fpre) goto exit;
+
+  prototype = strapp(prototype, "bool ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_equal(");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, " *a, ");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, " *b)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "compares contents of a and b, "
+                                      "field by field",
+                                      params,
+                                      "true if a and b are equal, "
+                                      "false if not",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (a == b) return true;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!a || !b) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_hash_fields(outfile, node, project, hash_mode_equal, indent);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return true;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_hash_fields(FILE *outfile,
+   *                            xmlNodePtr node,
+   *                            char *project,
+   *                            hash_mode mode,
+   *                            int indent)
+   *
+   *  @brief generates hash or equality C source code for every field of
+   *         struct or union element in @p node
+   *
+   *  Fields are visited in the order the header emits them.  A run of
+   *  integer, pointer or integer array fields is merged while every next
+   *  field is aligned no more strictly than the first and starts exactly
+   *  where the run ends, so no padding can fall inside the run, however
+   *  the struct itself is placed.
+   *
+   *  NOTE:  fields split off by an access profile are compared one at a
+   *         time, after all others
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param mode - which function code is emitted for
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_hash_fields(FILE *outfile,
+                             xmlNodePtr node,
+                             char *project,
+                             hash_mode mode,
+                             int indent)
+{
+  layout *lo = NULL;
+  layout *packed = NULL;
+  layout *order;
+  layout_member *m;
+  layout_member *first = NULL;
+  layout_member *last = NULL;
+  xmlNodePtr type;
+  hash_kind kind;
+  char *name = NULL;
+  bool split;
+  int run_bits = 0;
+  int pass;
+  int i;
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  if (!strcmp((char *)node->name, "union"))
+  {
+    emit_indent(outfile, indent);
+    if (mode == hash_mode_hash)
+      fprintf(outfile,
+              "hash = hash_bytes(hash, instance, sizeof(%s));\n",
+              name);
+    else
+      fprintf(outfile, "if (memcmp(a, b, sizeof(%s))) return false;\n", name);
+    goto exit;
+  }
+
+  lo = layout_new(node);
+  if (!lo) goto exit;
+
+  if (option_pack()) packed = layout_pack(lo);
+  order = packed ? packed : lo;
+
+  split = profile_split(name);
+
+  for (pass = 0; pass < (split ? 2 : 1); pass++)
+  {
+    for (i = 0; i < order->n; i++)
+    {
+      m = &order->members[i];
+      if (!m->name) continue;
+
+      if (split && (profile_field_is_cold(name, m->name) != (pass == 1)))
+        continue;
+
+      kind = hash_field_kind(m->field, &type);
+      if (intern_field(name, m->field)) kind = hash_kind_pointer;
+
+      if (first && (pass == 0) &&
+          ((kind == hash_kind_integer) ||
+           (kind == hash_kind_pointer) ||
+           (kind == hash_kind_array)) &&
+          (m->align > 0) &&
+          (m->align <= first->align) &&
+          !(run_bits % m->align))
+      {
+        last = m;
+        run_bits += m->size;
+        continue;
+      }
+
+      if (first && (first != last))
+        emit_hash_run(outfile, name, first->name, last->name, mode, indent);
+      else if (first)
+        emit_hash_field(outfile, first->field, project, name, mode, indent);
+
+      first = last = NULL;
+
+      if ((pass == 0) &&
+          ((kind == hash_kind_integer) ||
+           (kind == hash_kind_pointer) ||
+           (kind == hash_kind_array)) &&
+          (m->align > 0) &&
+          !(m->size % 8))
+      {
+        first = last = m;
+        run_bits = m->size;
+        continue;
+      }
+
+      emit_hash_field(outfile, m->field, project, name, mode, indent);
+    }
+
+    if (first && (first != last))
+      emit_hash_run(outfile, name, first->name, last->name, mode, indent);
+    else if (first)
+      emit_hash_field(outfile, first->field, project, name, mode, indent);
+
+    first = last = NULL;
+  }
+
+exit:
+  if (packed) layout_free(packed);
+  if (lo) layout_free(lo);
+  if (name) free(name);
+}
+
+  /**
+   *  @fn void emit_hash_run(FILE *outfile,
+   *                         char *aggregate_name,
+   *                         char *first,
+   *                         char *last,
+   *                         hash_mode mode,
+   *                         int indent)
+   *
+   *  @brief generates hash or equality C source code for a run of adjacent
+   *         fields, from field @p first through field @p last
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param aggregate_name - string containing name of struct
+   *  @param first - string containing name of first field of run
+   *  @param last - string containing name of last field of run
+   *  @param mode - which function code is emitted for
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_hash_run(FILE *outfile,
+                          char *aggregate_name,
+                          char *first,
+                          char *last,
+                          hash_mode mode,
+                          int indent)
+{
+  char *self = (mode == hash_mode_hash) ? "instance" : "a";
+
+  if (!outfile || !aggregate_name || !first || !last) goto exit;
+
+  emit_indent(outfile, indent);
+
+  if (mode == hash_mode_hash)
+    fprintf(outfile, "hash = hash_bytes(hash,\n");
+  else
+    fprintf(outfile, "if (memcmp(&a->%s,\n", first);
+
+  emit_indent(outfile, indent);
+
+  if (mode == hash_mode_hash)
+    fprintf(outfile, "                  &instance->%s,\n", first);
+  else
+    fprintf(outfile, "           &b->%s,\n", first);
+
+  emit_indent(outfile, indent);
+
+  fprintf(outfile,
+          "%soffsetof(%s, %s) + sizeof(%s->%s) -\n",
+          (mode == hash_mode_hash) ? "                  " : "           ",
+          aggregate_name,
+          last,
+          self,
+          last);
+
+  emit_indent(outfile, indent);
+
+  fprintf(outfile,
+          "%soffsetof(%s, %s))%s\n",
+          (mode == hash_mode_hash) ? "                  " : "           ",
+          aggregate_name,
+          first,
+          (mode == hash_mode_hash) ? ";" : ")");
+
+  if (mode == hash_mode_equal)
+  {
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "return false;\n");
+  }
+
+exit:
+}
+
+  /**
+   *  @fn void emit_hash_field(FILE *outfile,
+   *                           xmlNodePtr node,
+   *                           char *project,
+   *                           char *aggregate_name,
+   *                           hash_mode mode,
+   *                           int indent)
+   *
+   *  @brief generates hash or equality C source code for field element in
+   *         @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing field element
+   *  @param project - string containing project name
+   *  @param aggregate_name - string containing name of struct
+   *  @param mode - which function code is emitted for
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_hash_field(FILE *outfile,
+                            xmlNodePtr node,
+                            char *project,
+                            char *aggregate_name,
+                            hash_mode mode,
+                            int indent)
+{
+  xmlNodePtr type = NULL;
+  hash_kind kind;
+  char *field_name = NULL;
+  char *path = NULL;
+  char *lvalue = NULL;
+  char *a = NULL;
+  char *b = NULL;
+  char *read;
+  char *type_name = NULL;
+  char *fpre = NULL;
+
+  if (!outfile || !node || !project || !aggregate_name) goto exit;
+
+  field_name = get_attribute(node, "name");
+  if (!field_name) goto exit;
+
+  kind = hash_field_kind(node, &type);
+
+    // interned strings are shared, so equal strings have equal addresses
+
+  if (intern_field(aggregate_name, node)) kind = hash_kind_pointer;
+
+  if (kind == hash_kind_none)
+  {
+    if (mode == hash_mode_hash)
+      fprintf(outfile,
+              "#warning Compare field %s of %s here,"
+              " in _hash() and _equal()"
+              " OR remove this warning\n",
+              field_name,
+              aggregate_name);
+    goto exit;
+  }
+
+  path = strapp(path, profile_field_path(aggregate_name, field_name));
+  path = strapp(path, field_name);
+
+  lvalue = strapp(lvalue, "instance->");
+  lvalue = strapp(lvalue, path);
+
+  a = strapp(a, "a->");
+  a = strapp(a, path);
+
+  b = strapp(b, "b->");
+  b = strapp(b, path);
+
+    // inline strings are read from their buffer or heap
+
+  if ((kind == hash_kind_string) && sso_size(aggregate_name, node))
+  {
+    read = sso_read(lvalue);
+    free(lvalue);
+    lvalue = read;
+
+    read = sso_read(a);
+    free(a);
+    a = read;
+
+    read = sso_read(b);
+    free(b);
+    b = read;
+  }
+
+  emit_indent(outfile, indent);
+
+  switch (kind)
+  {
+    case hash_kind_integer:
+    case hash_kind_bitfield:
+      if (mode == hash_mode_hash)
+        fprintf(outfile,
+                "hash = hash_mix(hash, (uint64_t)%s);\n",
+                lvalue);
+      else
+        fprintf(outfile, "if (%s != %s) return false;\n", a, b);
+      break;
+
+    case hash_kind_pointer:
+      if (mode == hash_mode_hash)
+        fprintf(outfile,
+                "hash = hash_mix(hash, (uint64_t)(uintptr_t)%s);\n",
+                lvalue);
+      else
+        fprintf(outfile, "if (%s != %s) return false;\n", a, b);
+      break;
+
+    case hash_kind_float:
+      if (mode == hash_mode_hash)
+        fprintf(outfile, "hash = hash_double(hash, %s);\n", lvalue);
+      else
+        fprintf(outfile, "if (%s != %s) return false;\n", a, b);
+      break;
+
+    case hash_kind_float_array:
+      type_name = get_attribute(type, "type-name");
+
+      fprintf(outfile, "{\n");
+
+      emit_indent(outfile, indent + 1);
+      fprintf(outfile, "size_t i;\n");
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent + 1);
+      fprintf(outfile,
+              "for (i = 0; i < sizeof(%s) / sizeof(%s); i++)\n",
+              (mode == hash_mode_hash) ? lvalue : a,
+              type_name);
+
+      emit_indent(outfile, indent + 2);
+      if (mode == hash_mode_hash)
+        fprintf(outfile,
+                "hash = hash_double(hash, ((%s *)&%s)[i]);\n",
+                type_name,
+                lvalue);
+      else
+        fprintf(outfile,
+                "if (((%s *)&%s)[i] != ((%s *)&%s)[i]) return false;\n",
+                type_name,
+                a,
+                type_name,
+                b);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "}\n");
+      break;
+
+    case hash_kind_string:
+      if (mode == hash_mode_hash)
+        fprintf(outfile, "hash = hash_string(hash, %s);\n", lvalue);
+      else
+        fprintf(outfile,
+                "if (!hash_string_equal(%s, %s)) return false;\n",
+                a,
+                b);
+      break;
+
+    case hash_kind_chars:
+      if (mode == hash_mode_hash)
+      {
+        fprintf(outfile, "hash = hash_bytes(hash,\n");
+
+        emit_indent(outfile, indent);
+        fprintf(outfile, "                  %s,\n", lvalue);
+
+        emit_indent(outfile, indent);
+        fprintf(outfile,
+                "                  strnlen(%s, sizeof(%s)));\n",
+                lvalue,
+                lvalue);
+      }
+      else
+        fprintf(outfile,
+                "if (strncmp(%s, %s, sizeof(%s))) return false;\n",
+                a,
+                b,
+                a);
+      break;
+
+    case hash_kind_struct:
+      type_name = get_attribute(type, "name");
+      fpre = function_prefix(project, type_name);
+
+      if (mode == hash_mode_hash)
+        fprintf(outfile,
+                "hash = hash_mix(hash, %s_hash(&%s));\n",
+                fpre,
+                lvalue);
+      else
+        fprintf(outfile,
+                "if (!%s_equal(&%s, &%s)) return false;\n",
+                fpre,
+                a,
+                b);
+      break;
+
+    default:
+      if (mode == hash_mode_hash)
+        fprintf(outfile,
+                "hash = hash_bytes(hash, &%s, sizeof(%s));\n",
+                lvalue,
+                lvalue);
+      else
+        fprintf(outfile,
+                "if (memcmp(&%s, &%s, sizeof(%s))) return false;\n",
+                a,
+                b,
+                a);
+      break;
+  }
+
+exit:
+  if (field_name) free(field_name);
+  if (path) free(path);
+  if (lvalue) free(lvalue);
+  if (a) free(a);
+  if (b) free(b);
+  if (type_name) free(type_name);
+  if (fpre) free(fpre);
+}
+
+  /**
+   *  @fn hash_kind hash_field_kind(xmlNodePtr node, xmlNodePtr *type)
+   *
+   *  @brief determines how field element in @p node is hashed and compared
+   *
+   *  @param node - xmlNodePtr containing field element
+   *  @param type - address of xmlNodePtr receiving type element of field,
+   *                which is the scalar element for arrays and char *
+   *
+   *  @return @a hash_kind of field, hash_kind_none if field can not be
+   *          compared
+   */
+
+hash_kind hash_field_kind(xmlNodePtr node, xmlNodePtr *type)
+{
+  xmlNodePtr child;
+  xmlNodePtr scalar;
+  hash_kind kind = hash_kind_none;
+  char *s = NULL;
+
+  if (!node || !type) goto exit;
+
+  *type = NULL;
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (!strcmp((char *)child->name, "text")) continue;
+
+    *type = child;
+
+    if (!strcmp((char *)child->name, "scalar"))
+    {
+      switch (serialize_scalar_kind(child))
+      {
+        case serialize_kind_integer: kind = hash_kind_integer; break;
+        case serialize_kind_float:
+        case serialize_kind_double: kind = hash_kind_float; break;
+        default: kind = hash_kind_bytes; break;
+      }
+    }
+    else if (!strcmp((char *)child->name, "bitfield"))
+      kind = hash_kind_bitfield;
+    else if (!strcmp((char *)child->name, "enum"))
+      kind = hash_kind_integer;
+    else if (!strcmp((char *)child->name, "type-reference"))
+    {
+      s = get_attribute(child, "type");
+
+      if (s && !strcmp(s, "enum"))
+        kind = hash_kind_integer;
+      else if (s && !strcmp(s, "struct"))
+      {
+        free(s);
+        s = get_attribute(child, "name");
+
+        kind = aggregates_find(type_cache, s) ? hash_kind_struct
+                                              : hash_kind_bytes;
+      }
+      else
+        kind = hash_kind_bytes;
+    }
+    else if (!strcmp((char *)child->name, "pointer"))
+    {
+      kind = hash_kind_pointer;
+
+      scalar = pointer_find_scalar(child);
+      if (!scalar || (pointer_count(child) != 1)) continue;
+
+      s = get_attribute(scalar, "type-name");
+      if (s && !strcmp(s, "char"))
+      {
+        *type = scalar;
+        kind = hash_kind_string;
+      }
+    }
+    else if (!strcmp((char *)child->name, "array"))
+    {
+      kind = hash_kind_bytes;
+
+      scalar = array_find_scalar(child);
+      if (!scalar) continue;
+
+      if (array_pointer_count(child))
+      {
+        kind = hash_kind_array;
+        continue;
+      }
+
+      *type = scalar;
+
+      s = get_attribute(scalar, "type-name");
+
+      switch (serialize_scalar_kind(scalar))
+      {
+        case serialize_kind_integer:
+          if (s && !strcmp(s, "char") && (scalar->parent == child))
+            kind = hash_kind_chars;
+          else
+            kind = hash_kind_array;
+          break;
+
+        case serialize_kind_float:
+        case serialize_kind_double:
+          kind = hash_kind_float_array;
+          break;
+
+        default: break;
+      }
+    }
+
+    if (s) free(s);
+    s = NULL;
+  }
+
+exit:
+  if (s) free(s);
+
+  return kind;
+}
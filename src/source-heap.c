@@ -0,0 +1,1556 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-heap.c
+ *  @brief array backed heap add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  A heap keeps item pointers of a struct or union in one array, ordered as
+ *  a 4-ary heap on a key field, smallest key on top, or largest with the
+ *  ":max" option.  Four children per position make the tree half as deep as
+ *  a binary heap and put siblings next to each other, and each entry holds
+ *  a copy of the key, so sifting compares entries without touching items.
+ *
+ *  Every push hands out a handle, a small integer that stays with the item
+ *  while it is in the heap.  The heap tracks the position of each handle,
+ *  so after changing the key of an item callers pass its handle to
+ *  _update(), which moves the item up or down to where it now belongs, a
+ *  decrease-key, or increase-key, in O(log n).  Handles of popped items are
+ *  reused.
+ *
+ *  Keys may be integers, enums, floating point, char * or char arrays.
+ *  Items are not owned by the heap.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "source-heap.h"
+#include "source-serialize.h"
+#include "options.h"
+#include "profile.h"
+
+  /**
+   *  @typedef struct heap_names
+   *  @brief names shared by all functions of one heap
+   */
+
+typedef struct
+{
+  char *name;       /**<  typedef name of struct or union       */
+  char *heap_name;  /**<  typedef name of heap                  */
+  char *fpre;       /**<  function prefix of heap               */
+  char *item_fpre;  /**<  function prefix of struct or union    */
+  char *field;      /**<  name of key field                     */
+  char *path;       /**<  member access path of key field       */
+  char *key_type;   /**<  C type of copy of key in entries      */
+  hash_kind kind;   /**<  how key is compared                   */
+} heap_names;
+
+static void emit_heap_key_function(FILE *outfile,
+                                   heap_names *hn,
+                                   int indent);
+static void emit_heap_before_function(FILE *outfile,
+                                      heap_names *hn,
+                                      int indent);
+static void emit_heap_sift_up_function(FILE *outfile,
+                                       heap_names *hn,
+                                       int indent);
+static void emit_heap_sift_down_function(FILE *outfile,
+                                         heap_names *hn,
+                                         int indent);
+static void emit_heap_grow_function(FILE *outfile,
+                                    heap_names *hn,
+                                    int indent);
+static void emit_heap_new_function(FILE *outfile,
+                                   heap_names *hn,
+                                   int indent);
+static void emit_heap_heapify_function(FILE *outfile,
+                                       heap_names *hn,
+                                       int indent);
+static void emit_heap_free_function(FILE *outfile,
+                                    heap_names *hn,
+                                    int indent);
+static void emit_heap_push_function(FILE *outfile,
+                                    heap_names *hn,
+                                    int indent);
+static void emit_heap_peek_function(FILE *outfile,
+                                    heap_names *hn,
+                                    int indent);
+static void emit_heap_pop_function(FILE *outfile,
+                                   heap_names *hn,
+                                   int indent);
+static void emit_heap_update_function(FILE *outfile,
+                                      heap_names *hn,
+                                      int indent);
+static void emit_heap_count_function(FILE *outfile,
+                                     heap_names *hn,
+                                     int indent);
+
+  /**
+   *  @fn xmlNodePtr ordered_key(xmlNodePtr node, char *field, hash_kind *kind)
+   *
+   *  @brief finds key field @p field of struct or union in @p node, for
+   *         containers kept in key order
+   *
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param field - string containing name of key field, may be NULL
+   *  @param kind - address of @a hash_kind receiving how key is compared,
+   *                may be NULL
+   *
+   *  @return xmlNodePtr of key field element, NULL if struct or union has
+   *          no field named @p field, or it is of a type that can not be
+   *          ordered
+   */
+
+xmlNodePtr ordered_key(xmlNodePtr node, char *field, hash_kind *kind)
+{
+  xmlNodePtr child;
+  xmlNodePtr key = NULL;
+  xmlNodePtr type;
+  hash_kind k;
+  char *s = NULL;
+
+  if (!node || !field) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (strcmp((char *)child->name, "field")) continue;
+
+    s = get_attribute(child, "name");
+    if (s && !strcmp(s, field)) key = child;
+    if (s) free(s);
+    s = NULL;
+
+    if (key) break;
+  }
+
+  if (!key) goto exit;
+
+  k = hash_field_kind(key, &type);
+
+  switch (k)
+  {
+    case hash_kind_integer:
+      if (strcmp((char *)type->name, "scalar") &&
+          strcmp((char *)type->name, "type-reference"))
+        key = NULL;
+      break;
+
+    case hash_kind_float:
+    case hash_kind_string:
+    case hash_kind_chars:
+      break;
+
+    default:
+      key = NULL;
+      break;
+  }
+
+  if (key && kind) *kind = k;
+
+exit:
+  return key;
+}
+
+  /**
+   *  @fn char *ordered_key_type(xmlNodePtr node, char *field)
+   *
+   *  @brief builds C type of a copy of key field @p field of struct or
+   *         union in @p node
+   *
+   *  NOTE:  caller must free returned string
+   *
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param field - string containing name of key field, may be NULL
+   *
+   *  @return string such as "unsigned int" or "const char *", NULL if
+   *          @p field can not be ordered
+   */
+
+char *ordered_key_type(xmlNodePtr node, char *field)
+{
+  xmlNodePtr key;
+  xmlNodePtr type;
+  hash_kind kind;
+
+  key = ordered_key(node, field, &kind);
+  if (!key) return NULL;
+
+  if ((kind == hash_kind_string) || (kind == hash_kind_chars))
+    return strdup("const char *");
+
+  hash_field_kind(key, &type);
+
+  if (!strcmp((char *)type->name, "scalar"))
+    return get_attribute(type, "type-name");
+
+  return get_attribute(type, "name");
+}
+
+  /**
+   *  @fn xmlNodePtr heap_key(xmlNodePtr node, hash_kind *kind)
+   *
+   *  @brief finds key field of heap of struct or union in @p node
+   *
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param kind - address of @a hash_kind receiving how key is compared,
+   *                may be NULL
+   *
+   *  @return xmlNodePtr of key field element, NULL if struct or union has
+   *          no field named by the heap key option, or it is of a type that
+   *          can not be ordered
+   */
+
+xmlNodePtr heap_key(xmlNodePtr node, hash_kind *kind)
+{
+  return ordered_key(node, option_heap_key(), kind);
+}
+
+  /**
+   *  @fn char *heap_key_type(xmlNodePtr node)
+   *
+   *  @brief builds C type of the copy of the key kept in heap entries of
+   *         struct or union in @p node
+   *
+   *  NOTE:  caller must free returned string
+   *
+   *  @param node - xmlNodePtr containing struct or union element
+   *
+   *  @return string such as "unsigned int" or "const char *", NULL if
+   *          struct or union gets no heap
+   */
+
+char *heap_key_type(xmlNodePtr node)
+{
+  return ordered_key_type(node, option_heap_key());
+}
+
+  /**
+   *  @fn void emit_aggregate_heap_functions(FILE *outfile,
+   *                                         xmlNodePtr node,
+   *                                         char *project_name)
+   *
+   *  @brief generates heap C source code from struct or union element in
+   *         @p node
+   *
+   *  NOTE:  nothing is emitted for a struct or union without the key field
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_heap_functions(FILE *outfile,
+                                   xmlNodePtr node,
+                                   char *project_name)
+{
+  heap_names hn;
+  char *project = NULL;
+  xmlNodePtr key;
+  int indent = 0;
+
+  memset(&hn, 0, sizeof(hn));
+
+  if (!option_gen_heap()) goto exit;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  key = heap_key(node, &hn.kind);
+  if (!key) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+  str_lower(project);
+
+  hn.name = get_attribute(node, "name");
+  hn.field = get_attribute(key, "name");
+  hn.key_type = heap_key_type(node);
+  if (!hn.name || !hn.field || !hn.key_type) goto exit;
+
+  hn.heap_name = strapp(hn.heap_name, hn.name);
+  hn.heap_name = strapp(hn.heap_name, "_heap");
+
+  hn.fpre = container_prefix(project, hn.name, "heap");
+  hn.item_fpre = function_prefix(project, hn.name);
+  hn.path = profile_field_path(hn.name, hn.field);
+  if (!hn.heap_name || !hn.fpre || !hn.item_fpre) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          " *  Heap functions for struct %s, keyed by %s\n",
+          hn.heap_name,
+          hn.field);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  emit_heap_key_function(outfile, &hn, indent);
+  emit_heap_before_function(outfile, &hn, indent);
+  emit_heap_sift_up_function(outfile, &hn, indent);
+  emit_heap_sift_down_function(outfile, &hn, indent);
+  emit_heap_grow_function(outfile, &hn, indent);
+  emit_heap_new_function(outfile, &hn, indent);
+  emit_heap_heapify_function(outfile, &hn, indent);
+  emit_heap_free_function(outfile, &hn, indent);
+  emit_heap_push_function(outfile, &hn, indent);
+  emit_heap_peek_function(outfile, &hn, indent);
+  emit_heap_pop_function(outfile, &hn, indent);
+  emit_heap_update_function(outfile, &hn, indent);
+  emit_heap_count_function(outfile, &hn, indent);
+
+exit:
+  if (project) free(project);
+  if (hn.name) free(hn.name);
+  if (hn.heap_name) free(hn.heap_name);
+  if (hn.fpre) free(hn.fpre);
+  if (hn.item_fpre) free(hn.item_fpre);
+  if (hn.field) free(hn.field);
+  if (hn.key_type) free(hn.key_type);
+}
+
+  /**
+   *  @fn void emit_heap_key_function(FILE *outfile,
+   *                                  heap_names *hn,
+   *                                  int indent)
+   *
+   *  @brief generates static C function reading the key of an item of heap
+   *         @p hn
+   *
+   *  NOTE:  a NULL char * key orders as ""
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param hn - pointer to names of heap
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_heap_key_function(FILE *outfile,
+                                   heap_names *hn,
+                                   int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "item - pointer to item",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static inline ");
+  prototype = strapp(prototype, hn->key_type);
+  if (hn->kind != hash_kind_string && hn->kind != hash_kind_chars)
+    prototype = strapp(prototype, " ");
+  prototype = strapp(prototype, hn->fpre);
+  prototype = strapp(prototype, "_key(");
+  prototype = strapp(prototype, hn->name);
+  prototype = strapp(prototype, " *item)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "reads key of item",
+                                      params,
+                                      "key of item",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  switch (hn->kind)
+  {
+    case hash_kind_string:
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              "const char *key = %s_get_%s(item);\n",
+              hn->item_fpre,
+              hn->field);
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "return key ? key : \"\";\n");
+      break;
+
+    default:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "return item->%s%s;\n", hn->path, hn->field);
+      break;
+  }
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_heap_before_function(FILE *outfile,
+   *                                     heap_names *hn,
+   *                                     int indent)
+   *
+   *  @brief generates static C function ordering two entries of heap @p hn
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param hn - pointer to names of heap
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_heap_before_function(FILE *outfile,
+                                      heap_names *hn,
+                                      int indent)
+{
+  char *prototype = NULL;
+  char *op;
+  char *params[] =
+  {
+    "a - pointer to entry",
+    "b - pointer to entry",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static inline bool ");
+  prototype = strapp(prototype, hn->fpre);
+  prototype = strapp(prototype, "_before(const ");
+  prototype = strapp(prototype, hn->heap_name);
+  prototype = strapp(prototype, "_entry *a, const ");
+  prototype = strapp(prototype, hn->heap_name);
+  prototype = strapp(prototype, "_entry *b)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "determines if a belongs above b",
+                                      params,
+                                      "true if a belongs above b, false if "
+                                      "not",
+                                      indent + 1);
+
+  op = option_heap_max() ? ">" : "<";
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  if (hn->kind == hash_kind_string || hn->kind == hash_kind_chars)
+    fprintf(outfile, "return strcmp(a->key, b->key) %s 0;\n", op);
+  else
+    fprintf(outfile, "return a->key %s b->key;\n", op);
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_heap_sift_up_function(FILE *outfile,
+   *                                      heap_names *hn,
+   *                                      int indent)
+   *
+   *  @brief generates static C function moving an entry of heap @p hn up
+   *         to where it belongs
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param hn - pointer to names of heap
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_heap_sift_up_function(FILE *outfile,
+                                       heap_names *hn,
+                                       int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "heap - pointer to heap",
+    "pos - position of entry",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static void ");
+  prototype = strapp(prototype, hn->fpre);
+  prototype = strapp(prototype, "_sift_up(");
+  prototype = strapp(prototype, hn->heap_name);
+  prototype = strapp(prototype, " *heap, size_t pos)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "moves entry up past every parent it "
+                                      "belongs above",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_entry e = heap->entry[pos];\n", hn->heap_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t parent;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "while (pos)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "parent = (pos - 1) / 4;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (!%s_before(&e, &heap->entry[parent])) break;\n",
+          hn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->entry[pos] = heap->entry[parent];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->where[heap->entry[pos].handle] = pos;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pos = parent;\n");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->entry[pos] = e;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->where[e.handle] = pos;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_heap_sift_down_function(FILE *outfile,
+   *                                        heap_names *hn,
+   *                                        int indent)
+   *
+   *  @brief generates static C function moving an entry of heap @p hn down
+   *         to where it belongs
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param hn - pointer to names of heap
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_heap_sift_down_function(FILE *outfile,
+                                         heap_names *hn,
+                                         int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "heap - pointer to heap",
+    "pos - position of entry",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static void ");
+  prototype = strapp(prototype, hn->fpre);
+  prototype = strapp(prototype, "_sift_down(");
+  prototype = strapp(prototype, hn->heap_name);
+  prototype = strapp(prototype, " *heap, size_t pos)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "moves entry down past every child "
+                                      "belonging above it",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_entry e = heap->entry[pos];\n", hn->heap_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t first;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t last;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t best;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t c;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (;;)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "first = 4 * pos + 1;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (first >= heap->n) break;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "last = (first + 4 < heap->n) ? first + 4 : heap->n;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "best = first;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (c = first + 1; c < last; c++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "if (%s_before(&heap->entry[c], &heap->entry[best])) best = c;\n",
+          hn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (!%s_before(&heap->entry[best], &e)) break;\n",
+          hn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->entry[pos] = heap->entry[best];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->where[heap->entry[pos].handle] = pos;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pos = best;\n");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->entry[pos] = e;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->where[e.handle] = pos;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_heap_grow_function(FILE *outfile,
+   *                                   heap_names *hn,
+   *                                   int indent)
+   *
+   *  @brief generates static C function enlarging the arrays of heap @p hn
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param hn - pointer to names of heap
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_heap_grow_function(FILE *outfile,
+                                    heap_names *hn,
+                                    int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "heap - pointer to heap",
+    "size - new number of entries, handles and spares",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static bool ");
+  prototype = strapp(prototype, hn->fpre);
+  prototype = strapp(prototype, "_grow(");
+  prototype = strapp(prototype, hn->heap_name);
+  prototype = strapp(prototype, " *heap, size_t size)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "reallocates entries, handle positions "
+                                      "and spare handles",
+                                      params,
+                                      "true on success, false on failure, "
+                                      "heap unchanged",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_entry *entry;\n", hn->heap_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t *where;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t *spare;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "entry = realloc(heap->entry, size * sizeof(%s_entry));\n",
+          hn->heap_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!entry) return false;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->entry = entry;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "where = realloc(heap->where, size * sizeof(size_t));\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!where) return false;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->where = where;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "spare = realloc(heap->spare, size * sizeof(size_t));\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!spare) return false;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->spare = spare;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->size = size;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return true;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_heap_new_function(FILE *outfile,
+   *                                  heap_names *hn,
+   *                                  int indent)
+   *
+   *  @brief generates C function allocating an empty heap @p hn
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param hn - pointer to names of heap
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_heap_new_function(FILE *outfile,
+                                   heap_names *hn,
+                                   int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "capacity - number of items room is made for, the heap grows past it",
+    NULL
+  };
+
+  prototype = strapp(prototype, hn->heap_name);
+  prototype = strapp(prototype, " *");
+  prototype = strapp(prototype, hn->fpre);
+  prototype = strapp(prototype, "_new(size_t capacity)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "allocates an empty heap",
+                                      params,
+                                      "pointer to new heap on success, NULL "
+                                      "on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s *heap = NULL;\n", hn->heap_name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  emit_alloc(outfile, "heap", hn->heap_name, false);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!heap) return NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "memset(heap, 0, sizeof(%s));\n", hn->heap_name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (!%s_grow(heap, (capacity > 4) ? capacity : 4))\n",
+          hn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_free(heap);\n", hn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return heap;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_heap_heapify_function(FILE *outfile,
+   *                                      heap_names *hn,
+   *                                      int indent)
+   *
+   *  @brief generates C function building heap @p hn from an array of items
+   *
+   *  NOTE:  built bottom up in O(n), item i gets handle i
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param hn - pointer to names of heap
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_heap_heapify_function(FILE *outfile,
+                                       heap_names *hn,
+                                       int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "items - array of item pointers, none NULL, item i gets handle i",
+    "n - number of items",
+    NULL
+  };
+
+  prototype = strapp(prototype, hn->heap_name);
+  prototype = strapp(prototype, " *");
+  prototype = strapp(prototype, hn->fpre);
+  prototype = strapp(prototype, "_heapify(");
+  prototype = strapp(prototype, hn->name);
+  prototype = strapp(prototype, " **items, size_t n)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "builds a heap of n items at once",
+                                      params,
+                                      "pointer to new heap on success, NULL "
+                                      "on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s *heap = NULL;\n", hn->heap_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!items && n) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap = %s_new(n);\n", hn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!heap) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < n; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->entry[i].key = %s_key(items[i]);\n", hn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->entry[i].item = items[i];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->entry[i].handle = i;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->where[i] = i;\n");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->n = heap->handles = n;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (n > 1)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "for (i = (n - 2) / 4 + 1; i > 0; i--) %s_sift_down(heap, i - 1);\n",
+          hn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return heap;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_heap_free_function(FILE *outfile,
+   *                                   heap_names *hn,
+   *                                   int indent)
+   *
+   *  @brief generates C function freeing heap @p hn, not its items
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param hn - pointer to names of heap
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_heap_free_function(FILE *outfile,
+                                    heap_names *hn,
+                                    int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "heap - pointer to heap",
+    NULL
+  };
+
+  prototype = strapp(prototype, "void ");
+  prototype = strapp(prototype, hn->fpre);
+  prototype = strapp(prototype, "_free(");
+  prototype = strapp(prototype, hn->heap_name);
+  prototype = strapp(prototype, " *heap)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "frees heap, items are left alone",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!heap) return;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(heap->entry);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(heap->where);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(heap->spare);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(heap);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_heap_push_function(FILE *outfile,
+   *                                   heap_names *hn,
+   *                                   int indent)
+   *
+   *  @brief generates C function adding an item to heap @p hn
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param hn - pointer to names of heap
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_heap_push_function(FILE *outfile,
+                                    heap_names *hn,
+                                    int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "heap - pointer to heap",
+    "item - pointer to item",
+    "handle - address receiving handle of item, may be NULL",
+    NULL
+  };
+
+  prototype = strapp(prototype, "bool ");
+  prototype = strapp(prototype, hn->fpre);
+  prototype = strapp(prototype, "_push(");
+  prototype = strapp(prototype, hn->heap_name);
+  prototype = strapp(prototype, " *heap, ");
+  prototype = strapp(prototype, hn->name);
+  prototype = strapp(prototype, " *item, size_t *handle)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "adds item to heap",
+                                      params,
+                                      "true on success, false on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t h;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!heap || !item) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if ((heap->n == heap->size) && "
+          "!%s_grow(heap, heap->size * 2))\n",
+          hn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "h = heap->nspare ? heap->spare[--heap->nspare] : "
+          "heap->handles++;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->entry[heap->n].key = %s_key(item);\n", hn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->entry[heap->n].item = item;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->entry[heap->n].handle = h;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_sift_up(heap, heap->n++);\n", hn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (handle) *handle = h;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return true;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_heap_peek_function(FILE *outfile,
+   *                                   heap_names *hn,
+   *                                   int indent)
+   *
+   *  @brief generates C function returning the top item of heap @p hn
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param hn - pointer to names of heap
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_heap_peek_function(FILE *outfile,
+                                    heap_names *hn,
+                                    int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "heap - pointer to heap",
+    NULL
+  };
+
+  prototype = strapp(prototype, hn->name);
+  prototype = strapp(prototype, " *");
+  prototype = strapp(prototype, hn->fpre);
+  prototype = strapp(prototype, "_peek(");
+  prototype = strapp(prototype, hn->heap_name);
+  prototype = strapp(prototype, " *heap)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "returns top item, leaving it in heap",
+                                      params,
+                                      "pointer to item, NULL if heap is "
+                                      "empty",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return (heap && heap->n) ? heap->entry[0].item : NULL;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_heap_pop_function(FILE *outfile,
+   *                                  heap_names *hn,
+   *                                  int indent)
+   *
+   *  @brief generates C function removing the top item of heap @p hn
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param hn - pointer to names of heap
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_heap_pop_function(FILE *outfile,
+                                   heap_names *hn,
+                                   int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "heap - pointer to heap",
+    NULL
+  };
+
+  prototype = strapp(prototype, hn->name);
+  prototype = strapp(prototype, " *");
+  prototype = strapp(prototype, hn->fpre);
+  prototype = strapp(prototype, "_pop(");
+  prototype = strapp(prototype, hn->heap_name);
+  prototype = strapp(prototype, " *heap)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "removes top item, its handle is "
+                                      "freed for reuse",
+                                      params,
+                                      "pointer to item, NULL if heap is "
+                                      "empty",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_entry top;\n", hn->heap_name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!heap || !heap->n) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "top = heap->entry[0];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->where[top.handle] = SIZE_MAX;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "heap->spare[heap->nspare++] = top.handle;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (--heap->n)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "heap->entry[0] = heap->entry[heap->n];\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_sift_down(heap, 0);\n", hn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return top.item;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_heap_update_function(FILE *outfile,
+   *                                     heap_names *hn,
+   *                                     int indent)
+   *
+   *  @brief generates C function restoring heap @p hn order after the key
+   *         of one item changed
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param hn - pointer to names of heap
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_heap_update_function(FILE *outfile,
+                                      heap_names *hn,
+                                      int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "heap - pointer to heap",
+    "handle - handle of item whose key changed",
+    NULL
+  };
+
+  prototype = strapp(prototype, "bool ");
+  prototype = strapp(prototype, hn->fpre);
+  prototype = strapp(prototype, "_update(");
+  prototype = strapp(prototype, hn->heap_name);
+  prototype = strapp(prototype, " *heap, size_t handle)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "rereads key of item and moves it to "
+                                      "where it now belongs",
+                                      params,
+                                      "true on success, false if handle is "
+                                      "not in heap",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t pos;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!heap || (handle >= heap->handles)) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pos = heap->where[handle];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (pos == SIZE_MAX) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "heap->entry[pos].key = %s_key(heap->entry[pos].item);\n",
+          hn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_sift_up(heap, pos);\n", hn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_sift_down(heap, heap->where[handle]);\n", hn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return true;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_heap_count_function(FILE *outfile,
+   *                                    heap_names *hn,
+   *                                    int indent)
+   *
+   *  @brief generates C function counting the items of heap @p hn
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param hn - pointer to names of heap
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_heap_count_function(FILE *outfile,
+                                     heap_names *hn,
+                                     int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "heap - pointer to heap",
+    NULL
+  };
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, hn->fpre);
+  prototype = strapp(prototype, "_count(");
+  prototype = strapp(prototype, hn->heap_name);
+  prototype = strapp(prototype, " *heap)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "counts items in heap",
+                                      params,
+                                      "number of items",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return heap ? heap->n : 0;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
@@ -0,0 +1,750 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-intern.c
+ *  @brief string intern table add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  char * fields named by an @b intern directive in the tuning file keep
+ *  their strings in one reference counted table per generated source file.
+ *  Setters and _dup() intern, _free() releases, so equal strings share a
+ *  single copy and compare equal by pointer.
+ *
+ *  When any generated container may be used from several threads, see
+ *  concurrent_any(), the table functions are static <name>_unlocked()
+ *  versions wrapped in functions of the original name that hold one table
+ *  mutex, so entries and their reference counts are never raced on.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "source-intern.h"
+#include "source-concurrent.h"
+#include "header-concurrent.h"
+#include "source-serialize.h"
+#include "tuning.h"
+
+static void emit_intern_locked_functions(FILE *outfile);
+
+  /**
+   *  @fn bool intern_field(char *aggregate_name, xmlNodePtr node)
+   *
+   *  @brief determines if strings of field element in @p node are kept in
+   *         the intern table
+   *
+   *  @param aggregate_name - string containing name of struct or union
+   *  @param node - xmlNodePtr containing field element
+   *
+   *  @return true if field is a char * named by an intern directive,
+   *          false if not
+   */
+
+bool intern_field(char *aggregate_name, xmlNodePtr node)
+{
+  xmlNodePtr type;
+  char *field_name = NULL;
+  bool interned = false;
+
+  if (!aggregate_name || !node) goto exit;
+
+  if (!tuning_interns()) goto exit;
+
+  field_name = get_attribute(node, "name");
+  if (!field_name) goto exit;
+
+  if (!tuning_field_interned(aggregate_name, field_name)) goto exit;
+
+  interned = (serialize_field_kind(node, &type) == serialize_kind_string);
+
+exit:
+  if (field_name) free(field_name);
+
+  return interned;
+}
+
+  /**
+   *  @fn bool intern_needed(xmlNodePtr root)
+   *
+   *  @brief determines if any field of declarations in @p root is interned
+   *
+   *  @param root - xmlNodePtr containing c-decls element
+   *
+   *  @return true if intern table is needed, false if not
+   */
+
+bool intern_needed(xmlNodePtr root)
+{
+  xmlNodePtr node;
+  xmlNodePtr child;
+  char *name = NULL;
+  bool needed = false;
+
+  if (!root || !tuning_interns()) goto exit;
+
+  for (node = root->children; node && !needed; node = node->next)
+  {
+    if (strcmp((char *)node->name, "struct") &&
+        strcmp((char *)node->name, "union"))
+      continue;
+
+    name = get_attribute(node, "name");
+    if (!name) continue;
+
+    for (child = node->children; child; child = child->next)
+    {
+      if (strcmp((char *)child->name, "field")) continue;
+
+      if (intern_field(name, child)) needed = true;
+    }
+
+    free(name);
+    name = NULL;
+  }
+
+exit:
+  return needed;
+}
+
+  /**
+   *  @fn void emit_intern_table(FILE *outfile,
+   *                             xmlNodePtr root,
+   *                             char *project_name)
+   *
+   *  @brief generates string intern table and its public functions
+   *
+   *  NOTE:  nothing is emitted if no field of declarations in @p root is
+   *         interned
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param root - xmlNodePtr containing c-decls element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_intern_table(FILE *outfile, xmlNodePtr root, char *project_name)
+{
+  char *project = NULL;
+  char *fpre = NULL;
+  char *prototype = NULL;
+  char *suffix = NULL;
+  bool locked = false;
+  char *intern_params[] =
+  {
+    "s - string to intern",
+    NULL
+  };
+  char *release_params[] =
+  {
+    "s - string returned by _intern(), may be NULL",
+    NULL
+  };
+  int indent = 0;
+
+  if (!outfile || !root || !project_name) goto exit;
+
+  if (!intern_needed(root)) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+  str_lower(project);
+
+  fpre = function_prefix(project, "intern");
+  if (!fpre) goto exit;
+
+  locked = concurrent_any();
+  suffix = concurrent_suffix(locked);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " *  String intern table, one reference counted copy of\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " *  every string held by an interned field\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "typedef struct intern_entry intern_entry;\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "struct intern_entry\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "intern_entry *next;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint64_t hash;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t refs;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char s[];\n");
+
+  --indent;
+
+  fprintf(outfile, "};\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "static intern_entry **intern_buckets = NULL;\n");
+  fprintf(outfile, "static size_t intern_n_buckets = 0;\n");
+  fprintf(outfile, "static size_t intern_n = 0;\n");
+  if (locked)
+    fprintf(outfile,
+            "static pthread_mutex_t intern_lock = "
+            "PTHREAD_MUTEX_INITIALIZER;\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static uint64_t intern_hash(const char *s, size_t *len)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint64_t hash = UINT64_C(0xcbf29ce484222325);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "const char *p;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (p = s; *p; p++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "hash ^= (unsigned char)*p;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "hash *= UINT64_C(0x100000001b3);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*len = (size_t)(p - s);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return hash;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "static bool intern_grow(void)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "intern_entry **buckets;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "intern_entry *e;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "intern_entry *next;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "size_t n_buckets = intern_n_buckets ? intern_n_buckets * 2 : "
+          "256;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "buckets = calloc(n_buckets, sizeof(intern_entry *));\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!buckets) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < intern_n_buckets; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "for (e = intern_buckets[i]; e; e = next)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "next = e->next;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "e->next = buckets[e->hash & (n_buckets - 1)];\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "buckets[e->hash & (n_buckets - 1)] = e;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(intern_buckets);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "intern_buckets = buckets;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "intern_n_buckets = n_buckets;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return true;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "static char *intern_string%s(const char *s)\n", suffix);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "intern_entry *e;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint64_t hash;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t len;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!s) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "hash = intern_hash(s, &len);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (intern_n_buckets)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "for (e = intern_buckets[hash & (intern_n_buckets - 1)]; e; e = "
+          "e->next)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if ((e->hash == hash) && !strcmp(e->s, s))\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "e->refs++;\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "return e->s;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "// keep load below 3/4, the first call allocates the table\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if ((intern_n >= intern_n_buckets - intern_n_buckets / 4) && "
+          "!intern_grow())\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "e = malloc(offsetof(intern_entry, s) + len + 1);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!e) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "e->hash = hash;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "e->refs = 1;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "memcpy(e->s, s, len + 1);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "e->next = intern_buckets[hash & (intern_n_buckets - 1)];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "intern_buckets[hash & (intern_n_buckets - 1)] = e;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "intern_n++;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return e->s;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "static void intern_release%s(char *s)\n", suffix);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "intern_entry *e;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "intern_entry **link;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!s) return;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "e = (intern_entry *)(s - offsetof(intern_entry, s));\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (--e->refs) return;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "link = &intern_buckets[e->hash & (intern_n_buckets - 1)];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (; *link; link = &(*link)->next)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (*link == e)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "*link = e->next;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "break;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "intern_n--;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(e);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  if (locked) emit_intern_locked_functions(outfile);
+
+  prototype = strapp(prototype, "char *");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "(const char *s)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "returns shared copy of s, adding a "
+                                      "reference to it",
+                                      intern_params,
+                                      "interned string, NULL if s is NULL "
+                                      "or on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return intern_string(s);\n");
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  free(prototype);
+  prototype = NULL;
+
+  prototype = strapp(prototype, "void ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_release(char *s)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "drops a reference to interned s, "
+                                      "freeing it with the last one",
+                                      release_params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "intern_release(s);\n");
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (project) free(project);
+  if (fpre) free(fpre);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_intern_locked_functions(FILE *outfile)
+   *
+   *  @brief generates intern_string() and intern_release(), calling their
+   *         _unlocked() versions while holding the intern table mutex
+   *
+   *  @param outfile - open FILE * for writing
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_intern_locked_functions(FILE *outfile)
+{
+  int indent = 0;
+
+  fprintf(outfile, "static char *intern_string(const char *s)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char *rv = NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!s) return rv;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_lock(&intern_lock);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "rv = intern_string_unlocked(s);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_unlock(&intern_lock);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return rv;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "static void intern_release(char *s)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!s) return;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_lock(&intern_lock);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "intern_release_unlocked(s);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_unlock(&intern_lock);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+}
+
+  /**
+   *  @fn void emit_intern_forwarders(FILE *outfile,
+   *                                  xmlNodePtr root,
+   *                                  char *project_name)
+   *
+   *  @brief generates intern_string() and intern_release() for a split
+   *         source file, forwarding to the public functions of the one
+   *         intern table
+   *
+   *  NOTE:  nothing is emitted if no field of declarations in @p root is
+   *         interned
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param root - xmlNodePtr containing c-decls element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_intern_forwarders(FILE *outfile,
+                            xmlNodePtr root,
+                            char *project_name)
+{
+  char *project = NULL;
+  char *fpre = NULL;
+  int indent = 0;
+
+  if (!outfile || !root || !project_name) goto exit;
+
+  if (!intern_needed(root)) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+  str_lower(project);
+
+  fpre = function_prefix(project, "intern");
+  if (!fpre) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " *  String intern table is shared by all source files\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "static inline char *intern_string(const char *s)\n");
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return %s(s);\n", fpre);
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "static inline void intern_release(char *s)\n");
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_release(s);\n", fpre);
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (project) free(project);
+  if (fpre) free(fpre);
+}
@@ -0,0 +1,519 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-iter.c
+ *  @brief caller owned container iterator add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  Every array, list and avl gets an iterator type of its own, so any number
+ *  of loops, nested or on other threads, can walk one container at once.
+ *  An array iterator walks the item array in place, list and avl iterators
+ *  walk a snapshot of item pointers taken by _iter_begin().  _iter_next() is
+ *  static inline in the header, as is every iterator function of a plain
+ *  array, so simple loops compile down to an indexed walk.  Iterators of
+ *  concurrent containers hold the read lock from _iter_begin() to
+ *  _iter_end().  llist offers no walk of its own, so the snapshot of a list
+ *  moves its shared cursor.  A concurrent list takes the cursor mutex for
+ *  it, a plain list has no lock, so _iter_begin() on a plain list is not
+ *  thread-safe, callers must not begin two at once on one list.
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "source-iter.h"
+#include "source-concurrent.h"
+#include "options.h"
+
+static void emit_iter_begin_function(FILE *outfile,
+                                     char *name,
+                                     char *container_name,
+                                     char *fpre,
+                                     char *kind);
+static void emit_iter_collect_function(FILE *outfile,
+                                       char *name,
+                                       char *container_name,
+                                       char *fpre);
+static void emit_iter_grow(FILE *outfile,
+                           char *name,
+                           char *fail,
+                           int indent);
+
+  /**
+   *  @fn bool iter_container(char *kind)
+   *
+   *  @brief determines if container @p kind is generated, and so gets an
+   *         iterator
+   *
+   *  @param kind - string containing "array", "list" or "avl"
+   *
+   *  @return true if @p kind is generated, false if not
+   */
+
+bool iter_container(char *kind)
+{
+  if (!kind) return false;
+
+  if (!strcmp(kind, "array")) return option_gen_array();
+  if (!strcmp(kind, "list")) return option_gen_list();
+  if (!strcmp(kind, "avl")) return option_gen_avl();
+
+  return false;
+}
+
+  /**
+   *  @fn void emit_aggregate_iter_functions(FILE *outfile,
+   *                                         xmlNodePtr node,
+   *                                         char *project,
+   *                                         char *kind)
+   *
+   *  @brief generates _iter_begin() and _iter_end() for container @p kind of
+   *         struct or union in @p node
+   *
+   *  NOTE:  must follow the container functions, list iterators snapshot
+   *         through the cursor functions.  _iter_next(), and every iterator
+   *         function of a plain array, is static inline in the header.
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing lower case project name
+   *  @param kind - string containing "array", "list" or "avl"
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_iter_functions(FILE *outfile,
+                                   xmlNodePtr node,
+                                   char *project,
+                                   char *kind)
+{
+  char *name = NULL;
+  char *container_name = NULL;
+  char *fpre = NULL;
+  bool concurrent;
+  int indent = 0;
+
+  if (!outfile || !node || !project || !kind) goto exit;
+
+  if (!iter_container(kind)) goto exit;
+
+  concurrent = concurrent_container(kind);
+
+  if (!strcmp(kind, "array") && !concurrent) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  container_name = strapp(container_name, name);
+  container_name = strapp(container_name, "_");
+  container_name = strapp(container_name, kind);
+
+  fpre = container_prefix(project, name, kind);
+  if (!container_name || !fpre) goto exit;
+
+  if (!strcmp(kind, "avl"))
+    emit_iter_collect_function(outfile, name, container_name, fpre);
+
+  emit_iter_begin_function(outfile, name, container_name, fpre, kind);
+
+    // end
+
+  fprintf(outfile, "void %s_iter_end(%s_iter *iter)\n", fpre, container_name);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!iter || !iter->container) return;\n");
+
+  fprintf(outfile, "\n");
+
+  if (strcmp(kind, "array"))
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "free(iter->item);\n");
+  }
+
+  if (concurrent)
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "pthread_rwlock_unlock(&iter->container->lock);\n");
+  }
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "memset(iter, 0, sizeof(%s_iter));\n", container_name);
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (container_name) free(container_name);
+  if (fpre) free(fpre);
+}
+
+  /**
+   *  @fn void emit_iter_begin_function(FILE *outfile,
+   *                                    char *name,
+   *                                    char *container_name,
+   *                                    char *fpre,
+   *                                    char *kind)
+   *
+   *  @brief generates _iter_begin(), which fills the iterator, read locking
+   *         a concurrent container first
+   *
+   *  NOTE:  an array iterator walks the item array in place, list and avl
+   *         iterators walk a snapshot of item pointers.  llist offers no
+   *         walk of its own, so taking a list snapshot moves the list cursor.
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param name - string containing name of struct or union
+   *  @param container_name - string containing typedef name of container
+   *  @param fpre - string containing function prefix of container
+   *  @param kind - string containing "array", "list" or "avl"
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_iter_begin_function(FILE *outfile,
+                                     char *name,
+                                     char *container_name,
+                                     char *fpre,
+                                     char *kind)
+{
+  bool concurrent = concurrent_container(kind);
+  int indent = 0;
+
+  fprintf(outfile,
+          "bool %s_iter_begin(%s *instance,%s %s_iter *iter)\n",
+          fpre,
+          container_name,
+          strcmp(kind, "avl") ? "" : " avl_order order,",
+          container_name);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  if (!strcmp(kind, "list"))
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "%s *item = NULL;\n", name);
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "void *tmp = NULL;\n");
+  }
+
+  if (strcmp(kind, "array"))
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "bool ok = false;\n");
+  }
+
+  if (strcmp(kind, "array")) fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !iter) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "memset(iter, 0, sizeof(%s_iter));\n", container_name);
+
+  fprintf(outfile, "\n");
+
+  if (concurrent)
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "pthread_rwlock_rdlock(&instance->lock);\n");
+
+    fprintf(outfile, "\n");
+  }
+
+  if (!strcmp(kind, "array"))
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "iter->item = instance->item;\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "iter->n = instance->n;\n");
+  }
+  else if (!strcmp(kind, "list"))
+  {
+    if (concurrent)
+    {
+      emit_indent(outfile, indent);
+      fprintf(outfile, "pthread_mutex_lock(&instance->cursor);\n");
+
+      fprintf(outfile, "\n");
+    }
+
+    emit_indent(outfile, indent);
+    fprintf(outfile,
+            "for (item = %s_head%s(instance);\n",
+            fpre,
+            concurrent_suffix(concurrent));
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "     item;\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile,
+            "     item = %s_next%s(instance))\n",
+            fpre,
+            concurrent_suffix(concurrent));
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "{\n");
+
+    emit_iter_grow(outfile, name, "break", indent + 1);
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "iter->item[iter->n++] = item;\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "}\n");
+
+    fprintf(outfile, "\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "ok = item == NULL;\n");
+
+    if (concurrent)
+    {
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "pthread_mutex_unlock(&instance->cursor);\n");
+    }
+  }
+  else
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "%s_iter_collector = iter;\n", fpre);
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "if (instance->_avl)\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile,
+            "avl_walk(instance->_avl, order, (avl_action)%s_iter_collect);\n",
+            fpre);
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "ok = %s_iter_collector != NULL;\n", fpre);
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "%s_iter_collector = NULL;\n", fpre);
+  }
+
+  if (strcmp(kind, "array"))
+  {
+    fprintf(outfile, "\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "if (!ok)\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "{\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "free(iter->item);\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "memset(iter, 0, sizeof(%s_iter));\n", container_name);
+
+    if (concurrent)
+    {
+      emit_indent(outfile, indent + 1);
+      fprintf(outfile, "pthread_rwlock_unlock(&instance->lock);\n");
+    }
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "return false;\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "}\n");
+  }
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "iter->container = instance;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return true;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+}
+
+  /**
+   *  @fn void emit_iter_collect_function(FILE *outfile,
+   *                                      char *name,
+   *                                      char *container_name,
+   *                                      char *fpre)
+   *
+   *  @brief generates thread local collector and the avl_walk() action that
+   *         appends each node to it
+   *
+   *  NOTE:  avl_walk() passes no context to its action, so the iterator
+   *         being filled is handed over in a _Thread_local pointer, which the
+   *         action clears if it runs out of memory
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param name - string containing name of struct or union
+   *  @param container_name - string containing typedef name of container
+   *  @param fpre - string containing function prefix of container
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_iter_collect_function(FILE *outfile,
+                                       char *name,
+                                       char *container_name,
+                                       char *fpre)
+{
+  int indent = 0;
+
+  fprintf(outfile,
+          "static _Thread_local %s_iter *%s_iter_collector = NULL;\n",
+          container_name,
+          fpre);
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static int %s_iter_collect(%s_node *node)\n",
+          fpre,
+          container_name);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%s_iter *iter = %s_iter_collector;\n",
+          container_name,
+          fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "void *tmp = NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!iter || !node) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_iter_grow(outfile, name, "goto fail", indent);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "iter->item[iter->n++] = &node->data;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "fail:\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_iter_collector = NULL;\n", fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return 0;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+}
+
+  /**
+   *  @fn void emit_iter_grow(FILE *outfile,
+   *                          char *name,
+   *                          char *fail,
+   *                          int indent)
+   *
+   *  @brief generates code doubling the snapshot of "iter" each time its
+   *         count reaches a power of two
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param name - string containing name of struct or union
+   *  @param fail - string containing statement run if realloc() fails
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_iter_grow(FILE *outfile,
+                           char *name,
+                           char *fail,
+                           int indent)
+{
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!(iter->n & (iter->n - 1)))\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "tmp = realloc(iter->item,"
+          " sizeof(%s *) * (iter->n ? iter->n * 2 : 1));\n",
+          name);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!tmp) %s;\n", fail);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "iter->item = tmp;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+}
@@ -0,0 +1,3211 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-json.c
+ *  @brief JSON encoder and decoder add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  A struct is encoded as a JSON object holding every field in declared
+ *  order:
+ *
+ *    integers, bitfields  numbers
+ *    _Bool                true or false
+ *    enum references      name of value, from _to_str()
+ *    float, double        numbers, null if not finite
+ *    char *, char arrays  strings, null for a NULL char *
+ *    nested structs       objects, encoded recursively
+ *    arrays of scalars    arrays of numbers
+ *
+ *  The encoder writes straight into the caller's buffer.  The decoder is a
+ *  single pass over the text, finding the field of every key with a
+ *  perfect hash computed when the code is generated.  Unknown keys are
+ *  skipped, missing keys leave their fields as they were.  A number that is
+ *  not a whole number in the range of its integer field, or an invalid
+ *  escape in a string, fails the decode.  A char array decodes into all of
+ *  its bytes, and is NUL terminated only if the string is shorter, as
+ *  serialize and flat treat it.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "source-json.h"
+#include "source-serialize.h"
+#include "source-intern.h"
+#include "source-sso.h"
+#include "options.h"
+#include "profile.h"
+
+#define JSON_HASH_BASIS 2166136261u  /**<  FNV-1a 32 bit offset basis  */
+#define JSON_HASH_PRIME 16777619u    /**<  FNV-1a 32 bit prime         */
+#define JSON_SEEDS 65536             /**<  seeds tried per table size  */
+
+static void emit_aggregate_json_field_function(FILE *outfile,
+                                               xmlNodePtr node,
+                                               char *project,
+                                               int indent);
+static void emit_aggregate_json_write_function(FILE *outfile,
+                                               xmlNodePtr node,
+                                               char *project,
+                                               int indent);
+static void emit_aggregate_json_read_function(FILE *outfile,
+                                              xmlNodePtr node,
+                                              char *project,
+                                              int indent);
+static void emit_aggregate_to_json_function(FILE *outfile,
+                                            xmlNodePtr node,
+                                            char *project,
+                                            int indent);
+static void emit_aggregate_from_json_function(FILE *outfile,
+                                              xmlNodePtr node,
+                                              char *project,
+                                              int indent);
+static void emit_json_write_value(FILE *outfile,
+                                  char *lvalue,
+                                  serialize_kind kind,
+                                  xmlNodePtr type,
+                                  char *project,
+                                  int indent);
+static void emit_json_read_value(FILE *outfile,
+                                 char *lvalue,
+                                 serialize_kind kind,
+                                 xmlNodePtr type,
+                                 char *project,
+                                 int indent);
+static void emit_json_read_integer(FILE *outfile,
+                                   char *lvalue,
+                                   char *cast,
+                                   xmlNodePtr type,
+                                   bool is_signed);
+static void emit_json_read_interned(FILE *outfile, char *lvalue, int indent);
+static void emit_json_read_inline(FILE *outfile, char *lvalue, int indent);
+static serialize_kind json_field_kind(xmlNodePtr node, xmlNodePtr *type);
+static uint32_t json_hash(char *key, uint32_t seed);
+static int *json_perfect_hash(xmlNodePtr node,
+                              uint32_t *seed,
+                              uint32_t *size);
+static char *json_linkage(void);
+
+  /**
+   *  @fn void emit_json_helpers(FILE *outfile,
+   *                             xmlNodePtr root,
+   *                             char *project_name)
+   *
+   *  @brief generates static writer and reader helper functions used by all
+   *         JSON functions of a source file, and declares the JSON functions
+   *         of every struct so that nested structs may be declared later
+   *
+   *  NOTE:  nothing is emitted if declarations in @p root contain no struct
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param root - xmlNodePtr containing c-decls element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_json_helpers(FILE *outfile, xmlNodePtr root, char *project_name)
+{
+  xmlNodePtr node;
+  bool has_struct = false;
+  char *project = NULL;
+  char *name = NULL;
+  char *fpre = NULL;
+  int indent = 0;
+
+  if (!option_gen_json()) goto exit;
+
+  if (!outfile || !root || !project_name) goto exit;
+
+  for (node = root->children; node; node = node->next)
+  {
+    if (!strcmp((char *)node->name, "struct")) has_struct = true;
+  }
+
+  if (!has_struct) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+  str_lower(project);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " *  Writer and reader helpers for JSON functions\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "#define JSON_MAX_DEPTH 64\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "typedef struct\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char *buf;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t len;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t pos;\n");
+
+  --indent;
+
+  fprintf(outfile, "} json_writer;\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "typedef struct\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "const char *p;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "const char *end;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int depth;\n");
+
+  --indent;
+
+  fprintf(outfile, "} json_reader;\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline void json_put(json_writer *w, const char *s, "
+          "size_t n)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (w->pos < w->len)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "memcpy(w->buf + w->pos,\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "       s,\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "       (w->len - w->pos < n) ? w->len - w->pos : n);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "w->pos += n;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline void json_put_uint(json_writer *w, uint64_t "
+          "value)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char digits[20];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i = sizeof(digits);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "do\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "digits[--i] = (char)('0' + (value %% 10));\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "value /= 10;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "} while (value);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "json_put(w, digits + i, sizeof(digits) - i);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline void json_put_int(json_writer *w, int64_t value)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (value < 0)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "json_put(w, \"-\", 1);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "json_put_uint(w, (uint64_t)0 - (uint64_t)value);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "else\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "json_put_uint(w, (uint64_t)value);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline void json_put_double(json_writer *w,\n"
+          "                                   double value,\n"
+          "                                   bool is_float)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char number[32];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int n;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!isfinite(value))\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "json_put(w, \"null\", 4);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "// integral values are written without a format conversion\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if ((value > -9007199254740992.0) &&\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "    (value < 9007199254740992.0) &&\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "    (value == (double)(int64_t)value))\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "json_put_int(w, (int64_t)value);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "// shortest precision which reads back as the same value\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "n = snprintf(number, sizeof(number), \"%%.*g\", is_float ? 6 : "
+          "15, value);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (is_float ? ((float)strtod(number, NULL) != (float)value)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "             : (strtod(number, NULL) != value))\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "n = snprintf(number, sizeof(number), \"%%.*g\", is_float ? 9 : "
+          "17, value);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (n > 0) json_put(w, number, (size_t)n);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline void json_put_string(json_writer *w,\n"
+          "                                   const char *s,\n"
+          "                                   size_t max)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "static const char hex[] = \"0123456789abcdef\";\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char escape[6] = { '\\\\', 'u', '0', '0', '0', '0' };\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t run = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "unsigned char c;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!s)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "json_put(w, \"null\", 4);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "json_put(w, \"\\\"\", 1);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; (i < max) && s[i]; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "c = (unsigned char)s[i];\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "if ((c >= 0x20) && (c != '\"') && (c != '\\\\')) continue;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "json_put(w, s + run, i - run);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "run = i + 1;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (c >= 0x20)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "escape[1] = (char)c;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "json_put(w, escape, 2);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "else\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "escape[1] = 'u';\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "escape[4] = hex[c >> 4];\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "escape[5] = hex[c & 15];\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "json_put(w, escape, 6);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "json_put(w, s + run, i - run);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "json_put(w, \"\\\"\", 1);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "static inline void json_skip_space(json_reader *r)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "while ((r->p < r->end) &&\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "       ((*r->p == ' ') || (*r->p == '\\t') ||\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "        (*r->p == '\\n') || (*r->p == '\\r')))\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "r->p++;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "static inline bool json_accept(json_reader *r, char c)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "json_skip_space(r);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if ((r->p >= r->end) || (*r->p != c)) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "r->p++;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return true;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline bool json_accept_literal(json_reader *r,\n"
+          "                                       const char *literal,\n"
+          "                                       size_t n)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "json_skip_space(r);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (((size_t)(r->end - r->p) < n) || memcmp(r->p, literal, n)) "
+          "return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "r->p += n;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return true;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline int json_next(json_reader *r, char close)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (json_accept(r, ',')) return 1;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (json_accept(r, close)) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return -1;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline uint32_t json_hash(const char *key,\n"
+          "                                 size_t len,\n"
+          "                                 uint32_t seed)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint32_t hash = 2166136261u ^ seed;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < len; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "hash ^= (unsigned char)key[i];\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "hash *= 16777619u;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return hash;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline bool json_read_key(json_reader *r,\n"
+          "                                 const char **key,\n"
+          "                                 size_t *len)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "const char *p;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!json_accept(r, '\"')) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (p = r->p; (p < r->end) && (*p != '\"'); p++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if ((*p == '\\\\') && (p + 1 < r->end)) p++;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (p >= r->end) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*key = r->p;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*len = (size_t)(p - r->p);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "r->p = p + 1;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return json_accept(r, ':');\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline bool json_hex4(json_reader *r, uint32_t *code)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int i;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char c;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (r->end - r->p < 4) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (*code = 0, i = 0; i < 4; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "c = *r->p++;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "*code <<= 4;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "if ((c >= '0') && (c <= '9')) *code |= (uint32_t)(c - '0');\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "else if ((c >= 'a') && (c <= 'f')) *code |= (uint32_t)(c - 'a' + "
+          "10);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "else if ((c >= 'A') && (c <= 'F')) *code |= (uint32_t)(c - 'A' + "
+          "10);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "else return false;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return true;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline size_t json_decode_string(json_reader *r,\n"
+          "                                        char *dst,\n"
+          "                                        size_t size,\n"
+          "                                        bool *ok)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char utf8[4];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint32_t code;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint32_t low;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t n = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t len;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char c;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*ok = false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!json_accept(r, '\"')) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "while (r->p < r->end)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "c = *r->p++;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (c == '\"')\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (n < size) dst[n] = '\\0';\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "*ok = true;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "break;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "len = 1;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "utf8[0] = c;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (c == '\\\\')\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (r->p >= r->end) break;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "switch (c = *r->p++)\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "case 'b': utf8[0] = '\\b'; break;\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "case 'f': utf8[0] = '\\f'; break;\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "case 'n': utf8[0] = '\\n'; break;\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "case 'r': utf8[0] = '\\r'; break;\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "case 't': utf8[0] = '\\t'; break;\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "case 'u':\n");
+
+  emit_indent(outfile, indent + 4);
+  fprintf(outfile, "if (!json_hex4(r, &code)) return n;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 4);
+  fprintf(outfile, "if ((code >= 0xd800) && (code < 0xdc00))\n");
+
+  emit_indent(outfile, indent + 4);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 5);
+  fprintf(outfile,
+          "if ((r->end - r->p < 2) || (r->p[0] != '\\\\') || (r->p[1] != "
+          "'u'))\n");
+
+  emit_indent(outfile, indent + 6);
+  fprintf(outfile, "return n;\n");
+
+  emit_indent(outfile, indent + 5);
+  fprintf(outfile, "r->p += 2;\n");
+
+  emit_indent(outfile, indent + 5);
+  fprintf(outfile,
+          "if (!json_hex4(r, &low) || (low < 0xdc00) || (low > 0xdfff))\n");
+
+  emit_indent(outfile, indent + 6);
+  fprintf(outfile, "return n;\n");
+
+  emit_indent(outfile, indent + 5);
+  fprintf(outfile,
+          "code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);\n");
+
+  emit_indent(outfile, indent + 4);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 4);
+  fprintf(outfile, "if (code < 0x80)\n");
+
+  emit_indent(outfile, indent + 5);
+  fprintf(outfile, "utf8[0] = (char)code;\n");
+
+  emit_indent(outfile, indent + 4);
+  fprintf(outfile, "else if (code < 0x800)\n");
+
+  emit_indent(outfile, indent + 4);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 5);
+  fprintf(outfile, "utf8[0] = (char)(0xc0 | (code >> 6));\n");
+
+  emit_indent(outfile, indent + 5);
+  fprintf(outfile, "utf8[1] = (char)(0x80 | (code & 0x3f));\n");
+
+  emit_indent(outfile, indent + 5);
+  fprintf(outfile, "len = 2;\n");
+
+  emit_indent(outfile, indent + 4);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent + 4);
+  fprintf(outfile, "else if (code < 0x10000)\n");
+
+  emit_indent(outfile, indent + 4);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 5);
+  fprintf(outfile, "utf8[0] = (char)(0xe0 | (code >> 12));\n");
+
+  emit_indent(outfile, indent + 5);
+  fprintf(outfile, "utf8[1] = (char)(0x80 | ((code >> 6) & 0x3f));\n");
+
+  emit_indent(outfile, indent + 5);
+  fprintf(outfile, "utf8[2] = (char)(0x80 | (code & 0x3f));\n");
+
+  emit_indent(outfile, indent + 5);
+  fprintf(outfile, "len = 3;\n");
+
+  emit_indent(outfile, indent + 4);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent + 4);
+  fprintf(outfile, "else\n");
+
+  emit_indent(outfile, indent + 4);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 5);
+  fprintf(outfile, "utf8[0] = (char)(0xf0 | (code >> 18));\n");
+
+  emit_indent(outfile, indent + 5);
+  fprintf(outfile, "utf8[1] = (char)(0x80 | ((code >> 12) & 0x3f));\n");
+
+  emit_indent(outfile, indent + 5);
+  fprintf(outfile, "utf8[2] = (char)(0x80 | ((code >> 6) & 0x3f));\n");
+
+  emit_indent(outfile, indent + 5);
+  fprintf(outfile, "utf8[3] = (char)(0x80 | (code & 0x3f));\n");
+
+  emit_indent(outfile, indent + 5);
+  fprintf(outfile, "len = 4;\n");
+
+  emit_indent(outfile, indent + 4);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent + 4);
+  fprintf(outfile, "break;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "case '\"':\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "case '\\\\':\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "case '/': utf8[0] = c; break;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "default: return n;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "for (i = 0; i < len; i++, n++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (n < size) dst[n] = utf8[i];\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return n;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline char *json_read_string(json_reader *r, bool *ok)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "json_reader start;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char *s;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t n;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (json_accept_literal(r, \"null\", 4))\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "*ok = true;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "start = *r;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "n = json_decode_string(r, NULL, 0, ok);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!*ok) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "s = malloc(n + 1);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*ok = (s != NULL);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!s) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*r = start;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "json_decode_string(r, s, n + 1, ok);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return s;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline bool json_read_chars(json_reader *r,\n"
+          "                                   char *dst,\n"
+          "                                   size_t size)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool ok;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (json_accept_literal(r, \"null\", 4))\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "dst[0] = '\\0';\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return true;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "json_decode_string(r, dst, size, &ok);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return ok;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline bool json_scan_number(json_reader *r,\n"
+          "                                    const char **start,\n"
+          "                                    size_t *len,\n"
+          "                                    bool *integral)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "const char *p;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "json_skip_space(r);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*integral = true;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (p = r->p; p < r->end; p++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "if ((*p == '.') || (*p == 'e') || (*p == 'E') || (*p == '+'))\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "*integral = false;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "else if (((*p < '0') || (*p > '9')) && (*p != '-'))\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "break;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*start = r->p;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*len = (size_t)(p - r->p);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "r->p = p;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return *len > 0;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline double json_read_double(json_reader *r, bool *ok)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char number[64];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "const char *start;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t len;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool integral;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (json_accept_literal(r, \"null\", 4))\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "*ok = true;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return NAN;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*ok = json_scan_number(r, &start, &len, &integral);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!*ok || (len >= sizeof(number)))\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "*ok = false;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "memcpy(number, start, len);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "number[len] = '\\0';\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return strtod(number, NULL);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline uint64_t json_read_magnitude(json_reader *r,\n"
+          "                                           bool *negative,\n"
+          "                                           bool *ok)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "json_reader start = *r;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "const char *p;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t len;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint64_t value = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "double number;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool integral;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*negative = false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*ok = json_scan_number(r, &p, &len, &integral);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!*ok) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "// plain integers are converted in place, anything else by "
+          "strtod(),\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "// and must still be a whole number\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!integral)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "*r = start;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "number = json_read_double(r, ok);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "*negative = (number < 0);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (*negative) number = -number;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!(number < 18446744073709551616.0) ||\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "    ((double)(uint64_t)number != number))\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "*ok = false;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!*ok) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return (uint64_t)number;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*negative = (*p == '-');\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "for (p += *negative, len -= *negative; len; p++, len--)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "if ((*p == '-') || (value > (UINT64_MAX - (uint64_t)(*p - '0')) "
+          "/ 10))\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "*ok = false;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "return 0;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "value = value * 10 + (uint64_t)(*p - '0');\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return value;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline uint64_t json_read_uint(json_reader *r,\n"
+          "                                      uint64_t max,\n"
+          "                                      bool *ok)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool negative;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "uint64_t value = json_read_magnitude(r, &negative, ok);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if ((negative && value) || (value > max)) *ok = false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return *ok ? value : 0;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline int64_t json_read_int(json_reader *r,\n"
+          "                                    int64_t min,\n"
+          "                                    int64_t max,\n"
+          "                                    bool *ok)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool negative;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "uint64_t value = json_read_magnitude(r, &negative, ok);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (negative ? (value > (uint64_t)0 - (uint64_t)min) :\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "               (value > (uint64_t)max))\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "*ok = false;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!*ok) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "return negative ? (int64_t)((uint64_t)0 - value) : "
+          "(int64_t)value;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline bool json_read_bool(json_reader *r, bool *ok)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*ok = true;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (json_accept_literal(r, \"true\", 4)) return true;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (json_accept_literal(r, \"false\", 5)) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return json_read_uint(r, 1, ok) != 0;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "static inline bool json_skip_value(json_reader *r)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "const char *key;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t len;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool ok = true;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int more = 1;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "char close;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "json_skip_space(r);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (r->p >= r->end) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "switch (*r->p)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "case '\"':\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "json_decode_string(r, NULL, 0, &ok);\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "break;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "case '{':\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "case '[':\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (++r->depth > JSON_MAX_DEPTH) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "close = (*r->p++ == '{') ? '}' : ']';\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (json_accept(r, close)) more = 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "while (ok && (more > 0))\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "if ((close == '}') && !json_read_key(r, &key, &len))\n");
+
+  emit_indent(outfile, indent + 4);
+  fprintf(outfile, "ok = false;\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "else\n");
+
+  emit_indent(outfile, indent + 4);
+  fprintf(outfile, "ok = json_skip_value(r);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "if (ok) more = json_next(r, close);\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "--r->depth;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (more < 0) ok = false;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "break;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "case 't': ok = json_accept_literal(r, \"true\", 4); break;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "case 'f': ok = json_accept_literal(r, \"false\", 5); break;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "default: json_read_double(r, &ok); break;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return ok;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+
+    // every struct may be nested in a struct declared before it
+
+  for (node = root->children; node; node = node->next)
+  {
+    if (strcmp((char *)node->name, "struct")) continue;
+
+    name = get_attribute(node, "name");
+    if (!name) continue;
+
+    fpre = function_prefix(project, name);
+
+    if (fpre)
+    {
+      fprintf(outfile,
+              "%svoid %s_json_write(json_writer *w, %s *instance);\n",
+              json_linkage(),
+              fpre,
+              name);
+      fprintf(outfile,
+              "%sbool %s_json_read(json_reader *r, %s *instance);\n",
+              json_linkage(),
+              fpre,
+              name);
+    }
+
+    free(name);
+    name = NULL;
+
+    if (fpre) free(fpre);
+    fpre = NULL;
+  }
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (project) free(project);
+}
+
+  /**
+   *  @fn void emit_aggregate_json_functions(FILE *outfile,
+   *                                         xmlNodePtr node,
+   *                                         char *project_name)
+   *
+   *  @brief generates JSON encoder and decoder C source code from struct
+   *         element in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_json_functions(FILE *outfile,
+                                   xmlNodePtr node,
+                                   char *project_name)
+{
+  char *project = NULL;
+  char *name = NULL;
+  int indent = 0;
+
+  if (!option_gen_json()) goto exit;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  if (strcmp((char *)node->name, "struct")) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+  str_lower(project);
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " *  JSON functions for struct %s\n", name);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  emit_aggregate_json_field_function(outfile, node, project, indent);
+  emit_aggregate_json_write_function(outfile, node, project, indent);
+  emit_aggregate_json_read_function(outfile, node, project, indent);
+  emit_aggregate_to_json_function(outfile, node, project, indent);
+  emit_aggregate_from_json_function(outfile, node, project, indent);
+
+exit:
+  if (project) free(project);
+  if (name) free(name);
+}
+
+  /**
+   *  @fn void emit_aggregate_json_field_function(FILE *outfile,
+   *                                              xmlNodePtr node,
+   *                                              char *project,
+   *                                              int indent)
+   *
+   *  @brief generates static C source code finding the field named by a
+   *         JSON key of struct from element in @p node
+   *
+   *  NOTE:  the returned number is the slot of the field in a perfect hash
+   *         table, which is also its case label in _json_read()
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_json_field_function(FILE *outfile,
+                                               xmlNodePtr node,
+                                               char *project,
+                                               int indent)
+{
+  xmlNodePtr child;
+  xmlNodePtr type;
+  char *name = NULL;
+  char *fpre = NULL;
+  char *field_name = NULL;
+  int *slots = NULL;
+  uint32_t seed;
+  uint32_t size;
+  int field = 0;
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+  if (!fpre) goto exit;
+
+  slots = json_perfect_hash(node, &seed, &size);
+  if (!slots) goto exit;
+
+  fprintf(outfile,
+          "static int %s_json_field(const char *key, size_t len)\n",
+          fpre);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "static const char *const names[%u] =\n", size);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (strcmp((char *)child->name, "field")) continue;
+
+    if (json_field_kind(child, &type) == serialize_kind_none) continue;
+
+    field_name = get_attribute(child, "name");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "[%d] = \"%s\",\n", slots[field++], field_name);
+
+    if (field_name) free(field_name);
+    field_name = NULL;
+  }
+
+  if (!field)
+  {
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "NULL\n");
+  }
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "};\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "uint32_t slot = json_hash(key, len, %uu) & %u;\n",
+          seed,
+          size - 1);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (!names[slot] || strncmp(names[slot], key, len) ||"
+          " names[slot][len])\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return -1;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return (int)slot;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+  if (slots) free(slots);
+}
+
+  /**
+   *  @fn void emit_aggregate_json_write_function(FILE *outfile,
+   *                                              xmlNodePtr node,
+   *                                              char *project,
+   *                                              int indent)
+   *
+   *  @brief generates static C source code writing struct from element in
+   *         @p node as a JSON object
+   *
+   *  NOTE:  keys, with their quotes, colon and separating comma, are
+   *         written as constant strings
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_json_write_function(FILE *outfile,
+                                               xmlNodePtr node,
+                                               char *project,
+                                               int indent)
+{
+  xmlNodePtr child;
+  xmlNodePtr type;
+  serialize_kind kind;
+  char *name = NULL;
+  char *fpre = NULL;
+  char *field_name = NULL;
+  char *lvalue = NULL;
+  char *element = NULL;
+  char *type_name = NULL;
+  bool first = true;
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+  if (!fpre) goto exit;
+
+  fprintf(outfile,
+          "%svoid %s_json_write(json_writer *w, %s *instance)\n",
+          json_linkage(),
+          fpre,
+          name);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (strcmp((char *)child->name, "field")) continue;
+
+    field_name = get_attribute(child, "name");
+    if (!field_name) continue;
+
+    kind = json_field_kind(child, &type);
+
+    if (kind == serialize_kind_none)
+    {
+      fprintf(outfile,
+              "#warning Encode field %s of %s here,"
+              " in _json_write() and _json_read()"
+              " OR remove this warning\n",
+              field_name,
+              name);
+      goto next;
+    }
+
+    lvalue = strapp(lvalue, "instance->");
+    lvalue = strapp(lvalue, profile_field_path(name, field_name));
+    lvalue = strapp(lvalue, field_name);
+
+    if (sso_size(name, child))
+    {
+      element = sso_read(lvalue);
+      free(lvalue);
+      lvalue = element;
+      element = NULL;
+    }
+
+    emit_indent(outfile, indent);
+    fprintf(outfile,
+            "json_put(w, \"%s\\\"%s\\\":\", %d);\n",
+            first ? "{" : ",",
+            field_name,
+            (int)strlen(field_name) + 4);
+
+    first = false;
+
+    if (kind != serialize_kind_array)
+    {
+      emit_json_write_value(outfile, lvalue, kind, type, project, indent);
+      goto next;
+    }
+
+    type_name = get_attribute(type, "type-name");
+    if (!type_name) goto next;
+
+    element = strapp(element, "((");
+    element = strapp(element, type_name);
+    element = strapp(element, " *)&");
+    element = strapp(element, lvalue);
+    element = strapp(element, ")[i]");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "{\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "size_t i;\n");
+
+    fprintf(outfile, "\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "json_put(w, \"[\", 1);\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile,
+            "for (i = 0; i < sizeof(%s) / sizeof(%s); i++)\n",
+            lvalue,
+            type_name);
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "{\n");
+
+    emit_indent(outfile, indent + 2);
+    fprintf(outfile, "if (i) json_put(w, \",\", 1);\n");
+
+    emit_json_write_value(outfile,
+                          element,
+                          serialize_scalar_kind(type),
+                          type,
+                          project,
+                          indent + 2);
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "}\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "json_put(w, \"]\", 1);\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "}\n");
+
+next:
+    free(field_name);
+    field_name = NULL;
+
+    if (lvalue) free(lvalue);
+    lvalue = NULL;
+
+    if (element) free(element);
+    element = NULL;
+
+    if (type_name) free(type_name);
+    type_name = NULL;
+  }
+
+  emit_indent(outfile, indent);
+  if (first)
+    fprintf(outfile, "json_put(w, \"{}\", 2);\n");
+  else
+    fprintf(outfile, "json_put(w, \"}\", 1);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+}
+
+  /**
+   *  @fn void emit_aggregate_json_read_function(FILE *outfile,
+   *                                             xmlNodePtr node,
+   *                                             char *project,
+   *                                             int indent)
+   *
+   *  @brief generates static C source code reading a JSON object into
+   *         struct from element in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_json_read_function(FILE *outfile,
+                                              xmlNodePtr node,
+                                              char *project,
+                                              int indent)
+{
+  xmlNodePtr child;
+  xmlNodePtr type;
+  serialize_kind kind;
+  char *name = NULL;
+  char *fpre = NULL;
+  char *field_name = NULL;
+  char *lvalue = NULL;
+  char *element = NULL;
+  char *type_name = NULL;
+  int *slots = NULL;
+  uint32_t seed;
+  uint32_t size;
+  bool has_enum = false;
+  int field = 0;
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+  if (!fpre) goto exit;
+
+  slots = json_perfect_hash(node, &seed, &size);
+  if (!slots) goto exit;
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (strcmp((char *)child->name, "field")) continue;
+
+    if ((json_field_kind(child, &type) == serialize_kind_integer) &&
+        !strcmp((char *)type->name, "type-reference"))
+      has_enum = true;
+  }
+
+  fprintf(outfile,
+          "%sbool %s_json_read(json_reader *r, %s *instance)\n",
+          json_linkage(),
+          fpre,
+          name);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "const char *key;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t len;\n");
+
+  if (has_enum)
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "char word[64] = \"\";\n");
+  }
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool ok = false;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int more = 1;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!json_accept(r, '{')) return false;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (json_accept(r, '}')) return true;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (++r->depth > JSON_MAX_DEPTH) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "while (more > 0)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!json_read_key(r, &key, &len)) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "switch (%s_json_field(key, len))\n", fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (strcmp((char *)child->name, "field")) continue;
+
+    kind = json_field_kind(child, &type);
+    if (kind == serialize_kind_none) continue;
+
+    field_name = get_attribute(child, "name");
+    if (!field_name) continue;
+
+    lvalue = strapp(lvalue, "instance->");
+    lvalue = strapp(lvalue, profile_field_path(name, field_name));
+    lvalue = strapp(lvalue, field_name);
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "case %d:  /* %s */\n", slots[field++], field_name);
+
+    if (intern_field(name, child))
+    {
+      emit_json_read_interned(outfile, lvalue, indent + 1);
+      goto next;
+    }
+
+    if (sso_size(name, child))
+    {
+      emit_json_read_inline(outfile, lvalue, indent + 1);
+      goto next;
+    }
+
+    if (kind != serialize_kind_array)
+    {
+      emit_json_read_value(outfile, lvalue, kind, type, project, indent + 1);
+      goto next;
+    }
+
+    type_name = get_attribute(type, "type-name");
+    if (!type_name) goto next;
+
+    element = strapp(element, "((");
+    element = strapp(element, type_name);
+    element = strapp(element, " *)&");
+    element = strapp(element, lvalue);
+    element = strapp(element, ")[i++]");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "{\n");
+
+    emit_indent(outfile, indent + 2);
+    fprintf(outfile, "size_t i = 0;\n");
+
+    emit_indent(outfile, indent + 2);
+    fprintf(outfile, "int next = 1;\n");
+
+    fprintf(outfile, "\n");
+
+    emit_indent(outfile, indent + 2);
+    fprintf(outfile, "ok = json_accept(r, '[');\n");
+
+    emit_indent(outfile, indent + 2);
+    fprintf(outfile, "if (ok && json_accept(r, ']')) next = 0;\n");
+
+    fprintf(outfile, "\n");
+
+    emit_indent(outfile, indent + 2);
+    fprintf(outfile, "while (ok && (next > 0))\n");
+
+    emit_indent(outfile, indent + 2);
+    fprintf(outfile, "{\n");
+
+    emit_indent(outfile, indent + 3);
+    fprintf(outfile,
+            "if (i < sizeof(%s) / sizeof(%s))\n",
+            lvalue,
+            type_name);
+
+    emit_json_read_value(outfile,
+                         element,
+                         serialize_scalar_kind(type),
+                         type,
+                         project,
+                         indent + 4);
+
+    emit_indent(outfile, indent + 3);
+    fprintf(outfile, "else\n");
+
+    emit_indent(outfile, indent + 4);
+    fprintf(outfile, "ok = json_skip_value(r);\n");
+
+    fprintf(outfile, "\n");
+
+    emit_indent(outfile, indent + 3);
+    fprintf(outfile, "if (ok) next = json_next(r, ']');\n");
+
+    emit_indent(outfile, indent + 2);
+    fprintf(outfile, "}\n");
+
+    fprintf(outfile, "\n");
+
+    emit_indent(outfile, indent + 2);
+    fprintf(outfile, "if (next < 0) ok = false;\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "}\n");
+
+next:
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "break;\n");
+
+    fprintf(outfile, "\n");
+
+    free(field_name);
+    field_name = NULL;
+
+    if (lvalue) free(lvalue);
+    lvalue = NULL;
+
+    if (element) free(element);
+    element = NULL;
+
+    if (type_name) free(type_name);
+    type_name = NULL;
+  }
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "default:\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "ok = json_skip_value(r);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "break;\n");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!ok) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "more = json_next(r, '}');\n");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "ok = !more;\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "exit:\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "--r->depth;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return ok;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+  if (slots) free(slots);
+}
+
+  /**
+   *  @fn void emit_aggregate_to_json_function(FILE *outfile,
+   *                                           xmlNodePtr node,
+   *                                           char *project,
+   *                                           int indent)
+   *
+   *  @brief generates C source code encoding struct from element in @p node
+   *         as JSON text
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_to_json_function(FILE *outfile,
+                                            xmlNodePtr node,
+                                            char *project,
+                                            int indent)
+{
+  char *name = NULL;
+  char *fpre = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to struct to encode",
+    "buf - buffer receiving NUL terminated JSON text, may be NULL",
+    "len - size of buf in bytes",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+  if (!fpre) goto exit;
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_to_json(");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, " *instance, char *buf, size_t len)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "encodes instance as a JSON object",
+                                      params,
+                                      "length of whole JSON text, not "
+                                      "counting NUL",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "json_writer w;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "w.buf = buf;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "w.len = buf ? len : 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "w.pos = 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (instance) %s_json_write(&w, instance);\n", fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "else json_put(&w, \"null\", 4);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (w.len) buf[(w.pos < w.len) ? w.pos : w.len - 1] = '\\0';\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return w.pos;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_aggregate_from_json_function(FILE *outfile,
+   *                                             xmlNodePtr node,
+   *                                             char *project,
+   *                                             int indent)
+   *
+   *  @brief generates C source code decoding JSON text into struct from
+   *         element in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_from_json_function(FILE *outfile,
+                                              xmlNodePtr node,
+                                              char *project,
+                                              int indent)
+{
+  char *name = NULL;
+  char *fpre = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to struct receiving decoded fields, whose char *",
+    "           fields are freed and replaced by new strings",
+    "json - JSON text holding one object",
+    "len - length of json in bytes",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+  if (!fpre) goto exit;
+
+  prototype = strapp(prototype, "bool ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_from_json(");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, " *instance, const char *json, size_t len)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "decodes a JSON object into instance",
+                                      params,
+                                      "true on success, false if json is "
+                                      "malformed",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "json_reader r;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !json) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "r.p = json;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "r.end = json + len;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "r.depth = 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!%s_json_read(&r, instance)) return false;\n", fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "json_skip_space(&r);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return r.p == r.end;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_json_write_value(FILE *outfile,
+   *                                 char *lvalue,
+   *                                 serialize_kind kind,
+   *                                 xmlNodePtr type,
+   *                                 char *project,
+   *                                 int indent)
+   *
+   *  @brief generates C source code writing a single value as JSON
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param lvalue - string containing C expression of value
+   *  @param kind - JSON encoding of value
+   *  @param type - xmlNodePtr containing type element of value
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_json_write_value(FILE *outfile,
+                                  char *lvalue,
+                                  serialize_kind kind,
+                                  xmlNodePtr type,
+                                  char *project,
+                                  int indent)
+{
+  char *type_name = NULL;
+  char *is_unsigned = NULL;
+  char *fpre = NULL;
+
+  if (!outfile || !lvalue || !type || !project) goto exit;
+
+  type_name = get_attribute(type, "type-name");
+  is_unsigned = get_attribute(type, "unsigned");
+
+  emit_indent(outfile, indent);
+
+  switch (kind)
+  {
+    case serialize_kind_integer:
+      if (!strcmp((char *)type->name, "type-reference"))
+      {
+        free(type_name);
+        type_name = get_attribute(type, "name");
+
+        fpre = function_prefix(project, type_name);
+
+        fprintf(outfile,
+                "json_put_string(w, %s_to_str(%s), SIZE_MAX);\n",
+                fpre,
+                lvalue);
+      }
+      else if (type_name &&
+               (!strcmp(type_name, "_Bool") || !strcmp(type_name, "bool")))
+        fprintf(outfile,
+                "json_put(w, %s ? \"true\" : \"false\", %s ? 4 : 5);\n",
+                lvalue,
+                lvalue);
+      else if (is_unsigned && !strcmp(is_unsigned, "true"))
+        fprintf(outfile, "json_put_uint(w, (uint64_t)%s);\n", lvalue);
+      else
+        fprintf(outfile, "json_put_int(w, (int64_t)%s);\n", lvalue);
+      break;
+
+    case serialize_kind_bitfield:
+      fprintf(outfile, "json_put_uint(w, (uint64_t)%s);\n", lvalue);
+      break;
+
+    case serialize_kind_float:
+      fprintf(outfile, "json_put_double(w, %s, true);\n", lvalue);
+      break;
+
+    case serialize_kind_double:
+      fprintf(outfile, "json_put_double(w, %s, false);\n", lvalue);
+      break;
+
+    case serialize_kind_string:
+      fprintf(outfile, "json_put_string(w, %s, SIZE_MAX);\n", lvalue);
+      break;
+
+    case serialize_kind_bytes:
+      fprintf(outfile,
+              "json_put_string(w, %s, sizeof(%s));\n",
+              lvalue,
+              lvalue);
+      break;
+
+    case serialize_kind_aggregate:
+      free(type_name);
+      type_name = get_attribute(type, "name");
+
+      fpre = function_prefix(project, type_name);
+
+      fprintf(outfile, "%s_json_write(w, &%s);\n", fpre, lvalue);
+      break;
+
+    default:
+      fprintf(outfile, "json_put(w, \"null\", 4);\n");
+      break;
+  }
+
+exit:
+  if (type_name) free(type_name);
+  if (is_unsigned) free(is_unsigned);
+  if (fpre) free(fpre);
+}
+
+  /**
+   *  @fn void emit_json_read_integer(FILE *outfile,
+   *                                  char *lvalue,
+   *                                  char *cast,
+   *                                  xmlNodePtr type,
+   *                                  bool is_signed)
+   *
+   *  @brief generates C source code reading a JSON number into an integer,
+   *         setting ok to false if it is not a whole number in the range of
+   *         the type
+   *
+   *  NOTE:  the range comes from the size attribute of @p type, in bits,
+   *         64 bits if it has none
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param lvalue - string containing C expression of value
+   *  @param cast - string containing C type of value, NULL for no cast
+   *  @param type - xmlNodePtr containing scalar or bitfield element of value
+   *  @param is_signed - true if value is signed
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_json_read_integer(FILE *outfile,
+                                   char *lvalue,
+                                   char *cast,
+                                   xmlNodePtr type,
+                                   bool is_signed)
+{
+  char min[32];
+  char max[32];
+  char *s = NULL;
+  int size = 64;
+
+  if (!outfile || !lvalue || !type) goto exit;
+
+  s = get_attribute(type, "size");
+  if (s) size = atoi(s);
+  if ((size < 1) || (size > 64)) size = 64;
+
+    // whole width types use the <stdint.h> limits, bitfields their own
+
+  if ((size == 8) || (size == 16) || (size == 32) || (size == 64))
+  {
+    snprintf(min, sizeof(min), "INT%d_MIN", size);
+    snprintf(max, sizeof(max), "%sINT%d_MAX", is_signed ? "" : "U", size);
+  }
+  else if (is_signed)
+  {
+    snprintf(min, sizeof(min), "%lld", -(1LL << (size - 1)));
+    snprintf(max, sizeof(max), "%lld", (1LL << (size - 1)) - 1);
+  }
+  else
+    snprintf(max, sizeof(max), "%lluu", (1ULL << size) - 1);
+
+  fprintf(outfile, "%s = ", lvalue);
+
+  if (cast) fprintf(outfile, "(%s)", cast);
+
+  if (is_signed)
+    fprintf(outfile, "json_read_int(r, %s, %s, &ok);\n", min, max);
+  else
+    fprintf(outfile, "json_read_uint(r, %s, &ok);\n", max);
+
+exit:
+  if (s) free(s);
+}
+
+  /**
+   *  @fn void emit_json_read_interned(FILE *outfile,
+   *                                   char *lvalue,
+   *                                   int indent)
+   *
+   *  @brief generates C source code reading a JSON string into an interned
+   *         char * field, setting ok to false if it is malformed
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param lvalue - string containing C expression of field
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_json_read_interned(FILE *outfile, char *lvalue, int indent)
+{
+  if (!outfile || !lvalue) goto exit;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "intern_release(%s);\n", lvalue);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "char *s = json_read_string(r, &ok);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s = intern_string(s);\n", lvalue);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (s && !%s) ok = false;\n", lvalue);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "free(s);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+exit:
+}
+
+  /**
+   *  @fn void emit_json_read_inline(FILE *outfile,
+   *                                 char *lvalue,
+   *                                 int indent)
+   *
+   *  @brief generates C source code reading a JSON string into an inline
+   *         char * field, setting ok to false if it is malformed
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param lvalue - string containing C expression of field
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_json_read_inline(FILE *outfile, char *lvalue, int indent)
+{
+  char *store = NULL;
+
+  if (!outfile || !lvalue) goto exit;
+
+  store = sso_store(lvalue, "s");
+  if (!store) goto exit;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "char *s = json_read_string(r, &ok);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (ok && !%s) ok = false;\n", store);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "free(s);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+exit:
+  if (store) free(store);
+}
+
+  /**
+   *  @fn void emit_json_read_value(FILE *outfile,
+   *                                char *lvalue,
+   *                                serialize_kind kind,
+   *                                xmlNodePtr type,
+   *                                char *project,
+   *                                int indent)
+   *
+   *  @brief generates C source code reading a single JSON value, setting
+   *         ok to false if it is malformed
+   *
+   *  NOTE:  @p lvalue is used once, except for enums and char * fields
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param lvalue - string containing C expression of value
+   *  @param kind - JSON encoding of value
+   *  @param type - xmlNodePtr containing type element of value
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_json_read_value(FILE *outfile,
+                                 char *lvalue,
+                                 serialize_kind kind,
+                                 xmlNodePtr type,
+                                 char *project,
+                                 int indent)
+{
+  char *type_name = NULL;
+  char *is_unsigned = NULL;
+  char *fpre = NULL;
+
+  if (!outfile || !lvalue || !type || !project) goto exit;
+
+  type_name = get_attribute(type, "type-name");
+  is_unsigned = get_attribute(type, "unsigned");
+
+  emit_indent(outfile, indent);
+
+  switch (kind)
+  {
+    case serialize_kind_integer:
+      if (!strcmp((char *)type->name, "type-reference"))
+      {
+        free(type_name);
+        type_name = get_attribute(type, "name");
+
+        fpre = function_prefix(project, type_name);
+
+        fprintf(outfile,
+                "ok = json_read_chars(r, word, sizeof(word) - 1);\n");
+
+        emit_indent(outfile, indent);
+        fprintf(outfile, "if (ok) %s = %s_from_str(word);\n", lvalue, fpre);
+      }
+      else if (type_name &&
+               (!strcmp(type_name, "_Bool") || !strcmp(type_name, "bool")))
+        fprintf(outfile, "%s = json_read_bool(r, &ok);\n", lvalue);
+      else
+        emit_json_read_integer(outfile,
+                               lvalue,
+                               type_name,
+                               type,
+                               !(is_unsigned && !strcmp(is_unsigned, "true")));
+      break;
+
+    case serialize_kind_bitfield:
+        // generated bitfields are always uint32_t
+
+      emit_json_read_integer(outfile, lvalue, NULL, type, false);
+      break;
+
+    case serialize_kind_float:
+      fprintf(outfile, "%s = (float)json_read_double(r, &ok);\n", lvalue);
+      break;
+
+    case serialize_kind_double:
+      fprintf(outfile, "%s = json_read_double(r, &ok);\n", lvalue);
+      break;
+
+    case serialize_kind_string:
+      fprintf(outfile, "free(%s);\n", lvalue);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "%s = json_read_string(r, &ok);\n", lvalue);
+      break;
+
+    case serialize_kind_bytes:
+      fprintf(outfile,
+              "ok = json_read_chars(r, %s, sizeof(%s));\n",
+              lvalue,
+              lvalue);
+      break;
+
+    case serialize_kind_aggregate:
+      free(type_name);
+      type_name = get_attribute(type, "name");
+
+      fpre = function_prefix(project, type_name);
+
+      fprintf(outfile, "ok = %s_json_read(r, &%s);\n", fpre, lvalue);
+      break;
+
+    default:
+      fprintf(outfile, "ok = json_skip_value(r);\n");
+      break;
+  }
+
+exit:
+  if (type_name) free(type_name);
+  if (is_unsigned) free(is_unsigned);
+  if (fpre) free(fpre);
+}
+
+  /**
+   *  @fn serialize_kind json_field_kind(xmlNodePtr node, xmlNodePtr *type)
+   *
+   *  @brief determines how field element in @p node is encoded as JSON
+   *
+   *  @param node - xmlNodePtr containing field element
+   *  @param type - address of xmlNodePtr receiving type element of field,
+   *                which is the scalar element for arrays and pointers
+   *
+   *  @return @a serialize_kind of field, serialize_kind_bytes for char
+   *          arrays, serialize_kind_none if field can not be encoded
+   */
+
+static serialize_kind json_field_kind(xmlNodePtr node, xmlNodePtr *type)
+{
+  serialize_kind kind;
+  char *s = NULL;
+
+  kind = serialize_field_kind(node, type);
+
+  switch (kind)
+  {
+    case serialize_kind_bytes:
+        // char arrays are strings, other byte arrays are numbers, and
+        // scalars with no portable representation are not encoded
+
+      if ((*type)->parent == node)
+      {
+        kind = serialize_kind_none;
+        break;
+      }
+
+      s = get_attribute(*type, "type-name");
+
+      if (s && !strcmp(s, "char"))
+        kind = serialize_kind_bytes;
+      else if (serialize_scalar_kind(*type) == serialize_kind_integer)
+        kind = serialize_kind_array;
+      else
+        kind = serialize_kind_none;
+      break;
+
+    case serialize_kind_aggregate:
+        // a union has no way to tell which member is in use
+
+      s = get_attribute(*type, "type");
+      if (!s || strcmp(s, "struct")) kind = serialize_kind_none;
+      break;
+
+    default: break;
+  }
+
+  if (s) free(s);
+
+  return kind;
+}
+
+  /**
+   *  @fn uint32_t json_hash(char *key, uint32_t seed)
+   *
+   *  @brief hashes @p key exactly as json_hash() of generated code does
+   *
+   *  @param key - string to hash
+   *  @param seed - value mixed into hash
+   *
+   *  @return 32 bit FNV-1a hash of @p key
+   */
+
+static uint32_t json_hash(char *key, uint32_t seed)
+{
+  uint32_t hash = JSON_HASH_BASIS ^ seed;
+
+  for (; *key; key++)
+  {
+    hash ^= (unsigned char)*key;
+    hash *= JSON_HASH_PRIME;
+  }
+
+  return hash;
+}
+
+  /**
+   *  @fn int *json_perfect_hash(xmlNodePtr node,
+   *                             uint32_t *seed,
+   *                             uint32_t *size)
+   *
+   *  @brief finds a seed for which json_hash() puts the name of every
+   *         encoded field of struct in @p node in a slot of its own
+   *
+   *  NOTE:  table size starts at a power of two of at least twice the
+   *         number of fields, and is doubled when no seed works
+   *
+   *  @param node - xmlNodePtr containing struct element
+   *  @param seed - address of uint32_t receiving seed
+   *  @param size - address of uint32_t receiving table size
+   *
+   *  @return array holding slot of every encoded field, in declared order,
+   *          which caller must free, NULL on failure
+   */
+
+static int *json_perfect_hash(xmlNodePtr node,
+                              uint32_t *seed,
+                              uint32_t *size)
+{
+  xmlNodePtr child;
+  xmlNodePtr type;
+  char **names = NULL;
+  int *slots = NULL;
+  bool *used = NULL;
+  void *tmp;
+  uint32_t slot;
+  int n = 0;
+  int i;
+
+  if (!node || !seed || !size) goto exit;
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (strcmp((char *)child->name, "field")) continue;
+
+    if (json_field_kind(child, &type) == serialize_kind_none) continue;
+
+    tmp = realloc(names, sizeof(char *) * (n + 1));
+    if (!tmp) goto exit;
+
+    names = tmp;
+    names[n] = get_attribute(child, "name");
+    if (!names[n++]) goto exit;
+  }
+
+  slots = malloc(sizeof(int) * (n ? n : 1));
+  if (!slots) goto exit;
+
+  for (*size = 1; *size < (uint32_t)(2 * n); *size <<= 1) ;
+
+  for (;; *size <<= 1)
+  {
+    tmp = realloc(used, sizeof(bool) * *size);
+    if (!tmp) break;
+
+    used = tmp;
+
+    for (*seed = 0; *seed < JSON_SEEDS; ++*seed)
+    {
+      memset(used, 0, sizeof(bool) * *size);
+
+      for (i = 0; i < n; i++)
+      {
+        slot = json_hash(names[i], *seed) & (*size - 1);
+        if (used[slot]) break;
+
+        used[slot] = true;
+        slots[i] = (int)slot;
+      }
+
+      if (i == n) goto exit;
+    }
+  }
+
+  free(slots);
+  slots = NULL;
+
+exit:
+  if (names)
+  {
+    for (i = 0; i < n; i++)
+      if (names[i]) free(names[i]);
+    free(names);
+  }
+  if (used) free(used);
+
+  return slots;
+}
+
+  /**
+   *  @fn char *json_linkage(void)
+   *
+   *  @brief returns storage class of the per-struct JSON writer and reader
+   *
+   *  NOTE:  a struct nested in another may be emitted in a different split
+   *         source file, so split source gives them external linkage
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return "static " if source is not split, empty string if it is
+   */
+
+static char *json_linkage(void)
+{
+  return option_split_source() ? "" : "static ";
+}
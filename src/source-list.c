@@ -29,7 +29,11 @@
 #include "config.h"
 
 #include "source-list.h"
+#include "source-batch.h"
 #include "options.h"
+#include "source-concurrent.h"
+#include "source-iter.h"
+#include "tuning.h"
 
 static void emit_aggregate_list_new_function(FILE *outfile,
                                              xmlNodePtr node,
@@ -236,6 +240,9 @@ void emit_aggregate_list_functions(FILE *outfile,
   emit_aggregate_list_free_node_function(outfile, node, project, indent);
   emit_aggregate_list_cmp_node_function(outfile, node, project, indent);
 
+  emit_aggregate_batch_functions(outfile, node, project, "list");
+  emit_aggregate_iter_functions(outfile, node, project, "list");
+
 exit:
   if (project) free(project);
   if (name) free(name);
@@ -288,9 +295,11 @@ static void emit_aggregate_list_new_function(FILE *outfile,
   emit_aggregate_list_new_annotation(outfile, node, name, fpre2, indent + 1);
 
   fprintf(outfile,
-          "%s *%s_new(void)\n",
+          "%s%s *%s_new%s(void)\n",
+          concurrent_storage(option_concurrent_list()),
           list_name,
-          fpre);
+          fpre,
+          concurrent_suffix(option_concurrent_list()));
   fprintf(outfile, "{\n");
 
   ++indent;
@@ -369,6 +378,16 @@ static void emit_aggregate_list_new_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_create,
+                          "list",
+                          list_name,
+                          true,
+                          fpre,
+                          "new",
+                          "",
+                          "void");
+
 exit:
   if (name) free(name);
   if (fpre) free(fpre);
@@ -421,9 +440,11 @@ static void emit_aggregate_list_dup_function(FILE *outfile,
 
   emit_aggregate_list_dup_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "%s *%s_dup(%s *instance)\n",
+  fprintf(outfile, "%s%s *%s_dup%s(%s *instance)\n",
+                   concurrent_storage(option_concurrent_list()),
                    list_name,
                    fpre,
+                   concurrent_suffix(option_concurrent_list()),
                    list_name);
   fprintf(outfile, "{\n");
 
@@ -466,6 +487,17 @@ static void emit_aggregate_list_dup_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_copy,
+                          "list",
+                          list_name,
+                          true,
+                          fpre,
+                          "dup",
+                          "instance",
+                          "%s *instance",
+                          list_name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -523,9 +555,11 @@ static void emit_aggregate_list_free_function(FILE *outfile,
                                        indent + 1);
 
   fprintf(outfile,
-          "void %s_free(%s *instance)\n",
-           fpre,
-           list_name);
+          "%svoid %s_free%s(%s *instance)\n",
+          concurrent_storage(option_concurrent_list()),
+          fpre,
+          concurrent_suffix(option_concurrent_list()),
+          list_name);
   fprintf(outfile, "{\n");
 
   ++indent;
@@ -551,6 +585,17 @@ static void emit_aggregate_list_free_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_destroy,
+                          "list",
+                          "void",
+                          false,
+                          fpre,
+                          "free",
+                          "instance",
+                          "%s *instance",
+                          list_name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -604,11 +649,13 @@ static void emit_aggregate_list_add_function(FILE *outfile,
 
   emit_aggregate_list_add_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "void %s_add(%s *instance,\n"
+  fprintf(outfile, "%svoid %s_add%s(%s *instance,\n"
                    "  llist_position position,\n"
                    "  %s *where,\n"
                    "  %s *item)\n",
+                   concurrent_storage(option_concurrent_list()),
                    fpre,
+                   concurrent_suffix(option_concurrent_list()),
                    list_name,
                    name,
                    name);
@@ -633,6 +680,22 @@ static void emit_aggregate_list_add_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_write,
+                          "list",
+                          "void",
+                          false,
+                          fpre,
+                          "add",
+                          "instance, position, where, item",
+                          "%s *instance,\n"
+                          "  llist_position position,\n"
+                          "  %s *where,\n"
+                          "  %s *item",
+                          list_name,
+                          name,
+                          name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -685,8 +748,10 @@ static void emit_aggregate_list_remove_function(FILE *outfile,
 
   emit_aggregate_list_remove_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "void %s_remove(%s *instance, %s *item)\n",
+  fprintf(outfile, "%svoid %s_remove%s(%s *instance, %s *item)\n",
+                   concurrent_storage(option_concurrent_list()),
                    fpre,
+                   concurrent_suffix(option_concurrent_list()),
                    list_name,
                    name);
 
@@ -717,6 +782,18 @@ static void emit_aggregate_list_remove_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_write,
+                          "list",
+                          "void",
+                          false,
+                          fpre,
+                          "remove",
+                          "instance, item",
+                          "%s *instance, %s *item",
+                          list_name,
+                          name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -770,9 +847,11 @@ static void emit_aggregate_list_head_function(FILE *outfile,
 
   emit_aggregate_list_head_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "%s *%s_head(%s *instance)\n",
-                   name, 
+  fprintf(outfile, "%s%s *%s_head%s(%s *instance)\n",
+                   concurrent_storage(option_concurrent_list()),
+                   name,
                    fpre,
+                   concurrent_suffix(option_concurrent_list()),
                    list_name);
 
   fprintf(outfile, "{\n");
@@ -805,6 +884,17 @@ static void emit_aggregate_list_head_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_cursor,
+                          "list",
+                          name,
+                          true,
+                          fpre,
+                          "head",
+                          "instance",
+                          "%s *instance",
+                          list_name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -858,9 +948,11 @@ static void emit_aggregate_list_tail_function(FILE *outfile,
 
   emit_aggregate_list_tail_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "%s *%s_tail(%s *instance)\n",
-                   name, 
+  fprintf(outfile, "%s%s *%s_tail%s(%s *instance)\n",
+                   concurrent_storage(option_concurrent_list()),
+                   name,
                    fpre,
+                   concurrent_suffix(option_concurrent_list()),
                    list_name);
 
   fprintf(outfile, "{\n");
@@ -893,6 +985,17 @@ static void emit_aggregate_list_tail_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_cursor,
+                          "list",
+                          name,
+                          true,
+                          fpre,
+                          "tail",
+                          "instance",
+                          "%s *instance",
+                          list_name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -946,9 +1049,11 @@ static void emit_aggregate_list_current_function(FILE *outfile,
 
   emit_aggregate_list_current_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "%s *%s_current(%s *instance)\n",
-                   name, 
+  fprintf(outfile, "%s%s *%s_current%s(%s *instance)\n",
+                   concurrent_storage(option_concurrent_list()),
+                   name,
                    fpre,
+                   concurrent_suffix(option_concurrent_list()),
                    list_name);
 
   fprintf(outfile, "{\n");
@@ -981,6 +1086,17 @@ static void emit_aggregate_list_current_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_cursor,
+                          "list",
+                          name,
+                          true,
+                          fpre,
+                          "current",
+                          "instance",
+                          "%s *instance",
+                          list_name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -1034,9 +1150,11 @@ static void emit_aggregate_list_previous_function(FILE *outfile,
 
   emit_aggregate_list_previous_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "%s *%s_previous(%s *instance)\n",
-                   name, 
+  fprintf(outfile, "%s%s *%s_previous%s(%s *instance)\n",
+                   concurrent_storage(option_concurrent_list()),
+                   name,
                    fpre,
+                   concurrent_suffix(option_concurrent_list()),
                    list_name);
 
   fprintf(outfile, "{\n");
@@ -1069,6 +1187,17 @@ static void emit_aggregate_list_previous_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_cursor,
+                          "list",
+                          name,
+                          true,
+                          fpre,
+                          "previous",
+                          "instance",
+                          "%s *instance",
+                          list_name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -1122,9 +1251,11 @@ static void emit_aggregate_list_next_function(FILE *outfile,
 
   emit_aggregate_list_next_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "%s *%s_next(%s *instance)\n",
-                   name, 
+  fprintf(outfile, "%s%s *%s_next%s(%s *instance)\n",
+                   concurrent_storage(option_concurrent_list()),
+                   name,
                    fpre,
+                   concurrent_suffix(option_concurrent_list()),
                    list_name);
 
   fprintf(outfile, "{\n");
@@ -1157,6 +1288,17 @@ static void emit_aggregate_list_next_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_cursor,
+                          "list",
+                          name,
+                          true,
+                          fpre,
+                          "next",
+                          "instance",
+                          "%s *instance",
+                          list_name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -1210,9 +1352,11 @@ static void emit_aggregate_list_find_function(FILE *outfile,
 
   emit_aggregate_list_find_annotation(outfile, node, name, fpre2, indent + 1);
 
-  fprintf(outfile, "%s *%s_find(%s *instance, %s *needle)\n",
-                   name, 
+  fprintf(outfile, "%s%s *%s_find%s(%s *instance, %s *needle)\n",
+                   concurrent_storage(option_concurrent_list()),
+                   name,
                    fpre,
+                   concurrent_suffix(option_concurrent_list()),
                    list_name,
                    name);
 
@@ -1274,6 +1418,18 @@ static void emit_aggregate_list_find_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  emit_concurrent_wrapper(outfile,
+                          concurrent_lock_cursor,
+                          "list",
+                          name,
+                          true,
+                          fpre,
+                          "find",
+                          "instance, needle",
+                          "%s *instance, %s *needle",
+                          list_name,
+                          name);
+
 exit:
   if (name) free(name);
   if (list_name) free(list_name);
@@ -1308,6 +1464,7 @@ static void emit_aggregate_list_new_node_function(FILE *outfile,
   char *list_name = NULL;
   char *fpre = NULL;
   char *fpre2 = NULL;
+  char *node_name = NULL;
 
   if (!outfile || !node || !project) goto exit;
   if (strcmp((char *)node->name, "struct") &&
@@ -1338,8 +1495,11 @@ static void emit_aggregate_list_new_node_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+  node_name = strdup(name);
+  node_name = strapp(node_name, "_list_node");
+
   emit_indent(outfile, indent);
-  fprintf(outfile, "new_node = malloc(sizeof(%s_list_node));\n", name);
+  emit_alloc(outfile, "new_node", node_name, tuning_aligned(name));
 
   emit_indent(outfile, indent);
   fprintf(outfile,
@@ -1362,6 +1522,7 @@ exit:
   if (list_name) free(list_name);
   if (fpre) free(fpre);
   if (fpre2) free(fpre2);
+  if (node_name) free(node_name);
 }
 
   /**
@@ -0,0 +1,824 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-mmap.c
+ *  @brief mapped array file add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  A mapped array file holds, all integers little-endian:
+ *
+ *    magic                8 bytes, ARRAY_MAP_MAGIC
+ *    layout hash          8 bytes, <PREFIX>_FLAT_LAYOUT_HASH
+ *    number of items      8 bytes
+ *    index                8 bytes per item, file offset of its flat view
+ *    items                flat view of every item, see source-flat.c
+ *
+ *  Opening a file only checks its header, each item is verified when it is
+ *  fetched, so the cost of opening does not grow with the file.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "source-mmap.h"
+#include "source-flat.h"
+#include "options.h"
+
+static void emit_aggregate_array_save_function(FILE *outfile,
+                                               xmlNodePtr node,
+                                               char *project,
+                                               int indent);
+static void emit_aggregate_array_open_mmap_function(FILE *outfile,
+                                                    xmlNodePtr node,
+                                                    char *project,
+                                                    int indent);
+static void emit_aggregate_array_close_mmap_function(FILE *outfile,
+                                                     xmlNodePtr node,
+                                                     char *project,
+                                                     int indent);
+static void emit_aggregate_array_map_get_function(FILE *outfile,
+                                                  xmlNodePtr node,
+                                                  char *project,
+                                                  int indent);
+
+  /**
+   *  @fn void emit_mmap_helpers(FILE *outfile, xmlNodePtr root)
+   *
+   *  @brief generates constants used by all mapped array file functions of
+   *         a source file
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param root - xmlNodePtr containing c-decls element
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_mmap_helpers(FILE *outfile, xmlNodePtr root)
+{
+  int indent = 0;
+
+  if (!option_gen_mmap()) goto exit;
+
+  if (!outfile || !root) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " *  Header of mapped array files\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "#define ARRAY_MAP_MAGIC \"KDFMAP01\"\n");
+  fprintf(outfile, "#define ARRAY_MAP_HEADER_SIZE 24\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+}
+
+  /**
+   *  @fn void emit_aggregate_mmap_functions(FILE *outfile,
+   *                                         xmlNodePtr node,
+   *                                         char *project_name)
+   *
+   *  @brief generates mapped array file C source code from struct or union
+   *         element in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_mmap_functions(FILE *outfile,
+                                   xmlNodePtr node,
+                                   char *project_name)
+{
+  char *project = NULL;
+  char *name = NULL;
+  int indent = 0;
+
+  if (!option_gen_mmap()) goto exit;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+  str_lower(project);
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          " *  Mapped file functions for struct %s_array\n",
+          name);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  emit_aggregate_array_save_function(outfile, node, project, indent);
+  emit_aggregate_array_open_mmap_function(outfile, node, project, indent);
+  emit_aggregate_array_close_mmap_function(outfile, node, project, indent);
+  emit_aggregate_array_map_get_function(outfile, node, project, indent);
+
+exit:
+  if (project) free(project);
+  if (name) free(name);
+}
+
+  /**
+   *  @fn void emit_aggregate_array_save_function(FILE *outfile,
+   *                                              xmlNodePtr node,
+   *                                              char *project,
+   *                                              int indent)
+   *
+   *  @brief generates C source code writing every item of an array of
+   *         struct or union from element in @p node to a mapped array file
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_array_save_function(FILE *outfile,
+                                               xmlNodePtr node,
+                                               char *project,
+                                               int indent)
+{
+  char *name = NULL;
+  char *array_name = NULL;
+  char *fpre = NULL;
+  char *item_fpre = NULL;
+  char *hash = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to array to save",
+    "path - name of file to write",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  array_name = strdup(name);
+  array_name = strapp(array_name, "_array");
+
+  fpre = container_prefix(project, name, "array");
+  item_fpre = function_prefix(project, name);
+  hash = flat_macro(project, name, "LAYOUT_HASH");
+  if (!fpre || !item_fpre || !hash) goto exit;
+
+  prototype = strapp(prototype, "bool ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_save(");
+  prototype = strapp(prototype, array_name);
+  prototype = strapp(prototype, " *instance, char *path)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "writes flat view of every item to "
+                                      "file path, for _open_mmap()",
+                                      params,
+                                      "true on success, false on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "FILE *fp = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "unsigned char header[ARRAY_MAP_HEADER_SIZE];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "unsigned char entry[8];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "unsigned char *buf = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "unsigned char *tmp;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t capacity = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t size;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint64_t offset;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int i;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool ok = false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !path) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "fp = fopen(path, \"wb\");\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!fp) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "memcpy(header, ARRAY_MAP_MAGIC, 8);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "flat_put_le(header + 8, %s, 8);\n", hash);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "flat_put_le(header + 16, (uint64_t)instance->n, 8);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (fwrite(header, sizeof(header), 1, fp) != 1) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "offset = sizeof(header) + 8 * (uint64_t)instance->n;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < instance->n; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "flat_put_le(entry, offset, 8);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "if (fwrite(entry, sizeof(entry), 1, fp) != 1) goto exit;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "offset += %s_flat_size(instance->item[i]);\n",
+          item_fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < instance->n; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "size = %s_flat_size(instance->item[i]);\n", item_fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!size) continue;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (size > capacity)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "tmp = realloc(buf, size);\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (!tmp) goto exit;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "buf = tmp;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "capacity = size;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_flatten(instance->item[i], buf, size);\n", item_fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (fwrite(buf, size, 1, fp) != 1) goto exit;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "ok = true;\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "exit:\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (fp && fclose(fp)) ok = false;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (buf) free(buf);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return ok;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (array_name) free(array_name);
+  if (fpre) free(fpre);
+  if (item_fpre) free(item_fpre);
+  if (hash) free(hash);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_aggregate_array_open_mmap_function(FILE *outfile,
+   *                                                   xmlNodePtr node,
+   *                                                   char *project,
+   *                                                   int indent)
+   *
+   *  @brief generates C source code mapping a file written by _save() of an
+   *         array of struct or union from element in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_array_open_mmap_function(FILE *outfile,
+                                                    xmlNodePtr node,
+                                                    char *project,
+                                                    int indent)
+{
+  char *name = NULL;
+  char *array_name = NULL;
+  char *map_name = NULL;
+  char *fpre = NULL;
+  char *hash = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "path - name of file written by _save()",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  array_name = strdup(name);
+  array_name = strapp(array_name, "_array");
+
+  map_name = strdup(array_name);
+  map_name = strapp(map_name, "_map");
+
+  fpre = container_prefix(project, name, "array");
+  hash = flat_macro(project, name, "LAYOUT_HASH");
+  if (!map_name || !fpre || !hash) goto exit;
+
+  prototype = strapp(prototype, map_name);
+  prototype = strapp(prototype, " *");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_open_mmap(char *path)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "maps file path read-only, rejecting "
+                                      "files of any other layout",
+                                      params,
+                                      "pointer to mapped file, NULL on "
+                                      "failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s *map = NULL;\n", map_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "const unsigned char *base = MAP_FAILED;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "struct stat st;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t size = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int fd = -1;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!path) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "fd = open(path, O_RDONLY);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (fd < 0) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (fstat(fd, &st) || (st.st_size < ARRAY_MAP_HEADER_SIZE))"
+          " goto exit;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size = (size_t)st.st_size;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (base == MAP_FAILED) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (memcmp(base, ARRAY_MAP_MAGIC, 8) ||\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "    (flat_get_le(base + 8, 8) != %s) ||\n", hash);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "    (flat_get_le(base + 16, 8) >"
+          " (size - ARRAY_MAP_HEADER_SIZE) / 8))\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "map = malloc(sizeof(%s));\n", map_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!map) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "map->base = base;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "map->size = size;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "map->n = (size_t)flat_get_le(base + 16, 8);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "base = MAP_FAILED;\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "exit:\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (base != MAP_FAILED) munmap((void *)base, size);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (fd >= 0) close(fd);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return map;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (array_name) free(array_name);
+  if (map_name) free(map_name);
+  if (fpre) free(fpre);
+  if (hash) free(hash);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_aggregate_array_close_mmap_function(FILE *outfile,
+   *                                                    xmlNodePtr node,
+   *                                                    char *project,
+   *                                                    int indent)
+   *
+   *  @brief generates C source code unmapping a file mapped by _open_mmap()
+   *         for an array of struct or union from element in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_array_close_mmap_function(FILE *outfile,
+                                                     xmlNodePtr node,
+                                                     char *project,
+                                                     int indent)
+{
+  char *name = NULL;
+  char *array_name = NULL;
+  char *map_name = NULL;
+  char *fpre = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "map - pointer to mapped file",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  array_name = strdup(name);
+  array_name = strapp(array_name, "_array");
+
+  map_name = strdup(array_name);
+  map_name = strapp(map_name, "_map");
+
+  fpre = container_prefix(project, name, "array");
+  if (!map_name || !fpre) goto exit;
+
+  prototype = strapp(prototype, "void ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_close_mmap(");
+  prototype = strapp(prototype, map_name);
+  prototype = strapp(prototype, " *map)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "unmaps file, every view fetched from "
+                                      "it becomes invalid",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!map) return;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "munmap((void *)map->base, map->size);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(map);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (array_name) free(array_name);
+  if (map_name) free(map_name);
+  if (fpre) free(fpre);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_aggregate_array_map_get_function(FILE *outfile,
+   *                                                 xmlNodePtr node,
+   *                                                 char *project,
+   *                                                 int indent)
+   *
+   *  @brief generates C source code fetching flat view of one item of a
+   *         mapped file of struct or union from element in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_array_map_get_function(FILE *outfile,
+                                                  xmlNodePtr node,
+                                                  char *project,
+                                                  int indent)
+{
+  char *name = NULL;
+  char *array_name = NULL;
+  char *map_name = NULL;
+  char *fpre = NULL;
+  char *item_fpre = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "map - pointer to mapped file",
+    "index - index of item",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  array_name = strdup(name);
+  array_name = strapp(array_name, "_array");
+
+  map_name = strdup(array_name);
+  map_name = strapp(map_name, "_map");
+
+  fpre = container_prefix(project, name, "array");
+  item_fpre = function_prefix(project, name);
+  if (!map_name || !fpre || !item_fpre) goto exit;
+
+  prototype = strapp(prototype, "const unsigned char *");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_map_get(");
+  prototype = strapp(prototype, map_name);
+  prototype = strapp(prototype, " *map, size_t index)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "returns verified flat view of item "
+                                      "index, read with _flat_get_*()",
+                                      params,
+                                      "pointer to flat view, NULL if index "
+                                      "is out of range or item is damaged",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t start;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t end;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!map || (index >= map->n)) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "start = (size_t)flat_get_le(map->base + ARRAY_MAP_HEADER_SIZE"
+          " + 8 * index, 8);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (index + 1 < map->n)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "end = (size_t)flat_get_le(map->base + ARRAY_MAP_HEADER_SIZE"
+          " + 8 * (index + 1), 8);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "else\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "end = map->size;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if ((start < ARRAY_MAP_HEADER_SIZE + 8 * map->n) ||"
+          " (start > end) || (end > map->size))\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (!%s_flat_verify(map->base + start, end - start))"
+          " return NULL;\n",
+          item_fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return map->base + start;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (array_name) free(array_name);
+  if (map_name) free(map_name);
+  if (fpre) free(fpre);
+  if (item_fpre) free(item_fpre);
+  if (prototype) free(prototype);
+}
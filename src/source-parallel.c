@@ -0,0 +1,766 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-parallel.c
+ *  @brief parallel container walk add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  A parallel walk takes the items of an array, list or avl through its
+ *  iterator, so arrays are walked in place and lists and avls through a
+ *  snapshot, then splits them into one contiguous range per thread.  The
+ *  calling thread works the first range itself.  Each thread may keep a
+ *  zeroed scratch area of its own, on its own cache lines, which a reduce
+ *  function folds into the caller's context once every thread is done, in
+ *  thread order, so reductions need no locking.
+ */
+
+#include <string.h>
+
+#include "config.h"
+
+#include "source-parallel.h"
+#include "source-iter.h"
+#include "source-serialize.h"
+#include "layout.h"
+#include "options.h"
+
+static void emit_parallel_task(FILE *outfile, char *name, int indent);
+static void emit_parallel_work_function(FILE *outfile,
+                                        char *name,
+                                        char *fpre,
+                                        int indent);
+static void emit_parallel_run_function(FILE *outfile,
+                                       char *name,
+                                       char *fpre,
+                                       int indent);
+static void emit_parallel_container_functions(FILE *outfile,
+                                              char *name,
+                                              char *project,
+                                              char *kind,
+                                              int indent);
+
+  /**
+   *  @fn bool parallel_any(void)
+   *
+   *  @brief determines if any container gets parallel walk functions
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return true if parallel walks are generated, false if not
+   */
+
+bool parallel_any(void)
+{
+  return option_gen_parallel() &&
+         (option_gen_array() || option_gen_list() || option_gen_avl());
+}
+
+  /**
+   *  @fn void emit_aggregate_parallel_functions(FILE *outfile,
+   *                                             xmlNodePtr node,
+   *                                             char *project_name)
+   *
+   *  @brief generates parallel walk C source code for every container of
+   *         struct or union element in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_parallel_functions(FILE *outfile,
+                                       xmlNodePtr node,
+                                       char *project_name)
+{
+  static char *kinds[] = { "array", "list", "avl", NULL };
+  char *project = NULL;
+  char *name = NULL;
+  char *fpre = NULL;
+  int indent = 0;
+  int i;
+
+  if (!parallel_any()) goto exit;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+  str_lower(project);
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+  if (!fpre) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          " *  Parallel walk functions for containers of %s %s\n",
+          node->name,
+          name);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  emit_parallel_task(outfile, name, indent);
+  emit_parallel_work_function(outfile, name, fpre, indent);
+  emit_parallel_run_function(outfile, name, fpre, indent);
+
+  for (i = 0; kinds[i]; i++)
+  {
+    if (!iter_container(kinds[i])) continue;
+
+    emit_parallel_container_functions(outfile, name, project, kinds[i], indent);
+  }
+
+exit:
+  if (project) free(project);
+  if (name) free(name);
+  if (fpre) free(fpre);
+}
+
+  /**
+   *  @fn void emit_parallel_task(FILE *outfile, char *name, int indent)
+   *
+   *  @brief generates the struct describing the range of items one thread
+   *         of a parallel walk works on
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param name - string containing name of struct or union
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_parallel_task(FILE *outfile, char *name, int indent)
+{
+  fprintf(outfile, "typedef struct\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s **item;\n", name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t first;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t last;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_parallel_fn fn;\n", name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "void *ctx;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "void *local;\n");
+
+  --indent;
+
+  fprintf(outfile, "} %s_parallel_task;\n", name);
+
+  fprintf(outfile, "\n");
+}
+
+  /**
+   *  @fn void emit_parallel_work_function(FILE *outfile,
+   *                                       char *name,
+   *                                       char *fpre,
+   *                                       int indent)
+   *
+   *  @brief generates static thread function of a parallel walk
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param name - string containing name of struct or union
+   *  @param fpre - string containing function prefix of struct or union
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_parallel_work_function(FILE *outfile,
+                                        char *name,
+                                        char *fpre,
+                                        int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "arg - pointer to task of thread",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static void *");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_parallel_work(void *arg)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "applies function of task to each "
+                                      "item of its range",
+                                      params,
+                                      "NULL",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_parallel_task *task = arg;\n", name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = task->first; i < task->last; i++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "task->fn(task->item[i], task->ctx, task->local);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return NULL;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_parallel_run_function(FILE *outfile,
+   *                                      char *name,
+   *                                      char *fpre,
+   *                                      int indent)
+   *
+   *  @brief generates static function splitting an array of items over
+   *         threads, running them and reducing their scratch areas
+   *
+   *  NOTE:  a range whose thread can not be started is worked by the
+   *         calling thread, so a walk only fails when out of memory
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param name - string containing name of struct or union
+   *  @param fpre - string containing function prefix of struct or union
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_parallel_run_function(FILE *outfile,
+                                       char *name,
+                                       char *fpre,
+                                       int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "item - array of items",
+    "n - number of items",
+    "fn - function applied to each item",
+    "reduce - function folding each scratch area into ctx, may be NULL",
+    "ctx - pointer passed on to fn and reduce",
+    "nthreads - number of threads, less than 1 for one per online cpu",
+    "local_size - size of scratch area of each thread, may be 0",
+    NULL
+  };
+  int len;
+
+  prototype = strapp(prototype, "static bool ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_parallel_run(");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, " **item, size_t n, ");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, "_parallel_fn fn, ");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, "_parallel_reduce reduce, void *ctx, ");
+  prototype = strapp(prototype, "int nthreads, size_t local_size)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "walks item in parallel",
+                                      params,
+                                      "true on success, false if out of "
+                                      "memory, nothing walked",
+                                      indent + 1);
+
+  len = strlen(fpre) + 26;
+
+  fprintf(outfile, "static bool %s_parallel_run(%s **item,\n", fpre, name);
+  fprintf(outfile, "%*ssize_t n,\n", len, "");
+  fprintf(outfile, "%*s%s_parallel_fn fn,\n", len, "", name);
+  fprintf(outfile, "%*s%s_parallel_reduce reduce,\n", len, "", name);
+  fprintf(outfile, "%*svoid *ctx,\n", len, "");
+  fprintf(outfile, "%*sint nthreads,\n", len, "");
+  fprintf(outfile, "%*ssize_t local_size)\n", len, "");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_parallel_task *task;\n", name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_t *thread;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "unsigned char *local = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "size_t stride = (local_size + %d) / %d * %d;\n",
+          LAYOUT_CACHE_LINE - 1,
+          LAYOUT_CACHE_LINE,
+          LAYOUT_CACHE_LINE);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t k;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t started;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t t;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (nthreads < 1) nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (nthreads < 1) nthreads = 1;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "k = (size_t)nthreads;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (k > n) k = n ? n : 1;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "task = calloc(k, sizeof(%s_parallel_task));\n", name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "thread = calloc(k, sizeof(pthread_t));\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (stride) local = aligned_alloc(%d, k * stride);\n",
+          LAYOUT_CACHE_LINE);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!task || !thread || (stride && !local))\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "free(task);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "free(thread);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "free(local);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return false;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (local) memset(local, 0, k * stride);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (t = 0; t < k; t++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "task[t].item = item;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "task[t].first = n / k * t + (t < n %% k ? t : n %% k);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "task[t].last = task[t].first + n / k + (t < n %% k);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "task[t].fn = fn;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "task[t].ctx = ctx;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "task[t].local = local ? local + t * stride : NULL;\n");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (started = 1; started < k; started++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (pthread_create(&thread[started],\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "                   NULL,\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "                   %s_parallel_work,\n", fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "                   &task[started]))\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "break;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_parallel_work(&task[0]);\n", fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "for (t = started; t < k; t++) %s_parallel_work(&task[t]);\n",
+          fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (t = 1; t < started; t++) pthread_join(thread[t], NULL);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (reduce)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "for (t = 0; t < k; t++) reduce(ctx, task[t].local);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(task);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(thread);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(local);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return true;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_parallel_container_functions(FILE *outfile,
+   *                                             char *name,
+   *                                             char *project,
+   *                                             char *kind,
+   *                                             int indent)
+   *
+   *  @brief generates _parallel_reduce() and _parallel_for_each() of
+   *         container @p kind
+   *
+   *  NOTE:  items are taken through the container's iterator, which read
+   *         locks a concurrent container for the whole walk
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param name - string containing name of struct or union
+   *  @param project - string containing lower case project name
+   *  @param kind - string containing "array", "list" or "avl"
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_parallel_container_functions(FILE *outfile,
+                                              char *name,
+                                              char *project,
+                                              char *kind,
+                                              int indent)
+{
+  char *container_name = NULL;
+  char *fpre = NULL;
+  char *item_fpre = NULL;
+  char *prototype = NULL;
+  char *order;
+  bool is_avl;
+  int len;
+  char *reduce_params[] =
+  {
+    "instance - pointer to container, must not change during walk",
+    "order - order in which items are split over threads",
+    "fn - function applied to each item, on several threads at once",
+    "reduce - function folding each scratch area into ctx, may be NULL",
+    "ctx - pointer passed on to fn and reduce",
+    "nthreads - number of threads, less than 1 for one per online cpu",
+    "local_size - size of zeroed scratch area of each thread, may be 0",
+    NULL
+  };
+  char *for_each_params[] =
+  {
+    "instance - pointer to container, must not change during walk",
+    "order - order in which items are split over threads",
+    "fn - function applied to each item, on several threads at once",
+    "ctx - pointer passed on to fn",
+    "nthreads - number of threads, less than 1 for one per online cpu",
+    NULL
+  };
+
+  is_avl = !strcmp(kind, "avl");
+  order = is_avl ? " avl_order order," : "";
+
+  if (!is_avl)
+  {
+    memmove(&reduce_params[1], &reduce_params[2], 6 * sizeof(char *));
+    memmove(&for_each_params[1], &for_each_params[2], 4 * sizeof(char *));
+  }
+
+  container_name = strapp(container_name, name);
+  container_name = strapp(container_name, "_");
+  container_name = strapp(container_name, kind);
+
+  fpre = container_prefix(project, name, kind);
+  item_fpre = function_prefix(project, name);
+  if (!container_name || !fpre || !item_fpre) goto exit;
+
+    // reduce
+
+  prototype = strapp(prototype, "bool ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_parallel_reduce(");
+  prototype = strapp(prototype, container_name);
+  prototype = strapp(prototype, " *instance,");
+  prototype = strapp(prototype, order);
+  prototype = strapp(prototype, " ");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, "_parallel_fn fn, ");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, "_parallel_reduce reduce, void *ctx, ");
+  prototype = strapp(prototype, "int nthreads, size_t local_size)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "applies fn to every item on nthreads "
+                                      "threads, then reduces",
+                                      reduce_params,
+                                      "true on success, false on failure, "
+                                      "nothing walked",
+                                      indent + 1);
+
+  len = strlen(fpre) + 22;
+
+  fprintf(outfile,
+          "bool %s_parallel_reduce(%s *instance,\n",
+          fpre,
+          container_name);
+  if (is_avl) fprintf(outfile, "%*savl_order order,\n", len, "");
+  fprintf(outfile, "%*s%s_parallel_fn fn,\n", len, "", name);
+  fprintf(outfile, "%*s%s_parallel_reduce reduce,\n", len, "", name);
+  fprintf(outfile, "%*svoid *ctx,\n", len, "");
+  fprintf(outfile, "%*sint nthreads,\n", len, "");
+  fprintf(outfile, "%*ssize_t local_size)\n", len, "");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_iter iter;\n", container_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool ok;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !fn) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (!%s_iter_begin(instance,%s &iter)) return false;\n",
+          fpre,
+          is_avl ? " order," : "");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "ok = %s_parallel_run(iter.item,\n", item_fpre);
+
+  len = strlen(item_fpre) + 19;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%*siter.n,\n", len, "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%*sfn,\n", len, "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%*sreduce,\n", len, "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%*sctx,\n", len, "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%*snthreads,\n", len, "");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%*slocal_size);\n", len, "");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_iter_end(&iter);\n", fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return ok;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+    // for each
+
+  free(prototype);
+  prototype = NULL;
+
+  prototype = strapp(prototype, "bool ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_parallel_for_each(");
+  prototype = strapp(prototype, container_name);
+  prototype = strapp(prototype, " *instance,");
+  prototype = strapp(prototype, order);
+  prototype = strapp(prototype, " ");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, "_parallel_fn fn, void *ctx, int nthreads)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "applies fn to every item on nthreads "
+                                      "threads",
+                                      for_each_params,
+                                      "true on success, false on failure, "
+                                      "nothing walked",
+                                      indent + 1);
+
+  len = strlen(fpre) + 24;
+
+  fprintf(outfile,
+          "bool %s_parallel_for_each(%s *instance,\n",
+          fpre,
+          container_name);
+  if (is_avl) fprintf(outfile, "%*savl_order order,\n", len, "");
+  fprintf(outfile, "%*s%s_parallel_fn fn,\n", len, "", name);
+  fprintf(outfile, "%*svoid *ctx,\n", len, "");
+  fprintf(outfile, "%*sint nthreads)\n", len, "");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "return %s_parallel_reduce(instance,%s fn, NULL, ctx, nthreads, 0);\n",
+          fpre,
+          is_avl ? " order," : "");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (container_name) free(container_name);
+  if (fpre) free(fpre);
+  if (item_fpre) free(item_fpre);
+  if (prototype) free(prototype);
+}
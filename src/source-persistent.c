@@ -0,0 +1,3870 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-persistent.c
+ *  @brief persistent avl add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  The avl generator's ":persistent" option adds a copy-on-write avl,
+ *  <name>_pavl, next to the libavl one, ordered by the same
+ *  _avl_cmp_data_func().  Nodes are never changed once built.  A writer
+ *  copies the O(log n) nodes on the path to its change, shares every other
+ *  node with the old tree and publishes the new root as the current
+ *  snapshot.
+ *
+ *  Readers take the current snapshot with _pavl_acquire(), which costs a
+ *  reference count, and read it without locks until _pavl_release().
+ *  Nodes and items are reference counted, so the last snapshot holding a
+ *  node frees it.  Writers take one mutex, and allocate every node they
+ *  need before changing anything, so a failed write leaves the tree as it
+ *  was.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "source-persistent.h"
+#include "source-serialize.h"
+#include "options.h"
+
+  /**
+   *  @typedef struct persistent_names
+   *  @brief names shared by all functions of one persistent avl
+   */
+
+typedef struct
+{
+  char *name;       /**<  typedef name of struct or union       */
+  char *pavl_name;  /**<  typedef name of persistent avl        */
+  char *fpre;       /**<  function prefix of persistent avl     */
+  char *item_fpre;  /**<  function prefix of struct or union    */
+  char *avl_fpre;   /**<  function prefix of avl                */
+} persistent_names;
+
+static void emit_persistent_batch_type(FILE *outfile,
+                                       persistent_names *pn,
+                                       int indent);
+static void emit_persistent_cmp_function(FILE *outfile,
+                                         persistent_names *pn,
+                                         int indent);
+static void emit_persistent_height_function(FILE *outfile,
+                                            persistent_names *pn,
+                                            int indent);
+static void emit_persistent_item_retain_function(FILE *outfile,
+                                                 persistent_names *pn,
+                                                 int indent);
+static void emit_persistent_item_release_function(FILE *outfile,
+                                                  persistent_names *pn,
+                                                  int indent);
+static void emit_persistent_node_retain_function(FILE *outfile,
+                                                 persistent_names *pn,
+                                                 int indent);
+static void emit_persistent_node_release_function(FILE *outfile,
+                                                  persistent_names *pn,
+                                                  int indent);
+static void emit_persistent_drain_function(FILE *outfile,
+                                           persistent_names *pn,
+                                           int indent);
+static void emit_persistent_reserve_function(FILE *outfile,
+                                             persistent_names *pn,
+                                             int indent);
+static void emit_persistent_make_function(FILE *outfile,
+                                          persistent_names *pn,
+                                          int indent);
+static void emit_persistent_balance_function(FILE *outfile,
+                                             persistent_names *pn,
+                                             int indent);
+static void emit_persistent_find_node_function(FILE *outfile,
+                                               persistent_names *pn,
+                                               int indent);
+static void emit_persistent_insert_node_function(FILE *outfile,
+                                                 persistent_names *pn,
+                                                 int indent);
+static void emit_persistent_remove_min_function(FILE *outfile,
+                                                persistent_names *pn,
+                                                int indent);
+static void emit_persistent_delete_node_function(FILE *outfile,
+                                                 persistent_names *pn,
+                                                 int indent);
+static void emit_persistent_walk_node_function(FILE *outfile,
+                                               persistent_names *pn,
+                                               int indent);
+static void emit_persistent_collect_function(FILE *outfile,
+                                             persistent_names *pn,
+                                             int indent);
+static void emit_persistent_build_function(FILE *outfile,
+                                           persistent_names *pn,
+                                           int indent);
+static void emit_persistent_batch_cmp_function(FILE *outfile,
+                                               persistent_names *pn,
+                                               int indent);
+static void emit_persistent_publish_function(FILE *outfile,
+                                             persistent_names *pn,
+                                             int indent);
+static void emit_persistent_snapshot_function(FILE *outfile,
+                                              persistent_names *pn,
+                                              int indent);
+static void emit_persistent_release_function(FILE *outfile,
+                                             persistent_names *pn,
+                                             int indent);
+static void emit_persistent_new_function(FILE *outfile,
+                                         persistent_names *pn,
+                                         int indent);
+static void emit_persistent_free_function(FILE *outfile,
+                                          persistent_names *pn,
+                                          int indent);
+static void emit_persistent_insert_function(FILE *outfile,
+                                            persistent_names *pn,
+                                            int indent);
+static void emit_persistent_insert_many_function(FILE *outfile,
+                                                 persistent_names *pn,
+                                                 int indent);
+static void emit_persistent_delete_function(FILE *outfile,
+                                            persistent_names *pn,
+                                            int indent);
+static void emit_persistent_delete_many_function(FILE *outfile,
+                                                 persistent_names *pn,
+                                                 int indent);
+static void emit_persistent_count_function(FILE *outfile,
+                                           persistent_names *pn,
+                                           int indent);
+static void emit_persistent_find_function(FILE *outfile,
+                                          persistent_names *pn,
+                                          int indent);
+static void emit_persistent_walk_function(FILE *outfile,
+                                          persistent_names *pn,
+                                          int indent);
+
+  /**
+   *  @fn bool persistent_any(void)
+   *
+   *  @brief determines if persistent avls are generated
+   *
+   *  @par Parameters
+   *       None.
+   *
+   *  @return true if avls get a persistent avl, false if not
+   */
+
+bool persistent_any(void)
+{
+  return option_gen_avl() && option_persistent_avl();
+}
+
+  /**
+   *  @fn void emit_aggregate_persistent_functions(FILE *outfile,
+   *                                               xmlNodePtr node,
+   *                                               char *project_name)
+   *
+   *  @brief generates persistent avl C source code from struct or union
+   *         element in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_persistent_functions(FILE *outfile,
+                                         xmlNodePtr node,
+                                         char *project_name)
+{
+  persistent_names pn;
+  char *project = NULL;
+  int indent = 0;
+
+  memset(&pn, 0, sizeof(pn));
+
+  if (!persistent_any()) goto exit;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+  str_lower(project);
+
+  pn.name = get_attribute(node, "name");
+  if (!pn.name) goto exit;
+
+  pn.pavl_name = strapp(pn.pavl_name, pn.name);
+  pn.pavl_name = strapp(pn.pavl_name, "_pavl");
+
+  pn.fpre = container_prefix(project, pn.name, "pavl");
+  pn.item_fpre = function_prefix(project, pn.name);
+  pn.avl_fpre = container_prefix(project, pn.name, "avl");
+  if (!pn.pavl_name || !pn.fpre || !pn.item_fpre || !pn.avl_fpre) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          " *  Persistent avl functions for struct %s\n",
+          pn.pavl_name);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  emit_persistent_batch_type(outfile, &pn, indent);
+  emit_persistent_cmp_function(outfile, &pn, indent);
+  emit_persistent_height_function(outfile, &pn, indent);
+  emit_persistent_item_retain_function(outfile, &pn, indent);
+  emit_persistent_item_release_function(outfile, &pn, indent);
+  emit_persistent_node_retain_function(outfile, &pn, indent);
+  emit_persistent_node_release_function(outfile, &pn, indent);
+  emit_persistent_drain_function(outfile, &pn, indent);
+  emit_persistent_reserve_function(outfile, &pn, indent);
+  emit_persistent_make_function(outfile, &pn, indent);
+  emit_persistent_balance_function(outfile, &pn, indent);
+  emit_persistent_find_node_function(outfile, &pn, indent);
+  emit_persistent_insert_node_function(outfile, &pn, indent);
+  emit_persistent_remove_min_function(outfile, &pn, indent);
+  emit_persistent_delete_node_function(outfile, &pn, indent);
+  emit_persistent_walk_node_function(outfile, &pn, indent);
+  emit_persistent_collect_function(outfile, &pn, indent);
+  emit_persistent_build_function(outfile, &pn, indent);
+  emit_persistent_batch_cmp_function(outfile, &pn, indent);
+  emit_persistent_publish_function(outfile, &pn, indent);
+  emit_persistent_snapshot_function(outfile, &pn, indent);
+  emit_persistent_release_function(outfile, &pn, indent);
+  emit_persistent_new_function(outfile, &pn, indent);
+  emit_persistent_free_function(outfile, &pn, indent);
+  emit_persistent_insert_function(outfile, &pn, indent);
+  emit_persistent_insert_many_function(outfile, &pn, indent);
+  emit_persistent_delete_function(outfile, &pn, indent);
+  emit_persistent_delete_many_function(outfile, &pn, indent);
+  emit_persistent_count_function(outfile, &pn, indent);
+  emit_persistent_find_function(outfile, &pn, indent);
+  emit_persistent_walk_function(outfile, &pn, indent);
+
+exit:
+  if (project) free(project);
+  if (pn.name) free(pn.name);
+  if (pn.pavl_name) free(pn.pavl_name);
+  if (pn.fpre) free(pn.fpre);
+  if (pn.item_fpre) free(pn.item_fpre);
+  if (pn.avl_fpre) free(pn.avl_fpre);
+}
+
+  /**
+   *  @fn void emit_persistent_batch_type(FILE *outfile,
+   *                                      persistent_names *pn,
+   *                                      int indent)
+   *
+   *  @brief generates the struct sorting the items of _pavl_insert_many()
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_batch_type(FILE *outfile,
+                                       persistent_names *pn,
+                                       int indent)
+{
+  fprintf(outfile, "typedef struct\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_item *item;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t order;\n");
+
+  --indent;
+
+  fprintf(outfile, "} %s_batch;\n", pn->pavl_name);
+
+  fprintf(outfile, "\n");
+}
+
+  /**
+   *  @fn void emit_persistent_cmp_function(FILE *outfile,
+   *                                        persistent_names *pn,
+   *                                        int indent)
+   *
+   *  @brief generates static C function ordering two items the way the avl of
+   *         the same struct or union does, comparing the items in place
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_cmp_function(FILE *outfile,
+                                         persistent_names *pn,
+                                         int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "a - pointer to item",
+    "b - pointer to item",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static int ");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_cmp(");
+  prototype = strapp(prototype, pn->name);
+  prototype = strapp(prototype, " *a, ");
+  prototype = strapp(prototype, pn->name);
+  prototype = strapp(prototype, " *b)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "orders items with "
+                                      "_avl_cmp_data_func(), as the avl "
+                                      "does",
+                                      params,
+                                      "-1, 0 or 1 as a sorts before, with or "
+                                      "after b",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return %s_cmp_data_func(a, b);\n", pn->avl_fpre);
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_height_function(FILE *outfile,
+   *                                           persistent_names *pn,
+   *                                           int indent)
+   *
+   *  @brief generates static C function returning height of a subtree
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_height_function(FILE *outfile,
+                                            persistent_names *pn,
+                                            int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "node - pointer to root of subtree, may be NULL",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static int ");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_height(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *node)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "returns height of subtree",
+                                      params,
+                                      "height, 0 for an empty subtree",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return node ? node->height : 0;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_item_retain_function(FILE *outfile,
+   *                                                persistent_names *pn,
+   *                                                int indent)
+   *
+   *  @brief generates static C function taking a reference to an item
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_item_retain_function(FILE *outfile,
+                                                 persistent_names *pn,
+                                                 int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "item - pointer to item",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_item *");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_item_retain(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_item *item)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "takes a reference to item",
+                                      params,
+                                      "item",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "atomic_fetch_add(&item->refs, 1);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return item;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_item_release_function(FILE *outfile,
+   *                                                 persistent_names *pn,
+   *                                                 int indent)
+   *
+   *  @brief generates static C function dropping a reference to an item
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_item_release_function(FILE *outfile,
+                                                  persistent_names *pn,
+                                                  int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "item - pointer to item",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static void ");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_item_release(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_item *item)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "drops a reference to item, freeing it "
+                                      "with the last one",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (atomic_fetch_sub(&item->refs, 1) != 1) return;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_free(item->data);\n", pn->item_fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(item);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_node_retain_function(FILE *outfile,
+   *                                                persistent_names *pn,
+   *                                                int indent)
+   *
+   *  @brief generates static C function taking a reference to a node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_node_retain_function(FILE *outfile,
+                                                 persistent_names *pn,
+                                                 int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "node - pointer to node, may be NULL",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_node_retain(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *node)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "takes a reference to node",
+                                      params,
+                                      "node",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (node) atomic_fetch_add(&node->refs, 1);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return node;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_node_release_function(FILE *outfile,
+   *                                                 persistent_names *pn,
+   *                                                 int indent)
+   *
+   *  @brief generates static C function dropping a reference to a node
+   *
+   *  NOTE:  a node freed with its last reference releases its children and
+   *         its item, so nodes still shared by other snapshots stay
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_node_release_function(FILE *outfile,
+                                                  persistent_names *pn,
+                                                  int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "node - pointer to node, may be NULL",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static void ");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_node_release(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *node)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "drops a reference to node, freeing it "
+                                      "with the last one",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!node) return;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (atomic_fetch_sub(&node->refs, 1) != 1) return;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node_release(node->left);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node_release(node->right);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_item_release(node->item);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(node);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_drain_function(FILE *outfile,
+   *                                          persistent_names *pn,
+   *                                          int indent)
+   *
+   *  @brief generates static C function freeing nodes a change did not use
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_drain_function(FILE *outfile,
+                                           persistent_names *pn,
+                                           int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "pool - list of free nodes, chained through left",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static void ");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_drain(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *pool)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "frees list of free nodes",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *next;\n", pn->pavl_name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "while (pool)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "next = pool->left;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "free(pool);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "pool = next;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_reserve_function(FILE *outfile,
+   *                                            persistent_names *pn,
+   *                                            int indent)
+   *
+   *  @brief generates static C function allocating the nodes a change needs
+   *
+   *  NOTE:  every node is allocated before a change starts, so a change
+   *         either completes or leaves the tree as it was
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_reserve_function(FILE *outfile,
+                                             persistent_names *pn,
+                                             int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "pool - address of list of free nodes",
+    "count - number of nodes needed",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static bool ");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_reserve(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node **pool, size_t count)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "allocates count nodes, chained "
+                                      "through left, onto pool",
+                                      params,
+                                      "true on success, false on failure "
+                                      "with pool emptied",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *node;\n", pn->pavl_name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "while (count--)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "node = malloc(sizeof(%s_node));\n", pn->pavl_name);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!node)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "%s_drain(*pool);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "*pool = NULL;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "return false;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "node->left = *pool;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "*pool = node;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return true;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_make_function(FILE *outfile,
+   *                                         persistent_names *pn,
+   *                                         int indent)
+   *
+   *  @brief generates static C function building a node from the pool
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_make_function(FILE *outfile,
+                                          persistent_names *pn,
+                                          int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "pool - address of list of free nodes, never empty here",
+    "left - lesser subtree",
+    "item - item of node",
+    "right - greater subtree",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_make(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node **pool, ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *left, ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_item *item, ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *right)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "builds a node, taking over the "
+                                      "references passed in",
+                                      params,
+                                      "new node, holding one reference",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *node = *pool;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int left_height = %s_height(left);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int right_height = %s_height(right);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*pool = node->left;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "node->left = left;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "node->right = right;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "node->item = item;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "node->height = 1 + (left_height > right_height ? left_height : "
+          "right_height);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "atomic_init(&node->refs, 1);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return node;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_balance_function(FILE *outfile,
+   *                                            persistent_names *pn,
+   *                                            int indent)
+   *
+   *  @brief generates static C function building a balanced node, rotating
+   *         copies of nodes where the subtrees differ in height by two
+   *
+   *  NOTE:  nodes of the old tree are never changed, rotations build new
+   *         nodes around their children and items
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_balance_function(FILE *outfile,
+                                             persistent_names *pn,
+                                             int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "pool - address of list of free nodes",
+    "left - lesser subtree",
+    "item - item of node",
+    "right - greater subtree",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_balance(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node **pool, ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *left, ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_item *item, ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *right)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "builds a balanced node, taking over "
+                                      "the references passed in",
+                                      params,
+                                      "new root of subtree, holding one "
+                                      "reference",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *a;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *b;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *c;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *d;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_item *x;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_item *y;\n", pn->pavl_name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (%s_height(left) > %s_height(right) + 1)\n",
+          pn->fpre,
+          pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "a = %s_node_retain(left->left);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "c = %s_node_retain(left->right);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "x = %s_item_retain(left->item);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_node_release(left);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (%s_height(a) >= %s_height(c))\n", pn->fpre, pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "d = %s_make(pool, c, item, right);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "return %s_make(pool, a, x, d);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "b = %s_node_retain(c->left);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "d = %s_node_retain(c->right);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "y = %s_item_retain(c->item);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_node_release(c);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "a = %s_make(pool, a, x, b);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "d = %s_make(pool, d, item, right);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return %s_make(pool, a, y, d);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (%s_height(right) > %s_height(left) + 1)\n",
+          pn->fpre,
+          pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "c = %s_node_retain(right->left);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "d = %s_node_retain(right->right);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "y = %s_item_retain(right->item);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_node_release(right);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (%s_height(d) >= %s_height(c))\n", pn->fpre, pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "a = %s_make(pool, left, item, c);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "return %s_make(pool, a, y, d);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "a = %s_node_retain(c->left);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "b = %s_node_retain(c->right);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "x = %s_item_retain(c->item);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_node_release(c);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "a = %s_make(pool, left, item, a);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "d = %s_make(pool, b, y, d);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return %s_make(pool, a, x, d);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return %s_make(pool, left, item, right);\n", pn->fpre);
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_find_node_function(FILE *outfile,
+   *                                              persistent_names *pn,
+   *                                              int indent)
+   *
+   *  @brief generates static C function locating the node of an item
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_find_node_function(FILE *outfile,
+                                               persistent_names *pn,
+                                               int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "node - root of tree",
+    "needle - pointer to item to look for",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_find_node(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *node, ");
+  prototype = strapp(prototype, pn->name);
+  prototype = strapp(prototype, " *needle)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "locates node holding an item equal to "
+                                      "needle",
+                                      params,
+                                      "pointer to node on success, NULL if "
+                                      "not found",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int rv;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "while (node)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "rv = %s_cmp(needle, node->item->data);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!rv) break;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "node = (rv < 0) ? node->left : node->right;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return node;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_insert_node_function(FILE *outfile,
+   *                                                persistent_names *pn,
+   *                                                int indent)
+   *
+   *  @brief generates static C function inserting an item by copying the path
+   *         to its place
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_insert_node_function(FILE *outfile,
+                                                 persistent_names *pn,
+                                                 int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "pool - address of list of free nodes",
+    "node - root of old tree, left unchanged",
+    "item - item to insert, its reference is taken over",
+    "replaced - set true if item replaced an equal one",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_insert_node(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node **pool, ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *node, ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_item *item, bool *replaced)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "builds a new tree holding item, "
+                                      "sharing every subtree off its path "
+                                      "with node",
+                                      params,
+                                      "root of new tree, holding one "
+                                      "reference",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *left;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *right;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int rv;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (!node) return %s_make(pool, NULL, item, NULL);\n",
+          pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "rv = %s_cmp(item->data, node->item->data);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!rv)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "*replaced = true;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "left = %s_node_retain(node->left);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "right = %s_node_retain(node->right);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return %s_make(pool, left, item, right);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (rv < 0)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "left = %s_insert_node(pool, node->left, item, replaced);\n",
+          pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "right = %s_node_retain(node->right);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "else\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "left = %s_node_retain(node->left);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "right = %s_insert_node(pool, node->right, item, replaced);\n",
+          pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "return %s_balance(pool, left, %s_item_retain(node->item), "
+          "right);\n",
+          pn->fpre,
+          pn->fpre);
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_remove_min_function(FILE *outfile,
+   *                                               persistent_names *pn,
+   *                                               int indent)
+   *
+   *  @brief generates static C function removing the least item of a subtree
+   *         by copying the path to it
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_remove_min_function(FILE *outfile,
+                                                persistent_names *pn,
+                                                int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "pool - address of list of free nodes",
+    "node - root of old subtree, not empty, left unchanged",
+    "min - receives a reference to the least item",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_remove_min(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node **pool, ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *node, ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_item **min)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "builds a new subtree without its "
+                                      "least item",
+                                      params,
+                                      "root of new subtree, holding one "
+                                      "reference",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *left;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *right;\n", pn->pavl_name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!node->left)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "*min = %s_item_retain(node->item);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return %s_node_retain(node->right);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "left = %s_remove_min(pool, node->left, min);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "right = %s_node_retain(node->right);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "return %s_balance(pool, left, %s_item_retain(node->item), "
+          "right);\n",
+          pn->fpre,
+          pn->fpre);
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_delete_node_function(FILE *outfile,
+   *                                                persistent_names *pn,
+   *                                                int indent)
+   *
+   *  @brief generates static C function deleting an item by copying the path
+   *         to it
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_delete_node_function(FILE *outfile,
+                                                 persistent_names *pn,
+                                                 int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "pool - address of list of free nodes",
+    "node - root of old tree holding target, left unchanged",
+    "target - pointer to item to delete",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_delete_node(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node **pool, ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *node, ");
+  prototype = strapp(prototype, pn->name);
+  prototype = strapp(prototype, " *target)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "builds a new tree without the item "
+                                      "equal to target, sharing every "
+                                      "subtree off its path with node",
+                                      params,
+                                      "root of new tree, holding one "
+                                      "reference",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *left;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *right;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_item *item = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int rv;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!node) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "rv = %s_cmp(target, node->item->data);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (rv < 0)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "left = %s_delete_node(pool, node->left, target);\n",
+          pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "right = %s_node_retain(node->right);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "item = %s_item_retain(node->item);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "else if (rv > 0)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "left = %s_node_retain(node->left);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "right = %s_delete_node(pool, node->right, target);\n",
+          pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "item = %s_item_retain(node->item);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "else\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "if (!node->left) return %s_node_retain(node->right);\n",
+          pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "if (!node->right) return %s_node_retain(node->left);\n",
+          pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "left = %s_node_retain(node->left);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "right = %s_remove_min(pool, node->right, &item);\n",
+          pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return %s_balance(pool, left, item, right);\n", pn->fpre);
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_walk_node_function(FILE *outfile,
+   *                                              persistent_names *pn,
+   *                                              int indent)
+   *
+   *  @brief generates static C function walking a subtree in order
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_walk_node_function(FILE *outfile,
+                                               persistent_names *pn,
+                                               int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "node - root of subtree",
+    "action - function called for each item",
+    "arg - passed through to action",
+    "stop - set true when action returns non-zero",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static size_t ");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_walk_node(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *node, ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_action action, void *arg, bool *stop)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "calls action for each item of subtree "
+                                      "in order",
+                                      params,
+                                      "number of items action was called for",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t n;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!node || *stop) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "n = %s_walk_node(node->left, action, arg, stop);\n",
+          pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (*stop) return n;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "++n;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (action(node->item->data, arg))\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "*stop = true;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return n;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "return n + %s_walk_node(node->right, action, arg, stop);\n",
+          pn->fpre);
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_collect_function(FILE *outfile,
+   *                                            persistent_names *pn,
+   *                                            int indent)
+   *
+   *  @brief generates static C function gathering the items of a subtree in
+   *         order
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_collect_function(FILE *outfile,
+                                             persistent_names *pn,
+                                             int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "node - root of subtree",
+    "items - array with room for every item",
+    "n - address of number of items in array",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static void ");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_collect(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *node, ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_item **items, size_t *n)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "appends a reference to each item of "
+                                      "subtree, in order, to items",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!node) return;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_collect(node->left, items, n);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "items[(*n)++] = %s_item_retain(node->item);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_collect(node->right, items, n);\n", pn->fpre);
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_build_function(FILE *outfile,
+   *                                          persistent_names *pn,
+   *                                          int indent)
+   *
+   *  @brief generates static C function building a balanced tree bottom-up
+   *         from sorted items
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_build_function(FILE *outfile,
+                                           persistent_names *pn,
+                                           int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "pool - address of list of free nodes, one per item",
+    "items - array of items in order",
+    "n - number of items",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node *");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_build(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_node **pool, ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_item **items, size_t n)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "builds a balanced tree of sorted "
+                                      "items, taking over their references",
+                                      params,
+                                      "root of new tree, holding one "
+                                      "reference",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *left;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *right;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t mid = n / 2;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!n) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "left = %s_build(pool, items, mid);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "right = %s_build(pool, items + mid + 1, n - mid - 1);\n",
+          pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "return %s_make(pool, left, items[mid], right);\n",
+          pn->fpre);
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_batch_cmp_function(FILE *outfile,
+   *                                              persistent_names *pn,
+   *                                              int indent)
+   *
+   *  @brief generates static C function ordering batch entries for qsort()
+   *
+   *  NOTE:  equal items keep the order they were passed in, so the last of
+   *         them wins as with repeated _pavl_insert()
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_batch_cmp_function(FILE *outfile,
+                                               persistent_names *pn,
+                                               int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "a - pointer to batch entry",
+    "b - pointer to batch entry",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static int ");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_batch_cmp(const void *a, const void *b)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "orders batch entries by item, then by "
+                                      "position in the batch",
+                                      params,
+                                      "-1, 0 or 1 as a sorts before, with or "
+                                      "after b",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "const %s_batch *x = a;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "const %s_batch *y = b;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int rv;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "rv = %s_cmp(x->item->data, y->item->data);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (rv) return rv;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return (x->order > y->order) - (x->order < y->order);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_publish_function(FILE *outfile,
+   *                                            persistent_names *pn,
+   *                                            int indent)
+   *
+   *  @brief generates static C function making a snapshot the current one
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_publish_function(FILE *outfile,
+                                             persistent_names *pn,
+                                             int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to persistent avl, writer mutex held",
+    "snapshot - new snapshot, its reference is taken over",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_snapshot *");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_publish(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, " *instance, ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_snapshot *snapshot)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "swaps snapshot in as current, under "
+                                      "the pin mutex readers take it with",
+                                      params,
+                                      "old snapshot, whose reference caller "
+                                      "releases",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_snapshot *old;\n", pn->pavl_name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_lock(&instance->pin);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "old = instance->current;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "instance->current = snapshot;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_unlock(&instance->pin);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return old;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_snapshot_function(FILE *outfile,
+   *                                             persistent_names *pn,
+   *                                             int indent)
+   *
+   *  @brief generates C function taking the current snapshot of a persistent
+   *         avl
+   *
+   *  NOTE:  a snapshot costs a reference count, writers never change it, so
+   *         readers holding one need no lock
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_snapshot_function(FILE *outfile,
+                                              persistent_names *pn,
+                                              int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to persistent avl",
+    NULL
+  };
+
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_snapshot *");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_acquire(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, " *instance)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "takes current snapshot, release it "
+                                      "with _pavl_release()",
+                                      params,
+                                      "pointer to snapshot on success, NULL "
+                                      "on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_snapshot *snapshot = NULL;\n", pn->pavl_name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_lock(&instance->pin);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "snapshot = instance->current;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "atomic_fetch_add(&snapshot->refs, 1);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_unlock(&instance->pin);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return snapshot;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_release_function(FILE *outfile,
+   *                                            persistent_names *pn,
+   *                                            int indent)
+   *
+   *  @brief generates C function releasing a snapshot
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_release_function(FILE *outfile,
+                                             persistent_names *pn,
+                                             int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "snapshot - pointer to snapshot",
+    NULL
+  };
+
+  prototype = strapp(prototype, "void ");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_release(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_snapshot *snapshot)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "releases snapshot, freeing nodes no "
+                                      "other snapshot shares once the last "
+                                      "holder is gone",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!snapshot) return;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (atomic_fetch_sub(&snapshot->refs, 1) != 1) return;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node_release(snapshot->root);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(snapshot);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_new_function(FILE *outfile,
+   *                                        persistent_names *pn,
+   *                                        int indent)
+   *
+   *  @brief generates C function creating an empty persistent avl
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_new_function(FILE *outfile,
+                                         persistent_names *pn,
+                                         int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    NULL
+  };
+
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, " *");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_new(void)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "allocates an empty persistent avl",
+                                      params,
+                                      "pointer to new persistent avl on "
+                                      "success, NULL on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s *instance = NULL;\n", pn->pavl_name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "instance = malloc(sizeof(%s));\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "instance->current = malloc(sizeof(%s_snapshot));\n",
+          pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance->current)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "free(instance);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "instance = NULL;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "goto exit;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "instance->current->root = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "instance->current->n = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "atomic_init(&instance->current->refs, 1);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_init(&instance->writer, NULL);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_init(&instance->pin, NULL);\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "exit:\n");
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return instance;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_free_function(FILE *outfile,
+   *                                         persistent_names *pn,
+   *                                         int indent)
+   *
+   *  @brief generates C function freeing a persistent avl
+   *
+   *  NOTE:  snapshots taken earlier stay valid until released
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_free_function(FILE *outfile,
+                                          persistent_names *pn,
+                                          int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to persistent avl",
+    NULL
+  };
+
+  prototype = strapp(prototype, "void ");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_free(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, " *instance)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "frees persistent avl, snapshots still "
+                                      "held stay valid",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance) return;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_release(instance->current);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_destroy(&instance->writer);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_destroy(&instance->pin);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(instance);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_insert_function(FILE *outfile,
+   *                                           persistent_names *pn,
+   *                                           int indent)
+   *
+   *  @brief generates C function inserting a copy of an item into a persistent
+   *         avl
+   *
+   *  NOTE:  writers copy the O(log n) nodes on the path to the item, the new
+   *         snapshot shares every other node with the old one
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_insert_function(FILE *outfile,
+                                            persistent_names *pn,
+                                            int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to persistent avl",
+    "item - pointer to item to copy in",
+    NULL
+  };
+
+  prototype = strapp(prototype, "bool ");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_insert(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, " *instance, ");
+  prototype = strapp(prototype, pn->name);
+  prototype = strapp(prototype, " *item)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "inserts a copy of item, replacing an "
+                                      "equal one",
+                                      params,
+                                      "true on success, false on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_snapshot *snapshot = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_snapshot *old = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_item *entry = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *pool = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *root;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool replaced = false;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool ok = false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !item) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "snapshot = malloc(sizeof(%s_snapshot));\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!snapshot) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "entry = malloc(sizeof(%s_item));\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!entry) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "entry->data = %s_dup(item);\n", pn->item_fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!entry->data) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "atomic_init(&entry->refs, 1);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_lock(&instance->writer);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "root = instance->current->root;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (%s_reserve(&pool, (size_t)%s_height(root) + 4))\n",
+          pn->fpre,
+          pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "snapshot->root = %s_insert_node(&pool, root, entry, &replaced);\n",
+          pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "snapshot->n = instance->current->n + (replaced ? 0 : 1);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "atomic_init(&snapshot->refs, 1);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "old = %s_publish(instance, snapshot);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "snapshot = NULL;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "entry = NULL;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "ok = true;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_unlock(&instance->writer);\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "exit:\n");
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_drain(pool);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_release(old);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (entry)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (entry->data) %s_free(entry->data);\n", pn->item_fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "free(entry);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (snapshot) free(snapshot);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return ok;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_insert_many_function(FILE *outfile,
+   *                                                persistent_names *pn,
+   *                                                int indent)
+   *
+   *  @brief generates C function inserting copies of many items into a
+   *         persistent avl, publishing one snapshot
+   *
+   *  NOTE:  a batch large for the tree rebuilds it balanced bottom-up from
+   *         the merged sorted items in O(n + m), a small one path copies each
+   *         item, either way all items are added or none
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_insert_many_function(FILE *outfile,
+                                                 persistent_names *pn,
+                                                 int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to persistent avl",
+    "items - array of pointers to items to copy in",
+    "n - number of items",
+    NULL
+  };
+
+  prototype = strapp(prototype, "bool ");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_insert_many(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, " *instance, ");
+  prototype = strapp(prototype, pn->name);
+  prototype = strapp(prototype, " **items, size_t n)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "inserts copies of items, replacing "
+                                      "equal ones, NULL items are skipped",
+                                      params,
+                                      "true on success, false on failure "
+                                      "with tree unchanged",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_snapshot *snapshot = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_snapshot *old = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_batch *batch = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_item **existing = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_item **merged = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *pool = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *root = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *next;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t count = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t total;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t height;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t j;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t k;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool replaced;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool ok = false;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int rv;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !items) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "snapshot = malloc(sizeof(%s_snapshot));\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!snapshot) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "batch = malloc(sizeof(%s_batch) * (n ? n : 1));\n",
+          pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!batch) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < n; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!items[i]) continue;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "batch[count].item = malloc(sizeof(%s_item));\n",
+          pn->pavl_name);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!batch[count].item) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "batch[count].item->data = %s_dup(items[i]);\n",
+          pn->item_fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!batch[count].item->data)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "free(batch[count].item);\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "goto exit;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "atomic_init(&batch[count].item->refs, 1);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "batch[count].order = i;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "++count;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "qsort(batch, count, sizeof(%s_batch), %s_batch_cmp);\n",
+          pn->pavl_name,
+          pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = j = 0; i < count; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if ((i + 1 < count) &&\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile,
+          "!%s_cmp(batch[i].item->data, batch[i + 1].item->data))\n",
+          pn->fpre);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "%s_item_release(batch[i].item);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "else\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "batch[j++] = batch[i];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "count = j;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_lock(&instance->writer);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "root = %s_node_retain(instance->current->root);\n",
+          pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "total = instance->current->n;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "height = (size_t)%s_height(root);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (total + count <= count * (height + 1))\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "existing = malloc(sizeof(%s_item *) * (total + 1));\n",
+          pn->pavl_name);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "merged = malloc(sizeof(%s_item *) * (total + count + 1));\n",
+          pn->pavl_name);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!existing || !merged) goto unlock;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "if (!%s_reserve(&pool, total + count)) goto unlock;\n",
+          pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "j = 0;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_collect(root, existing, &j);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "for (i = j = k = 0; (i < count) || (j < total); )\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (j == total) rv = -1;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "else if (i == count) rv = 1;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          "else rv = %s_cmp(batch[i].item->data, existing[j]->data);\n",
+          pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (rv > 0)\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "merged[k++] = existing[j++];\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "else\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "if (!rv) %s_item_release(existing[j++]);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "merged[k++] = batch[i++].item;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "next = %s_build(&pool, merged, k);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_node_release(root);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "root = next;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "total = k;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "else\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "for (i = 0; i < count; i++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          "if (!%s_reserve(&pool, (size_t)%s_height(root) + 4)) goto "
+          "unlock;\n",
+          pn->fpre,
+          pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "replaced = false;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          "next = %s_insert_node(&pool, root, batch[i].item, &replaced);\n",
+          pn->fpre);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "batch[i].item = NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "%s_node_release(root);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "root = next;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "total += replaced ? 0 : 1;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "%s_drain(pool);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "pool = NULL;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "count = 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "snapshot->root = root;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "snapshot->n = total;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "atomic_init(&snapshot->refs, 1);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "root = NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "old = %s_publish(instance, snapshot);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "snapshot = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "ok = true;\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "unlock:\n");
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_unlock(&instance->writer);\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "exit:\n");
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_drain(pool);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node_release(root);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_release(old);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < count; i++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "if (batch[i].item) %s_item_release(batch[i].item);\n",
+          pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (batch) free(batch);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (existing) free(existing);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (merged) free(merged);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (snapshot) free(snapshot);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return ok;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_delete_function(FILE *outfile,
+   *                                           persistent_names *pn,
+   *                                           int indent)
+   *
+   *  @brief generates C function deleting an item from a persistent avl
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_delete_function(FILE *outfile,
+                                            persistent_names *pn,
+                                            int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to persistent avl",
+    "target - pointer to item to delete",
+    NULL
+  };
+
+  prototype = strapp(prototype, "bool ");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_delete(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, " *instance, ");
+  prototype = strapp(prototype, pn->name);
+  prototype = strapp(prototype, " *target)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "deletes the item equal to target",
+                                      params,
+                                      "true if an item was deleted, false if "
+                                      "none or on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_snapshot *snapshot = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_snapshot *old = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *pool = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *root;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t height;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool ok = false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !target) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "snapshot = malloc(sizeof(%s_snapshot));\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!snapshot) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_lock(&instance->writer);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "root = instance->current->root;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "height = (size_t)%s_height(root);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (%s_find_node(root, target) && %s_reserve(&pool, 3 * height + "
+          "3))\n",
+          pn->fpre,
+          pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "snapshot->root = %s_delete_node(&pool, root, target);\n",
+          pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "snapshot->n = instance->current->n - 1;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "atomic_init(&snapshot->refs, 1);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "old = %s_publish(instance, snapshot);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "snapshot = NULL;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "ok = true;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_unlock(&instance->writer);\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "exit:\n");
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_drain(pool);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_release(old);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (snapshot) free(snapshot);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return ok;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_delete_many_function(FILE *outfile,
+   *                                                persistent_names *pn,
+   *                                                int indent)
+   *
+   *  @brief generates C function deleting many items from a persistent avl,
+   *         publishing one snapshot
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_delete_many_function(FILE *outfile,
+                                                 persistent_names *pn,
+                                                 int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to persistent avl",
+    "targets - array of pointers to items to delete",
+    "n - number of targets",
+    NULL
+  };
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_delete_many(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, " *instance, ");
+  prototype = strapp(prototype, pn->name);
+  prototype = strapp(prototype, " **targets, size_t n)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "deletes the items equal to targets, "
+                                      "NULL targets are skipped",
+                                      params,
+                                      "number of items deleted, 0 on failure "
+                                      "with tree unchanged",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_snapshot *snapshot = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_snapshot *old = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *pool = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *root = NULL;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *next;\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t total;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t deleted = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !targets) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "snapshot = malloc(sizeof(%s_snapshot));\n", pn->pavl_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!snapshot) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_lock(&instance->writer);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "root = %s_node_retain(instance->current->root);\n",
+          pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "total = instance->current->n;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < n; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "if (!targets[i] || !%s_find_node(root, targets[i])) continue;\n",
+          pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "if (!%s_reserve(&pool, 3 * (size_t)%s_height(root) + 3))\n",
+          pn->fpre,
+          pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "deleted = 0;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "goto unlock;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "next = %s_delete_node(&pool, root, targets[i]);\n",
+          pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_node_release(root);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "root = next;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "--total;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "++deleted;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_drain(pool);\n", pn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "pool = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (deleted)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "snapshot->root = root;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "snapshot->n = total;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "atomic_init(&snapshot->refs, 1);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "root = NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "old = %s_publish(instance, snapshot);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "snapshot = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "unlock:\n");
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_unlock(&instance->writer);\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "exit:\n");
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_drain(pool);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node_release(root);\n", pn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_release(old);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (snapshot) free(snapshot);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return deleted;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_count_function(FILE *outfile,
+   *                                          persistent_names *pn,
+   *                                          int indent)
+   *
+   *  @brief generates C function returning number of items in a snapshot
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_count_function(FILE *outfile,
+                                           persistent_names *pn,
+                                           int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "snapshot - pointer to snapshot",
+    NULL
+  };
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_count(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_snapshot *snapshot)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "returns number of items in snapshot",
+                                      params,
+                                      "number of items",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return snapshot ? snapshot->n : 0;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_find_function(FILE *outfile,
+   *                                         persistent_names *pn,
+   *                                         int indent)
+   *
+   *  @brief generates C function finding an item in a snapshot
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_find_function(FILE *outfile,
+                                          persistent_names *pn,
+                                          int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "snapshot - pointer to snapshot",
+    "needle - pointer to item to look for",
+    NULL
+  };
+
+  prototype = strapp(prototype, pn->name);
+  prototype = strapp(prototype, " *");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_find(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_snapshot *snapshot, ");
+  prototype = strapp(prototype, pn->name);
+  prototype = strapp(prototype, " *needle)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "finds item equal to needle, valid "
+                                      "while snapshot is held and never to "
+                                      "be changed",
+                                      params,
+                                      "pointer to item on success, NULL if "
+                                      "not found",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *node;\n", pn->pavl_name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!snapshot || !needle) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "node = %s_find_node(snapshot->root, needle);\n", pn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return node ? node->item->data : NULL;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_persistent_walk_function(FILE *outfile,
+   *                                         persistent_names *pn,
+   *                                         int indent)
+   *
+   *  @brief generates C function walking a snapshot in order
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param pn - pointer to names of persistent avl
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_persistent_walk_function(FILE *outfile,
+                                          persistent_names *pn,
+                                          int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "snapshot - pointer to snapshot",
+    "action - function called for each item",
+    "arg - passed through to action",
+    NULL
+  };
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, pn->fpre);
+  prototype = strapp(prototype, "_walk(");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_snapshot *snapshot, ");
+  prototype = strapp(prototype, pn->pavl_name);
+  prototype = strapp(prototype, "_action action, void *arg)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "calls action for each item of "
+                                      "snapshot in order, until it returns "
+                                      "non-zero",
+                                      params,
+                                      "number of items action was called for",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool stop = false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!snapshot || !action) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "return %s_walk_node(snapshot->root, action, arg, &stop);\n",
+          pn->fpre);
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
@@ -0,0 +1,847 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-ring.c
+ *  @brief lock-free ring queue add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  A ring queue is a bounded multi-producer, multi-consumer queue of item
+ *  pointers, after D. Vyukov.  Each cell carries a sequence number telling
+ *  which position it is ready for:
+ *
+ *    sequence == position          empty, ready to push at position
+ *    sequence == position + 1      full, ready to pop at position
+ *
+ *  A producer or consumer claims a run of ready cells with one compare and
+ *  swap of the push or pop position, then fills or drains them and
+ *  publishes each by storing its next sequence number.  Nothing ever waits
+ *  on a lock, a full or empty queue simply makes the call return short.
+ *
+ *  Ownership of an item moves with its pointer, from the pusher to the
+ *  queue and from the queue to the popper.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "source-ring.h"
+#include "source-serialize.h"
+#include "options.h"
+
+static void emit_aggregate_ring_new_function(FILE *outfile,
+                                             xmlNodePtr node,
+                                             char *project,
+                                             int indent);
+static void emit_aggregate_ring_free_function(FILE *outfile,
+                                              xmlNodePtr node,
+                                              char *project,
+                                              int indent);
+static void emit_aggregate_ring_try_push_function(FILE *outfile,
+                                                  xmlNodePtr node,
+                                                  char *project,
+                                                  int indent);
+static void emit_aggregate_ring_try_pop_function(FILE *outfile,
+                                                 xmlNodePtr node,
+                                                 char *project,
+                                                 int indent);
+static void emit_aggregate_ring_batch_function(FILE *outfile,
+                                               xmlNodePtr node,
+                                               char *project,
+                                               bool push,
+                                               int indent);
+
+  /**
+   *  @fn void emit_aggregate_ring_functions(FILE *outfile,
+   *                                         xmlNodePtr node,
+   *                                         char *project_name)
+   *
+   *  @brief generates ring queue C source code from struct or union element
+   *         in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_ring_functions(FILE *outfile,
+                                   xmlNodePtr node,
+                                   char *project_name)
+{
+  char *project = NULL;
+  char *name = NULL;
+  int indent = 0;
+
+  if (!option_gen_ring()) goto exit;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+  str_lower(project);
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " *  Ring queue functions for struct %s_ring\n", name);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  emit_aggregate_ring_new_function(outfile, node, project, indent);
+  emit_aggregate_ring_free_function(outfile, node, project, indent);
+  emit_aggregate_ring_try_push_function(outfile, node, project, indent);
+  emit_aggregate_ring_try_pop_function(outfile, node, project, indent);
+  emit_aggregate_ring_batch_function(outfile, node, project, true, indent);
+  emit_aggregate_ring_batch_function(outfile, node, project, false, indent);
+
+exit:
+  if (project) free(project);
+  if (name) free(name);
+}
+
+  /**
+   *  @fn void emit_aggregate_ring_new_function(FILE *outfile,
+   *                                            xmlNodePtr node,
+   *                                            char *project,
+   *                                            int indent)
+   *
+   *  @brief generates C source code creating an empty ring queue of struct
+   *         or union from element in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_ring_new_function(FILE *outfile,
+                                             xmlNodePtr node,
+                                             char *project,
+                                             int indent)
+{
+  char *name = NULL;
+  char *ring_name = NULL;
+  char *fpre = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "capacity - least number of items queue holds, rounded up to a power",
+    "           of two",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  ring_name = strdup(name);
+  ring_name = strapp(ring_name, "_ring");
+
+  fpre = container_prefix(project, name, "ring");
+  if (!ring_name || !fpre) goto exit;
+
+  prototype = strapp(prototype, ring_name);
+  prototype = strapp(prototype, " *");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_new(size_t capacity)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "allocates an empty ring queue",
+                                      params,
+                                      "pointer to new queue on success, "
+                                      "NULL on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s *instance = NULL;\n", ring_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t size = 2;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "while (size < capacity)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (size > SIZE_MAX / 2) return NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size <<= 1;\n");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  emit_alloc(outfile, "instance", ring_name, true);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "instance->cell = calloc(size, sizeof(%s_cell));\n",
+          ring_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance->cell)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(instance);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return NULL;\n");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < size; i++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "atomic_init(&instance->cell[i].sequence, i);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "instance->mask = size - 1;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "atomic_init(&instance->push_pos, 0);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "atomic_init(&instance->pop_pos, 0);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return instance;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (ring_name) free(ring_name);
+  if (fpre) free(fpre);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_aggregate_ring_free_function(FILE *outfile,
+   *                                             xmlNodePtr node,
+   *                                             char *project,
+   *                                             int indent)
+   *
+   *  @brief generates C source code freeing a ring queue of struct or union
+   *         from element in @p node, and every item still queued
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_ring_free_function(FILE *outfile,
+                                              xmlNodePtr node,
+                                              char *project,
+                                              int indent)
+{
+  char *name = NULL;
+  char *ring_name = NULL;
+  char *fpre = NULL;
+  char *item_fpre = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to queue no other thread is using",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  ring_name = strdup(name);
+  ring_name = strapp(ring_name, "_ring");
+
+  fpre = container_prefix(project, name, "ring");
+  item_fpre = function_prefix(project, name);
+  if (!ring_name || !fpre || !item_fpre) goto exit;
+
+  prototype = strapp(prototype, "void ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_free(");
+  prototype = strapp(prototype, ring_name);
+  prototype = strapp(prototype, " *instance)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "frees queue and every item still in it",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s *item;\n", name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance) return;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "while ((item = %s_try_pop(instance)))\n", fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_free(item);\n", item_fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(instance->cell);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(instance);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (ring_name) free(ring_name);
+  if (fpre) free(fpre);
+  if (item_fpre) free(item_fpre);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_aggregate_ring_try_push_function(FILE *outfile,
+   *                                                 xmlNodePtr node,
+   *                                                 char *project,
+   *                                                 int indent)
+   *
+   *  @brief generates C source code queueing one struct or union from
+   *         element in @p node without blocking
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_ring_try_push_function(FILE *outfile,
+                                                  xmlNodePtr node,
+                                                  char *project,
+                                                  int indent)
+{
+  char *name = NULL;
+  char *ring_name = NULL;
+  char *fpre = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to queue",
+    "item - pointer to item, owned by queue once pushed",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  ring_name = strdup(name);
+  ring_name = strapp(ring_name, "_ring");
+
+  fpre = container_prefix(project, name, "ring");
+  if (!ring_name || !fpre) goto exit;
+
+  prototype = strapp(prototype, "bool ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_try_push(");
+  prototype = strapp(prototype, ring_name);
+  prototype = strapp(prototype, " *instance, ");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, " *item)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "queues item unless queue is full",
+                                      params,
+                                      "true if item queued, false if queue "
+                                      "is full or item is NULL",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!item) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return %s_push_batch(instance, &item, 1) == 1;\n", fpre);
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (ring_name) free(ring_name);
+  if (fpre) free(fpre);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_aggregate_ring_try_pop_function(FILE *outfile,
+   *                                                xmlNodePtr node,
+   *                                                char *project,
+   *                                                int indent)
+   *
+   *  @brief generates C source code dequeueing one struct or union from
+   *         element in @p node without blocking
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_ring_try_pop_function(FILE *outfile,
+                                                 xmlNodePtr node,
+                                                 char *project,
+                                                 int indent)
+{
+  char *name = NULL;
+  char *ring_name = NULL;
+  char *fpre = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to queue",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  ring_name = strdup(name);
+  ring_name = strapp(ring_name, "_ring");
+
+  fpre = container_prefix(project, name, "ring");
+  if (!ring_name || !fpre) goto exit;
+
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, " *");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_try_pop(");
+  prototype = strapp(prototype, ring_name);
+  prototype = strapp(prototype, " *instance)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "dequeues oldest item unless queue is "
+                                      "empty",
+                                      params,
+                                      "pointer to item, now owned by caller, "
+                                      "NULL if queue is empty",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s *item = NULL;\n", name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_pop_batch(instance, &item, 1);\n", fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return item;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (ring_name) free(ring_name);
+  if (fpre) free(fpre);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_aggregate_ring_batch_function(FILE *outfile,
+   *                                              xmlNodePtr node,
+   *                                              char *project,
+   *                                              bool push,
+   *                                              int indent)
+   *
+   *  @brief generates C source code queueing or dequeueing up to n structs
+   *         or unions from element in @p node with one claim on the queue
+   *
+   *  NOTE:  a cell is ready to push at position p when its sequence is p,
+   *         and ready to pop when its sequence is p + 1.  A sequence behind
+   *         that at the first cell means the queue is full, or empty, any
+   *         other mismatch means another thread claimed the position first.
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param push - true for _push_batch(), false for _pop_batch()
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_ring_batch_function(FILE *outfile,
+                                               xmlNodePtr node,
+                                               char *project,
+                                               bool push,
+                                               int indent)
+{
+  char *name = NULL;
+  char *ring_name = NULL;
+  char *fpre = NULL;
+  char *prototype = NULL;
+  char *pos = push ? "push_pos" : "pop_pos";
+  char *ready = push ? "" : " + 1";
+  char *push_params[] =
+  {
+    "instance - pointer to queue",
+    "items - array of non-NULL item pointers, those pushed owned by queue",
+    "n - number of items in array",
+    NULL
+  };
+  char *pop_params[] =
+  {
+    "instance - pointer to queue",
+    "items - array receiving popped item pointers, owned by caller",
+    "n - room in array",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  ring_name = strdup(name);
+  ring_name = strapp(ring_name, "_ring");
+
+  fpre = container_prefix(project, name, "ring");
+  if (!ring_name || !fpre) goto exit;
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, push ? "_push_batch(" : "_pop_batch(");
+  prototype = strapp(prototype, ring_name);
+  prototype = strapp(prototype, " *instance, ");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, " **items, size_t n)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      push ?
+                                        "queues as many leading items of "
+                                        "array as fit, in order" :
+                                        "dequeues up to n oldest items into "
+                                        "array, in order",
+                                      push ? push_params : pop_params,
+                                      push ?
+                                        "number of items queued, 0 if queue "
+                                        "is full" :
+                                        "number of items dequeued, 0 if "
+                                        "queue is empty",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_cell *cell;\n", ring_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t pos;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t seq = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t k;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !items || !n) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "pos = atomic_load_explicit(&instance->%s, "
+          "memory_order_relaxed);\n",
+          pos);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (;;)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (k = 0; k < n; k++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "cell = &instance->cell[(pos + k) & instance->mask];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "seq = atomic_load_explicit(&cell->sequence, "
+          "memory_order_acquire);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (seq != pos + k%s) break;\n", ready);
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (k)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (atomic_compare_exchange_weak_explicit(&instance->%s,\n",
+          pos);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "                                          &pos,\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "                                          pos + k,\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "                                          "
+          "memory_order_relaxed,\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "                                          "
+          "memory_order_relaxed))\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "break;\n");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "else if ((ptrdiff_t)(seq - (pos%s)) < 0)\n",
+          ready);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "else\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "pos = atomic_load_explicit(&instance->%s, "
+          "memory_order_relaxed);\n",
+          pos);
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < k; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "cell = &instance->cell[(pos + i) & instance->mask];\n");
+
+  emit_indent(outfile, indent);
+  if (push)
+    fprintf(outfile, "cell->item = items[i];\n");
+  else
+    fprintf(outfile, "items[i] = cell->item;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "atomic_store_explicit(&cell->sequence,\n");
+
+  emit_indent(outfile, indent);
+  if (push)
+    fprintf(outfile, "                      pos + i + 1,\n");
+  else
+    fprintf(outfile, "                      pos + i + instance->mask + 1,\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "                      memory_order_release);\n");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return k;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (ring_name) free(ring_name);
+  if (fpre) free(fpre);
+  if (prototype) free(prototype);
+}
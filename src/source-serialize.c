@@ -0,0 +1,1307 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-serialize.c
+ *  @brief serializer add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  Encoded format of a struct is a 32 bit payload length followed by every
+ *  field in declared order, all integers little-endian:
+ *
+ *    integers, enums      sizeof(field) bytes
+ *    bitfields            4 bytes
+ *    float, double        IEEE bits, 4 or 8 bytes
+ *    char *               32 bit length including NUL, 0 for NULL, then
+ *                         the string and its NUL
+ *    nested struct/union  encoded recursively, with its own length
+ *    arrays of scalars    each element as above
+ *
+ *  Unions, and scalars with no portable representation (long double,
+ *  _Complex), are copied byte for byte.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "source-serialize.h"
+#include "source-intern.h"
+#include "source-sso.h"
+#include "options.h"
+#include "profile.h"
+
+  /**
+   *  @typedef enum serialize_mode
+   *  @brief selects which serializer function code is emitted for
+   */
+
+typedef enum
+{
+  serialize_mode_size = 0,  /**<  code adding to encoded size  */
+  serialize_mode_encode,    /**<  code encoding a value        */
+  serialize_mode_decode     /**<  code decoding a value        */
+} serialize_mode;
+
+static void emit_aggregate_encoded_size_function(FILE *outfile,
+                                                 xmlNodePtr node,
+                                                 char *project,
+                                                 int indent);
+static void emit_aggregate_encode_function(FILE *outfile,
+                                           xmlNodePtr node,
+                                           char *project,
+                                           int indent);
+static void emit_aggregate_decode_function(FILE *outfile,
+                                           xmlNodePtr node,
+                                           char *project,
+                                           int indent);
+static void emit_serialize_fields(FILE *outfile,
+                                  xmlNodePtr node,
+                                  char *project,
+                                  serialize_mode mode,
+                                  int indent);
+static void emit_serialize_field(FILE *outfile,
+                                 xmlNodePtr node,
+                                 char *project,
+                                 char *aggregate_name,
+                                 serialize_mode mode,
+                                 int indent);
+static void emit_serialize_value(FILE *outfile,
+                                 char *lvalue,
+                                 serialize_kind kind,
+                                 serialize_mode mode,
+                                 int indent);
+
+  /**
+   *  @fn void emit_serialize_helpers(FILE *outfile, xmlNodePtr root)
+   *
+   *  @brief generates static little-endian helper functions used by all
+   *         serializer functions of a source file
+   *
+   *  NOTE:  nothing is emitted if declarations in @p root contain no struct
+   *         or union, so that the helpers are never unused
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param root - xmlNodePtr containing c-decls element
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_serialize_helpers(FILE *outfile, xmlNodePtr root)
+{
+  xmlNodePtr node;
+  bool has_aggregate = false;
+  int indent = 0;
+
+  if (!option_gen_serialize()) goto exit;
+
+  if (!outfile || !root) goto exit;
+
+  for (node = root->children; node; node = node->next)
+  {
+    if (!strcmp((char *)node->name, "struct") ||
+        !strcmp((char *)node->name, "union"))
+      has_aggregate = true;
+  }
+
+  if (!has_aggregate) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " *  Little-endian helpers for serializer functions\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline unsigned char *serialize_put_le(unsigned char *p,\n"
+          "                                              uint64_t value,\n"
+          "                                              size_t n)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < n; i++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "*p++ = (unsigned char)(value >> (8 * i));\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return p;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline uint64_t serialize_get_le(unsigned char **p, "
+          "size_t n)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint64_t value = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < n; i++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "value |= (uint64_t)(*p)[i] << (8 * i);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*p += n;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return value;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+}
+
+  /**
+   *  @fn void emit_aggregate_serialize_functions(FILE *outfile,
+   *                                              xmlNodePtr node,
+   *                                              char *project_name)
+   *
+   *  @brief generates serializer C source code from struct or union element
+   *         in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_serialize_functions(FILE *outfile,
+                                        xmlNodePtr node,
+                                        char *project_name)
+{
+  char *project = NULL;
+  char *name = NULL;
+  int indent = 0;
+
+  if (!option_gen_serialize()) goto exit;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+  str_lower(project);
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " *  Serializer functions for %s %s\n", node->name, name);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  emit_aggregate_encoded_size_function(outfile, node, project, indent);
+  emit_aggregate_encode_function(outfile, node, project, indent);
+  emit_aggregate_decode_function(outfile, node, project, indent);
+
+exit:
+  if (project) free(project);
+  if (name) free(name);
+}
+
+  /**
+   *  @fn void emit_aggregate_encoded_size_function(FILE *outfile,
+   *                                                xmlNodePtr node,
+   *                                                char *project,
+   *                                               int indent)
+   *
+   *  @brief generates C source code returning encoded size of struct or
+   *         union from element in @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_encoded_size_function(FILE *outfile,
+                                                 xmlNodePtr node,
+                                                 char *project,
+                                                 int indent)
+{
+  char *name = NULL;
+  char *fpre = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to struct or union to encode",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_encoded_size(");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, " *instance)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "returns number of bytes needed to "
+                                      "encode instance",
+                                      params,
+                                      "size in bytes, 0 on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t size = 4;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_serialize_fields(outfile, node, project, serialize_mode_size, indent);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return size;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_aggregate_encode_function(FILE *outfile,
+   *                                          xmlNodePtr node,
+   *                                          char *project,
+   *                                          int indent)
+   *
+   *  @brief generates C source code encoding struct or union from element
+   *         in @p node into a caller provided buffer
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_encode_function(FILE *outfile,
+                                           xmlNodePtr node,
+                                           char *project,
+                                           int indent)
+{
+  char *name = NULL;
+  char *fpre = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to struct or union to encode",
+    "buf - buffer receiving encoded bytes",
+    "len - size of buf in bytes",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_encode(");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, " *instance, unsigned char *buf, size_t len)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "encodes instance into buf as "
+                                      "little-endian, length prefixed bytes",
+                                      params,
+                                      "number of bytes written, "
+                                      "0 if buf is too small",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "unsigned char *p = buf;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t size = 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !buf) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size = %s_encoded_size(instance);\n", fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if ((len < size) || (size - 4 > UINT32_MAX))\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "size = 0;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "goto exit;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "p = serialize_put_le(p, size - 4, 4);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_serialize_fields(outfile, node, project, serialize_mode_encode, indent);
+
+  fprintf(outfile, "exit:\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return size;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_aggregate_decode_function(FILE *outfile,
+   *                                          xmlNodePtr node,
+   *                                          char *project,
+   *                                          int indent)
+   *
+   *  @brief generates C source code decoding struct or union from element
+   *         in @p node out of a caller provided buffer
+   *
+   *  NOTE:  decoded char * fields point into the buffer, nothing is
+   *         allocated, except interned fields, which take a reference in
+   *         the intern table so _free() can release them
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_aggregate_decode_function(FILE *outfile,
+                                           xmlNodePtr node,
+                                           char *project,
+                                           int indent)
+{
+  char *name = NULL;
+  char *fpre = NULL;
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "buf - buffer holding encoded bytes",
+    "len - number of bytes in buf",
+    "instance - pointer to struct or union receiving decoded values,",
+    "           char * fields point into buf, which must outlive",
+    "           instance, use _dup() for an instance owning its strings,",
+    "           interned fields are interned and owned by instance",
+    NULL
+  };
+
+  if (!outfile || !node || !project) goto exit;
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  fpre = function_prefix(project, name);
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, fpre);
+  prototype = strapp(prototype, "_decode(unsigned char *buf, size_t len, ");
+  prototype = strapp(prototype, name);
+  prototype = strapp(prototype, " *instance)");
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "decodes instance from bytes written "
+                                      "by _encode()",
+                                      params,
+                                      "number of bytes consumed, "
+                                      "0 if buf is truncated or corrupt",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "unsigned char *p = buf;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "unsigned char *end = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t payload;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t size = 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!buf || !instance || (len < 4)) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "payload = serialize_get_le(&p, 4);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (payload > len - 4) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "end = p + payload;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_serialize_fields(outfile, node, project, serialize_mode_decode, indent);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size = 4 + payload;\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "exit:\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return size;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (name) free(name);
+  if (fpre) free(fpre);
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_serialize_fields(FILE *outfile,
+   *                                 xmlNodePtr node,
+   *                                 char *project,
+   *                                 serialize_mode mode,
+   *                                 int indent)
+   *
+   *  @brief generates serializer C source code for all fields of struct or
+   *         union in @p node
+   *
+   *  NOTE:  a union has no way to tell which member is in use, so its bytes
+   *         are copied as is
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project - string containing project name
+   *  @param mode - which serializer function code is emitted for
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_serialize_fields(FILE *outfile,
+                                  xmlNodePtr node,
+                                  char *project,
+                                  serialize_mode mode,
+                                  int indent)
+{
+  xmlNodePtr child;
+  char *name = NULL;
+
+  if (!outfile || !node || !project) goto exit;
+
+  if (!strcmp((char *)node->name, "union"))
+  {
+    emit_serialize_value(outfile,
+                         "*instance",
+                         serialize_kind_bytes,
+                         mode,
+                         indent);
+    fprintf(outfile, "\n");
+    goto exit;
+  }
+
+  name = get_attribute(node, "name");
+  if (!name) goto exit;
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (strcmp((char *)child->name, "field")) continue;
+    emit_serialize_field(outfile, child, project, name, mode, indent);
+  }
+
+exit:
+  if (name) free(name);
+}
+
+  /**
+   *  @fn void emit_serialize_field(FILE *outfile,
+   *                                xmlNodePtr node,
+   *                                char *project,
+   *                                char *aggregate_name,
+   *                                serialize_mode mode,
+   *                                int indent)
+   *
+   *  @brief generates serializer C source code for field element in
+   *         @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing field element
+   *  @param project - string containing project name
+   *  @param aggregate_name - string containing name of struct
+   *  @param mode - which serializer function code is emitted for
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_serialize_field(FILE *outfile,
+                                 xmlNodePtr node,
+                                 char *project,
+                                 char *aggregate_name,
+                                 serialize_mode mode,
+                                 int indent)
+{
+  char *field_name = NULL;
+  char *lvalue = NULL;
+  char *value = NULL;
+  char *element = NULL;
+  char *type_name = NULL;
+  char *fpre = NULL;
+  xmlNodePtr type = NULL;
+  serialize_kind kind;
+  bool inline_string;
+
+  if (!outfile || !node || !project || !aggregate_name) goto exit;
+
+  field_name = get_attribute(node, "name");
+  if (!field_name) goto exit;
+
+  kind = serialize_field_kind(node, &type);
+
+  if (kind == serialize_kind_none)
+  {
+    if (mode == serialize_mode_encode)
+      fprintf(outfile,
+              "#warning Serialize field %s of %s here,"
+              " in _encoded_size(), _encode() and _decode()"
+              " OR remove this warning\n",
+              field_name,
+              aggregate_name);
+    goto exit;
+  }
+
+  lvalue = strapp(lvalue, "instance->");
+  lvalue = strapp(lvalue, profile_field_path(aggregate_name, field_name));
+  lvalue = strapp(lvalue, field_name);
+
+  if (kind == serialize_kind_string)
+  {
+      // inline strings are never NULL
+
+    inline_string = (sso_size(aggregate_name, node) > 0);
+
+    value = inline_string ? sso_read(lvalue) : strdup(lvalue);
+    if (!value) goto exit;
+
+    switch (mode)
+    {
+      case serialize_mode_size:
+        emit_indent(outfile, indent);
+        fprintf(outfile, "size += 4;\n");
+
+        emit_indent(outfile, indent);
+        if (inline_string)
+          fprintf(outfile, "size += strlen(%s) + 1;\n", value);
+        else
+          fprintf(outfile,
+                  "if (%s) size += strlen(%s) + 1;\n",
+                  value,
+                  value);
+        break;
+
+      case serialize_mode_encode:
+        if (!inline_string)
+        {
+          emit_indent(outfile, indent);
+          fprintf(outfile, "if (%s)\n", value);
+        }
+
+        emit_indent(outfile, indent);
+        fprintf(outfile, "{\n");
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "size_t n = strlen(%s) + 1;\n", value);
+
+        fprintf(outfile, "\n");
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "p = serialize_put_le(p, n, 4);\n");
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "memcpy(p, %s, n);\n", value);
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "p += n;\n");
+
+        emit_indent(outfile, indent);
+        fprintf(outfile, "}\n");
+
+        if (inline_string) break;
+
+        emit_indent(outfile, indent);
+        fprintf(outfile, "else\n");
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "p = serialize_put_le(p, 0, 4);\n");
+        break;
+
+      case serialize_mode_decode:
+        emit_indent(outfile, indent);
+        fprintf(outfile, "if ((size_t)(end - p) < 4) goto exit;\n");
+
+        emit_indent(outfile, indent);
+        fprintf(outfile, "{\n");
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "size_t n = serialize_get_le(&p, 4);\n");
+
+        fprintf(outfile, "\n");
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile,
+                "if (n && (((size_t)(end - p) < n) || p[n - 1]))"
+                " goto exit;\n");
+
+        if (inline_string)
+        {
+          free(value);
+          value = sso_store(lvalue, "n ? (const char *)p : NULL");
+
+          emit_indent(outfile, indent + 1);
+          fprintf(outfile, "%s.heap = NULL;\n", lvalue);
+
+          emit_indent(outfile, indent + 1);
+          fprintf(outfile, "if (!%s) goto exit;\n", value);
+        }
+        else if (intern_field(aggregate_name, node))
+        {
+          emit_indent(outfile, indent + 1);
+          fprintf(outfile,
+                  "%s = n ? intern_string((char *)p) : NULL;\n",
+                  lvalue);
+
+          emit_indent(outfile, indent + 1);
+          fprintf(outfile, "if (n && !%s) goto exit;\n", lvalue);
+        }
+        else
+        {
+          emit_indent(outfile, indent + 1);
+          fprintf(outfile, "%s = n ? (char *)p : NULL;\n", lvalue);
+        }
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "p += n;\n");
+
+        emit_indent(outfile, indent);
+        fprintf(outfile, "}\n");
+        break;
+    }
+  }
+  else if (kind == serialize_kind_aggregate)
+  {
+    type_name = get_attribute(type, "name");
+    fpre = function_prefix(project, type_name);
+    if (!fpre) goto exit;
+
+    switch (mode)
+    {
+      case serialize_mode_size:
+        emit_indent(outfile, indent);
+        fprintf(outfile, "size += %s_encoded_size(&%s);\n", fpre, lvalue);
+        break;
+
+      case serialize_mode_encode:
+        emit_indent(outfile, indent);
+        fprintf(outfile,
+                "p += %s_encode(&%s, p, (size_t)(buf + size - p));\n",
+                fpre,
+                lvalue);
+        break;
+
+      case serialize_mode_decode:
+        emit_indent(outfile, indent);
+        fprintf(outfile, "{\n");
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile,
+                "size_t n = %s_decode(p, (size_t)(end - p), &%s);\n",
+                fpre,
+                lvalue);
+
+        fprintf(outfile, "\n");
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "if (!n) goto exit;\n");
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "p += n;\n");
+
+        emit_indent(outfile, indent);
+        fprintf(outfile, "}\n");
+        break;
+    }
+  }
+  else if ((kind == serialize_kind_array) && (mode != serialize_mode_size))
+  {
+    type_name = get_attribute(type, "type-name");
+    if (!type_name) goto exit;
+
+    element = strapp(element, "((");
+    element = strapp(element, type_name);
+    element = strapp(element, " *)&");
+    element = strapp(element, lvalue);
+    element = strapp(element, ")[i]");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "{\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "size_t i;\n");
+
+    fprintf(outfile, "\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile,
+            "for (i = 0; i < sizeof(%s) / sizeof(%s); i++)\n",
+            lvalue,
+            type_name);
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "{\n");
+
+    emit_serialize_value(outfile,
+                         element,
+                         serialize_scalar_kind(type),
+                         mode,
+                         indent + 2);
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "}\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "}\n");
+  }
+  else if (kind == serialize_kind_array)
+  {
+      // every element is encoded in sizeof(element) bytes
+
+    emit_serialize_value(outfile, lvalue, serialize_kind_bytes, mode, indent);
+  }
+  else
+    emit_serialize_value(outfile, lvalue, kind, mode, indent);
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (field_name) free(field_name);
+  if (lvalue) free(lvalue);
+  if (value) free(value);
+  if (element) free(element);
+  if (type_name) free(type_name);
+  if (fpre) free(fpre);
+}
+
+  /**
+   *  @fn void emit_serialize_value(FILE *outfile,
+   *                                char *lvalue,
+   *                                serialize_kind kind,
+   *                                serialize_mode mode,
+   *                                int indent)
+   *
+   *  @brief generates serializer C source code for a single scalar value
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param lvalue - string containing C expression of value
+   *  @param kind - encoding of value, one of integer, float, double, bytes
+   *                or bitfield
+   *  @param mode - which serializer function code is emitted for
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_serialize_value(FILE *outfile,
+                                 char *lvalue,
+                                 serialize_kind kind,
+                                 serialize_mode mode,
+                                 int indent)
+{
+  char size[256];
+  char *bits_type;
+
+  if (!outfile || !lvalue) goto exit;
+
+    // bitfields can not be used with sizeof()
+
+  if (kind == serialize_kind_bitfield)
+    strcpy(size, "4");
+  else
+    snprintf(size, sizeof(size), "sizeof(%s)", lvalue);
+
+  bits_type = (kind == serialize_kind_float) ? "uint32_t" : "uint64_t";
+
+  if (mode == serialize_mode_size)
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "size += %s;\n", size);
+    goto exit;
+  }
+
+  if (mode == serialize_mode_decode)
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "if ((size_t)(end - p) < %s) goto exit;\n", size);
+  }
+
+  switch (kind)
+  {
+    case serialize_kind_integer:
+    case serialize_kind_bitfield:
+      emit_indent(outfile, indent);
+      if (mode == serialize_mode_encode)
+        fprintf(outfile,
+                "p = serialize_put_le(p, (uint64_t)%s, %s);\n",
+                lvalue,
+                size);
+      else
+        fprintf(outfile, "%s = serialize_get_le(&p, %s);\n", lvalue, size);
+      break;
+
+    case serialize_kind_float:
+    case serialize_kind_double:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "{\n");
+
+      emit_indent(outfile, indent + 1);
+      if (mode == serialize_mode_encode)
+        fprintf(outfile, "%s bits;\n", bits_type);
+      else
+        fprintf(outfile,
+                "%s bits = (%s)serialize_get_le(&p, sizeof(bits));\n",
+                bits_type,
+                bits_type);
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent + 1);
+      if (mode == serialize_mode_encode)
+      {
+        fprintf(outfile, "memcpy(&bits, &%s, sizeof(bits));\n", lvalue);
+
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile, "p = serialize_put_le(p, bits, sizeof(bits));\n");
+      }
+      else
+        fprintf(outfile, "memcpy(&%s, &bits, sizeof(bits));\n", lvalue);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "}\n");
+      break;
+
+    default:
+      emit_indent(outfile, indent);
+      if (mode == serialize_mode_encode)
+        fprintf(outfile, "memcpy(p, &%s, %s);\n", lvalue, size);
+      else
+        fprintf(outfile, "memcpy(&%s, p, %s);\n", lvalue, size);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "p += %s;\n", size);
+      break;
+  }
+
+exit:
+}
+
+  /**
+   *  @fn serialize_kind serialize_field_kind(xmlNodePtr node,
+   *                                          xmlNodePtr *type)
+   *
+   *  @brief determines how field element in @p node is encoded
+   *
+   *  NOTE:  arrays of one byte scalars, such as char arrays, are copied as
+   *         a whole
+   *
+   *  @param node - xmlNodePtr containing field element
+   *  @param type - address of xmlNodePtr receiving type element of field,
+   *                which is the scalar element for arrays and pointers
+   *
+   *  @return @a serialize_kind of field, serialize_kind_none if field can
+   *          not be serialized
+   */
+
+serialize_kind serialize_field_kind(xmlNodePtr node, xmlNodePtr *type)
+{
+  xmlNodePtr child;
+  xmlNodePtr scalar;
+  serialize_kind kind = serialize_kind_none;
+  char *s = NULL;
+
+  if (!node || !type) goto exit;
+
+  *type = NULL;
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (!strcmp((char *)child->name, "text")) continue;
+
+    *type = child;
+
+    if (!strcmp((char *)child->name, "scalar"))
+      kind = serialize_scalar_kind(child);
+    else if (!strcmp((char *)child->name, "bitfield"))
+      kind = serialize_kind_bitfield;
+    else if (!strcmp((char *)child->name, "enum"))
+      kind = serialize_kind_integer;
+    else if (!strcmp((char *)child->name, "type-reference"))
+    {
+      s = get_attribute(child, "type");
+
+      if (s && !strcmp(s, "enum"))
+        kind = serialize_kind_integer;
+      else
+      {
+        free(s);
+        s = get_attribute(child, "name");
+
+        if (aggregates_find(type_cache, s)) kind = serialize_kind_aggregate;
+      }
+    }
+    else if (!strcmp((char *)child->name, "pointer"))
+    {
+      scalar = pointer_find_scalar(child);
+      if (!scalar || (pointer_count(child) != 1)) continue;
+
+      *type = scalar;
+
+      s = get_attribute(scalar, "type-name");
+      if (s && !strcmp(s, "char")) kind = serialize_kind_string;
+    }
+    else if (!strcmp((char *)child->name, "array"))
+    {
+      scalar = array_find_scalar(child);
+      if (!scalar || array_pointer_count(child)) continue;
+
+      *type = scalar;
+
+      s = get_attribute(scalar, "size");
+
+      switch (serialize_scalar_kind(scalar))
+      {
+        case serialize_kind_integer:
+          if (s && (atoi(s) == 8))
+            kind = serialize_kind_bytes;
+          else
+            kind = serialize_kind_array;
+          break;
+
+        case serialize_kind_float:
+        case serialize_kind_double:
+          kind = serialize_kind_array;
+          break;
+
+        case serialize_kind_bytes:
+            // arrays of scalars with no portable representation are
+            // copied as a whole
+          kind = serialize_kind_bytes;
+          break;
+
+        default: break;
+      }
+    }
+
+    if (s) free(s);
+    s = NULL;
+  }
+
+exit:
+  return kind;
+}
+
+  /**
+   *  @fn serialize_kind serialize_scalar_kind(xmlNodePtr node)
+   *
+   *  @brief determines how scalar element in @p node is encoded
+   *
+   *  @param node - xmlNodePtr containing scalar element
+   *
+   *  @return one of serialize_kind_integer, serialize_kind_float,
+   *          serialize_kind_double or serialize_kind_bytes
+   */
+
+serialize_kind serialize_scalar_kind(xmlNodePtr node)
+{
+  serialize_kind kind = serialize_kind_bytes;
+  char *type_name = NULL;
+  char *s = NULL;
+  int size = 0;
+
+  if (!node) goto exit;
+
+  type_name = get_attribute(node, "type-name");
+  if (!type_name) goto exit;
+
+  s = get_attribute(node, "size");
+  if (s) size = atoi(s);
+
+  if (strstr(type_name, "_Complex") || strstr(type_name, "long double"))
+    kind = serialize_kind_bytes;
+  else if (strstr(type_name, "float") || strstr(type_name, "double"))
+  {
+    if (size == 32) kind = serialize_kind_float;
+    else if (size == 64) kind = serialize_kind_double;
+  }
+  else if ((size > 0) && (size <= 64))
+    kind = serialize_kind_integer;
+
+exit:
+  if (type_name) free(type_name);
+  if (s) free(s);
+
+  return kind;
+}
+
+  /**
+   *  @fn void emit_aggregate_serialize_annotation(FILE *outfile,
+   *                                               char *prototype,
+   *                                               char *brief,
+   *                                               char **params,
+   *                                               char *returns,
+   *                                               int indent)
+   *
+   *  @brief emits annotation for a serializer or flat view function
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param prototype - string containing function prototype
+   *  @param brief - string containing brief description
+   *  @param params - NULL terminated array of parameter description lines
+   *  @param returns - string containing description of return value
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_serialize_annotation(FILE *outfile,
+                                         char *prototype,
+                                         char *brief,
+                                         char **params,
+                                         char *returns,
+                                         int indent)
+{
+  int i;
+
+  if (!outfile || !prototype || !brief || !params || !returns) goto exit;
+
+  if (!option_annotation()) goto exit;
+
+  switch (option_annotation())
+  {
+    case annotation_type_doxygen:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/**\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @fn %s\n", prototype);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @brief %s\n", brief);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *\n");
+
+      for (i = 0; params[i]; i++)
+      {
+        emit_indent(outfile, indent);
+        fprintf(outfile,
+                " *  %s%s\n",
+                params[i][0] == ' ' ? "       " : "@param ",
+                params[i]);
+      }
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  @return %s\n", returns);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    case annotation_type_text:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "/*\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  %s\n", prototype);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *    %s\n", brief);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  Parameters\n");
+
+      for (i = 0; params[i]; i++)
+      {
+        emit_indent(outfile, indent);
+        fprintf(outfile, " *    %s\n", params[i]);
+      }
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *  Returns\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " *    %s\n", returns);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, " */\n");
+
+      fprintf(outfile, "\n");
+      break;
+
+    default: break;
+  }
+
+exit:
+}
@@ -0,0 +1,1835 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-shardmap.c
+ *  @brief sharded concurrent map add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  A sharded map spreads the items of a struct or union over a power of two
+ *  of shards, picked by the high half of the hash of the key field.  Each
+ *  shard is an open-addressed, linearly probed table of item pointers with
+ *  a mutex of its own, so threads working on different keys rarely meet.
+ *  Tables grow by doubling once three quarters full.
+ *
+ *  Keys may be integers, enums, char * or char arrays.  Items are owned by
+ *  the map and live until it is freed, callers change them only from an
+ *  update function, which runs with the shard locked, and read them through
+ *  copies from _get_copy() or a snapshot iterator.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "source-shardmap.h"
+#include "source-serialize.h"
+#include "options.h"
+#include "profile.h"
+
+  /**
+   *  @typedef struct shardmap_names
+   *  @brief names shared by all functions of one sharded map
+   */
+
+typedef struct
+{
+  char *name;       /**<  typedef name of struct or union       */
+  char *map_name;   /**<  typedef name of sharded map           */
+  char *fpre;       /**<  function prefix of sharded map        */
+  char *item_fpre;  /**<  function prefix of struct or union    */
+  char *field;      /**<  name of key field                     */
+  char *path;       /**<  member access path of key field       */
+  char *param;      /**<  declaration of key parameter          */
+  hash_kind kind;   /**<  how key is hashed and compared        */
+} shardmap_names;
+
+static void emit_shardmap_hash_function(FILE *outfile,
+                                        shardmap_names *sm,
+                                        int indent);
+static void emit_shardmap_slot_function(FILE *outfile,
+                                        shardmap_names *sm,
+                                        int indent);
+static void emit_shardmap_grow_function(FILE *outfile,
+                                        shardmap_names *sm,
+                                        int indent);
+static void emit_shardmap_get_or_insert_locked_function(FILE *outfile,
+                                                        shardmap_names *sm,
+                                                        int indent);
+static void emit_shardmap_new_function(FILE *outfile,
+                                       shardmap_names *sm,
+                                       int indent);
+static void emit_shardmap_free_function(FILE *outfile,
+                                        shardmap_names *sm,
+                                        int indent);
+static void emit_shardmap_get_or_insert_function(FILE *outfile,
+                                                 shardmap_names *sm,
+                                                 int indent);
+static void emit_shardmap_update_function(FILE *outfile,
+                                          shardmap_names *sm,
+                                          int indent);
+static void emit_shardmap_get_copy_function(FILE *outfile,
+                                            shardmap_names *sm,
+                                            int indent);
+static void emit_shardmap_count_function(FILE *outfile,
+                                         shardmap_names *sm,
+                                         int indent);
+static void emit_shardmap_iter_functions(FILE *outfile,
+                                         shardmap_names *sm,
+                                         int indent);
+static void emit_shardmap_lock_shard(FILE *outfile,
+                                     shardmap_names *sm,
+                                     int indent);
+static char *shardmap_key_value(shardmap_names *sm, char *item);
+
+  /**
+   *  @fn xmlNodePtr shardmap_key(xmlNodePtr node, hash_kind *kind)
+   *
+   *  @brief finds key field of sharded map of struct or union in @p node
+   *
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param kind - address of @a hash_kind receiving how key is hashed,
+   *                may be NULL
+   *
+   *  @return xmlNodePtr of key field element, NULL if struct or union has
+   *          no field named by the shardmap key option, or it is of a type
+   *          that can not be a key
+   */
+
+xmlNodePtr shardmap_key(xmlNodePtr node, hash_kind *kind)
+{
+  xmlNodePtr child;
+  xmlNodePtr key = NULL;
+  xmlNodePtr type;
+  hash_kind k;
+  char *s = NULL;
+
+  if (!node || !option_shardmap_key()) goto exit;
+
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (strcmp((char *)child->name, "field")) continue;
+
+    s = get_attribute(child, "name");
+    if (s && !strcmp(s, option_shardmap_key())) key = child;
+    if (s) free(s);
+    s = NULL;
+
+    if (key) break;
+  }
+
+  if (!key) goto exit;
+
+  k = hash_field_kind(key, &type);
+
+  switch (k)
+  {
+    case hash_kind_integer:
+      if (strcmp((char *)type->name, "scalar") &&
+          strcmp((char *)type->name, "type-reference"))
+        key = NULL;
+      break;
+
+    case hash_kind_string:
+    case hash_kind_chars:
+      break;
+
+    default:
+      key = NULL;
+      break;
+  }
+
+  if (key && kind) *kind = k;
+
+exit:
+  return key;
+}
+
+  /**
+   *  @fn char *shardmap_key_param(xmlNodePtr node)
+   *
+   *  @brief builds declaration of key parameter of sharded map functions of
+   *         struct or union in @p node
+   *
+   *  NOTE:  caller must free returned string
+   *
+   *  @param node - xmlNodePtr containing struct or union element
+   *
+   *  @return string such as "unsigned int key" or "const char *key", NULL if
+   *          struct or union gets no sharded map
+   */
+
+char *shardmap_key_param(xmlNodePtr node)
+{
+  xmlNodePtr key;
+  xmlNodePtr type;
+  hash_kind kind;
+  char *param = NULL;
+  char *s = NULL;
+
+  key = shardmap_key(node, &kind);
+  if (!key) goto exit;
+
+  if (kind != hash_kind_integer)
+  {
+    param = strdup("const char *key");
+    goto exit;
+  }
+
+  hash_field_kind(key, &type);
+
+  if (!strcmp((char *)type->name, "scalar"))
+    s = get_attribute(type, "type-name");
+  else
+    s = get_attribute(type, "name");
+
+  if (!s) goto exit;
+
+  param = strapp(param, s);
+  param = strapp(param, " key");
+
+exit:
+  if (s) free(s);
+
+  return param;
+}
+
+  /**
+   *  @fn void emit_aggregate_shardmap_functions(FILE *outfile,
+   *                                             xmlNodePtr node,
+   *                                             char *project_name)
+   *
+   *  @brief generates sharded map C source code from struct or union
+   *         element in @p node
+   *
+   *  NOTE:  nothing is emitted for a struct or union without the key field
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_shardmap_functions(FILE *outfile,
+                                       xmlNodePtr node,
+                                       char *project_name)
+{
+  shardmap_names sm;
+  char *project = NULL;
+  xmlNodePtr key;
+  int indent = 0;
+
+  memset(&sm, 0, sizeof(sm));
+
+  if (!option_gen_shardmap()) goto exit;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  key = shardmap_key(node, &sm.kind);
+  if (!key) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+  str_lower(project);
+
+  sm.name = get_attribute(node, "name");
+  sm.field = get_attribute(key, "name");
+  sm.param = shardmap_key_param(node);
+  if (!sm.name || !sm.field || !sm.param) goto exit;
+
+  sm.map_name = strapp(sm.map_name, sm.name);
+  sm.map_name = strapp(sm.map_name, "_shardmap");
+
+  sm.fpre = container_prefix(project, sm.name, "shardmap");
+  sm.item_fpre = function_prefix(project, sm.name);
+  sm.path = profile_field_path(sm.name, sm.field);
+  if (!sm.map_name || !sm.fpre || !sm.item_fpre) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          " *  Sharded map functions for struct %s, keyed by %s\n",
+          sm.map_name,
+          sm.field);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  emit_shardmap_hash_function(outfile, &sm, indent);
+  emit_shardmap_slot_function(outfile, &sm, indent);
+  emit_shardmap_grow_function(outfile, &sm, indent);
+  emit_shardmap_get_or_insert_locked_function(outfile, &sm, indent);
+  emit_shardmap_new_function(outfile, &sm, indent);
+  emit_shardmap_free_function(outfile, &sm, indent);
+  emit_shardmap_get_or_insert_function(outfile, &sm, indent);
+  emit_shardmap_update_function(outfile, &sm, indent);
+  emit_shardmap_get_copy_function(outfile, &sm, indent);
+  emit_shardmap_count_function(outfile, &sm, indent);
+  emit_shardmap_iter_functions(outfile, &sm, indent);
+
+exit:
+  if (project) free(project);
+  if (sm.name) free(sm.name);
+  if (sm.map_name) free(sm.map_name);
+  if (sm.fpre) free(sm.fpre);
+  if (sm.item_fpre) free(sm.item_fpre);
+  if (sm.field) free(sm.field);
+  if (sm.param) free(sm.param);
+}
+
+  /**
+   *  @fn void emit_shardmap_hash_function(FILE *outfile,
+   *                                       shardmap_names *sm,
+   *                                       int indent)
+   *
+   *  @brief generates static C function hashing a key of sharded map @p sm
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sm - pointer to names of sharded map
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_shardmap_hash_function(FILE *outfile,
+                                        shardmap_names *sm,
+                                        int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "key - key to hash",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static uint64_t ");
+  prototype = strapp(prototype, sm->fpre);
+  prototype = strapp(prototype, "_hash(");
+  prototype = strapp(prototype, sm->param);
+  prototype = strapp(prototype, ")");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "hashes key, high half picks shard, "
+                                      "low half picks slot",
+                                      params,
+                                      "64 bit hash of key",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  if (sm->kind == hash_kind_integer)
+    fprintf(outfile,
+            "return hash_final(hash_mix(HASH_SEED, (uint64_t)key));\n");
+  else
+    fprintf(outfile, "return hash_final(hash_string(HASH_SEED, key));\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_shardmap_slot_function(FILE *outfile,
+   *                                       shardmap_names *sm,
+   *                                       int indent)
+   *
+   *  @brief generates static C function probing a shard of sharded map
+   *         @p sm for a key
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sm - pointer to names of sharded map
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_shardmap_slot_function(FILE *outfile,
+                                        shardmap_names *sm,
+                                        int indent)
+{
+  char *prototype = NULL;
+  char *value = NULL;
+  char *params[] =
+  {
+    "shard - pointer to locked shard with a table",
+    "key - key to look for",
+    "hash - hash of key",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static ");
+  prototype = strapp(prototype, sm->name);
+  prototype = strapp(prototype, " **");
+  prototype = strapp(prototype, sm->fpre);
+  prototype = strapp(prototype, "_slot(");
+  prototype = strapp(prototype, sm->map_name);
+  prototype = strapp(prototype, "_shard *shard, ");
+  prototype = strapp(prototype, sm->param);
+  prototype = strapp(prototype, ", uint64_t hash)");
+
+  value = shardmap_key_value(sm, "shard->slot[i]");
+  if (!prototype || !value) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "finds slot holding key, or empty "
+                                      "slot where it belongs",
+                                      params,
+                                      "pointer to slot",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "for (i = hash & shard->mask; shard->slot[i]; "
+          "i = (i + 1) & shard->mask)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  switch (sm->kind)
+  {
+    case hash_kind_integer:
+      fprintf(outfile, "if (%s == key) break;\n", value);
+      break;
+
+    case hash_kind_string:
+      fprintf(outfile, "if (hash_string_equal(%s, key)) break;\n", value);
+      break;
+
+    default:
+      fprintf(outfile, "if (!strcmp(%s, key)) break;\n", value);
+      break;
+  }
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return &shard->slot[i];\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+  if (value) free(value);
+}
+
+  /**
+   *  @fn void emit_shardmap_grow_function(FILE *outfile,
+   *                                       shardmap_names *sm,
+   *                                       int indent)
+   *
+   *  @brief generates static C function doubling the table of a shard of
+   *         sharded map @p sm
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sm - pointer to names of sharded map
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_shardmap_grow_function(FILE *outfile,
+                                        shardmap_names *sm,
+                                        int indent)
+{
+  char *prototype = NULL;
+  char *value = NULL;
+  char *params[] =
+  {
+    "shard - pointer to locked shard",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static bool ");
+  prototype = strapp(prototype, sm->fpre);
+  prototype = strapp(prototype, "_grow(");
+  prototype = strapp(prototype, sm->map_name);
+  prototype = strapp(prototype, "_shard *shard)");
+
+  value = shardmap_key_value(sm, "slot[i]");
+  if (!prototype || !value) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "doubles table of shard, or creates "
+                                      "it, rehashing every item",
+                                      params,
+                                      "true on success, false if out of "
+                                      "memory, shard unchanged",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s **slot = shard->slot;\n", sm->name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t n = slot ? shard->mask + 1 : 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t size = slot ? n * 2 : 8;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t j;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "shard->slot = calloc(size, sizeof(%s *));\n", sm->name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!shard->slot)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "shard->slot = slot;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return false;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "shard->mask = size - 1;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < n; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!slot[i]) continue;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "j = %s_hash(%s) & shard->mask;\n", sm->fpre, value);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "while (shard->slot[j]) j = (j + 1) & shard->mask;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "shard->slot[j] = slot[i];\n");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(slot);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return true;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+  if (value) free(value);
+}
+
+  /**
+   *  @fn void emit_shardmap_get_or_insert_locked_function(FILE *outfile,
+   *                                                       shardmap_names *sm,
+   *                                                       int indent)
+   *
+   *  @brief generates static C function finding or adding item with a key
+   *         in a locked shard of sharded map @p sm
+   *
+   *  NOTE:  char array keys too long for the field are refused, stored
+   *         keys are never truncated
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sm - pointer to names of sharded map
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_shardmap_get_or_insert_locked_function(FILE *outfile,
+                                                        shardmap_names *sm,
+                                                        int indent)
+{
+  char *prototype = NULL;
+  char *value = NULL;
+  char *params[] =
+  {
+    "shard - pointer to locked shard",
+    "key - key of item",
+    "hash - hash of key",
+    "inserted - address of bool set true if item was added",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static ");
+  prototype = strapp(prototype, sm->name);
+  prototype = strapp(prototype, " *");
+  prototype = strapp(prototype, sm->fpre);
+  prototype = strapp(prototype, "_get_or_insert_locked(");
+  prototype = strapp(prototype, sm->map_name);
+  prototype = strapp(prototype, "_shard *shard, ");
+  prototype = strapp(prototype, sm->param);
+  prototype = strapp(prototype, ", uint64_t hash, bool *inserted)");
+
+  value = shardmap_key_value(sm, "*slot");
+  if (!prototype || !value) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "finds item with key, adding a new "
+                                      "one holding key if there is none",
+                                      params,
+                                      "pointer to item on success, NULL on "
+                                      "failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s **slot;\n", sm->name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*inserted = false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (shard->slot)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "slot = %s_slot(shard, key, hash);\n", sm->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (*slot) return *slot;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  if (sm->kind == hash_kind_chars)
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile,
+            "if (strlen(key) >= sizeof(((%s *)0)->%s%s)) return NULL;\n",
+            sm->name,
+            sm->path,
+            sm->field);
+
+    fprintf(outfile, "\n");
+  }
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (((shard->n + 1) * 4 > (shard->mask + 1) * 3) &&\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "    !%s_grow(shard))\n", sm->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "slot = %s_slot(shard, key, hash);\n", sm->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*slot = %s_new();\n", sm->item_fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!*slot) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  switch (sm->kind)
+  {
+    case hash_kind_integer:
+      fprintf(outfile, "%s = key;\n", value);
+      break;
+
+    case hash_kind_string:
+      fprintf(outfile,
+              "%s_set_%s(*slot, (char *)key);\n",
+              sm->item_fpre,
+              sm->field);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "if (key && !%s)\n", value);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "{\n");
+
+      emit_indent(outfile, indent + 1);
+      fprintf(outfile, "%s_free(*slot);\n", sm->item_fpre);
+
+      emit_indent(outfile, indent + 1);
+      fprintf(outfile, "*slot = NULL;\n");
+
+      emit_indent(outfile, indent + 1);
+      fprintf(outfile, "return NULL;\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "}\n");
+      break;
+
+    default:
+      fprintf(outfile, "strcpy(%s, key);\n", value);
+      break;
+  }
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "++shard->n;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*inserted = true;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return *slot;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+  if (value) free(value);
+}
+
+  /**
+   *  @fn void emit_shardmap_new_function(FILE *outfile,
+   *                                      shardmap_names *sm,
+   *                                      int indent)
+   *
+   *  @brief generates C source code creating an empty sharded map @p sm
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sm - pointer to names of sharded map
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_shardmap_new_function(FILE *outfile,
+                                       shardmap_names *sm,
+                                       int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "shards - least number of shards, rounded up to a power of two,",
+    "         a few per thread is plenty",
+    NULL
+  };
+
+  prototype = strapp(prototype, sm->map_name);
+  prototype = strapp(prototype, " *");
+  prototype = strapp(prototype, sm->fpre);
+  prototype = strapp(prototype, "_new(size_t shards)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "allocates an empty sharded map",
+                                      params,
+                                      "pointer to new map on success, NULL "
+                                      "on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s *map = NULL;\n", sm->map_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t n = 1;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "while ((n < shards) && (n <= UINT32_MAX / 2)) n <<= 1;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  emit_alloc(outfile, "map", sm->map_name, false);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!map) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "map->shard = aligned_alloc(_Alignof(%s_shard),\n",
+          sm->map_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "                           n * sizeof(%s_shard));\n",
+          sm->map_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!map->shard)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "free(map);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "memset(map->shard, 0, n * sizeof(%s_shard));\n",
+          sm->map_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "map->mask = n - 1;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < n; i++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "pthread_mutex_init(&map->shard[i].lock, NULL);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return map;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_shardmap_free_function(FILE *outfile,
+   *                                       shardmap_names *sm,
+   *                                       int indent)
+   *
+   *  @brief generates C source code freeing sharded map @p sm and every
+   *         item in it
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sm - pointer to names of sharded map
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_shardmap_free_function(FILE *outfile,
+                                        shardmap_names *sm,
+                                        int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "map - pointer to map no other thread is using",
+    NULL
+  };
+
+  prototype = strapp(prototype, "void ");
+  prototype = strapp(prototype, sm->fpre);
+  prototype = strapp(prototype, "_free(");
+  prototype = strapp(prototype, sm->map_name);
+  prototype = strapp(prototype, " *map)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "frees map and every item in it",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_shard *shard;\n", sm->map_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t j;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!map) return;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i <= map->mask; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "shard = &map->shard[i];\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (shard->slot)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "for (j = 0; j <= shard->mask; j++)\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (shard->slot[j]) %s_free(shard->slot[j]);\n",
+          sm->item_fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "free(shard->slot);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_destroy(&shard->lock);\n");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(map->shard);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(map);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_shardmap_get_or_insert_function(FILE *outfile,
+   *                                                shardmap_names *sm,
+   *                                                int indent)
+   *
+   *  @brief generates C source code finding or adding item with a key in
+   *         sharded map @p sm
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sm - pointer to names of sharded map
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_shardmap_get_or_insert_function(FILE *outfile,
+                                                 shardmap_names *sm,
+                                                 int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "map - pointer to map",
+    "key - key of item",
+    "inserted - address of bool set true if item was added, may be NULL",
+    NULL
+  };
+
+  prototype = strapp(prototype, sm->name);
+  prototype = strapp(prototype, " *");
+  prototype = strapp(prototype, sm->fpre);
+  prototype = strapp(prototype, "_get_or_insert(");
+  prototype = strapp(prototype, sm->map_name);
+  prototype = strapp(prototype, " *map, ");
+  prototype = strapp(prototype, sm->param);
+  prototype = strapp(prototype, ", bool *inserted)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "finds item with key, adding a new "
+                                      "one holding key if there is none",
+                                      params,
+                                      "pointer to item, still owned by map "
+                                      "and changed only through _update(), "
+                                      "NULL on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_shard *shard;\n", sm->map_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint64_t hash;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s *item;\n", sm->name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool is_new = false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (inserted) *inserted = false;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (!map%s) return NULL;\n",
+          sm->kind == hash_kind_chars ? " || !key" : "");
+
+  fprintf(outfile, "\n");
+
+  emit_shardmap_lock_shard(outfile, sm, indent);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "item = %s_get_or_insert_locked(shard, key, hash, &is_new);\n",
+          sm->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_unlock(&shard->lock);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (inserted) *inserted = is_new;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return item;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_shardmap_update_function(FILE *outfile,
+   *                                         shardmap_names *sm,
+   *                                         int indent)
+   *
+   *  @brief generates C source code changing item with a key of sharded map
+   *         @p sm in place, under its shard lock
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sm - pointer to names of sharded map
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_shardmap_update_function(FILE *outfile,
+                                          shardmap_names *sm,
+                                          int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "map - pointer to map",
+    "key - key of item, added first if missing",
+    "update - function changing item, must not change its key or call",
+    "         back into map",
+    "ctx - pointer passed on to update",
+    NULL
+  };
+
+  prototype = strapp(prototype, "bool ");
+  prototype = strapp(prototype, sm->fpre);
+  prototype = strapp(prototype, "_update(");
+  prototype = strapp(prototype, sm->map_name);
+  prototype = strapp(prototype, " *map, ");
+  prototype = strapp(prototype, sm->param);
+  prototype = strapp(prototype, ", ");
+  prototype = strapp(prototype, sm->map_name);
+  prototype = strapp(prototype, "_update_action update, void *ctx)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "calls update on item with key, with "
+                                      "its shard locked",
+                                      params,
+                                      "true if update was called, false on "
+                                      "failure",
+                                      indent + 1);
+
+  fprintf(outfile, "bool %s_update(%s *map,\n", sm->fpre, sm->map_name);
+
+  fprintf(outfile,
+          "%*s%s,\n",
+          (int)strlen(sm->fpre) + 13,
+          "",
+          sm->param);
+
+  fprintf(outfile,
+          "%*s%s_update_action update,\n",
+          (int)strlen(sm->fpre) + 13,
+          "",
+          sm->map_name);
+
+  fprintf(outfile,
+          "%*svoid *ctx)\n",
+          (int)strlen(sm->fpre) + 13,
+          "");
+
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_shard *shard;\n", sm->map_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint64_t hash;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s *item;\n", sm->name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool is_new;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (!map || !update%s) return false;\n",
+          sm->kind == hash_kind_chars ? " || !key" : "");
+
+  fprintf(outfile, "\n");
+
+  emit_shardmap_lock_shard(outfile, sm, indent);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "item = %s_get_or_insert_locked(shard, key, hash, &is_new);\n",
+          sm->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (item) update(item, is_new, ctx);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_unlock(&shard->lock);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return item != NULL;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_shardmap_get_copy_function(FILE *outfile,
+   *                                           shardmap_names *sm,
+   *                                           int indent)
+   *
+   *  @brief generates C source code copying item with a key out of sharded
+   *         map @p sm
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sm - pointer to names of sharded map
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_shardmap_get_copy_function(FILE *outfile,
+                                            shardmap_names *sm,
+                                            int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "map - pointer to map",
+    "key - key of item",
+    NULL
+  };
+
+  prototype = strapp(prototype, sm->name);
+  prototype = strapp(prototype, " *");
+  prototype = strapp(prototype, sm->fpre);
+  prototype = strapp(prototype, "_get_copy(");
+  prototype = strapp(prototype, sm->map_name);
+  prototype = strapp(prototype, " *map, ");
+  prototype = strapp(prototype, sm->param);
+  prototype = strapp(prototype, ")");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "copies item with key, taken with its "
+                                      "shard locked",
+                                      params,
+                                      "pointer to copy, owned by caller, "
+                                      "NULL if key is missing or on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_shard *shard;\n", sm->map_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint64_t hash;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s **slot;\n", sm->name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s *copy = NULL;\n", sm->name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (!map%s) return NULL;\n",
+          sm->kind == hash_kind_chars ? " || !key" : "");
+
+  fprintf(outfile, "\n");
+
+  emit_shardmap_lock_shard(outfile, sm, indent);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (shard->slot)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "slot = %s_slot(shard, key, hash);\n", sm->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (*slot) copy = %s_dup(*slot);\n", sm->item_fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_unlock(&shard->lock);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return copy;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_shardmap_count_function(FILE *outfile,
+   *                                        shardmap_names *sm,
+   *                                        int indent)
+   *
+   *  @brief generates C source code counting items of sharded map @p sm
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sm - pointer to names of sharded map
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_shardmap_count_function(FILE *outfile,
+                                         shardmap_names *sm,
+                                         int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "map - pointer to map",
+    NULL
+  };
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, sm->fpre);
+  prototype = strapp(prototype, "_count(");
+  prototype = strapp(prototype, sm->map_name);
+  prototype = strapp(prototype, " *map)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "counts items, locking one shard at "
+                                      "a time",
+                                      params,
+                                      "number of items",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t n = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!map) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i <= map->mask; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "pthread_mutex_lock(&map->shard[i].lock);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "n += map->shard[i].n;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "pthread_mutex_unlock(&map->shard[i].lock);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return n;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_shardmap_iter_functions(FILE *outfile,
+   *                                        shardmap_names *sm,
+   *                                        int indent)
+   *
+   *  @brief generates C source code of snapshot iterator over sharded map
+   *         @p sm
+   *
+   *  NOTE:  each shard is copied with its lock held, so the snapshot is
+   *         consistent per shard, not across shards
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sm - pointer to names of sharded map
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_shardmap_iter_functions(FILE *outfile,
+                                         shardmap_names *sm,
+                                         int indent)
+{
+  char *prototype = NULL;
+  char *begin_params[] =
+  {
+    "map - pointer to map",
+    "iter - pointer to caller owned iterator",
+    NULL
+  };
+  char *iter_params[] =
+  {
+    "iter - pointer to iterator",
+    NULL
+  };
+
+  prototype = strapp(prototype, "bool ");
+  prototype = strapp(prototype, sm->fpre);
+  prototype = strapp(prototype, "_iter_begin(");
+  prototype = strapp(prototype, sm->map_name);
+  prototype = strapp(prototype, " *map, ");
+  prototype = strapp(prototype, sm->map_name);
+  prototype = strapp(prototype, "_iter *iter)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "snapshots map into iter, copying "
+                                      "every item one shard at a time",
+                                      begin_params,
+                                      "true on success, false on failure, "
+                                      "iter empty",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_shard *shard = NULL;\n", sm->map_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s **tmp;\n", sm->name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t j;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!iter) return false;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "memset(iter, 0, sizeof(%s_iter));\n", sm->map_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!map) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i <= map->mask; i++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "shard = &map->shard[i];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_lock(&shard->lock);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (shard->n)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "tmp = realloc(iter->item, (iter->n + shard->n) * sizeof(%s *));\n",
+          sm->name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!tmp) goto fail;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "iter->item = tmp;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (j = 0; j <= shard->mask; j++)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!shard->slot[j]) continue;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "iter->item[iter->n] = %s_dup(shard->slot[j]);\n",
+          sm->item_fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!iter->item[iter->n]) goto fail;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "++iter->n;\n");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_unlock(&shard->lock);\n");
+
+  --indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return true;\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "fail:\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_unlock(&shard->lock);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_iter_end(iter);\n", sm->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return false;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  free(prototype);
+  prototype = NULL;
+
+  prototype = strapp(prototype, sm->name);
+  prototype = strapp(prototype, " *");
+  prototype = strapp(prototype, sm->fpre);
+  prototype = strapp(prototype, "_iter_next(");
+  prototype = strapp(prototype, sm->map_name);
+  prototype = strapp(prototype, "_iter *iter)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "steps iter to next copied item",
+                                      iter_params,
+                                      "pointer to copy, owned by iter until "
+                                      "_iter_end(), NULL after last item",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!iter || (iter->i >= iter->n)) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return iter->item[iter->i++];\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  free(prototype);
+  prototype = NULL;
+
+  prototype = strapp(prototype, "void ");
+  prototype = strapp(prototype, sm->fpre);
+  prototype = strapp(prototype, "_iter_end(");
+  prototype = strapp(prototype, sm->map_name);
+  prototype = strapp(prototype, "_iter *iter)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "frees every copy held by iter",
+                                      iter_params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t i;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!iter) return;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (i = 0; i < iter->n; i++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_free(iter->item[i]);\n", sm->item_fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(iter->item);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "memset(iter, 0, sizeof(%s_iter));\n", sm->map_name);
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_shardmap_lock_shard(FILE *outfile,
+   *                                    shardmap_names *sm,
+   *                                    int indent)
+   *
+   *  @brief emits statements hashing key and locking the shard of map it
+   *         belongs to
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sm - pointer to names of sharded map
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_shardmap_lock_shard(FILE *outfile,
+                                     shardmap_names *sm,
+                                     int indent)
+{
+  emit_indent(outfile, indent);
+  fprintf(outfile, "hash = %s_hash(key);\n", sm->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "shard = &map->shard[(hash >> 32) & map->mask];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_lock(&shard->lock);\n");
+}
+
+  /**
+   *  @fn char *shardmap_key_value(shardmap_names *sm, char *item)
+   *
+   *  @brief builds expression reading key field of @p item
+   *
+   *  NOTE:  caller must free returned string
+   *
+   *  @param sm - pointer to names of sharded map
+   *  @param item - string containing expression of item pointer
+   *
+   *  @return string containing expression, NULL on failure
+   */
+
+static char *shardmap_key_value(shardmap_names *sm, char *item)
+{
+  char *value = NULL;
+
+  if (sm->kind == hash_kind_string)
+  {
+    value = strapp(value, sm->item_fpre);
+    value = strapp(value, "_get_");
+    value = strapp(value, sm->field);
+    value = strapp(value, "(");
+    value = strapp(value, item);
+    value = strapp(value, ")");
+  }
+  else
+  {
+    value = strapp(value, "(");
+    value = strapp(value, item);
+    value = strapp(value, ")->");
+    value = strapp(value, sm->path);
+    value = strapp(value, sm->field);
+  }
+
+  return value;
+}
@@ -0,0 +1,2324 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-skiplist.c
+ *  @brief concurrent skip list add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  A skip list keeps item pointers of a struct or union in key order, on a
+ *  linked list with up to SKIPLIST_LEVELS levels of express lanes above it.
+ *  It is the lazy skip list of Herlihy, Lev, Luchangco and Shavit: _find(),
+ *  _range() and _walk() take no lock at all, while _insert() and _erase()
+ *  lock only the nodes right before the one they link or unlink, so writers
+ *  on different keys rarely meet.  A node is marked before it is unlinked
+ *  and flagged once linked at every level, which is what readers check.
+ *
+ *  Erased nodes may still be under a reader, so they are not freed but put
+ *  on a retired list, freed by _reclaim() at a point where the caller knows
+ *  no other thread uses the skip list, or by _free().
+ *
+ *  Keys are unique, and may be integers, enums, floating point, char * or
+ *  char arrays.  Items are not owned by the skip list, and their keys must
+ *  not change while they are in it.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "source-skiplist.h"
+#include "source-heap.h"
+#include "source-serialize.h"
+#include "options.h"
+#include "profile.h"
+
+#define SKIPLIST_LEVELS 32
+
+  /**
+   *  @typedef struct skiplist_names
+   *  @brief names shared by all functions of one skip list
+   */
+
+typedef struct
+{
+  char *name;           /**<  typedef name of struct or union       */
+  char *skiplist_name;  /**<  typedef name of skip list             */
+  char *fpre;           /**<  function prefix of skip list          */
+  char *item_fpre;      /**<  function prefix of struct or union    */
+  char *field;          /**<  name of key field                     */
+  char *path;           /**<  member access path of key field       */
+  char *key_type;       /**<  C type of copy of key in nodes        */
+  char *key_space;      /**<  "" after a pointer key type, else " " */
+  hash_kind kind;       /**<  how key is read                       */
+  bool string_key;      /**<  true if key is compared as a string   */
+} skiplist_names;
+
+static void emit_skiplist_key_function(FILE *outfile,
+                                       skiplist_names *sn,
+                                       int indent);
+static void emit_skiplist_cmp_function(FILE *outfile,
+                                       skiplist_names *sn,
+                                       int indent);
+static void emit_skiplist_level_function(FILE *outfile,
+                                         skiplist_names *sn,
+                                         int indent);
+static void emit_skiplist_node_new_function(FILE *outfile,
+                                            skiplist_names *sn,
+                                            int indent);
+static void emit_skiplist_node_free_function(FILE *outfile,
+                                             skiplist_names *sn,
+                                             int indent);
+static void emit_skiplist_search_function(FILE *outfile,
+                                          skiplist_names *sn,
+                                          int indent);
+static void emit_skiplist_unlock_function(FILE *outfile,
+                                          skiplist_names *sn,
+                                          int indent);
+static void emit_skiplist_new_function(FILE *outfile,
+                                       skiplist_names *sn,
+                                       int indent);
+static void emit_skiplist_reclaim_function(FILE *outfile,
+                                           skiplist_names *sn,
+                                           int indent);
+static void emit_skiplist_free_function(FILE *outfile,
+                                        skiplist_names *sn,
+                                        int indent);
+static void emit_skiplist_insert_function(FILE *outfile,
+                                          skiplist_names *sn,
+                                          int indent);
+static void emit_skiplist_erase_function(FILE *outfile,
+                                         skiplist_names *sn,
+                                         int indent);
+static void emit_skiplist_find_function(FILE *outfile,
+                                        skiplist_names *sn,
+                                        int indent);
+static void emit_skiplist_range_function(FILE *outfile,
+                                         skiplist_names *sn,
+                                         int indent);
+static void emit_skiplist_walk_function(FILE *outfile,
+                                        skiplist_names *sn,
+                                        int indent);
+static void emit_skiplist_count_function(FILE *outfile,
+                                         skiplist_names *sn,
+                                         int indent);
+
+  /**
+   *  @fn xmlNodePtr skiplist_key(xmlNodePtr node, hash_kind *kind)
+   *
+   *  @brief finds key field of skip list of struct or union in @p node
+   *
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param kind - address of @a hash_kind receiving how key is compared,
+   *                may be NULL
+   *
+   *  @return xmlNodePtr of key field element, NULL if struct or union has
+   *          no field named by the skip list key option, or it is of a type
+   *          that can not be ordered
+   */
+
+xmlNodePtr skiplist_key(xmlNodePtr node, hash_kind *kind)
+{
+  return ordered_key(node, option_skiplist_key(), kind);
+}
+
+  /**
+   *  @fn char *skiplist_key_type(xmlNodePtr node)
+   *
+   *  @brief builds C type of the copy of the key kept in skip list nodes of
+   *         struct or union in @p node
+   *
+   *  NOTE:  caller must free returned string
+   *
+   *  @param node - xmlNodePtr containing struct or union element
+   *
+   *  @return string such as "unsigned int" or "const char *", NULL if
+   *          struct or union gets no skip list
+   */
+
+char *skiplist_key_type(xmlNodePtr node)
+{
+  return ordered_key_type(node, option_skiplist_key());
+}
+
+  /**
+   *  @fn void emit_aggregate_skiplist_functions(FILE *outfile,
+   *                                             xmlNodePtr node,
+   *                                             char *project_name)
+   *
+   *  @brief generates skip list C source code from struct or union element
+   *         in @p node
+   *
+   *  NOTE:  nothing is emitted for a struct or union without the key field
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_aggregate_skiplist_functions(FILE *outfile,
+                                       xmlNodePtr node,
+                                       char *project_name)
+{
+  skiplist_names sn;
+  char *project = NULL;
+  xmlNodePtr key;
+  int indent = 0;
+
+  memset(&sn, 0, sizeof(sn));
+
+  if (!option_gen_skiplist()) goto exit;
+
+  if (!outfile || !node || !project_name) goto exit;
+
+  key = skiplist_key(node, &sn.kind);
+  if (!key) goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+  str_lower(project);
+
+  sn.name = get_attribute(node, "name");
+  sn.field = get_attribute(key, "name");
+  sn.key_type = skiplist_key_type(node);
+  if (!sn.name || !sn.field || !sn.key_type) goto exit;
+
+  sn.string_key = (sn.kind == hash_kind_string) ||
+                  (sn.kind == hash_kind_chars);
+  sn.key_space = sn.string_key ? "" : " ";
+
+  sn.skiplist_name = strapp(sn.skiplist_name, sn.name);
+  sn.skiplist_name = strapp(sn.skiplist_name, "_skiplist");
+
+  sn.fpre = container_prefix(project, sn.name, "skiplist");
+  sn.item_fpre = function_prefix(project, sn.name);
+  sn.path = profile_field_path(sn.name, sn.field);
+  if (!sn.skiplist_name || !sn.fpre || !sn.item_fpre) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          " *  Skip list functions for struct %s, keyed by %s\n",
+          sn.skiplist_name,
+          sn.field);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  emit_skiplist_key_function(outfile, &sn, indent);
+  emit_skiplist_cmp_function(outfile, &sn, indent);
+  emit_skiplist_level_function(outfile, &sn, indent);
+  emit_skiplist_node_new_function(outfile, &sn, indent);
+  emit_skiplist_node_free_function(outfile, &sn, indent);
+  emit_skiplist_search_function(outfile, &sn, indent);
+  emit_skiplist_unlock_function(outfile, &sn, indent);
+  emit_skiplist_new_function(outfile, &sn, indent);
+  emit_skiplist_reclaim_function(outfile, &sn, indent);
+  emit_skiplist_free_function(outfile, &sn, indent);
+  emit_skiplist_insert_function(outfile, &sn, indent);
+  emit_skiplist_erase_function(outfile, &sn, indent);
+  emit_skiplist_find_function(outfile, &sn, indent);
+  emit_skiplist_range_function(outfile, &sn, indent);
+  emit_skiplist_walk_function(outfile, &sn, indent);
+  emit_skiplist_count_function(outfile, &sn, indent);
+
+exit:
+  if (project) free(project);
+  if (sn.name) free(sn.name);
+  if (sn.skiplist_name) free(sn.skiplist_name);
+  if (sn.fpre) free(sn.fpre);
+  if (sn.item_fpre) free(sn.item_fpre);
+  if (sn.field) free(sn.field);
+  if (sn.key_type) free(sn.key_type);
+}
+
+  /**
+   *  @fn void emit_skiplist_key_function(FILE *outfile,
+   *                                      skiplist_names *sn,
+   *                                      int indent)
+   *
+   *  @brief generates static C function reading the key of an item of skip
+   *         list @p sn
+   *
+   *  NOTE:  a NULL char * key orders as ""
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sn - pointer to names of skip list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_skiplist_key_function(FILE *outfile,
+                                       skiplist_names *sn,
+                                       int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "item - pointer to item",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static inline ");
+  prototype = strapp(prototype, sn->key_type);
+  prototype = strapp(prototype, sn->key_space);
+  prototype = strapp(prototype, sn->fpre);
+  prototype = strapp(prototype, "_key(");
+  prototype = strapp(prototype, sn->name);
+  prototype = strapp(prototype, " *item)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "reads key of item",
+                                      params,
+                                      "key of item",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  switch (sn->kind)
+  {
+    case hash_kind_string:
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              "const char *key = %s_get_%s(item);\n",
+              sn->item_fpre,
+              sn->field);
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "return key ? key : \"\";\n");
+      break;
+
+    default:
+      emit_indent(outfile, indent);
+      fprintf(outfile, "return item->%s%s;\n", sn->path, sn->field);
+      break;
+  }
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_skiplist_cmp_function(FILE *outfile,
+   *                                      skiplist_names *sn,
+   *                                      int indent)
+   *
+   *  @brief generates static C function ordering two keys of skip list
+   *         @p sn
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sn - pointer to names of skip list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_skiplist_cmp_function(FILE *outfile,
+                                       skiplist_names *sn,
+                                       int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "a - key",
+    "b - key",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static inline int ");
+  prototype = strapp(prototype, sn->fpre);
+  prototype = strapp(prototype, "_cmp(");
+  prototype = strapp(prototype, sn->key_type);
+  prototype = strapp(prototype, sn->key_space);
+  prototype = strapp(prototype, "a, ");
+  prototype = strapp(prototype, sn->key_type);
+  prototype = strapp(prototype, sn->key_space);
+  prototype = strapp(prototype, "b)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "orders two keys",
+                                      params,
+                                      "less than, equal to or greater than 0 "
+                                      "as a sorts before, with or after b",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  if (sn->string_key)
+    fprintf(outfile, "return strcmp(a, b);\n");
+  else
+    fprintf(outfile, "return (a > b) - (a < b);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_skiplist_level_function(FILE *outfile,
+   *                                        skiplist_names *sn,
+   *                                        int indent)
+   *
+   *  @brief generates static C function drawing the height of a new node
+   *
+   *  NOTE:  each further level is taken with probability 1/2, from a hashed
+   *         counter shared by all threads
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sn - pointer to names of skip list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_skiplist_level_function(FILE *outfile,
+                                         skiplist_names *sn,
+                                         int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to skip list",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static int ");
+  prototype = strapp(prototype, sn->fpre);
+  prototype = strapp(prototype, "_level(");
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, " *instance)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "draws number of levels of a new node",
+                                      params,
+                                      "height between 1 and the skip list "
+                                      "maximum",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "uint32_t x;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int height = 1;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "x = atomic_fetch_add(&instance->seed, 0x9e3779b9u);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "x ^= x >> 16;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "x *= 0x85ebca6bu;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "x ^= x >> 13;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "x *= 0xc2b2ae35u;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "x ^= x >> 16;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "while ((x & 1) && (height < %d))\n", SKIPLIST_LEVELS);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "++height;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "x >>= 1;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return height;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_skiplist_node_new_function(FILE *outfile,
+   *                                           skiplist_names *sn,
+   *                                           int indent)
+   *
+   *  @brief generates static C function allocating a node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sn - pointer to names of skip list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_skiplist_node_new_function(FILE *outfile,
+                                            skiplist_names *sn,
+                                            int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "item - pointer to item, may be NULL",
+    "height - number of levels of node",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static ");
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, "_node *");
+  prototype = strapp(prototype, sn->fpre);
+  prototype = strapp(prototype, "_node_new(");
+  prototype = strapp(prototype, sn->name);
+  prototype = strapp(prototype, " *item, int height)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "allocates an unlinked node, a NULL "
+                                      "item makes the head",
+                                      params,
+                                      "pointer to node, NULL on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *node = NULL;\n", sn->skiplist_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int level;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "node = malloc(sizeof(*node) + sizeof(node->next[0]) * height);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!node) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (item) node->key = %s_key(item);\n", sn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "node->item = item;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "node->retired = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "node->height = height;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_init(&node->lock, NULL);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "atomic_init(&node->marked, false);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "atomic_init(&node->linked, false);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (level = 0; level < height; level++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "atomic_init(&node->next[level], NULL);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return node;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_skiplist_node_free_function(FILE *outfile,
+   *                                            skiplist_names *sn,
+   *                                            int indent)
+   *
+   *  @brief generates static C function freeing a node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sn - pointer to names of skip list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_skiplist_node_free_function(FILE *outfile,
+                                             skiplist_names *sn,
+                                             int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "node - pointer to node, may be NULL",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static void ");
+  prototype = strapp(prototype, sn->fpre);
+  prototype = strapp(prototype, "_node_free(");
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, "_node *node)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "frees node, but not its item",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!node) return;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "pthread_mutex_destroy(&node->lock);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(node);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_skiplist_search_function(FILE *outfile,
+   *                                         skiplist_names *sn,
+   *                                         int indent)
+   *
+   *  @brief generates static C function finding the neighbours of a key at
+   *         every level
+   *
+   *  NOTE:  takes no locks, the result may be stale by the time it is used
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sn - pointer to names of skip list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_skiplist_search_function(FILE *outfile,
+                                          skiplist_names *sn,
+                                          int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to skip list",
+    "key - key to look for",
+    "preds - array receiving last node before key at each level",
+    "succs - array receiving next node at each level, NULL at end",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static int ");
+  prototype = strapp(prototype, sn->fpre);
+  prototype = strapp(prototype, "_search(");
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, " *instance, ");
+  prototype = strapp(prototype, sn->key_type);
+  prototype = strapp(prototype, sn->key_space);
+  prototype = strapp(prototype, "key, ");
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, "_node **preds, ");
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, "_node **succs)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "finds last node before key and first "
+                                      "node not before it at each level",
+                                      params,
+                                      "highest level holding a node with "
+                                      "key, -1 if none",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *pred = instance->head;\n", sn->skiplist_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *curr;\n", sn->skiplist_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int found = -1;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int level;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "for (level = %d; level >= 0; level--)\n",
+          SKIPLIST_LEVELS - 1);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "curr = atomic_load_explicit(&pred->next[level], "
+          "memory_order_acquire);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "while (curr && (%s_cmp(curr->key, key) < 0))\n", sn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "pred = curr;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          "curr = atomic_load_explicit(&pred->next[level], "
+          "memory_order_acquire);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "if ((found < 0) && curr && !%s_cmp(curr->key, key)) found = "
+          "level;\n",
+          sn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "preds[level] = pred;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "succs[level] = curr;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return found;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_skiplist_unlock_function(FILE *outfile,
+   *                                         skiplist_names *sn,
+   *                                         int indent)
+   *
+   *  @brief generates static C function unlocking the predecessors locked by a
+   *         writer
+   *
+   *  NOTE:  a node before several levels is locked once, at the lowest of
+   *         them
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sn - pointer to names of skip list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_skiplist_unlock_function(FILE *outfile,
+                                          skiplist_names *sn,
+                                          int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "preds - array of nodes locked from level 0 up",
+    "highest - highest level locked, -1 if none",
+    NULL
+  };
+
+  prototype = strapp(prototype, "static void ");
+  prototype = strapp(prototype, sn->fpre);
+  prototype = strapp(prototype, "_unlock(");
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, "_node **preds, int highest)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "unlocks each distinct node of preds "
+                                      "up to level highest",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int level;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (level = 0; level <= highest; level++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!level || (preds[level] != preds[level - 1]))\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "pthread_mutex_unlock(&preds[level]->lock);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_skiplist_new_function(FILE *outfile,
+   *                                      skiplist_names *sn,
+   *                                      int indent)
+   *
+   *  @brief generates C function creating an empty skip list
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sn - pointer to names of skip list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_skiplist_new_function(FILE *outfile,
+                                       skiplist_names *sn,
+                                       int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    NULL
+  };
+
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, " *");
+  prototype = strapp(prototype, sn->fpre);
+  prototype = strapp(prototype, "_new(void)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "creates an empty skip list",
+                                      params,
+                                      "pointer to new skip list, NULL on "
+                                      "failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s *instance = NULL;\n", sn->skiplist_name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "instance = malloc(sizeof(%s));\n", sn->skiplist_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "instance->head = %s_node_new(NULL, %d);\n",
+          sn->fpre,
+          SKIPLIST_LEVELS);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance->head)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "free(instance);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "instance = NULL;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "goto exit;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "atomic_init(&instance->retired, NULL);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "atomic_init(&instance->n, 0);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "atomic_init(&instance->seed, (uint32_t)(uintptr_t)instance);\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "exit:\n");
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return instance;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_skiplist_reclaim_function(FILE *outfile,
+   *                                          skiplist_names *sn,
+   *                                          int indent)
+   *
+   *  @brief generates C function freeing the nodes of erased items
+   *
+   *  NOTE:  erased nodes stay readable until this runs, so lock-free readers
+   *         never touch freed memory, callers run it only while no other
+   *         thread uses the skip list
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sn - pointer to names of skip list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_skiplist_reclaim_function(FILE *outfile,
+                                           skiplist_names *sn,
+                                           int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to skip list",
+    NULL
+  };
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, sn->fpre);
+  prototype = strapp(prototype, "_reclaim(");
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, " *instance)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "frees nodes of erased items, only "
+                                      "while no other thread uses the skip "
+                                      "list",
+                                      params,
+                                      "number of nodes freed",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *node;\n", sn->skiplist_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *next;\n", sn->skiplist_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t freed = 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "node = atomic_exchange(&instance->retired, NULL);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (; node; node = next)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "next = node->retired;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_node_free(node);\n", sn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "++freed;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return freed;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_skiplist_free_function(FILE *outfile,
+   *                                       skiplist_names *sn,
+   *                                       int indent)
+   *
+   *  @brief generates C function freeing a skip list
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sn - pointer to names of skip list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_skiplist_free_function(FILE *outfile,
+                                        skiplist_names *sn,
+                                        int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to skip list",
+    NULL
+  };
+
+  prototype = strapp(prototype, "void ");
+  prototype = strapp(prototype, sn->fpre);
+  prototype = strapp(prototype, "_free(");
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, " *instance)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "frees skip list, but not its items",
+                                      params,
+                                      "nothing",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *node;\n", sn->skiplist_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *next;\n", sn->skiplist_name);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance) return;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_reclaim(instance);\n", sn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (node = instance->head; node; node = next)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "next = atomic_load_explicit(&node->next[0], "
+          "memory_order_relaxed);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_node_free(node);\n", sn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(instance);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_skiplist_insert_function(FILE *outfile,
+   *                                         skiplist_names *sn,
+   *                                         int indent)
+   *
+   *  @brief generates C function inserting an item into a skip list
+   *
+   *  NOTE:  locks only the nodes before the new one, from level 0 up, and
+   *         retries if any of them changed since the search
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sn - pointer to names of skip list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_skiplist_insert_function(FILE *outfile,
+                                          skiplist_names *sn,
+                                          int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to skip list",
+    "item - pointer to item",
+    NULL
+  };
+
+  prototype = strapp(prototype, "bool ");
+  prototype = strapp(prototype, sn->fpre);
+  prototype = strapp(prototype, "_insert(");
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, " *instance, ");
+  prototype = strapp(prototype, sn->name);
+  prototype = strapp(prototype, " *item)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "inserts item, which the skip list "
+                                      "does not own or copy",
+                                      params,
+                                      "true if inserted, false if key "
+                                      "already present or on failure",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%s_node *preds[%d];\n",
+          sn->skiplist_name,
+          SKIPLIST_LEVELS);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%s_node *succs[%d];\n",
+          sn->skiplist_name,
+          SKIPLIST_LEVELS);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *node = NULL;\n", sn->skiplist_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *pred;\n", sn->skiplist_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *succ;\n", sn->skiplist_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *next;\n", sn->skiplist_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int height;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int highest;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int level;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool valid;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool inserted = false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !item) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "node = %s_node_new(item, %s_level(instance));\n",
+          sn->fpre,
+          sn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!node) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "height = node->height;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (;;)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "level = %s_search(instance, node->key, preds, succs);\n",
+          sn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (level >= 0)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "succ = succs[level];\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (atomic_load(&succ->marked)) continue;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "while (!atomic_load(&succ->linked))\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, ";\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "goto exit;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "highest = -1;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "valid = true;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "for (level = 0; valid && (level < height); level++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "pred = preds[level];\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "succ = succs[level];\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (!level || (pred != preds[level - 1]))\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "pthread_mutex_lock(&pred->lock);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "highest = level;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          "next = atomic_load_explicit(&pred->next[level], "
+          "memory_order_acquire);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "valid = !atomic_load(&pred->marked) && (next == succ);\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          "if (valid && succ) valid = !atomic_load(&succ->marked);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!valid)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "%s_unlock(preds, highest);\n", sn->fpre);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "continue;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "for (level = 0; level < height; level++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "next = succs[level];\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          "atomic_store_explicit(&node->next[level], next, "
+          "memory_order_relaxed);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "for (level = 0; level < height; level++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "pred = preds[level];\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          "atomic_store_explicit(&pred->next[level], node, "
+          "memory_order_release);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "atomic_store(&node->linked, true);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_unlock(preds, highest);\n", sn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "break;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "atomic_fetch_add(&instance->n, 1);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "node = NULL;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "inserted = true;\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "exit:\n");
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node_free(node);\n", sn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return inserted;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_skiplist_erase_function(FILE *outfile,
+   *                                        skiplist_names *sn,
+   *                                        int indent)
+   *
+   *  @brief generates C function erasing an item from a skip list
+   *
+   *  NOTE:  marks the node under its own lock, then unlinks it with the nodes
+   *         before it locked, the node is kept for readers until _reclaim()
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sn - pointer to names of skip list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_skiplist_erase_function(FILE *outfile,
+                                         skiplist_names *sn,
+                                         int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to skip list",
+    "key - key of item to erase",
+    NULL
+  };
+
+  prototype = strapp(prototype, sn->name);
+  prototype = strapp(prototype, " *");
+  prototype = strapp(prototype, sn->fpre);
+  prototype = strapp(prototype, "_erase(");
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, " *instance, ");
+  prototype = strapp(prototype, sn->key_type);
+  prototype = strapp(prototype, sn->key_space);
+  prototype = strapp(prototype, "key)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "erases the item with key",
+                                      params,
+                                      "pointer to erased item, NULL if key "
+                                      "not present",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%s_node *preds[%d];\n",
+          sn->skiplist_name,
+          SKIPLIST_LEVELS);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%s_node *succs[%d];\n",
+          sn->skiplist_name,
+          SKIPLIST_LEVELS);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *victim = NULL;\n", sn->skiplist_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *pred;\n", sn->skiplist_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *next;\n", sn->skiplist_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s *item = NULL;\n", sn->name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int height = 0;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int highest;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int level;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool marked = false;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "bool valid;\n");
+
+  fprintf(outfile, "\n");
+
+  if (sn->string_key)
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "if (!instance || !key) goto exit;\n");
+  }
+  else
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "if (!instance) goto exit;\n");
+  }
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "for (;;)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "level = %s_search(instance, key, preds, succs);\n",
+          sn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!marked)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (level < 0) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "victim = succs[level];\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (!atomic_load(&victim->linked)) goto exit;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (victim->height - 1 != level) goto exit;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (atomic_load(&victim->marked)) goto exit;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "height = victim->height;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "pthread_mutex_lock(&victim->lock);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (atomic_load(&victim->marked))\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "pthread_mutex_unlock(&victim->lock);\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "goto exit;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "atomic_store(&victim->marked, true);\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "marked = true;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "highest = -1;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "valid = true;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "for (level = 0; valid && (level < height); level++)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "pred = preds[level];\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (!level || (pred != preds[level - 1]))\n");
+
+  emit_indent(outfile, indent + 3);
+  fprintf(outfile, "pthread_mutex_lock(&pred->lock);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "highest = level;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          "next = atomic_load_explicit(&pred->next[level], "
+          "memory_order_acquire);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          "valid = !atomic_load(&pred->marked) && (next == victim);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "if (!valid)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "%s_unlock(preds, highest);\n", sn->fpre);
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "continue;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "for (level = height - 1; level >= 0; level--)\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "pred = preds[level];\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          "next = atomic_load_explicit(&victim->next[level], "
+          "memory_order_acquire);\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile,
+          "atomic_store_explicit(&pred->next[level], next, "
+          "memory_order_release);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "pthread_mutex_unlock(&victim->lock);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "%s_unlock(preds, highest);\n", sn->fpre);
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "break;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "item = victim->item;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "atomic_fetch_sub(&instance->n, 1);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "next = atomic_load(&instance->retired);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "do\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "victim->retired = next;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "while (!atomic_compare_exchange_weak(&instance->retired, &next, "
+          "victim));\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile, "exit:\n");
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return item;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_skiplist_find_function(FILE *outfile,
+   *                                       skiplist_names *sn,
+   *                                       int indent)
+   *
+   *  @brief generates C function finding an item in a skip list without
+   *         locking
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sn - pointer to names of skip list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_skiplist_find_function(FILE *outfile,
+                                        skiplist_names *sn,
+                                        int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to skip list",
+    "key - key to look for",
+    NULL
+  };
+
+  prototype = strapp(prototype, sn->name);
+  prototype = strapp(prototype, " *");
+  prototype = strapp(prototype, sn->fpre);
+  prototype = strapp(prototype, "_find(");
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, " *instance, ");
+  prototype = strapp(prototype, sn->key_type);
+  prototype = strapp(prototype, sn->key_space);
+  prototype = strapp(prototype, "key)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "finds the item with key, without "
+                                      "taking any lock",
+                                      params,
+                                      "pointer to item, NULL if key not "
+                                      "present",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%s_node *preds[%d];\n",
+          sn->skiplist_name,
+          SKIPLIST_LEVELS);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%s_node *succs[%d];\n",
+          sn->skiplist_name,
+          SKIPLIST_LEVELS);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *node;\n", sn->skiplist_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "int level;\n");
+
+  fprintf(outfile, "\n");
+
+  if (sn->string_key)
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "if (!instance || !key) return NULL;\n");
+  }
+  else
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "if (!instance) return NULL;\n");
+  }
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "level = %s_search(instance, key, preds, succs);\n",
+          sn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (level < 0) return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "node = succs[level];\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "if (!atomic_load(&node->linked) || atomic_load(&node->marked)) "
+          "return NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return node->item;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_skiplist_range_function(FILE *outfile,
+   *                                        skiplist_names *sn,
+   *                                        int indent)
+   *
+   *  @brief generates C function calling a function for each item of a key
+   *         range of a skip list without locking
+   *
+   *  NOTE:  items inserted or erased during the scan may or may not be seen
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sn - pointer to names of skip list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_skiplist_range_function(FILE *outfile,
+                                         skiplist_names *sn,
+                                         int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to skip list",
+    "low - lowest key of range",
+    "high - highest key of range",
+    "action - function called with each item and arg",
+    "arg - pointer passed through to action",
+    NULL
+  };
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, sn->fpre);
+  prototype = strapp(prototype, "_range(");
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, " *instance, ");
+  prototype = strapp(prototype, sn->key_type);
+  prototype = strapp(prototype, sn->key_space);
+  prototype = strapp(prototype, "low, ");
+  prototype = strapp(prototype, sn->key_type);
+  prototype = strapp(prototype, sn->key_space);
+  prototype = strapp(prototype, "high, ");
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, "_action action, void *arg)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "calls action on each item with low <= "
+                                      "key <= high, in key order, until it "
+                                      "returns non-zero",
+                                      params,
+                                      "number of items action was called on",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%s_node *preds[%d];\n",
+          sn->skiplist_name,
+          SKIPLIST_LEVELS);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "%s_node *succs[%d];\n",
+          sn->skiplist_name,
+          SKIPLIST_LEVELS);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *node;\n", sn->skiplist_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t visited = 0;\n");
+
+  fprintf(outfile, "\n");
+
+  if (sn->string_key)
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "if (!instance || !action || !low || !high) return 0;\n");
+  }
+  else
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "if (!instance || !action) return 0;\n");
+  }
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_search(instance, low, preds, succs);\n", sn->fpre);
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "node = succs[0];\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "while (node && (%s_cmp(node->key, high) <= 0))\n",
+          sn->fpre);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "if (atomic_load(&node->linked) && !atomic_load(&node->marked))\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "++visited;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (action(node->item, arg)) break;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "node = atomic_load_explicit(&node->next[0], "
+          "memory_order_acquire);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return visited;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_skiplist_walk_function(FILE *outfile,
+   *                                       skiplist_names *sn,
+   *                                       int indent)
+   *
+   *  @brief generates C function calling a function for each item of a skip
+   *         list without locking
+   *
+   *  NOTE:  items inserted or erased during the walk may or may not be seen
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sn - pointer to names of skip list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_skiplist_walk_function(FILE *outfile,
+                                        skiplist_names *sn,
+                                        int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to skip list",
+    "action - function called with each item and arg",
+    "arg - pointer passed through to action",
+    NULL
+  };
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, sn->fpre);
+  prototype = strapp(prototype, "_walk(");
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, " *instance, ");
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, "_action action, void *arg)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "calls action on each item, in key "
+                                      "order, until it returns non-zero",
+                                      params,
+                                      "number of items action was called on",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "%s_node *node;\n", sn->skiplist_name);
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t visited = 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance || !action) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile,
+          "node = atomic_load_explicit(&instance->head->next[0], "
+          "memory_order_acquire);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "while (node)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "if (atomic_load(&node->linked) && !atomic_load(&node->marked))\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "++visited;\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "if (action(node->item, arg)) break;\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile,
+          "node = atomic_load_explicit(&node->next[0], "
+          "memory_order_acquire);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return visited;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
+
+  /**
+   *  @fn void emit_skiplist_count_function(FILE *outfile,
+   *                                        skiplist_names *sn,
+   *                                        int indent)
+   *
+   *  @brief generates C function returning the number of items of a skip list
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param sn - pointer to names of skip list
+   *  @param indent - indent level for output
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_skiplist_count_function(FILE *outfile,
+                                         skiplist_names *sn,
+                                         int indent)
+{
+  char *prototype = NULL;
+  char *params[] =
+  {
+    "instance - pointer to skip list",
+    NULL
+  };
+
+  prototype = strapp(prototype, "size_t ");
+  prototype = strapp(prototype, sn->fpre);
+  prototype = strapp(prototype, "_count(");
+  prototype = strapp(prototype, sn->skiplist_name);
+  prototype = strapp(prototype, " *instance)");
+  if (!prototype) goto exit;
+
+  emit_aggregate_serialize_annotation(outfile,
+                                      prototype,
+                                      "returns number of items",
+                                      params,
+                                      "number of items, 0 if instance is NULL",
+                                      indent + 1);
+
+  fprintf(outfile, "%s\n", prototype);
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!instance) return 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return atomic_load(&instance->n);\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+  if (prototype) free(prototype);
+}
@@ -0,0 +1,296 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file source-sso.c
+ *  @brief small string inline buffer add-on for source.c
+ *
+ *  Input in XML format as produced by c_decls_to_xml.so GCC plugin
+ *
+ *  Output is C language source code
+ *
+ *  char * fields named by an @b inline directive in the tuning file are
+ *  declared as a struct of a heap pointer and a fixed buffer.  Strings that
+ *  fit the buffer are stored in it, longer strings spill to the heap.  The
+ *  getter and setter keep their char * signatures.
+ *
+ *  NOTE:  an inline field never reads as NULL, setting NULL stores ""
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "source-sso.h"
+#include "source-intern.h"
+#include "source-serialize.h"
+#include "tuning.h"
+
+  /**
+   *  @fn int sso_size(char *aggregate_name, xmlNodePtr node)
+   *
+   *  @brief returns size of inline buffer of field element in @p node
+   *
+   *  NOTE:  interned fields are never inline
+   *
+   *  @param aggregate_name - string containing name of struct or union
+   *  @param node - xmlNodePtr containing field element
+   *
+   *  @return size of buffer in bytes, 0 if field is not inline
+   */
+
+int sso_size(char *aggregate_name, xmlNodePtr node)
+{
+  xmlNodePtr type;
+  char *field_name = NULL;
+  int size = 0;
+
+  if (!aggregate_name || !node) goto exit;
+
+  field_name = get_attribute(node, "name");
+  if (!field_name) goto exit;
+
+  size = tuning_field_inline(aggregate_name, field_name);
+  if (!size) goto exit;
+
+  if ((serialize_field_kind(node, &type) != serialize_kind_string) ||
+      intern_field(aggregate_name, node))
+    size = 0;
+
+exit:
+  if (field_name) free(field_name);
+
+  return size;
+}
+
+  /**
+   *  @fn bool sso_needed(xmlNodePtr root)
+   *
+   *  @brief determines if any field of declarations in @p root is inline
+   *
+   *  @param root - xmlNodePtr containing c-decls element
+   *
+   *  @return true if inline string helper is needed, false if not
+   */
+
+bool sso_needed(xmlNodePtr root)
+{
+  xmlNodePtr node;
+  xmlNodePtr child;
+  char *name = NULL;
+  bool needed = false;
+
+  if (!root) goto exit;
+
+  for (node = root->children; node && !needed; node = node->next)
+  {
+    if (strcmp((char *)node->name, "struct") &&
+        strcmp((char *)node->name, "union"))
+      continue;
+
+    name = get_attribute(node, "name");
+    if (!name) continue;
+
+    for (child = node->children; child; child = child->next)
+    {
+      if (strcmp((char *)child->name, "field")) continue;
+
+      if (sso_size(name, child)) needed = true;
+    }
+
+    free(name);
+    name = NULL;
+  }
+
+exit:
+  return needed;
+}
+
+  /**
+   *  @fn char *sso_read(char *lvalue)
+   *
+   *  @brief builds C expression reading string of inline field
+   *
+   *  @param lvalue - string containing C expression of field
+   *
+   *  @return pointer to allocated string on success
+   *          NULL on failure
+   */
+
+char *sso_read(char *lvalue)
+{
+  char *expression = NULL;
+
+  if (!lvalue) goto exit;
+
+  expression = strapp(expression, "(");
+  expression = strapp(expression, lvalue);
+  expression = strapp(expression, ".heap ? ");
+  expression = strapp(expression, lvalue);
+  expression = strapp(expression, ".heap : ");
+  expression = strapp(expression, lvalue);
+  expression = strapp(expression, ".buf)");
+
+exit:
+  return expression;
+}
+
+  /**
+   *  @fn char *sso_store(char *lvalue, char *value)
+   *
+   *  @brief builds C expression storing string @p value in inline field,
+   *         which is true on success and false if out of memory
+   *
+   *  @param lvalue - string containing C expression of field
+   *  @param value - string containing C expression of string to store
+   *
+   *  @return pointer to allocated string on success
+   *          NULL on failure
+   */
+
+char *sso_store(char *lvalue, char *value)
+{
+  char *expression = NULL;
+
+  if (!lvalue || !value) goto exit;
+
+  expression = strapp(expression, "sso_store(&");
+  expression = strapp(expression, lvalue);
+  expression = strapp(expression, ".heap, ");
+  expression = strapp(expression, lvalue);
+  expression = strapp(expression, ".buf, sizeof(");
+  expression = strapp(expression, lvalue);
+  expression = strapp(expression, ".buf), ");
+  expression = strapp(expression, value);
+  expression = strapp(expression, ")");
+
+exit:
+  return expression;
+}
+
+  /**
+   *  @fn void emit_sso_helpers(FILE *outfile, xmlNodePtr root)
+   *
+   *  @brief generates static helper function storing strings in inline
+   *         fields
+   *
+   *  NOTE:  nothing is emitted if no field of declarations in @p root is
+   *         inline
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param root - xmlNodePtr containing c-decls element
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void emit_sso_helpers(FILE *outfile, xmlNodePtr root)
+{
+  int indent = 0;
+
+  if (!outfile || !root) goto exit;
+
+  if (!sso_needed(root)) goto exit;
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, "/*\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " *  Store helper for inline string fields\n");
+
+  emit_indent(outfile, indent + 2);
+  fprintf(outfile, " */\n");
+
+  fprintf(outfile, "\n");
+
+  fprintf(outfile,
+          "static inline bool sso_store(char **heap,\n"
+          "                             char *buf,\n"
+          "                             size_t size,\n"
+          "                             const char *s)\n");
+  fprintf(outfile, "{\n");
+
+  ++indent;
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "size_t len;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "free(*heap);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*heap = NULL;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!s) s = \"\";\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "len = strlen(s);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (len < size)\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "{\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "memcpy(buf, s, len + 1);\n");
+
+  emit_indent(outfile, indent + 1);
+  fprintf(outfile, "return true;\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "buf[0] = 0;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "*heap = malloc(len + 1);\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "if (!*heap) return false;\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "memcpy(*heap, s, len + 1);\n");
+
+  fprintf(outfile, "\n");
+
+  emit_indent(outfile, indent);
+  fprintf(outfile, "return true;\n");
+
+  --indent;
+
+  fprintf(outfile, "}\n");
+
+  fprintf(outfile, "\n");
+
+exit:
+}
@@ -33,8 +33,37 @@
 #include "source-array.h"
 #include "source-list.h"
 #include "source-avl.h"
+#include "source-serialize.h"
+#include "source-flat.h"
+#include "source-mmap.h"
+#include "source-delimited.h"
+#include "source-json.h"
+#include "source-hash.h"
+#include "source-ring.h"
+#include "source-shardmap.h"
+#include "source-parallel.h"
+#include "source-persistent.h"
+#include "source-heap.h"
+#include "source-skiplist.h"
+#include "source-intern.h"
+#include "source-sso.h"
 #include "options.h"
-
+#include "profile.h"
+#include "tuning.h"
+
+static void gen_split_sources(xmlNodePtr root,
+                              char *base_name,
+                              char *project_name);
+static void emit_source_front_matter(FILE *outfile,
+                                     xmlNodePtr root,
+                                     char *file_name,
+                                     char *project_name);
+static void emit_source_helpers(FILE *outfile,
+                                xmlNodePtr root,
+                                char *project_name);
+static void emit_record_functions(FILE *outfile,
+                                  xmlNodePtr node,
+                                  char *project_name);
 static void emit_enum_functions(FILE *outfile,
                                 xmlNodePtr node,
                                 char *project_name);
@@ -61,11 +90,13 @@ static void emit_aggregate_getter_function(FILE *outfile,
                                            xmlNodePtr node,
                                            char *project,
                                            char *aggregate_name,
+                                           bool inline_accessor,
                                            int indent);
 static void emit_aggregate_setter_function(FILE *outfile,
                                            xmlNodePtr node,
                                            char *project,
                                            char *aggregate_name,
+                                           bool inline_accessor,
                                            int indent);
 
 static void emit_source_annotation(FILE *outfile, char *file_name);
@@ -128,7 +159,6 @@ void gen_source(xmlDocPtr doc, char *base_name)
   FILE *outfile = NULL;
   char *outfile_name = NULL;
   char *project_name = NULL;
-  char *tmp = NULL;
 
   if (!doc || !base_name) return;
 
@@ -155,10 +185,153 @@ void gen_source(xmlDocPtr doc, char *base_name)
 
   str_upper(project_name);
 
-  tmp = strdup(project_name);
-  if (!tmp) goto exit;
+  emit_source_front_matter(outfile, root, outfile_name, project_name);
 
-  str_lower(tmp);
+  emit_intern_table(outfile, root, project_name);
+
+  if (!option_split_source())
+    emit_source_helpers(outfile, root, project_name);
+
+    // Emit functions for all enums, structs, and unions
+
+  for (node = root->children; node; node = node->next)
+  {
+    if (!strcmp((char *)node->name, "enum"))
+      emit_enum_functions(outfile, node, project_name);
+    else if (!option_split_source() &&
+             (!strcmp((char *)node->name, "struct") ||
+              !strcmp((char *)node->name, "union")))
+      emit_record_functions(outfile, node, project_name);
+  }
+
+  if (option_split_source())
+    gen_split_sources(root, base_name, project_name);
+
+exit:
+  if (outfile) fclose(outfile);
+  if (outfile_name) free(outfile_name);
+  if (project_name) free(project_name);
+}
+
+  /**
+   *  @fn int source_split_files(xmlNodePtr root)
+   *
+   *  @brief returns number of split source files for the structs and unions
+   *         in @p root
+   *
+   *  @param root - xmlNodePtr containing c-decls element
+   *
+   *  @return number of <base name>-<n>.c files, 0 if source is not split
+   */
+
+int source_split_files(xmlNodePtr root)
+{
+  xmlNodePtr node;
+  int n = 0;
+
+  if (!root || !option_split_source()) return 0;
+
+  for (node = root->children; node; node = node->next)
+  {
+    if (!strcmp((char *)node->name, "struct") ||
+        !strcmp((char *)node->name, "union"))
+      ++n;
+  }
+
+  return (n + option_split_source() - 1) / option_split_source();
+}
+
+  /**
+   *  @fn void gen_split_sources(xmlNodePtr root,
+   *                             char *base_name,
+   *                             char *project_name)
+   *
+   *  @brief generates a <base name>-<n>.c source file for every group of
+   *         structs and unions in @p root
+   *
+   *  NOTE:  every file carries its own copy of the static helpers, and
+   *         reaches the intern table in <base name>.c through the public
+   *         intern functions
+   *
+   *  @param root - xmlNodePtr containing c-decls element
+   *  @param base_name - basic name of project for output files
+   *  @param project_name - string containing upper case project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void gen_split_sources(xmlNodePtr root,
+                              char *base_name,
+                              char *project_name)
+{
+  xmlNodePtr node;
+  FILE *outfile = NULL;
+  char *outfile_name = NULL;
+  int n = 0;
+
+  if (!root || !base_name || !project_name) goto exit;
+
+  outfile_name = malloc(strlen(base_name) + 16);
+  if (!outfile_name) goto exit;
+
+  for (node = root->children; node; node = node->next)
+  {
+    if (strcmp((char *)node->name, "struct") &&
+        strcmp((char *)node->name, "union"))
+      continue;
+
+    if (!(n++ % option_split_source()))
+    {
+      if (outfile) fclose(outfile);
+
+      sprintf(outfile_name,
+              "%s-%d.c",
+              base_name,
+              (n + option_split_source() - 1) / option_split_source());
+
+      outfile = fopen(outfile_name, "w");
+      if (!outfile) goto exit;
+
+      emit_source_front_matter(outfile, root, outfile_name, project_name);
+      emit_intern_forwarders(outfile, root, project_name);
+      emit_source_helpers(outfile, root, project_name);
+    }
+
+    emit_record_functions(outfile, node, project_name);
+  }
+
+exit:
+  if (outfile) fclose(outfile);
+  if (outfile_name) free(outfile_name);
+}
+
+  /**
+   *  @fn void emit_source_front_matter(FILE *outfile,
+   *                                    xmlNodePtr root,
+   *                                    char *file_name,
+   *                                    char *project_name)
+   *
+   *  @brief emits license, warnings, file annotation and includes that
+   *         start every source file
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param root - xmlNodePtr containing c-decls element
+   *  @param file_name - string containing output file name
+   *  @param project_name - string containing upper case project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_source_front_matter(FILE *outfile,
+                                     xmlNodePtr root,
+                                     char *file_name,
+                                     char *project_name)
+{
+  char *tmp = NULL;
+
+  if (!outfile || !root || !file_name || !project_name) goto exit;
 
   switch (option_license())
   {
@@ -189,42 +362,227 @@ void gen_source(xmlDocPtr doc, char *base_name)
       break;
   }
 
-  emit_source_annotation(outfile, basename(outfile_name));
+  emit_source_annotation(outfile, basename(file_name));
 
     // Emit front matter for source file
 
   fprintf(outfile, "#include <stdlib.h>\n");
   fprintf(outfile, "#include <stdio.h>\n");
   fprintf(outfile, "#include <string.h>\n");
+  if (option_gen_json())
+    fprintf(outfile, "#include <math.h>\n");
+  if (intern_needed(root))
+    fprintf(outfile, "#include <stddef.h>\n");
+  if (option_gen_mmap())
+    fprintf(outfile, "#include <fcntl.h>\n");
+  if (option_gen_mmap() || parallel_any())
+    fprintf(outfile, "#include <unistd.h>\n");
+  if (option_gen_mmap())
+  {
+    fprintf(outfile, "#include <sys/mman.h>\n");
+    fprintf(outfile, "#include <sys/stat.h>\n");
+  }
   fprintf(outfile, "\n");
 
+  tmp = strdup(project_name);
+  if (!tmp) goto exit;
+
+  str_lower(tmp);
+
   fprintf(outfile, "#include \"%s.h\"\n", tmp);
   fprintf(outfile, "\n");
 
-  free(tmp);
-  tmp = NULL;
+exit:
+  if (tmp) free(tmp);
+}
 
-    // Emit functions for all enums, structs, and unions
+  /**
+   *  @fn void emit_source_helpers(FILE *outfile,
+   *                               xmlNodePtr root,
+   *                               char *project_name)
+   *
+   *  @brief emits static helpers shared by the functions of all structs and
+   *         unions in a source file
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param root - xmlNodePtr containing c-decls element
+   *  @param project_name - string containing upper case project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
 
-  for (node = root->children; node; node = node->next)
+static void emit_source_helpers(FILE *outfile,
+                                xmlNodePtr root,
+                                char *project_name)
+{
+  emit_sso_helpers(outfile, root);
+  emit_serialize_helpers(outfile, root);
+  emit_flat_helpers(outfile, root);
+  emit_mmap_helpers(outfile, root);
+  emit_delimited_helpers(outfile, root);
+  emit_json_helpers(outfile, root, project_name);
+  emit_hash_helpers(outfile, root);
+}
+
+  /**
+   *  @fn void emit_record_functions(FILE *outfile,
+   *                                 xmlNodePtr node,
+   *                                 char *project_name)
+   *
+   *  @brief emits utility and generator functions of struct or union in
+   *         @p node
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing upper case project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+static void emit_record_functions(FILE *outfile,
+                                  xmlNodePtr node,
+                                  char *project_name)
+{
+  emit_aggregate_functions(outfile, node, project_name);
+  emit_aggregate_array_functions(outfile, node, project_name);
+  emit_aggregate_list_functions(outfile, node, project_name);
+  emit_aggregate_avl_functions(outfile, node, project_name);
+  emit_aggregate_persistent_functions(outfile, node, project_name);
+  emit_aggregate_serialize_functions(outfile, node, project_name);
+  emit_aggregate_flat_functions(outfile, node, project_name);
+  emit_aggregate_mmap_functions(outfile, node, project_name);
+  emit_aggregate_delimited_functions(outfile, node, project_name);
+  emit_aggregate_json_functions(outfile, node, project_name);
+  emit_aggregate_hash_functions(outfile, node, project_name);
+  emit_aggregate_ring_functions(outfile, node, project_name);
+  emit_aggregate_shardmap_functions(outfile, node, project_name);
+  emit_aggregate_parallel_functions(outfile, node, project_name);
+  emit_aggregate_heap_functions(outfile, node, project_name);
+  emit_aggregate_skiplist_functions(outfile, node, project_name);
+}
+
+  /**
+   *  @fn void emit_aggregate_inline_accessors(FILE *outfile,
+   *                                           xmlNodePtr node,
+   *                                           char *project_name)
+   *
+   *  @brief generates static inline getters and setters for the trivial
+   *         fields of struct or union element in @p node
+   *
+   *  NOTE:  output is meant for the header, after the declaration of the
+   *         struct or union.  Nothing is emitted unless the inline accessors
+   *         option is on.
+   *
+   *  @param outfile - open FILE * for writing
+   *  @param node - xmlNodePtr containing struct or union element
+   *  @param project_name - string containing project name
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+  
+void emit_aggregate_inline_accessors(FILE *outfile,
+                                     xmlNodePtr node,
+                                     char *project_name)
+{
+  xmlNodePtr child;
+  char *project = NULL;
+  char *aggregate_name = NULL;
+
+  if (!outfile || !node || !project_name) goto exit;
+  if (!option_inline_accessors()) goto exit;
+  if (strcmp((char *)node->name, "struct") &&
+      strcmp((char *)node->name, "union"))
+    goto exit;
+
+  project = strdup(project_name);
+  if (!project) goto exit;
+  str_lower(project);
+
+  aggregate_name = get_attribute(node, "name");
+  if (!aggregate_name) goto exit;
+
+  for (child = node->children; child; child = child->next)
   {
-    if (!strcmp((char *)node->name, "enum"))
-      emit_enum_functions(outfile, node, project_name);
-    else if (!strcmp((char *)node->name, "struct") ||
-             !strcmp((char *)node->name, "union"))
+    if (strcmp((char *)child->name, "field")) continue;
+    emit_aggregate_getter_function(outfile,
+                                   child,
+                                   project,
+                                   aggregate_name,
+                                   true,
+                                   0);
+    emit_aggregate_setter_function(outfile,
+                                   child,
+                                   project,
+                                   aggregate_name,
+                                   true,
+                                   0);
+  }
+
+exit:
+  if (project) free(project);
+  if (aggregate_name) free(aggregate_name);
+}
+
+  /**
+   *  @fn bool aggregate_accessor_is_inline(xmlNodePtr node, bool setter)
+   *
+   *  @brief determines if getter or setter of field in @p node is emitted
+   *         as a static inline function in the header
+   *
+   *  Getters are trivial for scalars and char pointers, setters only for
+   *  scalars, since a char pointer setter must free and duplicate strings.
+   *
+   *  @param node - xmlNodePtr containing field element
+   *  @param setter - true for setter, false for getter
+   *
+   *  @return true if accessor is inline, false if not
+   */
+
+bool aggregate_accessor_is_inline(xmlNodePtr node, bool setter)
+{
+  xmlNodePtr child;
+  xmlNodePtr scalar = NULL;
+  char *field_type = NULL;
+  int n_pointers = 0;
+  bool is_array = false;
+  bool is_inline = false;
+
+  if (!option_inline_accessors()) goto exit;
+  if (!node || strcmp((char *)node->name, "field")) goto exit;
+
+  for (child = node->children; child; child = child->next)
+  {
+    if (!strcmp((char *)child->name, "array"))
+    {
+      is_array = true;
+      scalar = array_find_scalar(child);
+    }
+    else if (!strcmp((char *)child->name, "pointer"))
     {
-      emit_aggregate_functions(outfile, node, project_name);
-      emit_aggregate_array_functions(outfile, node, project_name);
-      emit_aggregate_list_functions(outfile, node, project_name);
-      emit_aggregate_avl_functions(outfile, node, project_name);
+      n_pointers = pointer_count(child);
+      scalar = pointer_find_scalar(child);
     }
+    else if (!strcmp((char *)child->name, "scalar"))
+      scalar = child;
   }
 
+  if (!scalar || is_array) goto exit;
+
+  field_type = get_attribute(scalar, "type-name");
+  if (!field_type) goto exit;
+
+  if (!n_pointers)
+    is_inline = true;
+  else if (!setter && (n_pointers == 1) && !strcmp(field_type, "char"))
+    is_inline = true;
+
 exit:
-  if (outfile) fclose(outfile);
-  if (outfile_name) free(outfile_name);
-  if (project_name) free(project_name);
-  if (tmp) free(tmp);
+  if (field_type) free(field_type);
+
+  return is_inline;
 }
 
   /**
@@ -466,6 +824,7 @@ static void emit_aggregate_new_function(FILE *outfile,
 {
   char *name = NULL;
   char *fpre = NULL;
+  char *cold_name = NULL;
 
   if (!outfile || !node || !project) goto exit;
   if (strcmp((char *)node->name, "struct") &&
@@ -493,13 +852,54 @@ static void emit_aggregate_new_function(FILE *outfile,
   fprintf(outfile, "\n");
 
   emit_indent(outfile, indent);
-  fprintf(outfile, "instance = malloc(sizeof(%s));\n", name);
+  emit_alloc(outfile, "instance", name, tuning_aligned(name));
 
   emit_indent(outfile, indent);
   fprintf(outfile, "if (instance) memset(instance, 0, sizeof(%s));\n", name);
 
   fprintf(outfile, "\n");
 
+  if (profile_split(name))
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "if (instance)\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "{\n");
+
+    cold_name = strapp(cold_name, name);
+    cold_name = strapp(cold_name, "_cold");
+
+    emit_indent(outfile, indent + 1);
+    emit_alloc(outfile, "instance->_cold", cold_name, tuning_aligned(name));
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile,
+            "if (instance->_cold) "
+            "memset(instance->_cold, 0, sizeof(%s_cold));\n",
+            name);
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "else\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "{\n");
+
+    emit_indent(outfile, indent + 2);
+    fprintf(outfile, "free(instance);\n");
+
+    emit_indent(outfile, indent + 2);
+    fprintf(outfile, "instance = NULL;\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "}\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "}\n");
+
+    fprintf(outfile, "\n");
+  }
+
   emit_indent(outfile, indent);
   fprintf(outfile, "return instance;\n");
 
@@ -512,6 +912,7 @@ static void emit_aggregate_new_function(FILE *outfile,
 exit:
   if (name) free(name);
   if (fpre) free(fpre);
+  if (cold_name) free(cold_name);
 }
 
   /**
@@ -550,6 +951,9 @@ static void emit_aggregate_dup_function(FILE *outfile,
   char *type_name = NULL;
   char *type = NULL;
   char *reference_name = NULL;
+  char *aggregate_name = NULL;
+  char *cold_name = NULL;
+  char *path;
 
   if (!outfile || !node || !project) goto exit;
   if (strcmp((char *)node->name, "struct") &&
@@ -559,6 +963,9 @@ static void emit_aggregate_dup_function(FILE *outfile,
   name = get_attribute(node, "name");
   if (!name) goto exit;
 
+  aggregate_name = strdup(name);
+  if (!aggregate_name) goto exit;
+
   fpre = function_prefix(project, name);
 
   emit_aggregate_dup_annotation(outfile, node, name, fpre, indent + 1);
@@ -583,7 +990,7 @@ static void emit_aggregate_dup_function(FILE *outfile,
   fprintf(outfile, "\n");
 
   emit_indent(outfile, indent);
-  fprintf(outfile, "new_instance = malloc(sizeof(%s));\n", name);
+  emit_alloc(outfile, "new_instance", name, tuning_aligned(name));
 
   emit_indent(outfile, indent);
   fprintf(outfile, "if (!new_instance) goto exit;\n");
@@ -598,6 +1005,47 @@ static void emit_aggregate_dup_function(FILE *outfile,
 
   fprintf(outfile, "\n");
 
+    // cold half of a split struct is copied the same way
+
+  if (profile_split(aggregate_name))
+  {
+    cold_name = strapp(cold_name, aggregate_name);
+    cold_name = strapp(cold_name, "_cold");
+
+    emit_indent(outfile, indent);
+    emit_alloc(outfile,
+               "new_instance->_cold",
+               cold_name,
+               tuning_aligned(aggregate_name));
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "if (!new_instance->_cold)\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "{\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "free(new_instance);\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "new_instance = NULL;\n");
+
+    emit_indent(outfile, indent + 1);
+    fprintf(outfile, "goto exit;\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile, "}\n");
+
+    fprintf(outfile, "\n");
+
+    emit_indent(outfile, indent);
+    fprintf(outfile,
+            "memcpy(new_instance->_cold, instance->_cold, sizeof(%s_cold));\n",
+            aggregate_name);
+
+    fprintf(outfile, "\n");
+  }
+
     // Any pointer to non-scalar field must call that field's _dup function
 
   for (child = node->children; child; child = child->next)
@@ -608,6 +1056,7 @@ static void emit_aggregate_dup_function(FILE *outfile,
     if (strcmp((char *)child->name, "field")) continue;
 
     name = get_attribute(child, "name");
+    path = profile_field_path(aggregate_name, name);
 
       // collect array levels, pointers, and scalar information
 
@@ -649,9 +1098,11 @@ static void emit_aggregate_dup_function(FILE *outfile,
         fpre2 = function_prefix(project, tmp_s);
         emit_indent(outfile, indent);
         fprintf(outfile,
-                "new_instance->%s = %s_dup(instance->%s);\n",
+                "new_instance->%s%s = %s_dup(instance->%s%s);\n",
+                path,
                 name,
                 fpre2,
+                path,
                 name);
         fprintf(outfile, "\n");
         free(fpre2);
@@ -666,14 +1117,40 @@ static void emit_aggregate_dup_function(FILE *outfile,
     else if (n_pointers == 1 && scalar)
     {
       type_name = get_attribute(scalar, "type-name");
-      if (type_name && !strcmp(type_name, "char"))
+      if (intern_field(aggregate_name, child))
       {
         emit_indent(outfile, indent);
-        fprintf(outfile, "if (instance->%s)\n", name);
+        fprintf(outfile,
+                "new_instance->%s%s = intern_string(instance->%s%s);\n",
+                path,
+                name,
+                path,
+                name);
+        fprintf(outfile, "\n");
+      }
+      else if (sso_size(aggregate_name, child))
+      {
+        emit_indent(outfile, indent);
+        fprintf(outfile, "if (instance->%s%s.heap)\n", path, name);
+        emit_indent(outfile, indent + 1);
+        fprintf(outfile,
+                "new_instance->%s%s.heap = strdup(instance->%s%s.heap);\n",
+                path,
+                name,
+                path,
+                name);
+        fprintf(outfile, "\n");
+      }
+      else if (type_name && !strcmp(type_name, "char"))
+      {
+        emit_indent(outfile, indent);
+        fprintf(outfile, "if (instance->%s%s)\n", path, name);
         emit_indent(outfile, indent + 1);
         fprintf(outfile,
-                "new_instance->%s = strdup(instance->%s);\n",
+                "new_instance->%s%s = strdup(instance->%s%s);\n",
+                path,
                 name,
+                path,
                 name);
         fprintf(outfile, "\n");
       }
@@ -711,14 +1188,16 @@ static void emit_aggregate_dup_function(FILE *outfile,
         fprintf(outfile, "%s *tmp_%s_struct = NULL;\n", type_name, name);
 
         emit_indent(outfile, indent);
-        fprintf(outfile, "tmp_%s_struct = %s_dup(&(instance->%s));\n",
+        fprintf(outfile, "tmp_%s_struct = %s_dup(&(instance->%s%s));\n",
                 name,
                 fpre2,
+                path,
                 name);
 
         emit_indent(outfile, indent);
         fprintf(outfile,
-                "memcpy(&new_instance->%s, tmp_%s_struct, sizeof(%s));\n",
+                "memcpy(&new_instance->%s%s, tmp_%s_struct, sizeof(%s));\n",
+                path,
                 name,
                 name,
                 type_name);
@@ -760,6 +1239,8 @@ static void emit_aggregate_dup_function(FILE *outfile,
 exit:
   if (name) free(name);
   if (fpre) free(fpre);
+  if (aggregate_name) free(aggregate_name);
+  if (cold_name) free(cold_name);
 }
 
   /**
@@ -797,6 +1278,8 @@ static void emit_aggregate_free_function(FILE *outfile,
   char *tmp_s = NULL;
   char *type_name = NULL;
   char *reference_name = NULL;
+  char *aggregate_name = NULL;
+  char *path;
 
   if (!outfile || !node || !project) goto exit;
   if (strcmp((char *)node->name, "struct") &&
@@ -806,6 +1289,9 @@ static void emit_aggregate_free_function(FILE *outfile,
   name = get_attribute(node, "name");
   if (!name) goto exit;
 
+  aggregate_name = strdup(name);
+  if (!aggregate_name) goto exit;
+
   fpre = function_prefix(project, name);
 
   emit_aggregate_free_annotation(outfile, node, name, fpre, indent + 1);
@@ -833,6 +1319,7 @@ static void emit_aggregate_free_function(FILE *outfile,
     if (strcmp((char *)child->name, "field")) continue;
 
     name = get_attribute(child, "name");
+    path = profile_field_path(aggregate_name, name);
 
       // collect array levels, pointers, and scalar information
 
@@ -873,11 +1360,12 @@ static void emit_aggregate_free_function(FILE *outfile,
       {
         fpre2 = function_prefix(project, tmp_s);
         emit_indent(outfile, indent);
-        fprintf(outfile, "if (instance->%s)\n", name);
+        fprintf(outfile, "if (instance->%s%s)\n", path, name);
         emit_indent(outfile, indent + 1);
         fprintf(outfile,
-                "%s_free(instance->%s);\n",
+                "%s_free(instance->%s%s);\n",
                 fpre2,
+                path,
                 name);
         fprintf(outfile, "\n");
         free(fpre2);
@@ -892,12 +1380,24 @@ static void emit_aggregate_free_function(FILE *outfile,
     else if (n_pointers == 1 && scalar)
     {
       type_name = get_attribute(scalar, "type-name");
-      if (type_name && !strcmp(type_name, "char"))
+      if (intern_field(aggregate_name, child))
       {
         emit_indent(outfile, indent);
-        fprintf(outfile, "if (instance->%s)\n", name);
+        fprintf(outfile, "intern_release(instance->%s%s);\n", path, name);
+        fprintf(outfile, "\n");
+      }
+      else if (sso_size(aggregate_name, child))
+      {
+        emit_indent(outfile, indent);
+        fprintf(outfile, "free(instance->%s%s.heap);\n", path, name);
+        fprintf(outfile, "\n");
+      }
+      else if (type_name && !strcmp(type_name, "char"))
+      {
+        emit_indent(outfile, indent);
+        fprintf(outfile, "if (instance->%s%s)\n", path, name);
         emit_indent(outfile, indent + 1);
-        fprintf(outfile, "free(instance->%s);\n", name);
+        fprintf(outfile, "free(instance->%s%s);\n", path, name);
         fprintf(outfile, "\n");
       }
       else fprintf(outfile, "#warning Place code to free '%s' here\n", name);
@@ -922,6 +1422,12 @@ static void emit_aggregate_free_function(FILE *outfile,
     name = NULL;
   }
 
+  if (profile_split(aggregate_name))
+  {
+    emit_indent(outfile, indent);
+    fprintf(outfile, "free(instance->_cold);\n");
+  }
+
   emit_indent(outfile, indent);
   fprintf(outfile, "free(instance);\n");
 
@@ -938,6 +1444,7 @@ static void emit_aggregate_free_function(FILE *outfile,
 exit:
   if (name) free(name);
   if (fpre) free(fpre);
+  if (aggregate_name) free(aggregate_name);
 }
 
   /**
@@ -981,11 +1488,13 @@ static void emit_aggregate_getters_and_setters(FILE *outfile,
                                    child,
                                    project,
                                    aggregate_name,
+                                   false,
                                    indent);
     emit_aggregate_setter_function(outfile,
                                    child,
                                    project,
                                    aggregate_name,
+                                   false,
                                    indent);
   }
 
@@ -998,6 +1507,7 @@ exit:
    *                                          xmlNodePtr node,
    *                                          char *project,
    *                                          char *aggregate_name,
+   *                                          bool inline_accessor,
    *                                          int indent)
    *
    *  @brief generates getter C source code for struct or union from element
@@ -1007,6 +1517,9 @@ exit:
    *  @param node - xmlNodePtr containing struct or union element
    *  @param project - string containing project name
    *  @param aggregate_name - string containing name of struct or union
+   *  @param inline_accessor - true to emit only a trivial getter as a
+   *                           static inline function, false to emit all
+   *                           other getters
    *  @param indent - indent level for output
    *
    *  @par Returns
@@ -1017,18 +1530,22 @@ static void emit_aggregate_getter_function(FILE *outfile,
                                            xmlNodePtr node,
                                            char *project,
                                            char *aggregate_name,
+                                           bool inline_accessor,
                                            int indent)
 {
   char *field_name = NULL;
   char *field_type = NULL;
   char *fpre = NULL;
   char *function_name = NULL;
+  char *lvalue = NULL;
+  char *expression = NULL;
   xmlNodePtr child = NULL;
   arrays *arrs = NULL;
   int n_pointers = 0;
   xmlNodePtr scalar = NULL;
   xmlNodePtr reference = NULL;
   char pointers[33];
+  char *path;
   int i;
 
   if (!outfile || !node || !project) goto exit;
@@ -1039,6 +1556,8 @@ static void emit_aggregate_getter_function(FILE *outfile,
   field_name = get_attribute(node, "name");
   if (!field_name) goto exit;
 
+  path = profile_field_path(aggregate_name, field_name);
+
   for (child = node->children; child; child = child->next)
   {
     if (!strcmp((char *)child->name, "array"))
@@ -1067,6 +1586,8 @@ static void emit_aggregate_getter_function(FILE *outfile,
 
   if (!field_type) goto exit;
 
+  if (inline_accessor != aggregate_accessor_is_inline(node, false)) goto exit;
+
   for (i = 0; i < n_pointers; i++)
     pointers[i] = '*';
 
@@ -1127,7 +1648,8 @@ static void emit_aggregate_getter_function(FILE *outfile,
                                      indent + 1);
 
     fprintf(outfile,
-            "%s %s%s(%s *instance)\n",
+            "%s%s %s%s(%s *instance)\n",
+            inline_accessor ? "static inline " : "",
             field_type,
             pointers,
             function_name,
@@ -1138,16 +1660,36 @@ static void emit_aggregate_getter_function(FILE *outfile,
 
     ++indent;
 
-    if (n_pointers)
+    if (n_pointers && sso_size(aggregate_name, node))
+    {
+      lvalue = strapp(lvalue, "instance->");
+      lvalue = strapp(lvalue, path);
+      lvalue = strapp(lvalue, field_name);
+
+      expression = sso_read(lvalue);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "if (!instance) return NULL;\n");
+
+      fprintf(outfile, "\n");
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "return %s;\n", expression);
+    }
+    else if (n_pointers)
     {
       emit_indent(outfile, indent);
-      fprintf(outfile, "return instance ? instance->%s : NULL;\n", field_name);
+      fprintf(outfile,
+              "return instance ? instance->%s%s : NULL;\n",
+              path,
+              field_name);
     }
     else if (scalar)
     {
       emit_indent(outfile, indent);
       fprintf(outfile,
-              "return instance ? instance->%s : 0;\n",
+              "return instance ? instance->%s%s : 0;\n",
+              path,
               field_name);
     }
 
@@ -1165,6 +1707,8 @@ exit:
   if (field_type) free(field_type);
   if (fpre) free(fpre);
   if (function_name) free(function_name);
+  if (lvalue) free(lvalue);
+  if (expression) free(expression);
 }
 
   /**
@@ -1172,6 +1716,7 @@ exit:
    *                                          xmlNodePtr node,
    *                                          char *project,
    *                                          char *aggregate_name,
+   *                                          bool inline_accessor,
    *                                          int indent)
    *
    *  @brief generates setter C source code for struct or union from element
@@ -1181,6 +1726,9 @@ exit:
    *  @param node - xmlNodePtr containing struct or union element
    *  @param project - string containing project name
    *  @param aggregate_name - string containing name of struct or union
+   *  @param inline_accessor - true to emit only a trivial setter as a
+   *                           static inline function, false to emit all
+   *                           other setters
    *  @param indent - indent level for output
    *
    *  @par Returns
@@ -1191,18 +1739,22 @@ static void emit_aggregate_setter_function(FILE *outfile,
                                            xmlNodePtr node,
                                            char *project,
                                            char *aggregate_name,
+                                           bool inline_accessor,
                                            int indent)
 {
   char *field_name = NULL;
   char *field_type = NULL;
   char *fpre = NULL;
   char *function_name = NULL;
+  char *lvalue = NULL;
+  char *expression = NULL;
   xmlNodePtr child = NULL;
   arrays *arrs = NULL;
   int n_pointers = 0;
   xmlNodePtr scalar = NULL;
   xmlNodePtr reference = NULL;
   char pointers[33];
+  char *path;
   int i;
 
   if (!outfile || !node || !project) goto exit;
@@ -1213,6 +1765,8 @@ static void emit_aggregate_setter_function(FILE *outfile,
   field_name = get_attribute(node, "name");
   if (!field_name) goto exit;
 
+  path = profile_field_path(aggregate_name, field_name);
+
   for (child = node->children; child; child = child->next)
   {
     if (!strcmp((char *)child->name, "array"))
@@ -1241,6 +1795,8 @@ static void emit_aggregate_setter_function(FILE *outfile,
 
   if (!field_type) goto exit;
 
+  if (inline_accessor != aggregate_accessor_is_inline(node, true)) goto exit;
+
   for (i = 0; i < n_pointers; i++)
     pointers[i] = '*';
 
@@ -1301,7 +1857,8 @@ static void emit_aggregate_setter_function(FILE *outfile,
                                      indent + 1);
 
     fprintf(outfile,
-            "void %s(%s *instance, %s %s%s)\n",
+            "%svoid %s(%s *instance, %s %s%s)\n",
+            inline_accessor ? "static inline " : "",
             function_name,
             aggregate_name,
             field_type,
@@ -1318,23 +1875,53 @@ static void emit_aggregate_setter_function(FILE *outfile,
 
     fprintf(outfile, "\n");
 
-    if (n_pointers)
+    if (n_pointers && sso_size(aggregate_name, node))
+    {
+      lvalue = strapp(lvalue, "instance->");
+      lvalue = strapp(lvalue, path);
+      lvalue = strapp(lvalue, field_name);
+
+      expression = sso_store(lvalue, field_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile, "%s;\n", expression);
+    }
+    else if (n_pointers && intern_field(aggregate_name, node))
+    {
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              "intern_release(instance->%s%s);\n",
+              path,
+              field_name);
+
+      emit_indent(outfile, indent);
+      fprintf(outfile,
+              "instance->%s%s = intern_string(%s);\n",
+              path,
+              field_name,
+              field_name);
+    }
+    else if (n_pointers)
     {
       emit_indent(outfile, indent);
       fprintf(outfile,
-              "if (instance->%s) free(instance->%s);\n",
+              "if (instance->%s%s) free(instance->%s%s);\n",
+              path,
               field_name,
+              path,
               field_name);
 
       emit_indent(outfile, indent);
       fprintf(outfile,
-              "instance->%s = NULL;\n",
+              "instance->%s%s = NULL;\n",
+              path,
               field_name);
 
       emit_indent(outfile, indent);
       fprintf(outfile,
-              "if (%s) instance->%s = strdup(%s);\n",
+              "if (%s) instance->%s%s = strdup(%s);\n",
               field_name,
+              path,
               field_name,
               field_name);
     }
@@ -1342,7 +1929,8 @@ static void emit_aggregate_setter_function(FILE *outfile,
     {
       emit_indent(outfile, indent);
       fprintf(outfile,
-              "if (instance) instance->%s = %s;\n",
+              "instance->%s%s = %s;\n",
+              path,
               field_name,
               field_name);
     }
@@ -1361,6 +1949,8 @@ exit:
   if (field_type) free(field_type);
   if (fpre) free(fpre);
   if (function_name) free(function_name);
+  if (lvalue) free(lvalue);
+  if (expression) free(expression);
 }
 
   /**
@@ -0,0 +1,368 @@
+/*
+ *  Copyright 2025,2026 Patrick T. Head
+ *
+ *  This program is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or (at your
+ *  option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ *  @file tuning.c
+ *  @brief tracks layout tuning directives for generated structs
+ *
+ *  A tuning file contains one directive per line:
+ *
+ *    align &lt;struct name&gt; [&lt;bytes&gt;]
+ *    separate &lt;struct name&gt;.&lt;field name&gt; [&lt;bytes&gt;]
+ *    intern &lt;struct name&gt;.&lt;field name&gt;
+ *    inline &lt;struct name&gt;.&lt;field name&gt; &lt;bytes&gt;
+ *
+ *  @b align aligns every instance of a struct or union, @b separate starts a
+ *  field on its own cache line so that fields written by different threads
+ *  do not share one.  @a bytes defaults to @a LAYOUT_CACHE_LINE and must be
+ *  a power of two.  @b intern stores a char * field in the generated string
+ *  intern table, so equal strings share one copy.  @b inline stores strings
+ *  of a char * field shorter than @a bytes in a buffer inside the struct,
+ *  longer ones on the heap.
+ *
+ *  Blank lines, lines starting with '#' and unknown directives are ignored.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "tuning.h"
+#include "layout.h"
+
+  /**
+   *  @typedef enum tuning_kind
+   *  @brief kinds of tuning directives
+   */
+
+typedef enum
+{
+  tuning_kind_align = 0,  /**<  align whole struct or union        */
+  tuning_kind_separate,   /**<  place field on its own cache line  */
+  tuning_kind_intern,     /**<  intern strings of char * field     */
+  tuning_kind_inline      /**<  store short strings in the struct  */
+} tuning_kind;
+
+  /**
+   *  @typedef tuning_entry
+   *  @brief creates a type for a @a tuning_entry struct
+   */
+
+typedef struct tuning_entry tuning_entry;
+
+  /**
+   *  @struct tuning_entry
+   *  @brief defines a single tuning directive
+   */
+
+struct tuning_entry
+{
+  tuning_kind kind;   /**<  kind of directive                       */
+  char *aggregate;    /**<  name of struct or union                 */
+  char *field;        /**<  name of field, NULL for whole aggregate  */
+  int bytes;          /**<  alignment in bytes                      */
+};
+
+  /*  static module variables  */
+
+static tuning_entry *_entries = NULL;  /**<  module, loaded directives    */
+static int _n_entries = 0;             /**<  module, number of directives  */
+
+  /*  Module specific function prototypes  */
+
+static tuning_entry *tuning_find(tuning_kind kind,
+                                 char *aggregate,
+                                 char *field);
+
+  /**
+   *  @fn int tuning_load(char *file_name)
+   *
+   *  @brief loads tuning directives from @p file_name
+   *
+   *  @param file_name - string containing name of tuning file
+   *
+   *  @return 0 on success
+   *         -1 on failure
+   */
+
+int tuning_load(char *file_name)
+{
+  FILE *infile = NULL;
+  char line[1024];
+  char *directive;
+  char *name;
+  char *bytes;
+  char *dot = NULL;
+  tuning_kind kind;
+  tuning_entry *tmp;
+  int n;
+  int retval = -1;
+
+  tuning_free();
+
+  if (!file_name) goto exit;
+
+  infile = fopen(file_name, "r");
+  if (!infile) goto exit;
+
+  while (fgets(line, sizeof(line), infile))
+  {
+    directive = strtok(line, " \t\r\n");
+    if (!directive || (*directive == '#')) continue;
+
+    name = strtok(NULL, " \t\r\n");
+    if (!name) continue;
+
+    bytes = strtok(NULL, " \t\r\n");
+    n = bytes ? atoi(bytes) : LAYOUT_CACHE_LINE;
+    if (n <= 0) continue;
+
+    if (!strcmp(directive, "align"))
+      kind = tuning_kind_align;
+    else if (!strcmp(directive, "separate"))
+      kind = tuning_kind_separate;
+    else if (!strcmp(directive, "intern"))
+      kind = tuning_kind_intern;
+    else if (!strcmp(directive, "inline") && bytes)
+      kind = tuning_kind_inline;
+    else
+      continue;
+
+    if ((kind != tuning_kind_inline) && (n & (n - 1))) continue;
+
+    if (kind != tuning_kind_align)
+    {
+      dot = strchr(name, '.');
+      if (!dot || (dot == name) || !dot[1]) continue;
+      *dot = 0;
+    }
+
+    tmp = realloc(_entries, sizeof(tuning_entry) * (_n_entries + 1));
+    if (!tmp) goto exit;
+    _entries = tmp;
+
+    _entries[_n_entries].kind = kind;
+    _entries[_n_entries].aggregate = strdup(name);
+    _entries[_n_entries].field =
+      (kind != tuning_kind_align) ? strdup(dot + 1) : NULL;
+    _entries[_n_entries].bytes = n;
+
+    ++_n_entries;
+  }
+
+  retval = 0;
+
+exit:
+  if (infile) fclose(infile);
+
+  return retval;
+}
+
+  /**
+   *  @fn void tuning_free(void)
+   *
+   *  @brief frees all memory allocated to loaded tuning directives
+   *
+   *  @par Parameters
+   *  None.
+   *
+   *  @par Returns
+   *  Nothing.
+   */
+
+void tuning_free(void)
+{
+  int i;
+
+  for (i = 0; i < _n_entries; i++)
+  {
+    free(_entries[i].aggregate);
+    if (_entries[i].field) free(_entries[i].field);
+  }
+
+  if (_entries) free(_entries);
+
+  _entries = NULL;
+  _n_entries = 0;
+}
+
+  /**
+   *  @fn int tuning_align(char *aggregate)
+   *
+   *  @brief returns requested alignment of struct or union @p aggregate
+   *
+   *  @param aggregate - string containing name of struct or union
+   *
+   *  @return alignment in bytes, 0 if none requested
+   */
+
+int tuning_align(char *aggregate)
+{
+  tuning_entry *entry;
+
+  entry = tuning_find(tuning_kind_align, aggregate, NULL);
+
+  return entry ? entry->bytes : 0;
+}
+
+  /**
+   *  @fn int tuning_field_align(char *aggregate, char *field)
+   *
+   *  @brief returns requested alignment of @p field of @p aggregate
+   *
+   *  @param aggregate - string containing name of struct or union
+   *  @param field - string containing name of field
+   *
+   *  @return alignment in bytes, 0 if field is not separated
+   */
+
+int tuning_field_align(char *aggregate, char *field)
+{
+  tuning_entry *entry;
+
+  entry = tuning_find(tuning_kind_separate, aggregate, field);
+
+  return entry ? entry->bytes : 0;
+}
+
+  /**
+   *  @fn bool tuning_aligned(char *aggregate)
+   *
+   *  @brief determines if instances of @p aggregate need over-aligned
+   *         allocation
+   *
+   *  @param aggregate - string containing name of struct or union
+   *
+   *  @return true if any align or separate directive names @p aggregate,
+   *          false if not
+   */
+
+bool tuning_aligned(char *aggregate)
+{
+  int i;
+
+  if (!aggregate) return false;
+
+  for (i = 0; i < _n_entries; i++)
+  {
+    if ((_entries[i].kind == tuning_kind_intern) ||
+        (_entries[i].kind == tuning_kind_inline))
+      continue;
+    if (!strcmp(_entries[i].aggregate, aggregate)) return true;
+  }
+
+  return false;
+}
+
+  /**
+   *  @fn bool tuning_field_interned(char *aggregate, char *field)
+   *
+   *  @brief determines if strings of @p field of @p aggregate are kept in
+   *         the generated intern table
+   *
+   *  @param aggregate - string containing name of struct or union
+   *  @param field - string containing name of field
+   *
+   *  @return true if field is interned, false if not
+   */
+
+bool tuning_field_interned(char *aggregate, char *field)
+{
+  return tuning_find(tuning_kind_intern, aggregate, field) != NULL;
+}
+
+  /**
+   *  @fn int tuning_field_inline(char *aggregate, char *field)
+   *
+   *  @brief returns size of buffer inside @p aggregate holding short
+   *         strings of @p field
+   *
+   *  @param aggregate - string containing name of struct or union
+   *  @param field - string containing name of field
+   *
+   *  @return size of buffer in bytes, 0 if field is not inline
+   */
+
+int tuning_field_inline(char *aggregate, char *field)
+{
+  tuning_entry *entry;
+
+  entry = tuning_find(tuning_kind_inline, aggregate, field);
+
+  return entry ? entry->bytes : 0;
+}
+
+  /**
+   *  @fn bool tuning_interns(void)
+   *
+   *  @brief determines if any field is interned
+   *
+   *  @par Parameters
+   *  None.
+   *
+   *  @return true if any intern directive is loaded, false if not
+   */
+
+bool tuning_interns(void)
+{
+  int i;
+
+  for (i = 0; i < _n_entries; i++)
+  {
+    if (_entries[i].kind == tuning_kind_intern) return true;
+  }
+
+  return false;
+}
+
+  /**
+   *  @fn static tuning_entry *tuning_find(tuning_kind kind,
+   *                                       char *aggregate,
+   *                                       char *field)
+   *
+   *  @brief locates last directive of @p kind for @p aggregate and @p field
+   *
+   *  @param kind - kind of directive
+   *  @param aggregate - string containing name of struct or union
+   *  @param field - string containing name of field, NULL for aggregate
+   *
+   *  @return pointer to @a tuning_entry on success
+   *          NULL on failure
+   */
+
+static tuning_entry *tuning_find(tuning_kind kind,
+                                 char *aggregate,
+                                 char *field)
+{
+  int i;
+
+  if (!aggregate) return NULL;
+  if ((kind != tuning_kind_align) && !field) return NULL;
+
+  for (i = _n_entries - 1; i >= 0; i--)
+  {
+    if (_entries[i].kind != kind) continue;
+    if (strcmp(_entries[i].aggregate, aggregate)) continue;
+    if (field && strcmp(_entries[i].field, field)) continue;
+
+    return &_entries[i];
+  }
+
+  return NULL;
+}